@@ -15,7 +15,9 @@
  */
 package com.tencent.mtt.hippy;
 
+import android.content.ComponentCallbacks2;
 import android.content.Context;
+import android.content.res.Configuration;
 import android.text.TextUtils;
 
 import androidx.annotation.NonNull;
@@ -78,6 +80,36 @@ public abstract class HippyEngine {
   @SuppressWarnings("JavaJniMissingFunction")
   private static native void setNativeLogHandler(HippyLogAdapter handler);
 
+  private static boolean sEnginePoolEnabled = false;
+  @SuppressWarnings("JavaJniMissingFunction")
+  private static native void enableEnginePool(int size, V8InitParams v8InitParams);
+  /**
+   * Terminates the idle engines of the engine pool, it is refilled by the next engine created once
+   * memory allows it. Called on memory pressure already.
+   */
+  @SuppressWarnings("JavaJniMissingFunction")
+  public static native void trimEnginePool();
+
+  private static boolean sThreadingConfigured = false;
+  @SuppressWarnings("JavaJniMissingFunction")
+  private static native void setThreadingConfig(int jsPriority, long jsAffinityMask,
+      long jsStackSize, int workerPriority, long workerAffinityMask, long workerStackSize);
+
+  private static boolean sSharedThreadsEnabled = false;
+  @SuppressWarnings("JavaJniMissingFunction")
+  private static native void enableSharedThreads(int maxThreadCount);
+
+  public static final int SHARED_THREAD_METRICS_THREAD_COUNT = 0;
+  public static final int SHARED_THREAD_METRICS_SEQUENCE_COUNT = 1;
+  public static final int SHARED_THREAD_METRICS_TASK_COUNT = 2;
+  public static final int SHARED_THREAD_METRICS_CONTENDED_TASK_COUNT = 3;
+  /**
+   * @return metrics of the js threads shared by engines, indexed by SHARED_THREAD_METRICS_*,
+   * all 0 while {@link EngineInitParams#sharedJsThreadCount} is not set
+   */
+  @SuppressWarnings("JavaJniMissingFunction")
+  public static native long[] getSharedThreadMetrics();
+
   /**
    * @param params 创建实例需要的参数 创建一个HippyEngine实例
    */
@@ -93,6 +125,16 @@ public abstract class HippyEngine {
     BuglyUtils.registerSdkAppIdIfNeeded(params.context);
     params.check();
     LogUtils.enableDebugLog(params.enableLog);
+    // before the shared threads and the engine pool, they start threads of their own
+    if (params.jsThreadOptions != null || params.workerThreadOptions != null) {
+      setThreadingConfigIfNeeded(params.jsThreadOptions, params.workerThreadOptions);
+    }
+    if (params.sharedJsThreadCount > 0) {
+      enableSharedThreadsIfNeeded(params.sharedJsThreadCount);
+    }
+    if (params.enginePoolSize > 0 && params.groupId == -1 && params.debugMode != DebugMode.Dev) {
+      enableEnginePoolIfNeeded(params);
+    }
     HippyEngine hippyEngine;
     if (params.groupId == -1) {
       hippyEngine = new HippyNormalEngineManager(params, null);
@@ -102,6 +144,51 @@ public abstract class HippyEngine {
     return hippyEngine;
   }
 
+  private static synchronized void setThreadingConfigIfNeeded(ThreadOptions jsThreadOptions,
+      ThreadOptions workerThreadOptions) {
+    if (sThreadingConfigured) {
+      return;
+    }
+    sThreadingConfigured = true;
+    ThreadOptions js = jsThreadOptions != null ? jsThreadOptions : new ThreadOptions();
+    ThreadOptions worker = workerThreadOptions != null ? workerThreadOptions : new ThreadOptions();
+    setThreadingConfig(js.priority, js.affinityMask, js.stackSize, worker.priority,
+        worker.affinityMask, worker.stackSize);
+  }
+
+  private static synchronized void enableSharedThreadsIfNeeded(int maxThreadCount) {
+    if (sSharedThreadsEnabled) {
+      return;
+    }
+    sSharedThreadsEnabled = true;
+    enableSharedThreads(maxThreadCount);
+  }
+
+  private static synchronized void enableEnginePoolIfNeeded(EngineInitParams params) {
+    if (sEnginePoolEnabled) {
+      return;
+    }
+    sEnginePoolEnabled = true;
+    enableEnginePool(params.enginePoolSize, params.v8InitParams);
+    params.context.getApplicationContext().registerComponentCallbacks(new ComponentCallbacks2() {
+      @Override
+      public void onTrimMemory(int level) {
+        if (level >= TRIM_MEMORY_RUNNING_LOW) {
+          trimEnginePool();
+        }
+      }
+
+      @Override
+      public void onConfigurationChanged(@NonNull Configuration newConfig) {
+      }
+
+      @Override
+      public void onLowMemory() {
+        trimEnginePool();
+      }
+    });
+  }
+
   /**
    * listen engine state. no need to make this method public
    */
@@ -256,6 +343,17 @@ public abstract class HippyEngine {
     public ByteBuffer blob;
   }
 
+  // Scheduling of the threads engines start, unset fields keep the os defaults.
+  public static class ThreadOptions {
+    public static final int DEFAULT_PRIORITY = Integer.MIN_VALUE;
+    // nice value, -20 (highest) to 19 (lowest), as android.os.Process.THREAD_PRIORITY_*
+    public int priority = DEFAULT_PRIORITY;
+    // bit n allows cpu n, 0 leaves the thread unrestricted
+    public long affinityMask = 0;
+    // in bytes, 0 keeps the default
+    public long stackSize = 0;
+  }
+
   // Hippy 引擎初始化时的参数设置
   @SuppressWarnings("deprecation")
   public static class EngineInitParams {
@@ -318,6 +416,19 @@ public abstract class HippyEngine {
     // 可选参数 日志输出
     public HippyLogAdapter logAdapter;
     public V8InitParams v8InitParams;
+    // optional args, engines kept pre-created for groupId -1 so that later engines start without
+    // creating threads and isolate, 0 disables it. Only the first engine created enables the pool,
+    // engines with a snapshot are never pooled.
+    public int enginePoolSize = 0;
+    // optional args, engines run their js on at most this many threads shared with other engines
+    // instead of a thread each, 0 disables it. Only the first engine created enables it. A js
+    // task that blocks, e.g. a sync native call, holds up the engines sharing its thread; engines
+    // in debug mode keep threads of their own.
+    public int sharedJsThreadCount = 0;
+    // optional args, scheduling of the js threads and of the worker threads of engines. Only the
+    // first engine created sets it, for every engine and shared thread started afterwards.
+    public ThreadOptions jsThreadOptions;
+    public ThreadOptions workerThreadOptions;
     public boolean enableTurbo;
     public boolean runningOnTVPlatform;
 
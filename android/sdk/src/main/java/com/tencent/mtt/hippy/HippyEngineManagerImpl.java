@@ -27,6 +27,7 @@ import com.tencent.mtt.hippy.adapter.monitor.HippyEngineMonitorAdapter;
 import com.tencent.mtt.hippy.adapter.monitor.HippyEngineMonitorEvent;
 import com.tencent.mtt.hippy.adapter.monitor.HippyEngineMonitorPoint;
 import com.tencent.mtt.hippy.adapter.thirdparty.HippyThirdPartyAdapter;
+import com.tencent.mtt.hippy.bridge.HippyBridgeImpl;
 import com.tencent.mtt.hippy.bridge.HippyBridgeManager;
 import com.tencent.mtt.hippy.bridge.HippyBridgeManagerImpl;
 import com.tencent.mtt.hippy.bridge.bundleloader.HippyAssetBundleLoader;
@@ -469,8 +470,19 @@ public abstract class HippyEngineManagerImpl extends HippyEngineManager implemen
     return mHippyV8;
   }
 
+  private void setRuntimeBackground(boolean background) {
+    if (mEngineContext == null || mEngineContext.getBridgeManager() == null) {
+      return;
+    }
+    long runTimeId = mEngineContext.getBridgeManager().getV8RuntimeId();
+    if (runTimeId != HippyBridgeManagerImpl.V8_RUNTIME_ID_EMPTY) {
+      HippyBridgeImpl.setRuntimeBackground(runTimeId, background);
+    }
+  }
+
   @Override
   public void onEngineResume() {
+    setRuntimeBackground(false);
     if (mEngineContext != null && mEngineContext.mEngineLifecycleEventListeners != null) {
       for (HippyRootView rootView : mInstances) {
         rootView.onResume();
@@ -497,6 +509,7 @@ public abstract class HippyEngineManagerImpl extends HippyEngineManager implemen
 
   @Override
   public void onEnginePause() {
+    setRuntimeBackground(true);
     if (mEngineContext != null && mEngineContext.mEngineLifecycleEventListeners != null) {
       for (HippyRootView rootView : mInstances) {
         rootView.onPause();
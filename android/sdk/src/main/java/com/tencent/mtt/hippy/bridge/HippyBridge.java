@@ -49,6 +49,34 @@ public interface HippyBridge {
     void callFunction(String action, NativeCallback callback, byte[] buffer, int offset,
             int length);
 
+    /**
+     * @param coalesceKey "moduleName.eventName", optionally followed by "#target", messages
+     *                    whose rule was enabled by {@link #setMessageCoalescing} fold into a
+     *                    pending one with the same key, null to never coalesce
+     * @param isInput     true for touch and gesture events, which run ahead of other queued js
+     *                    tasks, every other call runs in the order it was made
+     */
+    void callFunction(String action, String coalesceKey, boolean isInput, NativeCallback callback,
+            ByteBuffer buffer);
+
+    void callFunction(String action, String coalesceKey, boolean isInput, NativeCallback callback,
+            byte[] buffer, int offset, int length);
+
+    void setMessageCoalescing(String moduleName, String eventName, boolean coalesced);
+
+    /**
+     * @return dropped and merged message counts, indexed by
+     * {@link HippyBridgeImpl#COALESCER_STATS_DROPPED} and {@link HippyBridgeImpl#COALESCER_STATS_MERGED}
+     */
+    long[] getMessageCoalescerStats();
+
+    /**
+     * @return counts of the JS timers, indexed by {@link HippyBridgeImpl#TIMER_STATS_DELAYED_TASKS},
+     * {@link HippyBridgeImpl#TIMER_STATS_WAKE_UPS}, {@link HippyBridgeImpl#TIMER_STATS_COALESCED_TASKS}
+     * and {@link HippyBridgeImpl#TIMER_STATS_SAVED_WAKE_UPS}
+     */
+    long[] getTimerStats();
+
     long getV8RuntimeId();
 
     interface BridgeCallback {
@@ -31,6 +31,8 @@ import com.tencent.mtt.hippy.devsupport.DevRemoteDebugProxy;
 import com.tencent.mtt.hippy.devsupport.DevServerCallBack;
 import com.tencent.mtt.hippy.devsupport.DevSupportManager;
 import com.tencent.mtt.hippy.devsupport.inspector.Inspector;
+import com.tencent.mtt.hippy.dom.HippyChoreographer;
+import com.tencent.mtt.hippy.dom.ICSChoreographer;
 import com.tencent.mtt.hippy.modules.HippyModuleManager;
 import com.tencent.mtt.hippy.modules.nativemodules.HippyNativeModuleInfo;
 import com.tencent.mtt.hippy.serialization.PrimitiveValueDeserializer;
@@ -60,6 +62,14 @@ import androidx.annotation.Nullable;
 @SuppressWarnings({"unused", "JavaJniMissingFunction"})
 public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnReceiveDataListener {
 
+    public static final int COALESCER_STATS_DROPPED = 0;
+    public static final int COALESCER_STATS_MERGED = 1;
+
+    public static final int TIMER_STATS_DELAYED_TASKS = 0;
+    public static final int TIMER_STATS_WAKE_UPS = 1;
+    public static final int TIMER_STATS_COALESCED_TASKS = 2;
+    public static final int TIMER_STATS_SAVED_WAKE_UPS = 3;
+
     private static final Object sBridgeSyncLock;
 
     static {
@@ -242,6 +252,12 @@ public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnRecei
 
     @Override
     public void callFunction(String action, NativeCallback callback, ByteBuffer buffer) {
+        callFunction(action, null, false, callback, buffer);
+    }
+
+    @Override
+    public void callFunction(String action, String coalesceKey, boolean isInput,
+            NativeCallback callback, ByteBuffer buffer) {
         if (!mInit || TextUtils.isEmpty(action) || buffer == null || buffer.limit() == 0) {
             return;
         }
@@ -249,7 +265,8 @@ public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnRecei
         int offset = buffer.position();
         int length = buffer.limit() - buffer.position();
         if (buffer.isDirect()) {
-            callFunction(action, mV8RuntimeId, callback, buffer, offset, length);
+            callFunction(action, coalesceKey, isInput, mV8RuntimeId, callback, buffer, offset,
+                    length);
         } else {
             /*
              * In Android's DirectByteBuffer implementation.
@@ -266,7 +283,8 @@ public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnRecei
              * {@link ByteBuffer#arrayOffset} will be ignored, treated as 0.
              */
             offset += buffer.arrayOffset();
-            callFunction(action, mV8RuntimeId, callback, buffer.array(), offset, length);
+            callFunction(action, coalesceKey, isInput, mV8RuntimeId, callback, buffer.array(),
+                    offset, length);
         }
     }
 
@@ -278,12 +296,43 @@ public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnRecei
     @Override
     public void callFunction(String action, NativeCallback callback, byte[] buffer, int offset,
             int length) {
+        callFunction(action, null, false, callback, buffer, offset, length);
+    }
+
+    @Override
+    public void callFunction(String action, String coalesceKey, boolean isInput,
+            NativeCallback callback, byte[] buffer, int offset, int length) {
         if (!mInit || TextUtils.isEmpty(action) || buffer == null || offset < 0 || length < 0
                 || offset + length > buffer.length) {
             return;
         }
 
-        callFunction(action, mV8RuntimeId, callback, buffer, offset, length);
+        callFunction(action, coalesceKey, isInput, mV8RuntimeId, callback, buffer, offset,
+                length);
+    }
+
+    @Override
+    public void setMessageCoalescing(String moduleName, String eventName, boolean coalesced) {
+        if (!mInit || TextUtils.isEmpty(moduleName) || TextUtils.isEmpty(eventName)) {
+            return;
+        }
+        setMessageCoalescing(mV8RuntimeId, moduleName, eventName, coalesced);
+    }
+
+    @Override
+    public long[] getMessageCoalescerStats() {
+        if (!mInit) {
+            return null;
+        }
+        return getMessageCoalescerStats(mV8RuntimeId);
+    }
+
+    @Override
+    public long[] getTimerStats() {
+        if (!mInit) {
+            return null;
+        }
+        return getTimerStats(mV8RuntimeId);
     }
 
     @Override
@@ -329,6 +378,8 @@ public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnRecei
 
     public static native int createSnapshot(String[] script, String path, String uri, String config);
 
+    public static native void setRuntimeBackground(long runtimeId, boolean background);
+
     public native long initJSFramework(byte[] globalConfig, boolean useLowMemoryMode,
             boolean enableV8Serialization, boolean isDevModule, NativeCallback callback,
             long groupId, V8InitParams v8InitParams);
@@ -340,14 +391,23 @@ public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnRecei
 
     public native void destroy(long runtimeId, boolean useLowMemoryMode, boolean isReload, NativeCallback callback);
 
-    public native void callFunction(String action, long runtimeId, NativeCallback callback,
-            ByteBuffer buffer, int offset, int length);
+    public native void callFunction(String action, String coalesceKey, boolean isInput,
+            long runtimeId, NativeCallback callback, ByteBuffer buffer, int offset, int length);
 
-    public native void callFunction(String action, long runtimeId, NativeCallback callback,
-            byte[] buffer, int offset, int length);
+    public native void callFunction(String action, String coalesceKey, boolean isInput,
+            long runtimeId, NativeCallback callback, byte[] buffer, int offset, int length);
+
+    public static native void setMessageCoalescing(long runtimeId, String moduleName,
+            String eventName, boolean coalesced);
+
+    public static native long[] getMessageCoalescerStats(long runtimeId);
+
+    public static native long[] getTimerStats(long runtimeId);
 
     public native void onResourceReady(ByteBuffer output, long runtimeId, long resId);
 
+    public native void onFrame(long requestId, long frameTimeNanos);
+
     private native void runInJsThread(long runtimeId, Callback<Void> callback);
 
     public void callNatives(String moduleName, String moduleFunc, String callId, byte[] buffer) {
@@ -427,6 +487,21 @@ public class HippyBridgeImpl implements HippyBridge, DevRemoteDebugProxy.OnRecei
         });
     }
 
+    @SuppressWarnings("unused")
+    public void requestFrame(final long requestId) {
+        UIThreadUtils.runOnUiThread(new Runnable() {
+            @Override
+            public void run() {
+                ICSChoreographer.getInstance().postFrameCallback(new HippyChoreographer.FrameCallback() {
+                    @Override
+                    public void doFrame(long frameTimeNanos) {
+                        onFrame(requestId, frameTimeNanos);
+                    }
+                });
+            }
+        });
+    }
+
     private HippyArray parseJsonData(ByteBuffer buffer) {
         byte[] bytes;
         if (buffer.isDirect()) {
@@ -58,6 +58,21 @@ public interface HippyBridgeManager {
   void callJavaScriptModule(String mName, String name, Object params,
       BridgeTransferType transferType);
 
+  /**
+   * While JS is busy, a pending message of a coalesced event is replaced by the newer one of the
+   * same target. The event name is the one passed to EventDispatcher, or the method name for
+   * other modules.
+   */
+  void setMessageCoalescing(String moduleName, String eventName, boolean coalesced);
+
+  long[] getMessageCoalescerStats();
+
+  /**
+   * Timer deadlines are moved within a slack window so that timers due close together wake the JS
+   * thread once, the saved wake ups count only the ones the moved deadlines avoided.
+   */
+  long[] getTimerStats();
+
   HippyThirdPartyAdapter getThirdPartyAdapter();
 
   long getV8RuntimeId();
@@ -37,6 +37,7 @@ import com.tencent.mtt.hippy.adapter.thirdparty.HippyThirdPartyAdapter;
 import com.tencent.mtt.hippy.bridge.bundleloader.HippyBundleLoader;
 import com.tencent.mtt.hippy.bridge.jsi.TurboModuleManager;
 import com.tencent.mtt.hippy.common.Callback;
+import com.tencent.mtt.hippy.common.HippyArray;
 import com.tencent.mtt.hippy.common.HippyJsException;
 import com.tencent.mtt.hippy.common.HippyMap;
 import com.tencent.mtt.hippy.modules.HippyModuleManager;
@@ -53,6 +54,8 @@ import com.tencent.mtt.hippy.utils.UIThreadUtils;
 import java.nio.ByteBuffer;
 import java.nio.charset.StandardCharsets;
 import java.util.ArrayList;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
 import org.json.JSONException;
 import org.json.JSONObject;
 
@@ -103,6 +106,8 @@ public class HippyBridgeManagerImpl implements HippyBridgeManager, HippyBridge.B
     private HippyEngine.V8InitParams v8InitParams;
     @Nullable
     private NativeCallback mCallFunctionCallback;
+    // rule name "moduleName.eventName" to {moduleName, eventName}
+    private final Map<String, String[]> mCoalescedEvents = new ConcurrentHashMap<>();
 
     public HippyBridgeManagerImpl(HippyEngineContext context, HippyBundleLoader coreBundleLoader,
             int bridgeType, boolean enableV8Serialization, HippyEngine.DebugMode debugMode,
@@ -184,6 +189,13 @@ public class HippyBridgeManagerImpl implements HippyBridgeManager, HippyBridge.B
             }
         }
 
+        String coalesceKey = null;
+        boolean isInput = false;
+        if (msg.arg2 == FUNCTION_ACTION_CALL_JSMODULE && msg.obj instanceof HippyMap) {
+            coalesceKey = getCoalesceKey((HippyMap) msg.obj);
+            isInput = isInputEvent((HippyMap) msg.obj);
+        }
+
         PrimitiveValueSerializer serializer = (msg.obj instanceof JSValue) ?
                 recommendSerializer : compatibleSerializer;
 
@@ -208,7 +220,7 @@ public class HippyBridgeManagerImpl implements HippyBridgeManager, HippyBridge.B
                 buffer.put(bytes);
             }
 
-            mHippyBridge.callFunction(action, mCallFunctionCallback, buffer);
+            mHippyBridge.callFunction(action, coalesceKey, isInput, mCallFunctionCallback, buffer);
         } else {
             if (enableV8Serialization) {
                 if (safeHeapWriter == null) {
@@ -223,14 +235,61 @@ public class HippyBridgeManagerImpl implements HippyBridgeManager, HippyBridge.B
                 ByteBuffer buffer = safeHeapWriter.chunked();
                 int offset = buffer.arrayOffset() + buffer.position();
                 int length = buffer.limit() - buffer.position();
-                mHippyBridge.callFunction(action, mCallFunctionCallback, buffer.array(), offset, length);
+                mHippyBridge.callFunction(action, coalesceKey, isInput, mCallFunctionCallback,
+                        buffer.array(), offset, length);
             } else {
                 mStringBuilder.setLength(0);
                 byte[] bytes = ArgumentUtils.objectToJsonOpt(msg.obj, mStringBuilder).getBytes(
                         StandardCharsets.UTF_16LE);
-                mHippyBridge.callFunction(action, mCallFunctionCallback, bytes);
+                mHippyBridge.callFunction(action, coalesceKey, isInput, mCallFunctionCallback,
+                        bytes, 0, bytes.length);
+            }
+        }
+    }
+
+    /**
+     * EventDispatcher sends every event through a few methods with the event name and the target
+     * view in the params, so the key is built from those, other modules are keyed by method.
+     *
+     * @return "moduleName.eventName#target" for a coalesced event, otherwise null
+     */
+    @Nullable
+    private String getCoalesceKey(HippyMap call) {
+        if (mCoalescedEvents.isEmpty()) {
+            return null;
+        }
+        String eventName = call.getString("methodName");
+        Object target = null;
+        Object params = call.get("params");
+        if (params instanceof HippyMap && ((HippyMap) params).containsKey("name")) {
+            // receiveNativeGesture({name, id, ...})
+            eventName = ((HippyMap) params).getString("name");
+            target = ((HippyMap) params).get("id");
+        } else if (params instanceof HippyArray) {
+            HippyArray args = (HippyArray) params;
+            if (args.size() >= 3 && args.getObject(1) instanceof String) {
+                // receiveUIComponentEvent(tagId, eventName, param)
+                target = args.getObject(0);
+                eventName = args.getString(1);
+            } else if (args.size() >= 1 && args.getObject(0) instanceof String) {
+                // receiveNativeEvent(eventName, param)
+                eventName = args.getString(0);
             }
         }
+        String rule = call.getString("moduleName") + "." + eventName;
+        if (!mCoalescedEvents.containsKey(rule)) {
+            return null;
+        }
+        return target == null ? rule : rule + "#" + target;
+    }
+
+    /**
+     * Touch and gestures reach js through EventDispatcher.receiveNativeGesture, only those run
+     * ahead of the calls queued before them.
+     */
+    private boolean isInputEvent(HippyMap call) {
+        return "EventDispatcher".equals(call.getString("moduleName"))
+                && "receiveNativeGesture".equals(call.getString("methodName"));
     }
 
     private void handleRunScript(Message msg) {
@@ -300,6 +359,10 @@ public class HippyBridgeManagerImpl implements HippyBridgeManager, HippyBridge.B
                                 timeMonitor.addPoint(HippyEngineMonitorPoint.INIT_JS_FRAMEWORK_END);
                                 timeMonitor.startEvent(HippyEngineMonitorEvent.ENGINE_LOAD_EVENT_LOAD_COMMONJS);
                                 mIsInit = true;
+                                // rules set before the runtime existed
+                                for (String[] rule : mCoalescedEvents.values()) {
+                                    mHippyBridge.setMessageCoalescing(rule[0], rule[1], true);
+                                }
                                 loadCoreBundle(timeMonitor, callback);
                             }
                         }, mGroupId);
@@ -769,6 +832,38 @@ public class HippyBridgeManagerImpl implements HippyBridgeManager, HippyBridge.B
     return mHippyBridge.getV8RuntimeId();
   }
 
+  @Override
+  public void setMessageCoalescing(String moduleName, String eventName, boolean coalesced) {
+    if (TextUtils.isEmpty(moduleName) || TextUtils.isEmpty(eventName)) {
+      return;
+    }
+    String rule = moduleName + "." + eventName;
+    if (coalesced) {
+      mCoalescedEvents.put(rule, new String[]{moduleName, eventName});
+    } else {
+      mCoalescedEvents.remove(rule);
+    }
+    if (mIsInit && mHippyBridge != null) {
+      mHippyBridge.setMessageCoalescing(moduleName, eventName, coalesced);
+    }
+  }
+
+  @Override
+  public long[] getMessageCoalescerStats() {
+    if (!mIsInit || mHippyBridge == null) {
+      return null;
+    }
+    return mHippyBridge.getMessageCoalescerStats();
+  }
+
+  @Override
+  public long[] getTimerStats() {
+    if (!mIsInit || mHippyBridge == null) {
+      return null;
+    }
+    return mHippyBridge.getTimerStats();
+  }
+
   private boolean enableTurbo() {
         return mContext.getGlobalConfigs() != null && mContext.getGlobalConfigs().enableTurbo();
     }
@@ -39,6 +39,17 @@ public class V8 implements V8Memory {
     long callback(long currentHeapLimit, long initialHeapLimit);
   }
 
+  public interface HangCallback {
+    /**
+     * This callback is invoked once for every js task that runs longer than the threshold
+     * given to setHangWatchdog. origin names where the task was posted from, elapsedMs counts
+     * from the start of the task and jsStack is the js stack sampled while it was stalled,
+     * empty when the js thread did not yield it within a quarter of the threshold.
+     * It is called on the watchdog thread, even while the js thread stays stalled.
+     */
+    void onHang(long elapsedMs, String origin, String jsStack);
+  }
+
   private final long mV8RuntimeId;
 
   public V8(long mV8RuntimeId) {
@@ -69,6 +80,33 @@ public class V8 implements V8Memory {
     return writeHeapSnapshot(mV8RuntimeId, filePath, callback);
   }
 
+  // The method must be called in the js thread, a sampleInterval or stackDepth of 0 uses the default
+  public boolean startSamplingHeapProfiler(long sampleInterval, int stackDepth) {
+    return startSamplingHeapProfiler(mV8RuntimeId, sampleInterval, stackDepth);
+  }
+
+  // The method must be called in the js thread, the profile can be opened by devtools as a .heapprofile
+  public boolean writeSamplingHeapProfile(@NonNull String filePath, @NonNull Callback<Integer> callback) {
+    return writeSamplingHeapProfile(mV8RuntimeId, filePath, callback);
+  }
+
+  // The method must be called in the js thread
+  public void stopSamplingHeapProfiler() {
+    stopSamplingHeapProfiler(mV8RuntimeId);
+  }
+
+  // The method must be called in the js thread, a samplingIntervalUs of 0 uses the default
+  // and a maxDurationMs of 0 profiles until stopCpuProfiling
+  public boolean startCpuProfiling(int samplingIntervalUs, int maxDurationMs) {
+    return startCpuProfiling(mV8RuntimeId, samplingIntervalUs, maxDurationMs);
+  }
+
+  // The method must be called in the js thread, the callback is called on a worker thread with
+  // whether the profile was written, it can be opened by devtools as a .cpuprofile
+  public boolean stopCpuProfiling(@NonNull String filePath, @NonNull Callback<Boolean> callback) {
+    return stopCpuProfiling(mV8RuntimeId, filePath, callback);
+  }
+
   // The method must be called in the js thread
   public void addNearHeapLimitCallback(NearHeapLimitCallback callback) {
     addNearHeapLimitCallback(mV8RuntimeId, callback);
@@ -84,6 +122,11 @@ public class V8 implements V8Memory {
     requestInterrupt(mV8RuntimeId, callback);
   }
 
+  // the method can be called from any thread but onHang, a thresholdMs of 0 stops the watchdog
+  public void setHangWatchdog(long thresholdMs, HangCallback callback) {
+    setHangWatchdog(mV8RuntimeId, thresholdMs, callback);
+  }
+
   // [memory]
   private native boolean getHeapStatistics(long runtimeId, Callback<V8HeapStatistics> callback) throws NoSuchMethodException;
 
@@ -93,10 +136,22 @@ public class V8 implements V8Memory {
 
   private native boolean writeHeapSnapshot(long runtimeId, String filePath, Callback<Integer> callback) throws NoSuchMethodException;
 
+  private native boolean startSamplingHeapProfiler(long runtimeId, long sampleInterval, int stackDepth);
+
+  private native boolean writeSamplingHeapProfile(long runtimeId, String filePath, Callback<Integer> callback);
+
+  private native void stopSamplingHeapProfiler(long runtimeId);
+
+  private native boolean startCpuProfiling(long runtimeId, int samplingIntervalUs, int maxDurationMs);
+
+  private native boolean stopCpuProfiling(long runtimeId, String filePath, Callback<Boolean> callback);
+
   private native void addNearHeapLimitCallback(long runtimeId, NearHeapLimitCallback callback);
 
   private native void printCurrentStackTrace(long runtimeId, Callback<String> callback);
 
   private native void requestInterrupt(long runtimeId, Callback<Void> callback);
 
+  private native void setHangWatchdog(long runtimeId, long thresholdMs, HangCallback callback);
+
 }
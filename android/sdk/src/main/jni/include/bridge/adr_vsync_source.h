@@ -0,0 +1,46 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <jni.h>
+
+#include <memory>
+
+#include "core/core.h"
+#include "jni/scoped_java_ref.h"
+
+// Ticks requestAnimationFrame on the display vsync through the Choreographer
+// of HippyBridgeImpl instead of a 16ms timer.
+class ADRVsyncSource : public VsyncSource {
+ public:
+  explicit ADRVsyncSource(std::shared_ptr<JavaRef> bridge) : bridge_(std::move(bridge)) {}
+
+  void RequestFrame(FrameCallback cb) override;
+
+  static FrameCallback TakeRequestCB(int64_t request_id);
+
+ private:
+  static int64_t SetRequestCB(FrameCallback cb);
+
+  std::shared_ptr<JavaRef> bridge_;
+};
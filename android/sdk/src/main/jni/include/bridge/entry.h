@@ -69,6 +69,31 @@ void RunInJsThread(JNIEnv *j_env,
                    jlong j_runtime_id,
                    jobject j_callback);
 
+void SetRuntimeBackground(JNIEnv* j_env,
+                          __unused jobject j_obj,
+                          jlong j_runtime_id,
+                          jboolean j_background);
+
+void EnableEnginePool(JNIEnv* j_env,
+                      __unused jobject j_obj,
+                      jint j_size,
+                      jobject j_vm_init_param);
+
+void TrimEnginePool(__unused JNIEnv* j_env, __unused jobject j_obj);
+
+void SetThreadingConfig(__unused JNIEnv* j_env,
+                        __unused jobject j_obj,
+                        jint j_js_priority,
+                        jlong j_js_affinity_mask,
+                        jlong j_js_stack_size,
+                        jint j_worker_priority,
+                        jlong j_worker_affinity_mask,
+                        jlong j_worker_stack_size);
+
+void EnableSharedThreads(__unused JNIEnv* j_env, __unused jobject j_obj, jint j_max_thread_count);
+
+jlongArray GetSharedThreadMetrics(JNIEnv* j_env, __unused jobject j_obj);
+
 
 }  // namespace bridge
 }  // namespace hippy
@@ -35,6 +35,8 @@ void CallJavaMethod(jobject j_obj,
 void CallFunctionByHeapBuffer(JNIEnv* j_env,
                               jobject j_obj,
                               jstring j_action,
+                              jstring j_coalesce_key,
+                              jboolean j_is_input,
                               jlong j_runtime_id,
                               jobject j_callback,
                               jbyteArray j_byte_array,
@@ -44,11 +46,24 @@ void CallFunctionByHeapBuffer(JNIEnv* j_env,
 void CallFunctionByDirectBuffer(JNIEnv* j_env,
                                 jobject j_obj,
                                 jstring j_action,
+                                jstring j_coalesce_key,
+                                jboolean j_is_input,
                                 jlong j_runtime_id,
                                 jobject j_callback,
                                 jobject j_buffer,
                                 jint j_offset,
                                 jint j_length);
 
+void SetMessageCoalescing(JNIEnv* j_env,
+                          jobject j_obj,
+                          jlong j_runtime_id,
+                          jstring j_module_name,
+                          jstring j_event_name,
+                          jboolean j_coalesced);
+
+jlongArray GetMessageCoalescerStats(JNIEnv* j_env, jobject j_obj, jlong j_runtime_id);
+
+jlongArray GetTimerStats(JNIEnv* j_env, jobject j_obj, jlong j_runtime_id);
+
 }  // namespace bridge
 }  // namespace hippy
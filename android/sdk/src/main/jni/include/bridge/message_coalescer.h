@@ -0,0 +1,94 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "jni/scoped_java_ref.h"
+
+namespace hippy {
+namespace bridge {
+
+// Folds high frequency native to js messages, such as scroll or touch move
+// events, while they wait for the js runner. Only messages whose key matches
+// a registered rule are coalesced, every other message is delivered as is.
+//
+// A key is "<module>.<event>" optionally followed by "#<target>", the rule is
+// the part before '#'. All events of a module share one action on the wire,
+// so the sender derives the key from the payload it serializes, and messages
+// for different targets, such as two scroll views, never replace each other.
+class MessageCoalescer {
+ public:
+  using bytes = std::string;
+  // folds incoming into pending, both are payloads in the wire format of the runtime
+  using MergeFunction = std::function<void(bytes& pending, bytes&& incoming)>;
+
+  struct Message {
+    bytes data;
+    std::shared_ptr<JavaRef> buffer_owner;
+    // one per folded message, every sender is answered when the message runs
+    std::vector<std::shared_ptr<JavaRef>> callbacks;
+  };
+
+  struct Stats {
+    // pending messages replaced by a newer one
+    uint64_t dropped_count = 0;
+    // messages folded into a pending one by a merge function
+    uint64_t merged_count = 0;
+  };
+
+  MessageCoalescer() = default;
+  ~MessageCoalescer() = default;
+
+  static std::u16string RuleName(const std::u16string& module_name, const std::u16string& event_name);
+
+  // without a merge function the newest message replaces the pending one
+  void RegisterRule(const std::u16string& module_name,
+                    const std::u16string& event_name,
+                    MergeFunction merge = nullptr);
+  void UnregisterRule(const std::u16string& module_name, const std::u16string& event_name);
+
+  // returns true when message was folded into a pending one and must not be
+  // posted, otherwise the caller posts it and calls Start when the task runs
+  bool Offer(const std::u16string& key, const std::shared_ptr<Message>& message);
+  // takes the payload of a posted message, newer ones are posted anew from now on
+  Message Start(const std::u16string& key, const std::shared_ptr<Message>& message);
+
+  Stats GetStats();
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::u16string, MergeFunction> rules_;
+  std::unordered_map<std::u16string, std::shared_ptr<Message>> pending_;
+  Stats stats_;
+};
+
+}  // namespace bridge
+}  // namespace hippy
@@ -26,8 +26,12 @@
 #include <stdint.h>
 
 #include <any>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <utility>
 
+#include "bridge/message_coalescer.h"
 #include "core/core.h"
 #include "jni/java_turbo_module.h"
 #include "jni/scoped_java_ref.h"
@@ -53,6 +57,11 @@ class Runtime {
     return bridge_func_;
   }
   inline std::string& GetBuffer() { return serializer_reused_buffer_; }
+  inline std::shared_ptr<hippy::bridge::MessageCoalescer> GetMessageCoalescer() {
+    return message_coalescer_;
+  }
+  inline bool IsBackground() { return is_background_; }
+  inline void SetBackground(bool background) { is_background_ = background; }
 
   inline void SetGroupId(int64_t id) { group_id_ = id; }
   inline void SetBridgeFunc(std::shared_ptr<hippy::napi::CtxValue> func) {
@@ -89,6 +98,29 @@ class Runtime {
   inline std::shared_ptr<hippy::InterruptQueue> GetInterruptQueue() {
     return interrupt_queue_;
   }
+  inline void SetHangWatchdog(std::shared_ptr<HangWatchdog> watchdog) {
+    hang_watchdog_ = watchdog;
+  }
+  inline std::shared_ptr<HangWatchdog> GetHangWatchdog() {
+    return hang_watchdog_;
+  }
+  // js thread only, swaps in the future of the script requested last and
+  // returns the one of the script before it
+  inline hippy::base::Future<bool> SwapLastScriptRun(hippy::base::Future<bool> script_run) {
+    std::swap(last_script_run_, script_run);
+    return script_run;
+  }
+  // js thread only, runs task once every script requested before it has run:
+  // right away when none is pending, otherwise as a js task at priority.
+  // Later scripts and tasks wait for it in turn.
+  template <typename F>
+  void RunAfterLastScript(JavaScriptTaskRunner::Priority priority, F&& task) {
+    if (last_script_run_.IsReady()) {
+      task();
+      return;
+    }
+    PostAfterLastScript(priority, std::function<void()>(std::forward<F>(task)));
+  }
   inline auto GetNearHeapLimitCallback() {
     return near_heap_limit_cb_;
   }
@@ -101,10 +133,15 @@ class Runtime {
   static std::shared_ptr<Runtime> Find(v8::Isolate* isolate);
   static bool Erase(int32_t id);
   static bool Erase(const std::shared_ptr<Runtime>& runtime);
+  // true when every runtime running on engine is in the background
+  static bool IsEngineInBackground(const std::shared_ptr<Engine>& engine);
 
  private:
+  void PostAfterLastScript(JavaScriptTaskRunner::Priority priority, std::function<void()> task);
+
   bool enable_v8_serialization_;
   bool is_debug_;
+  std::atomic<bool> is_background_;
   int64_t group_id_;
   std::shared_ptr<Bridge> bridge_;
   std::string serializer_reused_buffer_;
@@ -114,7 +151,10 @@ class Runtime {
   int32_t id_;
   std::unordered_map<uint32_t, std::any> slot_;
   std::shared_ptr<hippy::InterruptQueue> interrupt_queue_;
+  std::shared_ptr<hippy::bridge::MessageCoalescer> message_coalescer_;
+  std::shared_ptr<HangWatchdog> hang_watchdog_;
   std::function<size_t(void*, size_t, size_t)> near_heap_limit_cb_;
+  hippy::base::Future<bool> last_script_run_ = hippy::base::MakeReadyFuture(true);
 #ifndef V8_WITHOUT_INSPECTOR
   std::shared_ptr<V8InspectorContext> inspector_context_;
 #endif
@@ -50,6 +50,7 @@ class ConvertUtils {
  public:
   using Ctx = hippy::napi::Ctx;
   using CtxValue = hippy::napi::CtxValue;
+  using LocalValue = hippy::napi::LocalValue;
 
   static bool Init();
 
@@ -63,7 +64,7 @@ class ConvertUtils {
       const std::string &module_name,
       const std::string &method_name,
       const std::vector<std::string> &method_arg_types,
-      const std::vector<std::shared_ptr<CtxValue>> &arg_values);
+      const std::vector<LocalValue> &arg_values);
 
   static std::tuple<bool, std::string, std::shared_ptr<CtxValue>> ConvertMethodResultToJSValue(
       const std::shared_ptr<Ctx>& ctx,
@@ -73,15 +74,15 @@ class ConvertUtils {
       const std::shared_ptr<Scope>& scope);
 
   static std::tuple<bool, std::string, jobject> ToJObject(const std::shared_ptr<Ctx>& ctx,
-                                                          const std::shared_ptr<CtxValue> &value);
+                                                          const LocalValue &value);
 
   static std::tuple<bool, std::string, jobject> ToHippyMap(
       const std::shared_ptr<Ctx>& ctx,
-      const std::shared_ptr<CtxValue> &value);
+      const LocalValue &value);
 
   static std::tuple<bool, std::string, jobject> ToHippyArray(
       const std::shared_ptr<Ctx>& ctx,
-      const std::shared_ptr<CtxValue> &value);
+      const LocalValue &value);
 
   static std::tuple<bool, std::string, std::shared_ptr<CtxValue>> ToJsValueInArray(
       const std::shared_ptr<Ctx>& ctx,
@@ -100,7 +101,7 @@ class ConvertUtils {
       const std::shared_ptr<Ctx>& ctx,
       const std::string &type,
       jvalue &j_args,
-      const std::shared_ptr<CtxValue> &value);
+      const LocalValue &value);
 
   static std::tuple<bool, std::string, bool> HandleObjectType(
       const std::shared_ptr<Ctx>& ctx,
@@ -108,7 +109,7 @@ class ConvertUtils {
       const std::string &method_name,
       const std::string &type,
       jvalue &j_args,
-      const std::shared_ptr<CtxValue> &value,
+      const LocalValue &value,
       std::vector<std::shared_ptr<JavaRef>> &global_refs);
 
   static std::unordered_map<std::string, MethodInfo> GetMethodMap(
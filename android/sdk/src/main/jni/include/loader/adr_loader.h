@@ -25,6 +25,7 @@
 #include <android/asset_manager.h>
 
 #include <map>
+#include <vector>
 
 #include "core/core.h"
 #include "jni/scoped_java_ref.h"
@@ -78,12 +79,17 @@ class ADRLoader : public hippy::base::UriLoader {
   using u8string = unicode_string_view::u8string;
 
   ADRLoader() = default;
-  virtual ~ADRLoader() = default;
+  virtual ~ADRLoader();
 
   virtual bool RequestUntrustedContent(const unicode_string_view& uri,
                                        std::function<void(u8string)> cb);
   virtual bool RequestUntrustedContent(const unicode_string_view& uri,
                                        u8string& str);
+  // files are mapped and assets are used from the apk or asset buffer
+  virtual bool RequestSourceBuffer(const unicode_string_view& uri,
+                                   std::function<void(std::shared_ptr<hippy::base::SourceBuffer>)> cb) override;
+  // files and assets are read in chunks while they are parsed
+  virtual std::shared_ptr<hippy::base::SourceStream> RequestSourceStream(const unicode_string_view& uri) override;
 
   inline void SetBridge(std::shared_ptr<JavaRef> bridge) { bridge_ = bridge; }
   inline void SetWorkerTaskRunner(std::weak_ptr<WorkerTaskRunner> runner) {
@@ -104,9 +110,15 @@ class ADRLoader : public hippy::base::UriLoader {
                    bool is_auto_fill = false);
   bool LoadByJni(const unicode_string_view& uri,
                  const std::function<void(u8string)>& cb);
+  bool MapFile(const unicode_string_view& path,
+               const std::function<void(std::shared_ptr<hippy::base::SourceBuffer>)>& cb);
+  bool MapAsset(const unicode_string_view& path,
+                const std::function<void(std::shared_ptr<hippy::base::SourceBuffer>)>& cb);
+  void AddPendingRead(WorkerTaskRunner::TaskHandle handle);
 
   std::shared_ptr<JavaRef> bridge_;
   std::weak_ptr<WorkerTaskRunner> runner_;
   std::unordered_map<int64_t, std::function<void(u8string)>> request_map_;
+  std::vector<WorkerTaskRunner::TaskHandle> pending_reads_;
   std::mutex mutex_;
 };
@@ -52,13 +52,32 @@ jboolean GetHeapSpaceStatistics(JNIEnv *j_env,
                                 jlong j_runtime_id,
                                 jobject j_callback);
 // [Heap] WriteHeapSnapshot
-// Creating a heap snapshot requires memory about twice the size of the heap at the time the snapshot is created.
-// This results in the risk of OOM killers terminating the process.
+// The snapshot is streamed to the file in fixed size chunks, but v8 still builds a graph of the
+// whole heap first, which may take as much memory again as the heap.
+// This results in the risk of OOM killers terminating the process, prefer the sampling heap profiler.
 jboolean WriteHeapSnapshot(JNIEnv *j_env,
                            jobject j_object,
                            jlong j_runtime_id,
                            jstring j_heap_snapshot_path,
                            jobject j_callback);
+// [Heap] StartSamplingHeapProfiler
+// Sampling allocations has little overhead, a j_sample_interval or j_stack_depth of 0 uses the default.
+jboolean StartSamplingHeapProfiler(JNIEnv *j_env,
+                                   jobject j_object,
+                                   jlong j_runtime_id,
+                                   jlong j_sample_interval,
+                                   jint j_stack_depth);
+// [Heap] WriteSamplingHeapProfile
+// Writes the live allocations sampled so far as a .heapprofile of devtools, sampling goes on.
+jboolean WriteSamplingHeapProfile(JNIEnv *j_env,
+                                  jobject j_object,
+                                  jlong j_runtime_id,
+                                  jstring j_heap_profile_path,
+                                  jobject j_callback);
+// [Heap] StopSamplingHeapProfiler
+void StopSamplingHeapProfiler(JNIEnv *j_env,
+                              jobject j_object,
+                              jlong j_runtime_id);
 
 }  // namespace bridge
 }  // namespace hippy
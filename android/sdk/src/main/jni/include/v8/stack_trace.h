@@ -24,12 +24,18 @@
 
 #include <jni.h>
 
+#include <memory>
+
+#include "core/napi/v8/v8_ctx.h"
 #include "jni/jni_register.h"
 
 namespace hippy {
 inline namespace driver {
 inline namespace v8_engine {
 
+// js thread only
+tdf::base::unicode_string_view CaptureCurrentStackTrace(const std::shared_ptr<hippy::napi::V8Ctx>& ctx);
+
 void GetCurrentStackTrace(JNIEnv *j_env,
                           jobject j_object,
                           jlong j_runtime_id,
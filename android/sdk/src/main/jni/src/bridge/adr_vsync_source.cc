@@ -0,0 +1,86 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "bridge/adr_vsync_source.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "jni/jni_env.h"
+#include "jni/jni_register.h"
+
+static std::atomic<int64_t> global_request_id{0};
+static std::mutex request_mutex;
+// requests outlive the source that made them, the callbacks only hold weak refs
+static std::unordered_map<int64_t, VsyncSource::FrameCallback> request_map;
+
+void ADRVsyncSource::RequestFrame(FrameCallback cb) {
+  std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
+  jmethodID j_method_id = instance->GetMethods().j_request_frame_method_id;
+  if (!j_method_id) {
+    TDF_BASE_DLOG(ERROR) << "jni request_frame_method_id error";
+    return;
+  }
+  JNIEnv* j_env = instance->AttachCurrentThread();
+  int64_t id = SetRequestCB(std::move(cb));
+  j_env->CallVoidMethod(bridge_->GetObj(), j_method_id, static_cast<jlong>(id));
+  if (JNIEnvironment::ClearJEnvException(j_env)) {
+    TakeRequestCB(id);
+  }
+}
+
+VsyncSource::FrameCallback ADRVsyncSource::TakeRequestCB(int64_t request_id) {
+  std::lock_guard<std::mutex> lock(request_mutex);
+  auto it = request_map.find(request_id);
+  if (it == request_map.end()) {
+    return nullptr;
+  }
+  FrameCallback cb = std::move(it->second);
+  request_map.erase(it);
+  return cb;
+}
+
+int64_t ADRVsyncSource::SetRequestCB(FrameCallback cb) {
+  std::lock_guard<std::mutex> lock(request_mutex);
+  int64_t id = global_request_id.fetch_add(1);
+  request_map.insert({id, std::move(cb)});
+  return id;
+}
+
+void OnFrame(__unused JNIEnv* j_env,
+             __unused jobject j_object,
+             jlong j_request_id,
+             jlong j_frame_time_nanos) {
+  VsyncSource::FrameCallback cb = ADRVsyncSource::TakeRequestCB(j_request_id);
+  if (!cb) {
+    TDF_BASE_DLOG(WARNING) << "HippyBridgeImpl onFrame, cb not found " << j_request_id;
+    return;
+  }
+  // Choreographer frame times are on CLOCK_MONOTONIC, as is MonotonicallyIncreasingTime
+  cb(hippy::base::checked_numeric_cast<jlong, uint64_t>(j_frame_time_nanos / 1000000));
+}
+
+REGISTER_JNI("com/tencent/mtt/hippy/bridge/HippyBridgeImpl", // NOLINT(cert-err58-cpp)
+             "onFrame",
+             "(JJ)V",
+             OnFrame)
@@ -26,13 +26,15 @@
 #include <android/asset_manager_jni.h>
 #include <sys/stat.h>
 
-#include <future>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 
 #include "bridge/adr_bridge.h"
+#include "bridge/adr_vsync_source.h"
 #include "bridge/java2js.h"
 #include "bridge/js2java.h"
 #include "bridge/runtime.h"
@@ -40,6 +42,7 @@
 #include "core/napi/v8/v8_ctx.h"
 #include "core/napi/v8/v8_ctx_value.h"
 #include "core/vm/v8/v8_vm.h"
+#include "core/vm/v8/snapshot_builder.h"
 #include "core/vm/v8/snapshot_data.h"
 #include "jni/turbo_module_manager.h"
 #include "jni/exception_handler.h"
@@ -58,9 +61,10 @@ using Ctx = hippy::napi::Ctx;
 using V8Ctx = hippy::napi::V8Ctx;
 using StringViewUtils = hippy::base::StringViewUtils;
 using HippyFile = hippy::base::HippyFile;
+using SourceBuffer = hippy::base::SourceBuffer;
 using VM = hippy::vm::VM;
 using V8VM = hippy::vm::V8VM;
-using V8SnapshotVM = hippy::vm::V8SnapshotVM;
+using SnapshotBuilder = hippy::vm::SnapshotBuilder;
 using V8VMInitParam = hippy::vm::V8VMInitParam;
 #ifndef V8_WITHOUT_INSPECTOR
 using V8InspectorClientImpl = hippy::inspector::V8InspectorClientImpl;
@@ -70,11 +74,6 @@ constexpr char kLogTag[] = "native";
 constexpr char kGlobalKey[] = "global";
 constexpr char kNativeGlobalKey[] = "__HIPPYNATIVEGLOBAL__";
 constexpr char kCallNativesKey[] = "hippyCallNatives";
-constexpr char kCurDir[] = "__HIPPYCURDIR__";
-constexpr char kCodeCacheFailCountFilePostfix[] = "_fail_count";
-const uint8_t kCodeCacheMaxFailCount = 3;
-
-std::vector<intptr_t> external_references{};
 
 void HandleUncaughtJsError(v8::Local<v8::Message> message,
                            v8::Local<v8::Value> data) {
@@ -123,11 +122,41 @@ REGISTER_STATIC_JNI("com/tencent/mtt/hippy/HippyEngine", // NOLINT(cert-err58-cp
                     "(Lcom/tencent/mtt/hippy/adapter/HippyLogAdapter;)V",
                     setNativeLogHandler)
 
+REGISTER_STATIC_JNI("com/tencent/mtt/hippy/HippyEngine", // NOLINT(cert-err58-cpp)
+                    "enableEnginePool",
+                    "(ILcom/tencent/mtt/hippy/HippyEngine$V8InitParams;)V",
+                    EnableEnginePool)
+
+REGISTER_STATIC_JNI("com/tencent/mtt/hippy/HippyEngine", // NOLINT(cert-err58-cpp)
+                    "trimEnginePool",
+                    "()V",
+                    TrimEnginePool)
+
+REGISTER_STATIC_JNI("com/tencent/mtt/hippy/HippyEngine", // NOLINT(cert-err58-cpp)
+                    "setThreadingConfig",
+                    "(IJJIJJ)V",
+                    SetThreadingConfig)
+
+REGISTER_STATIC_JNI("com/tencent/mtt/hippy/HippyEngine", // NOLINT(cert-err58-cpp)
+                    "enableSharedThreads",
+                    "(I)V",
+                    EnableSharedThreads)
+
+REGISTER_STATIC_JNI("com/tencent/mtt/hippy/HippyEngine", // NOLINT(cert-err58-cpp)
+                    "getSharedThreadMetrics",
+                    "()[J",
+                    GetSharedThreadMetrics)
+
 REGISTER_STATIC_JNI("com/tencent/mtt/hippy/bridge/HippyBridgeImpl", // NOLINT(cert-err58-cpp)
                     "createSnapshot",
                     "([Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)I",
                     CreateSnapshot)
 
+REGISTER_STATIC_JNI("com/tencent/mtt/hippy/bridge/HippyBridgeImpl", // NOLINT(cert-err58-cpp)
+                    "setRuntimeBackground",
+                    "(JZ)V",
+                    SetRuntimeBackground)
+
 REGISTER_JNI("com/tencent/mtt/hippy/bridge/HippyBridgeImpl", // NOLINT(cert-err58-cpp)
              "initJSFramework",
              "([BZZZLcom/tencent/mtt/hippy/bridge/NativeCallback;"
@@ -159,15 +188,20 @@ REGISTER_JNI("com/tencent/mtt/hippy/bridge/HippyBridgeImpl", // NOLINT(cert-err5
 static std::unordered_map<int64_t, std::pair<std::shared_ptr<Engine>, uint32_t>>
     reuse_engine_map;
 static std::mutex engine_mutex;
+// pre-created engines for the default group, the pointer is guarded by
+// engine_mutex, the pool is thread safe and fills itself on its own thread
+static std::shared_ptr<EnginePool> engine_pool;
 static std::mutex log_mutex;
-static std::mutex code_cache_file_mutex;
 static bool is_inited = false;
 
 constexpr int64_t kDefaultEngineId = -1;
 constexpr int64_t kDebuggerEngineId = -9999;
 constexpr uint32_t kRuntimeSlotIndex = 0;
+constexpr uint64_t kEnginePoolMinAvailableMemory = 256 * hippy::base::MB;
 // -1 means single isolate multi-context mode
 constexpr int32_t kReuseRuntimeId = -1;
+// bundles fetched through java, e.g. from a debug server, may never answer
+constexpr uint64_t kScriptLoadTimeoutInMs = 60 * 1000;
 
 enum INIT_CB_STATE {
   SNAPSHOT_INVALID = -2,
@@ -236,247 +270,138 @@ void RunScript(JNIEnv* j_env, __unused jobject, jlong j_runtime_id, jstring j_sc
   auto runner = runtime->GetEngine()->GetJSRunner();
   std::shared_ptr<JavaScriptTask> task = std::make_shared<JavaScriptTask>();
   task->callback = [runtime, script{std::move(script)}] () mutable {
-    auto context = std::static_pointer_cast<hippy::napi::V8Ctx>(runtime->GetScope()->GetContext());
-    auto ret = context->RunScript(script, "");
+    runtime->RunAfterLastScript(JavaScriptTaskRunner::Priority::kNormal, [runtime, script] {
+      auto context = std::static_pointer_cast<hippy::napi::V8Ctx>(runtime->GetScope()->GetContext());
+      auto ret = context->RunScript(script, "");
+    });
   };
   runner->PostTask(task);
 }
 
-// Code cache file corruption prevention strategy:
-// Record count before RunScript, clean count after RunScript, and if only start recording three times in a row, clean the code cache file.
-bool CheckUseCodeCacheBeforeRunScript(const unicode_string_view& code_cache_path) {
-  unicode_string_view fail_count_path = code_cache_path + unicode_string_view(kCodeCacheFailCountFilePostfix);
-  u8string content;
-  HippyFile::ReadFile(fail_count_path, content, false);
-  if (content.length() == 1) {
-    uint8_t count = content[0];
-    if (count >= kCodeCacheMaxFailCount) {
-      TDF_BASE_DLOG(INFO) << "Check code cache, count >= 3";
-      // need to remove code cache file
-      return false;
-    } else {
-      TDF_BASE_DLOG(INFO) << "Check code cache, count = " << static_cast<int>(count);
-      ++count;
-      content[0] = count;
-      HippyFile::SaveFile(fail_count_path, content);
-    }
-  } else {
-    TDF_BASE_DLOG(INFO) << "Check code cache, no count";
-    content.clear();
-    content.push_back(1);
-    HippyFile::SaveFile(fail_count_path, content);
+// Caches of all scripts an engine runs go through one manager per cache dir,
+// keyed by their content. Called on the js thread.
+static void SetupCodeCacheManager(const std::shared_ptr<Runtime>& runtime,
+                                  const unicode_string_view& code_cache_dir) {
+  auto engine = runtime->GetEngine();
+  std::string cache_dir = StringViewUtils::ToU8StdStr(code_cache_dir);
+  if (cache_dir.empty()) {
+    return;
+  }
+  if (cache_dir.back() != '/') {
+    cache_dir.push_back('/');
   }
-  return true;
+  std::shared_ptr<CodeCacheManager> manager = engine->GetCodeCacheManager();
+  if (!manager || manager->GetCacheDir() != cache_dir) {
+    manager = std::make_shared<CodeCacheManager>(code_cache_dir,
+                                                 v8::ScriptCompiler::CachedDataVersionTag(),
+                                                 engine->GetWorkerTaskRunner());
+    manager->RemoveStale();
+    engine->SetCodeCacheManager(manager);
+  }
+  std::static_pointer_cast<V8Ctx>(runtime->GetScope()->GetContext())->SetCodeCacheManager(manager);
 }
 
-void CheckUseCodeCacheAfterRunScript(const unicode_string_view& code_cache_path) {
-  unicode_string_view fail_count_path = code_cache_path + unicode_string_view(kCodeCacheFailCountFilePostfix);
-  HippyFile::RmFile(fail_count_path);
-}
+using RunScriptCallback = std::function<void(bool,
+                                             std::chrono::time_point<std::chrono::system_clock>,
+                                             std::chrono::time_point<std::chrono::system_clock>)>;
 
-bool RunScriptInternal(const std::shared_ptr<Runtime>& runtime,
+// Called on the js thread. The script is read on another thread while the js
+// runner keeps running other tasks; scripts of a runtime still run in the order
+// they were requested. cb runs on the js thread with the result and the load
+// start and end time.
+void RunScriptInternal(const std::shared_ptr<Runtime>& runtime,
                        const unicode_string_view& file_name,
                        bool is_use_code_cache,
                        const unicode_string_view& code_cache_dir,
                        const unicode_string_view& uri,
                        AAssetManager* asset_manager,
-                       std::chrono::time_point<std::chrono::system_clock> &load_start,
-                       std::chrono::time_point<std::chrono::system_clock> &load_end) {
+                       RunScriptCallback cb) {
   TDF_BASE_LOG(INFO) << "RunScriptInternal begin, file_name = " << file_name
                      << ", is_use_code_cache = " << is_use_code_cache
                      << ", code_cache_dir = " << code_cache_dir
                      << ", uri = " << uri
                      << ", asset_manager = " << asset_manager;
-  unicode_string_view script_content;
-  bool read_script_flag;
-  unicode_string_view code_cache_content;
-  uint64_t modify_time = 0;
-
-  load_start = std::chrono::system_clock::now();
+  auto load_start = std::chrono::system_clock::now();
   auto engine = runtime->GetEngine();
-  auto task_runner = engine->GetWorkerTaskRunner();
-  unicode_string_view code_cache_path;
   if (is_use_code_cache) {
-    if (!asset_manager) {
-      modify_time = HippyFile::GetFileModifytime(uri);
-    }
-
-    code_cache_path = code_cache_dir + file_name + unicode_string_view("_") +
-                      unicode_string_view(std::to_string(modify_time));
-
-    std::promise<u8string> read_file_promise;
-    auto read_file_future = read_file_promise.get_future();
-    auto task = std::make_unique<CommonTask>();
-    task->func_ = hippy::base::MakeCopyable([p = std::move(read_file_promise),
-                                             code_cache_path, code_cache_dir]() mutable {
-      std::lock_guard<std::mutex> lock(code_cache_file_mutex);
-      u8string content;
-      HippyFile::ReadFile(code_cache_path, content, true);
-      if (content.empty()) {
-        TDF_BASE_DLOG(INFO) << "Read code cache failed";
-        int ret = HippyFile::RmFullPath(code_cache_dir);
-        TDF_BASE_DLOG(INFO) << "RmFullPath ret = " << ret;
-        HIPPY_USE(ret);
-      } else {
-        TDF_BASE_DLOG(INFO) << "Read code cache succ";
-        if (!CheckUseCodeCacheBeforeRunScript(code_cache_path)) {
-          int ret = HippyFile::RmFullPath(code_cache_dir);
-          TDF_BASE_DLOG(INFO) << "RmFullPath on check, ret = " << ret;
-          HIPPY_USE(ret);
-          content.clear();
-        }
-      }
-      p.set_value(std::move(content));
-    });
-    task_runner->PostPromiseTask(std::move(task));
-    u8string content;
-    read_script_flag = runtime->GetScope()->GetUriLoader()->RequestUntrustedContent(uri, content);
-    if (read_script_flag) {
-      script_content = unicode_string_view(std::move(content));
-    }
-    code_cache_content = read_file_future.get();
-  } else {
-    u8string content;
-    read_script_flag = runtime->GetScope()->GetUriLoader()->RequestUntrustedContent(uri, content);
-    if (read_script_flag) {
-      script_content = unicode_string_view(std::move(content));
-    }
+    SetupCodeCacheManager(runtime, code_cache_dir);
   }
-  load_end = std::chrono::system_clock::now();
-
-  TDF_BASE_DLOG(INFO) << "uri = " << uri
-                      << "read_script_flag = " << read_script_flag
-                      << ", script content = " << script_content;
-
-  if (!read_script_flag || StringViewUtils::IsEmpty(script_content)) {
-    TDF_BASE_LOG(WARNING) << "read_script_flag = " << read_script_flag
-                          << ", script content empty, uri = " << uri;
-    if (is_use_code_cache) {
-      std::lock_guard<std::mutex> lock(code_cache_file_mutex);
-      CheckUseCodeCacheAfterRunScript(code_cache_path);
-    }
-    return false;
+  // file and asset scripts stay in their mapping, v8 reads them as external strings;
+  // a read the loader drops, e.g. when it is destroyed, resolves to nullptr
+  hippy::base::Promise<std::shared_ptr<SourceBuffer>> script_promise;
+  bool read_script_flag = runtime->GetScope()->GetUriLoader()->RequestSourceBuffer(
+      uri, hippy::base::MakeResolver<std::shared_ptr<SourceBuffer>>(script_promise, nullptr));
+  if (!read_script_flag) {
+    // not every failure path of the loader calls back
+    script_promise.SetValue(nullptr);
   }
-
-  auto ret = std::static_pointer_cast<hippy::napi::V8Ctx>(
-      runtime->GetScope()->GetContext())->RunScript(
-          script_content, file_name, is_use_code_cache,&code_cache_content, true);
-  if (is_use_code_cache) {
-    if (!StringViewUtils::IsEmpty(code_cache_content)) {
-      std::unique_ptr<CommonTask> task = std::make_unique<CommonTask>();
-      task->func_ = [code_cache_path, code_cache_dir, code_cache_content] {
-        std::lock_guard<std::mutex> lock(code_cache_file_mutex);
-        int check_dir_ret = HippyFile::CheckDir(code_cache_dir, F_OK);
-        TDF_BASE_DLOG(INFO) << "check_parent_dir_ret = " << check_dir_ret;
-        if (check_dir_ret) {
-          HippyFile::CreateDir(code_cache_dir, S_IRWXU);
-        }
-
-        size_t pos = StringViewUtils::FindLastOf(code_cache_path, EXTEND_LITERAL('/'));
-        unicode_string_view code_cache_parent_dir = StringViewUtils::SubStr(code_cache_path, 0, pos);
-        int check_parent_dir_ret =
-            HippyFile::CheckDir(code_cache_parent_dir, F_OK);
-        TDF_BASE_DLOG(INFO)
-            << "check_parent_dir_ret = " << check_parent_dir_ret;
-        if (check_parent_dir_ret) {
-          HippyFile::CreateDir(code_cache_parent_dir, S_IRWXU);
-        }
-
-        std::string u8_code_cache_content =
-            StringViewUtils::ToU8StdStr(code_cache_content);
-        bool save_file_ret = HippyFile::SaveFile(code_cache_path, u8_code_cache_content);
-        TDF_BASE_LOG(INFO) << "code cache save_file_ret = " << save_file_ret;
-        HIPPY_USE(save_file_ret);
-
-        CheckUseCodeCacheAfterRunScript(code_cache_path);
-      };
-      task_runner->PostTask(std::move(task));
+  auto runner = engine->GetJSRunner();
+  std::shared_ptr<hippy::base::InlineTask> timeout_task = hippy::base::InlineTask::Create([script_promise, uri] {
+    if (script_promise.SetValue(nullptr)) {
+      TDF_BASE_LOG(WARNING) << "script load timeout, uri = " << uri;
     }
+  });
+  runner->PostDelayedTask(timeout_task, kScriptLoadTimeoutInMs);
+
+  // the bundle is hashed and its code cache read on the worker, not on the js
+  // thread where the script then runs
+  std::shared_ptr<CodeCacheManager> manager = engine->GetCodeCacheManager();
+  hippy::base::Executor lookup_executor;
+  if (manager) {
+    lookup_executor = engine->GetWorkerTaskRunner()->Schedule();
   }
+  auto script_future = script_promise.GetFuture().Then(
+      lookup_executor, [manager](std::shared_ptr<SourceBuffer> source) {
+    CodeCacheManager::Entry cache_entry;
+    if (manager && source) {
+      cache_entry = manager->Lookup(source->data(), source->size());
+    }
+    return std::make_tuple(std::move(source), std::move(cache_entry));
+  });
+
+  hippy::base::Promise<bool> script_run;
+  auto previous_script_run = runtime->SwapLastScriptRun(script_run.GetFuture());
+  hippy::base::WhenAll(previous_script_run, std::move(script_future)).Then(
+      runner->Schedule(),
+      [runtime, file_name, uri, load_start, cb, timeout_task, script_run](
+          std::tuple<bool, std::tuple<std::shared_ptr<SourceBuffer>, CodeCacheManager::Entry>> result) {
+    auto load_end = std::chrono::system_clock::now();
+    runtime->GetEngine()->GetJSRunner()->CancelTask(timeout_task);
+    std::shared_ptr<SourceBuffer> source = std::move(std::get<0>(std::get<1>(result)));
+    if (!source) {
+      TDF_BASE_LOG(WARNING) << "script content empty, uri = " << uri;
+      cb(false, load_start, load_end);
+      script_run.SetValue(false);
+      return;
+    }
 
-  bool flag = (ret != nullptr);
-  TDF_BASE_LOG(INFO) << "runScript end, flag = " << flag;
-  return flag;
+    // the code cache, if any, is produced by the context's manager
+    auto ret = std::static_pointer_cast<V8Ctx>(runtime->GetScope()->GetContext())->RunScript(
+        source, file_name, std::get<1>(std::get<1>(result)));
+    bool flag = (ret != nullptr);
+    TDF_BASE_LOG(INFO) << "runScript end, flag = " << flag;
+    cb(flag, load_start, load_end);
+    script_run.SetValue(flag);
+  });
 }
 
-enum class CreateSnapshotResult {
-  kSuccess, kFailed, kRunScriptError, kSnapshotBlobInvalid, kSaveSnapshotFailed
-};
-
 jint CreateSnapshot(JNIEnv* j_env,
                     __unused jobject j_obj,
                     jobjectArray j_script_array,
                     jstring j_base_path,
                     jstring j_snapshot_uri,
                     jstring j_config) {
-  auto time_begin = std::chrono::time_point_cast<std::chrono::microseconds>(
-      std::chrono::system_clock::now())
-      .time_since_epoch()
-      .count();
-  auto vm = std::make_shared<V8SnapshotVM>();
-  auto engine = std::make_shared<Engine>();
-  engine->SyncInit(vm);
-
   auto base_path = JniUtils::ToStrView(j_env, j_base_path);
   auto global_config = JniUtils::ToStrView(j_env, j_config);
-  TDF_BASE_LOG(INFO) << "CreateSnapshot global_config = " << global_config;
-  auto context_cb = [global_config, base_path](void* wrapper) {
-    TDF_BASE_CHECK(wrapper);
-    auto* scope_wrapper = reinterpret_cast<ScopeWrapper*>(wrapper);
-    TDF_BASE_CHECK(scope_wrapper);
-    auto scope = scope_wrapper->scope.lock();
-    TDF_BASE_CHECK(scope);
-    auto ctx = scope->GetContext();
-    auto global_object = ctx->GetGlobalObject();
-    auto user_global_object_key = ctx->CreateString(kGlobalKey);
-    ctx->SetProperty(global_object, user_global_object_key, global_object);
-    auto native_global_key = ctx->CreateString(kNativeGlobalKey);
-    auto global_config_object = V8VM::ParseJson(ctx, global_config);
-    ctx->SetProperty(global_object, native_global_key, global_config_object);
-    auto key = ctx->CreateString(kCurDir);
-    auto value = ctx->CreateString(base_path);
-    ctx->SetProperty(global_object, key, value);
-  };
-  std::unique_ptr<RegisterMap> scope_cb_map = std::make_unique<RegisterMap>();
-  scope_cb_map->insert({hippy::base::kContextCreatedCBKey, context_cb});
-  auto scope = engine->SyncCreateScope(std::move(scope_cb_map));
-  auto v8_ctx = std::static_pointer_cast<hippy::napi::V8Ctx>(scope->GetContext());
+  auto snapshot_uri = JniUtils::ToStrView(j_env, j_snapshot_uri);
+  std::vector<unicode_string_view> scripts;
   auto cnt = j_env->GetArrayLength(j_script_array);
   for (auto i = 0; i < cnt; ++i) {
     auto j_script = reinterpret_cast<jstring>(j_env->GetObjectArrayElement(j_script_array, i));
-    auto script = JniUtils::ToStrView(j_env, j_script);
-    hippy::napi::V8TryCatch try_catch(true, v8_ctx);
-    auto result = v8_ctx->RunScript(script, "");
-    if (try_catch.HasCaught()) {
-      TDF_BASE_LOG(ERROR) << "RunScript error, error = " << try_catch.GetExceptionMsg();
-      return static_cast<jint>(CreateSnapshotResult::kRunScriptError);
-    }
-  }
-  auto creator = vm->snapshot_creator_;
-  v8_ctx->SetDefaultContext(creator);
-  TDF_BASE_LOG(INFO) << "CreateBlob";
-  v8_ctx = nullptr;
-  scope = nullptr;
-  auto blob = creator->CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
-#if (V8_MAJOR_VERSION >= 9)
-  if (!blob.IsValid()) {
-    return static_cast<jint>(CreateSnapshotResult::kSnapshotBlobInvalid);
+    scripts.push_back(JniUtils::ToStrView(j_env, j_script));
   }
-#endif
-  SnapshotData snapshot_data;
-  snapshot_data.WriteMetaData(blob);
-  auto time_end = std::chrono::time_point_cast<std::chrono::microseconds>(
-      std::chrono::system_clock::now())
-      .time_since_epoch()
-      .count();
-  TDF_BASE_LOG(INFO) << "blob size = " << blob.raw_size << ", buffer size = " << snapshot_data.buffer_holder.size()
-    << ", cost = " << (time_end - time_begin);
-  auto snapshot_uri = JniUtils::ToStrView(j_env, j_snapshot_uri);
-  bool save_file_ret = HippyFile::SaveFile(snapshot_uri, snapshot_data.buffer_holder);
-  if (!save_file_ret) {
-    return static_cast<jint>(CreateSnapshotResult::kSaveSnapshotFailed);
-  }
-  return static_cast<jint>(CreateSnapshotResult::kSuccess);
+  auto result = SnapshotBuilder::BuildToFile(scripts, base_path, global_config, snapshot_uri);
+  return static_cast<jint>(result);
 }
 
 jboolean RunScriptFromUri(JNIEnv* j_env,
@@ -519,7 +444,7 @@ jboolean RunScriptFromUri(JNIEnv* j_env,
   std::shared_ptr<Ctx> ctx = runtime->GetScope()->GetContext();
   std::shared_ptr<JavaScriptTask> task = std::make_shared<JavaScriptTask>();
   task->callback = [ctx, base_path] {
-    auto key = ctx->CreateString(kCurDir);
+    auto key = ctx->GetPropertyKey(hippy::napi::PropertyKeyId::kCurDir);
     auto value = ctx->CreateString(base_path);
     auto global = ctx->GetGlobalObject();
     ctx->SetProperty(global, key, value);
@@ -537,36 +462,37 @@ jboolean RunScriptFromUri(JNIEnv* j_env,
                     j_can_use_code_cache, code_cache_dir, uri, aasset_manager,
                     time_begin] {
     TDF_BASE_DLOG(INFO) << "runScriptFromUri enter";
-    std::chrono::time_point<std::chrono::system_clock> load_start;
-    std::chrono::time_point<std::chrono::system_clock> load_end;
-    bool flag = RunScriptInternal(runtime, script_name, j_can_use_code_cache,
-                                  code_cache_dir, uri, aasset_manager, load_start, load_end);
-    auto time_end = std::chrono::time_point_cast<std::chrono::microseconds>(
-                        std::chrono::system_clock::now())
-                        .time_since_epoch()
-                        .count();
-
-    TDF_BASE_DLOG(INFO) << "runScriptFromUri = " << (time_end - time_begin) << ", uri = " << uri;
-
-    JNIEnv* j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
-    auto load_start_millis = std::chrono::time_point_cast<std::chrono::milliseconds>(load_start)
-        .time_since_epoch()
-        .count();
-    auto load_end_millis = std::chrono::time_point_cast<std::chrono::milliseconds>(load_end)
-        .time_since_epoch()
-        .count();
-    std::string payload = "{\"load_start_millis\":" + std::to_string(load_start_millis)
-            + ", \"load_end_millis\": "+ std::to_string(load_end_millis) + "}";
-    jstring j_payload = JniUtils::StrViewToJString(j_env, unicode_string_view(payload));
-    if (flag) {
-      hippy::bridge::CallJavaMethod(save_object_->GetObj(), INIT_CB_STATE::SUCCESS, nullptr, j_payload);
-    } else {
-      jstring j_msg = JniUtils::StrViewToJString(j_env, u"run script error");
-      hippy::bridge::CallJavaMethod(save_object_->GetObj(), INIT_CB_STATE::RUN_SCRIPT_ERROR, j_msg, j_payload);
-      j_env->DeleteLocalRef(j_msg);
-    }
-    j_env->DeleteLocalRef(j_payload);
-    return flag;
+    RunScriptInternal(runtime, script_name, j_can_use_code_cache, code_cache_dir, uri, aasset_manager,
+                      [save_object_, uri, time_begin](
+                          bool flag,
+                          std::chrono::time_point<std::chrono::system_clock> load_start,
+                          std::chrono::time_point<std::chrono::system_clock> load_end) {
+      auto time_end = std::chrono::time_point_cast<std::chrono::microseconds>(
+                          std::chrono::system_clock::now())
+                          .time_since_epoch()
+                          .count();
+
+      TDF_BASE_DLOG(INFO) << "runScriptFromUri = " << (time_end - time_begin) << ", uri = " << uri;
+
+      JNIEnv* j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
+      auto load_start_millis = std::chrono::time_point_cast<std::chrono::milliseconds>(load_start)
+          .time_since_epoch()
+          .count();
+      auto load_end_millis = std::chrono::time_point_cast<std::chrono::milliseconds>(load_end)
+          .time_since_epoch()
+          .count();
+      std::string payload = "{\"load_start_millis\":" + std::to_string(load_start_millis)
+              + ", \"load_end_millis\": "+ std::to_string(load_end_millis) + "}";
+      jstring j_payload = JniUtils::StrViewToJString(j_env, unicode_string_view(payload));
+      if (flag) {
+        hippy::bridge::CallJavaMethod(save_object_->GetObj(), INIT_CB_STATE::SUCCESS, nullptr, j_payload);
+      } else {
+        jstring j_msg = JniUtils::StrViewToJString(j_env, u"run script error");
+        hippy::bridge::CallJavaMethod(save_object_->GetObj(), INIT_CB_STATE::RUN_SCRIPT_ERROR, j_msg, j_payload);
+        j_env->DeleteLocalRef(j_msg);
+      }
+      j_env->DeleteLocalRef(j_payload);
+    });
   };
 
   runner->PostTask(task);
@@ -574,6 +500,19 @@ jboolean RunScriptFromUri(JNIEnv* j_env,
   return JNI_TRUE;
 }
 
+// pooled engines only serve instances whose vm would be created the same way
+bool IsSameVMInitParam(const std::shared_ptr<V8VMInitParam>& param,
+                       const std::shared_ptr<hippy::vm::VMInitParam>& pool_param) {
+  auto pool_v8_param = std::static_pointer_cast<V8VMInitParam>(pool_param);
+  if (!param || !pool_v8_param) {
+    return !param && !pool_v8_param;
+  }
+  return param->type == V8VMInitParam::V8VMSnapshotType::kNoSnapshot
+      && pool_v8_param->type == V8VMInitParam::V8VMSnapshotType::kNoSnapshot
+      && param->initial_heap_size_in_bytes == pool_v8_param->initial_heap_size_in_bytes
+      && param->maximum_heap_size_in_bytes == pool_v8_param->maximum_heap_size_in_bytes;
+}
+
 jlong InitInstance(JNIEnv* j_env,
                    jobject j_object,
                    jbyteArray j_global_config,
@@ -626,12 +565,9 @@ jlong InitInstance(JNIEnv* j_env,
             is_valid = false;
             break;
           }
+          // mapped read only and shared with other engines on the same file
           auto path = uri_obj->GetPath();
-          is_valid = HippyFile::ReadFile(uri, param->snapshot_data.buffer_holder, false);
-          if (!is_valid) {
-            break;
-          }
-          is_valid = param->snapshot_data.ReadMetadata();
+          is_valid = param->snapshot_data.MapFile(path);
         } else {
           auto j_blob_field = j_env->GetFieldID(cls, "blob", "Ljava/nio/ByteBuffer;");
           auto j_buffer = j_env->GetObjectField(j_vm_init_param, j_blob_field);
@@ -735,6 +671,7 @@ jlong InitInstance(JNIEnv* j_env,
     loader->SetBridge(bridge->GetRef());
     loader->SetWorkerTaskRunner(runtime->GetEngine()->GetWorkerTaskRunner());
     scope->SetUriLoader(loader);
+    scope->SetVsyncSource(std::make_shared<ADRVsyncSource>(bridge->GetRef()));
   };
 
   RegisterFunction scope_cb = [save_object_ = std::move(save_object)](void*) {
@@ -761,6 +698,8 @@ jlong InitInstance(JNIEnv* j_env,
       engine = std::make_shared<Engine>();
       reuse_engine_map[group] = std::make_pair(engine, 1);
       runtime->SetEngine(engine);
+      // the inspector holds the js thread while paused
+      engine->SetSharedThreadsAllowed(false);
       engine->AsyncInit(param, std::move(engine_cb_map));
     }
   } else if (group != kDefaultEngineId) {
@@ -781,10 +720,22 @@ jlong InitInstance(JNIEnv* j_env,
       engine->AsyncInit(param, std::move(engine_cb_map));
     }
   } else {  // kDefaultEngineId
-    TDF_BASE_DLOG(INFO) << "default create engine";
-    engine = std::make_shared<Engine>();
-    runtime->SetEngine(engine);
-    engine->AsyncInit(param, std::move(engine_cb_map));
+    {
+      std::lock_guard<std::mutex> lock(engine_mutex);
+      if (engine_pool && IsSameVMInitParam(param, engine_pool->GetInitParam())) {
+        engine = engine_pool->Take();
+      }
+    }
+    if (engine) {
+      TDF_BASE_DLOG(INFO) << "default engine from pool";
+      runtime->SetEngine(engine);
+      EnginePool::RunVMCreatedCallback(engine, vm_cb);
+    } else {
+      TDF_BASE_DLOG(INFO) << "default create engine";
+      engine = std::make_shared<Engine>();
+      runtime->SetEngine(engine);
+      engine->AsyncInit(param, std::move(engine_cb_map));
+    }
   }
   std::unordered_map<std::string, std::string> init_param = {
       { hippy::base::kUseSnapshot,  use_snapshot ? "1" : "0" }
@@ -879,18 +830,136 @@ void RunInJsThread(JNIEnv *j_env,
   auto task_runner = runtime->GetEngine()->GetJSRunner();
   TDF_BASE_CHECK(task_runner);
   auto task = std::make_unique<JavaScriptTask>();
-  task->callback = [cb]() {
-    auto j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
-    auto j_callback = cb->GetObj();
-    auto j_cb_class = j_env->GetObjectClass(j_callback);
-    auto j_cb_method_id = j_env->GetMethodID(j_cb_class, "callback",
-                                             "(Ljava/lang/Object;Ljava/lang/Throwable;)V");
-    j_env->CallVoidMethod(j_callback, j_cb_method_id, nullptr, nullptr);
-    JNIEnvironment::ClearJEnvException(j_env);
+  task->callback = [runtime, cb]() {
+    runtime->RunAfterLastScript(JavaScriptTaskRunner::Priority::kNormal, [cb] {
+      auto j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
+      auto j_callback = cb->GetObj();
+      auto j_cb_class = j_env->GetObjectClass(j_callback);
+      auto j_cb_method_id = j_env->GetMethodID(j_cb_class, "callback",
+                                               "(Ljava/lang/Object;Ljava/lang/Throwable;)V");
+      j_env->CallVoidMethod(j_callback, j_cb_method_id, nullptr, nullptr);
+      JNIEnvironment::ClearJEnvException(j_env);
+    });
   };
   task_runner->PostTask(std::move(task));
 }
 
+void SetRuntimeBackground(JNIEnv* j_env,
+                          __unused jobject j_obj,
+                          jlong j_runtime_id,
+                          jboolean j_background) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "SetRuntimeBackground, j_runtime_id invalid";
+    return;
+  }
+  runtime->SetBackground(j_background);
+  auto engine = runtime->GetEngine();
+  if (!engine) {
+    return;
+  }
+  // an engine shared by a group keeps the foreground slack while any of its
+  // runtimes is visible
+  bool is_background = Runtime::IsEngineInBackground(engine);
+  engine->GetJSRunner()->SetBackground(is_background);
+  auto stats = engine->GetJSRunner()->GetTimerStats();
+  TDF_BASE_DLOG(INFO) << "SetRuntimeBackground, is_background = " << is_background
+                      << ", timer wake ups saved = " << stats.saved_wake_up_count
+                      << ", coalesced timers = " << stats.coalesced_task_count;
+}
+
+void EnableEnginePool(JNIEnv* j_env,
+                      __unused jobject j_obj,
+                      jint j_size,
+                      jobject j_vm_init_param) {
+  std::shared_ptr<V8VMInitParam> param;
+  if (j_vm_init_param) {
+    jclass cls = j_env->GetObjectClass(j_vm_init_param);
+    auto j_type = j_env->GetIntField(j_vm_init_param, j_env->GetFieldID(cls, "type", "I"));
+    if (static_cast<V8VMInitParam::V8VMSnapshotType>(j_type) != V8VMInitParam::V8VMSnapshotType::kNoSnapshot) {
+      TDF_BASE_LOG(WARNING) << "EnableEnginePool, engines with snapshot are not pooled";
+      return;
+    }
+    auto initial_heap_size_in_bytes = j_env->GetLongField(j_vm_init_param,
+                                                          j_env->GetFieldID(cls, "initialHeapSize", "J"));
+    auto maximum_heap_size_in_bytes = j_env->GetLongField(j_vm_init_param,
+                                                          j_env->GetFieldID(cls, "maximumHeapSize", "J"));
+    param = std::make_shared<V8VMInitParam>();
+    param->initial_heap_size_in_bytes =
+        hippy::base::checked_numeric_cast<jlong, size_t>(initial_heap_size_in_bytes);
+    param->maximum_heap_size_in_bytes =
+        hippy::base::checked_numeric_cast<jlong, size_t>(maximum_heap_size_in_bytes);
+    param->type = V8VMInitParam::V8VMSnapshotType::kNoSnapshot;
+  }
+  EnginePool::Config config;
+  config.size = hippy::base::checked_numeric_cast<jint, uint32_t>(j_size);
+  config.min_available_memory = kEnginePoolMinAvailableMemory;
+  config.param = param;
+  TDF_BASE_LOG(INFO) << "EnableEnginePool, size = " << config.size;
+  auto pool = std::make_shared<EnginePool>(config);
+  std::shared_ptr<EnginePool> old_pool;
+  {
+    std::lock_guard<std::mutex> lock(engine_mutex);
+    old_pool = std::move(engine_pool);
+    engine_pool = pool;
+  }
+  // stopping and starting engines must not hold up InitInstance on engine_mutex
+  if (old_pool) {
+    old_pool->Trim();
+  }
+  pool->Fill();
+}
+
+void TrimEnginePool(__unused JNIEnv* j_env, __unused jobject j_obj) {
+  std::shared_ptr<EnginePool> pool;
+  {
+    std::lock_guard<std::mutex> lock(engine_mutex);
+    pool = engine_pool;
+  }
+  if (pool) {
+    TDF_BASE_LOG(INFO) << "TrimEnginePool, idle count = " << pool->IdleCount();
+    pool->Trim();
+  }
+}
+
+void SetThreadingConfig(__unused JNIEnv* j_env,
+                        __unused jobject j_obj,
+                        jint j_js_priority,
+                        jlong j_js_affinity_mask,
+                        jlong j_js_stack_size,
+                        jint j_worker_priority,
+                        jlong j_worker_affinity_mask,
+                        jlong j_worker_stack_size) {
+  TDF_BASE_LOG(INFO) << "SetThreadingConfig, js priority = " << j_js_priority
+                     << ", worker priority = " << j_worker_priority;
+  Engine::ThreadingConfig config;
+  // the mask is a bit set, a java long holds it as is
+  config.js_thread.set_priority(j_js_priority)
+      .set_affinity_mask(static_cast<uint64_t>(j_js_affinity_mask))
+      .set_stack_size(hippy::base::checked_numeric_cast<jlong, size_t>(j_js_stack_size));
+  config.worker_thread.set_priority(j_worker_priority)
+      .set_affinity_mask(static_cast<uint64_t>(j_worker_affinity_mask))
+      .set_stack_size(hippy::base::checked_numeric_cast<jlong, size_t>(j_worker_stack_size));
+  Engine::SetThreadingConfig(config);
+}
+
+void EnableSharedThreads(__unused JNIEnv* j_env, __unused jobject j_obj, jint j_max_thread_count) {
+  TDF_BASE_LOG(INFO) << "EnableSharedThreads, max_thread_count = " << j_max_thread_count;
+  Engine::EnableSharedThreads(hippy::base::checked_numeric_cast<jint, uint32_t>(j_max_thread_count));
+}
+
+jlongArray GetSharedThreadMetrics(JNIEnv* j_env, __unused jobject j_obj) {
+  hippy::base::SequencedThreadPool::Metrics metrics = Engine::GetSharedThreadMetrics();
+  // in the order of HippyEngine.SHARED_THREAD_METRICS_*
+  jlong values[] = {static_cast<jlong>(metrics.thread_count),
+                    static_cast<jlong>(metrics.sequence_count),
+                    hippy::base::checked_numeric_cast<uint64_t, jlong>(metrics.task_count),
+                    hippy::base::checked_numeric_cast<uint64_t, jlong>(metrics.contended_task_count)};
+  jlongArray j_metrics = j_env->NewLongArray(sizeof(values) / sizeof(values[0]));
+  j_env->SetLongArrayRegion(j_metrics, 0, sizeof(values) / sizeof(values[0]), values);
+  return j_metrics;
+}
+
 }  // namespace bridge
 }  // namespace hippy
 
@@ -41,31 +41,52 @@ enum CALLFUNCTION_CB_STATE {
 REGISTER_JNI( // NOLINT(cert-err58-cpp)
         "com/tencent/mtt/hippy/bridge/HippyBridgeImpl",
         "callFunction",
-        "(Ljava/lang/String;JLcom/tencent/mtt/hippy/bridge/NativeCallback;[BII)V",
+        "(Ljava/lang/String;Ljava/lang/String;ZJLcom/tencent/mtt/hippy/bridge/NativeCallback;[BII)V",
         CallFunctionByHeapBuffer)
 
 REGISTER_JNI( // NOLINT(cert-err58-cpp)
         "com/tencent/mtt/hippy/bridge/HippyBridgeImpl",
         "callFunction",
-        "(Ljava/lang/String;JLcom/tencent/mtt/hippy/bridge/"
+        "(Ljava/lang/String;Ljava/lang/String;ZJLcom/tencent/mtt/hippy/bridge/"
         "NativeCallback;Ljava/nio/ByteBuffer;II)V",
         CallFunctionByDirectBuffer)
 
+REGISTER_STATIC_JNI( // NOLINT(cert-err58-cpp)
+        "com/tencent/mtt/hippy/bridge/HippyBridgeImpl",
+        "setMessageCoalescing",
+        "(JLjava/lang/String;Ljava/lang/String;Z)V",
+        SetMessageCoalescing)
+
+REGISTER_STATIC_JNI( // NOLINT(cert-err58-cpp)
+        "com/tencent/mtt/hippy/bridge/HippyBridgeImpl",
+        "getMessageCoalescerStats",
+        "(J)[J",
+        GetMessageCoalescerStats)
+
+REGISTER_STATIC_JNI( // NOLINT(cert-err58-cpp)
+        "com/tencent/mtt/hippy/bridge/HippyBridgeImpl",
+        "getTimerStats",
+        "(J)[J",
+        GetTimerStats)
+
 using unicode_string_view = tdf::base::unicode_string_view;
 using bytes = std::string;
 
 using Ctx = hippy::napi::Ctx;
 using V8Ctx = hippy::napi::V8Ctx;
 using CtxValue = hippy::napi::CtxValue;
+using LocalValue = hippy::napi::LocalValue;
+using ValueScope = hippy::napi::ValueScope;
 using StringViewUtils = hippy::base::StringViewUtils;
 using VM = hippy::vm::VM;
+using MessageCoalescer = hippy::bridge::MessageCoalescer;
 using V8VM = hippy::vm::V8VM;
 
-const char kHippyBridgeName[] = "hippyBridge";
-
 void CallFunction(JNIEnv* j_env,
                   __unused jobject j_obj,
                   jstring j_action,
+                  jstring j_coalesce_key,
+                  jboolean j_is_input,
                   jlong j_runtime_id,
                   jobject j_callback,
                   bytes buffer_data,
@@ -83,12 +104,34 @@ void CallFunction(JNIEnv* j_env,
   }
   unicode_string_view action_name = JniUtils::ToStrView(j_env, j_action);
   TDF_BASE_DLOG(INFO) << "CallFunction action_name = " << action_name;
-  std::shared_ptr<JavaRef> cb = std::make_shared<JavaRef>(j_env, j_callback);
-  std::shared_ptr<JavaScriptTask> task = std::make_shared<JavaScriptTask>();
-  task->callback = [runtime, cb_ = std::move(cb), action_name,
-                    buffer_data_ = std::move(buffer_data),
-                    buffer_owner_ = std::move(buffer_owner)] {
+  TDF_BASE_DCHECK(action_name.encoding() ==
+                  unicode_string_view::Encoding::Utf16);
+  auto message = std::make_shared<MessageCoalescer::Message>();
+  message->data = std::move(buffer_data);
+  message->buffer_owner = std::move(buffer_owner);
+  message->callbacks.push_back(std::make_shared<JavaRef>(j_env, j_callback));
+  std::u16string coalesce_key;
+  if (j_coalesce_key) {
+    coalesce_key = JniUtils::ToStrView(j_env, j_coalesce_key).utf16_value();
+  }
+  std::shared_ptr<MessageCoalescer> coalescer = runtime->GetMessageCoalescer();
+  if (coalescer->Offer(coalesce_key, message)) {
+    return;
+  }
+  // touch and gestures must not wait behind timers or dynamic load callbacks,
+  // the rest of the bridge calls keep the order they were made in
+  auto priority = j_is_input ? JavaScriptTaskRunner::Priority::kInput
+                             : JavaScriptTaskRunner::Priority::kNormal;
+  auto call = [runtime, action_name, coalesce_key, message] {
+    MessageCoalescer::Message latest = runtime->GetMessageCoalescer()->Start(coalesce_key, message);
+    const bytes& buffer_data_ = latest.data;
     JNIEnv* j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
+    // a coalesced message answers every message folded into it
+    auto reply = [&latest](CALLFUNCTION_CB_STATE state, jstring j_msg, jstring j_reply_action) {
+      for (const auto& cb : latest.callbacks) {
+        CallJavaMethod(cb->GetObj(), state, j_msg, j_reply_action);
+      }
+    };
     std::shared_ptr<Scope> scope = runtime->GetScope();
     if (!scope) {
       TDF_BASE_DLOG(WARNING) << "CallFunction scope invalid";
@@ -97,7 +140,7 @@ void CallFunction(JNIEnv* j_env,
     auto context = scope->GetContext();
     if (!runtime->GetBridgeFunc()) {
       TDF_BASE_DLOG(INFO) << "init bridge func";
-      auto func_name = context->CreateString(kHippyBridgeName);
+      auto func_name = context->GetPropertyKey(hippy::napi::PropertyKeyId::kHippyBridge);
       auto global_object = context->GetGlobalObject();
       auto fn = context->GetProperty(global_object, func_name);
       bool is_fn = context->IsFunction(fn);
@@ -105,8 +148,7 @@ void CallFunction(JNIEnv* j_env,
       if (!is_fn) {
         auto j_action = JniUtils::StrViewToJString(j_env, action_name);
         auto j_msg = JniUtils::StrViewToJString(j_env, u"hippyBridge not find");
-        CallJavaMethod(cb_->GetObj(), CALLFUNCTION_CB_STATE::NO_METHOD_ERROR,
-                       j_msg, j_action);
+        reply(CALLFUNCTION_CB_STATE::NO_METHOD_ERROR, j_msg, j_action);
         j_env->DeleteLocalRef(j_action);
         j_env->DeleteLocalRef(j_msg);
         return;
@@ -114,8 +156,6 @@ void CallFunction(JNIEnv* j_env,
         runtime->SetBridgeFunc(fn);
       }
     }
-    TDF_BASE_DCHECK(action_name.encoding() ==
-                    unicode_string_view::Encoding::Utf16);
     if (runtime->IsDebug() &&
         action_name.utf16_value() == u"onWebsocketMsg") {
 #ifndef V8_WITHOUT_INSPECTOR
@@ -127,17 +167,19 @@ void CallFunction(JNIEnv* j_env,
       }
 #endif
       jstring j_action = JniUtils::StrViewToJString(j_env, action_name);
-      CallJavaMethod(cb_->GetObj(), CALLFUNCTION_CB_STATE::SUCCESS, nullptr, j_action);
+      reply(CALLFUNCTION_CB_STATE::SUCCESS, nullptr, j_action);
       j_env->DeleteLocalRef(j_action);
       return;
     }
 
-    std::shared_ptr<CtxValue> action = context->CreateString(action_name);
-    std::shared_ptr<CtxValue> params;
+    // action, params and the result only live for this call, keep them as
+    // local handles instead of persistent CtxValues
+    ValueScope value_scope(context);
+    LocalValue action = context->CreateStringLocal(action_name);
+    LocalValue params;
     if (runtime->IsEnableV8Serialization()) {
       v8::Isolate* isolate = std::static_pointer_cast<V8VM>(runtime->GetEngine()->GetVM())->isolate_;
-      v8::HandleScope handle_scope(isolate);
-      v8::Local<v8::Context> ctx = std::static_pointer_cast<V8Ctx>(runtime->GetScope()->GetContext())->context_persistent_.Get(isolate);
+      v8::Local<v8::Context> ctx = std::static_pointer_cast<V8Ctx>(context)->context_persistent_.Get(isolate);
       hippy::napi::V8TryCatch try_catch(true, context);
       v8::ValueDeserializer deserializer(
           isolate, reinterpret_cast<const uint8_t*>(buffer_data_.c_str()),
@@ -145,8 +187,7 @@ void CallFunction(JNIEnv* j_env,
       TDF_BASE_CHECK(deserializer.ReadHeader(ctx).FromMaybe(false));
       v8::MaybeLocal<v8::Value> ret = deserializer.ReadValue(ctx);
       if (!ret.IsEmpty()) {
-        params = std::make_shared<hippy::napi::V8CtxValue>(
-            isolate, ret.ToLocalChecked());
+        params = hippy::napi::ToLocalValue(ret.ToLocalChecked());
       } else {
         jstring j_action = JniUtils::StrViewToJString(j_env, action_name);
         jstring j_msg;
@@ -156,9 +197,7 @@ void CallFunction(JNIEnv* j_env,
         } else {
           j_msg = JniUtils::StrViewToJString(j_env, u"deserializer error");
         }
-        CallJavaMethod(
-            cb_->GetObj(),
-            hippy::bridge::CALLFUNCTION_CB_STATE::DESERIALIZER_FAILED, j_msg, j_action);
+        reply(CALLFUNCTION_CB_STATE::DESERIALIZER_FAILED, j_msg, j_action);
         j_env->DeleteLocalRef(j_action);
         j_env->DeleteLocalRef(j_msg);
         return;
@@ -169,31 +208,35 @@ void CallFunction(JNIEnv* j_env,
       unicode_string_view buf_str(std::move(str));
       TDF_BASE_DLOG(INFO) << "action_name = " << action_name
                           << ", buf_str = " << buf_str;
-      params = VM::ParseJson(context, buf_str);
+      params = context->ToLocal(VM::ParseJson(context, buf_str));
     }
-    if (!params) {
-      params = context->CreateNull();
+    if (params.IsEmpty()) {
+      params = context->CreateNullLocal();
     }
-    std::shared_ptr<CtxValue> argv[] = {action, params};
-    context->CallFunction(runtime->GetBridgeFunc(), 2, argv);
+    LocalValue argv[] = {action, params};
+    context->CallFunctionLocal(runtime->GetBridgeFunc(), 2, argv);
 
     jstring j_action = JniUtils::StrViewToJString(j_env, action_name);
-    CallJavaMethod(cb_->GetObj(), CALLFUNCTION_CB_STATE::SUCCESS, nullptr, j_action);
+    reply(CALLFUNCTION_CB_STATE::SUCCESS, nullptr, j_action);
     j_env->DeleteLocalRef(j_action);
   };
-
-  runner->PostTask(task);
+  // e.g. loadInstance must not reach js before the bundle run ahead of it
+  runner->PostFunction([runtime, priority, call = std::move(call)] {
+    runtime->RunAfterLastScript(priority, call);
+  }, priority, "CallFunction");
 }
 
 void CallFunctionByHeapBuffer(JNIEnv* j_env,
                               jobject j_obj,
                               jstring j_action,
+                              jstring j_coalesce_key,
+                              jboolean j_is_input,
                               jlong j_runtime_id,
                               jobject j_callback,
                               jbyteArray j_byte_array,
                               jint j_offset,
                               jint j_length) {
-  CallFunction(j_env, j_obj, j_action, j_runtime_id, j_callback,
+  CallFunction(j_env, j_obj, j_action, j_coalesce_key, j_is_input, j_runtime_id, j_callback,
                JniUtils::AppendJavaByteArrayToBytes(j_env, j_byte_array,
                                                     j_offset, j_length),
                nullptr);
@@ -202,6 +245,8 @@ void CallFunctionByHeapBuffer(JNIEnv* j_env,
 void CallFunctionByDirectBuffer(JNIEnv* j_env,
                                 jobject j_obj,
                                 jstring j_action,
+                                jstring j_coalesce_key,
+                                jboolean j_is_input,
                                 jlong j_runtime_id,
                                 jobject j_callback,
                                 jobject j_buffer,
@@ -209,12 +254,73 @@ void CallFunctionByDirectBuffer(JNIEnv* j_env,
                                 jint j_length) {
   char* buffer_address = static_cast<char*>(j_env->GetDirectBufferAddress(j_buffer));
   TDF_BASE_CHECK(buffer_address != nullptr);
-  CallFunction(j_env, j_obj, j_action, j_runtime_id, j_callback,
+  CallFunction(j_env, j_obj, j_action, j_coalesce_key, j_is_input, j_runtime_id, j_callback,
                bytes(buffer_address + j_offset,
                      hippy::base::checked_numeric_cast<jint, size_t>(j_length)),
                std::make_shared<JavaRef>(j_env, j_buffer));
 }
 
+void SetMessageCoalescing(JNIEnv* j_env,
+                          __unused jobject j_obj,
+                          jlong j_runtime_id,
+                          jstring j_module_name,
+                          jstring j_event_name,
+                          jboolean j_coalesced) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "SetMessageCoalescing j_runtime_id invalid";
+    return;
+  }
+  if (!j_module_name || !j_event_name) {
+    TDF_BASE_DLOG(WARNING) << "SetMessageCoalescing rule invalid";
+    return;
+  }
+  std::u16string module_name = JniUtils::ToStrView(j_env, j_module_name).utf16_value();
+  std::u16string event_name = JniUtils::ToStrView(j_env, j_event_name).utf16_value();
+  if (j_coalesced) {
+    runtime->GetMessageCoalescer()->RegisterRule(module_name, event_name);
+  } else {
+    runtime->GetMessageCoalescer()->UnregisterRule(module_name, event_name);
+  }
+}
+
+jlongArray GetMessageCoalescerStats(JNIEnv* j_env, __unused jobject j_obj, jlong j_runtime_id) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "GetMessageCoalescerStats j_runtime_id invalid";
+    return nullptr;
+  }
+  MessageCoalescer::Stats stats = runtime->GetMessageCoalescer()->GetStats();
+  // in the order of HippyBridgeImpl.COALESCER_STATS_*
+  jlong values[] = {hippy::base::checked_numeric_cast<uint64_t, jlong>(stats.dropped_count),
+                    hippy::base::checked_numeric_cast<uint64_t, jlong>(stats.merged_count)};
+  jlongArray j_stats = j_env->NewLongArray(sizeof(values) / sizeof(values[0]));
+  j_env->SetLongArrayRegion(j_stats, 0, sizeof(values) / sizeof(values[0]), values);
+  return j_stats;
+}
+
+jlongArray GetTimerStats(JNIEnv* j_env, __unused jobject j_obj, jlong j_runtime_id) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "GetTimerStats j_runtime_id invalid";
+    return nullptr;
+  }
+  auto engine = runtime->GetEngine();
+  if (!engine) {
+    return nullptr;
+  }
+  // counted per js runner, runtimes sharing an engine see the same numbers
+  JavaScriptTaskRunner::TimerStats stats = engine->GetJSRunner()->GetTimerStats();
+  // in the order of HippyBridgeImpl.TIMER_STATS_*
+  jlong values[] = {hippy::base::checked_numeric_cast<uint64_t, jlong>(stats.delayed_task_count),
+                    hippy::base::checked_numeric_cast<uint64_t, jlong>(stats.wake_up_count),
+                    hippy::base::checked_numeric_cast<uint64_t, jlong>(stats.coalesced_task_count),
+                    hippy::base::checked_numeric_cast<uint64_t, jlong>(stats.saved_wake_up_count)};
+  jlongArray j_stats = j_env->NewLongArray(sizeof(values) / sizeof(values[0]));
+  j_env->SetLongArrayRegion(j_stats, 0, sizeof(values) / sizeof(values[0]), values);
+  return j_stats;
+}
+
 void CallJavaMethod(jobject j_obj,
                     jlong j_ret_code,
                     jstring j_ret_content,
@@ -0,0 +1,101 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "bridge/message_coalescer.h"
+
+#include <iterator>
+
+namespace hippy {
+namespace bridge {
+
+std::u16string MessageCoalescer::RuleName(const std::u16string& module_name, const std::u16string& event_name) {
+  return module_name + u"." + event_name;
+}
+
+void MessageCoalescer::RegisterRule(const std::u16string& module_name,
+                                    const std::u16string& event_name,
+                                    MergeFunction merge) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  rules_[RuleName(module_name, event_name)] = std::move(merge);
+}
+
+void MessageCoalescer::UnregisterRule(const std::u16string& module_name, const std::u16string& event_name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto rule = RuleName(module_name, event_name);
+  rules_.erase(rule);
+  // the posted tasks of pending messages still deliver them
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (it->first.compare(0, it->first.find(u'#'), rule) == 0) {
+      it = pending_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool MessageCoalescer::Offer(const std::u16string& key, const std::shared_ptr<Message>& message) {
+  if (key.empty()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto rule_it = rules_.find(key.substr(0, key.find(u'#')));
+  if (rule_it == rules_.end()) {
+    return false;
+  }
+  auto pending_it = pending_.find(key);
+  if (pending_it == pending_.end()) {
+    pending_[key] = message;
+    return false;
+  }
+  std::shared_ptr<Message>& pending = pending_it->second;
+  const MergeFunction& merge = rule_it->second;
+  if (merge) {
+    merge(pending->data, std::move(message->data));
+    ++stats_.merged_count;
+  } else {
+    pending->data = std::move(message->data);
+    pending->buffer_owner = std::move(message->buffer_owner);
+    ++stats_.dropped_count;
+  }
+  pending->callbacks.insert(pending->callbacks.end(),
+                            std::make_move_iterator(message->callbacks.begin()),
+                            std::make_move_iterator(message->callbacks.end()));
+  return true;
+}
+
+MessageCoalescer::Message MessageCoalescer::Start(const std::u16string& key,
+                                                  const std::shared_ptr<Message>& message) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = pending_.find(key);
+  if (it != pending_.end() && it->second == message) {
+    pending_.erase(it);
+  }
+  return std::move(*message);
+}
+
+MessageCoalescer::Stats MessageCoalescer::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace bridge
+}  // namespace hippy
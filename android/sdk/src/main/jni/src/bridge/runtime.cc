@@ -35,11 +35,21 @@ static std::mutex mutex;
 static std::atomic<int32_t> global_runtime_key{0};
 
 Runtime::Runtime(std::shared_ptr<Bridge> bridge, bool enable_v8_serialization, bool is_dev)
-    : enable_v8_serialization_(enable_v8_serialization), is_debug_(is_dev), group_id_(0),
-    bridge_(std::move(bridge)), interrupt_queue_(nullptr) {
+    : enable_v8_serialization_(enable_v8_serialization), is_debug_(is_dev), is_background_(false), group_id_(0),
+    bridge_(std::move(bridge)), interrupt_queue_(nullptr),
+    message_coalescer_(std::make_shared<hippy::bridge::MessageCoalescer>()) {
   id_ = global_runtime_key.fetch_add(1);
 }
 
+void Runtime::PostAfterLastScript(JavaScriptTaskRunner::Priority priority, std::function<void()> task) {
+  hippy::base::Promise<bool> task_run;
+  SwapLastScriptRun(task_run.GetFuture()).Then(
+      engine_->GetJSRunner()->Schedule(priority), [task = std::move(task), task_run](bool) {
+    task();
+    task_run.SetValue(true);
+  });
+}
+
 void Runtime::Insert(const std::shared_ptr<Runtime>& runtime) {
   std::lock_guard<std::mutex> lock(mutex);
   RuntimeMap[runtime->id_] = runtime;
@@ -99,3 +109,13 @@ bool Runtime::Erase(int32_t id) {
 bool Runtime::Erase(const std::shared_ptr<Runtime>& runtime) {
   return Runtime::Erase(runtime->id_);
 }
+
+bool Runtime::IsEngineInBackground(const std::shared_ptr<Engine>& engine) {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto& p: RuntimeMap) {
+    if (p.second->GetEngine() == engine && !p.second->IsBackground()) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -31,6 +31,8 @@
 
 using namespace hippy::napi;
 using unicode_string_view = tdf::base::unicode_string_view;
+using LocalValue = hippy::napi::LocalValue;
+using ValueScope = hippy::napi::ValueScope;
 using StringViewUtils = hippy::base::StringViewUtils;
 
 bool IsBasicNumberType(const std::string &type) {
@@ -62,7 +64,7 @@ std::tuple<bool, std::string, std::shared_ptr<JNIArgs>> ConvertUtils::ConvertJSI
     const std::string &module_name,
     const std::string &method_name,
     const std::vector<std::string> &method_arg_types,
-    const std::vector<std::shared_ptr<CtxValue>> &arg_values) {
+    const std::vector<LocalValue> &arg_values) {
   std::shared_ptr<V8Ctx> context = std::static_pointer_cast<V8Ctx>(ctx);
 
   auto actual_arg_count = arg_values.size();
@@ -73,7 +75,7 @@ std::tuple<bool, std::string, std::shared_ptr<JNIArgs>> ConvertUtils::ConvertJSI
     std::string type = method_arg_types.at(i);
 
     jvalue *j_args = &jni_args->args_[i];
-    std::shared_ptr<CtxValue> value = arg_values.at(i);
+    const LocalValue& value = arg_values.at(i);
 
     // basic type
     auto base_tuple = HandleBasicType(ctx, type, *j_args, value);
@@ -118,7 +120,7 @@ std::tuple<bool, std::string, std::shared_ptr<JNIArgs>> ConvertUtils::ConvertJSI
 std::tuple<bool, std::string, bool> ConvertUtils::HandleBasicType(const std::shared_ptr<Ctx>& ctx,
                                                                   const std::string &type,
                                                                   jvalue &j_args,
-                                                                  const std::shared_ptr<CtxValue> &value) {
+                                                                  const LocalValue &value) {
   auto context = std::static_pointer_cast<V8Ctx>(ctx);
 
   // number
@@ -170,7 +172,7 @@ ConvertUtils::HandleObjectType(const std::shared_ptr<Ctx>& ctx,
                                const std::string &method_name,
                                const std::string &type,
                                jvalue &j_args,
-                               const std::shared_ptr<CtxValue> &value,
+                               const LocalValue &value,
                                std::vector<std::shared_ptr<JavaRef>> &global_refs) {
   auto v8_ctx = std::static_pointer_cast<V8Ctx>(ctx);
 
@@ -327,17 +329,19 @@ ConvertUtils::HandleObjectType(const std::shared_ptr<Ctx>& ctx,
 }
 
 std::tuple<bool, std::string, jobject> ConvertUtils::ToHippyMap(const std::shared_ptr<Ctx>& ctx,
-                                                                const std::shared_ptr<CtxValue> &value) {
+                                                                const LocalValue &value) {
   std::shared_ptr<V8Ctx> v8_ctx = std::static_pointer_cast<V8Ctx>(ctx);
 
   JNIEnv *j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
   jobject obj = j_env->NewObject(hippy_map_clazz, hippy_map_constructor);
-  std::shared_ptr<CtxValue> array = v8_ctx->ConvertMapToArray(value);
+  LocalValue array = v8_ctx->ConvertMapToArrayLocal(value);
 
   auto array_len = v8_ctx->GetArrayLength(array);
   for (uint32_t i = 0; i < array_len; i = i + 2) {
+    // entries release their handles before the next one is read
+    ValueScope value_scope(ctx);
     // key
-    std::shared_ptr<CtxValue> key = v8_ctx->CopyArrayElement(array, i);
+    LocalValue key = v8_ctx->CopyArrayElementLocal(array, i);
     unicode_string_view str_view;
     std::string key_str;
     if (ctx->GetValueString(key, &str_view)) {
@@ -350,7 +354,7 @@ std::tuple<bool, std::string, jobject> ConvertUtils::ToHippyMap(const std::share
     TDF_BASE_DLOG(INFO) << "key " << key_str.c_str();
 
     // value
-    std::shared_ptr<CtxValue> item = v8_ctx->CopyArrayElement(array, i + 1);
+    LocalValue item = v8_ctx->CopyArrayElementLocal(array, i + 1);
     auto to_jobject_tuple = ToJObject(ctx, item);
     if (!std::get<0>(to_jobject_tuple)) {
       j_env->DeleteLocalRef(key_j_obj);
@@ -366,13 +370,14 @@ std::tuple<bool, std::string, jobject> ConvertUtils::ToHippyMap(const std::share
 }
 
 std::tuple<bool, std::string, jobject> ConvertUtils::ToHippyArray(const std::shared_ptr<Ctx>& ctx,
-                                                                  const std::shared_ptr<CtxValue> &value) {
+                                                                  const LocalValue &value) {
   std::shared_ptr<V8Ctx> v8_ctx = std::static_pointer_cast<V8Ctx>(ctx);
   JNIEnv *j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
   jobject obj = j_env->NewObject(hippy_array_clazz, hippy_array_constructor);
   auto array_len = v8_ctx->GetArrayLength(value);
   for (uint32_t i = 0; i < array_len; i++) {
-    std::shared_ptr<CtxValue> item = v8_ctx->CopyArrayElement(value, i);
+    ValueScope value_scope(ctx);
+    LocalValue item = v8_ctx->CopyArrayElementLocal(value, i);
     auto to_jobject_tuple = ToJObject(ctx, item);
     if (!std::get<0>(to_jobject_tuple)) {
       return to_jobject_tuple;
@@ -386,7 +391,7 @@ std::tuple<bool, std::string, jobject> ConvertUtils::ToHippyArray(const std::sha
 }
 
 std::tuple<bool, std::string, jobject> ConvertUtils::ToJObject(const std::shared_ptr<Ctx>& ctx,
-                                                               const std::shared_ptr<CtxValue> &value) {
+                                                               const LocalValue &value) {
   double num;
   bool b;
   std::string str;
@@ -57,9 +57,10 @@ std::shared_ptr<CtxValue> JavaTurboModule::InvokeJavaMethod(const std::shared_pt
   TDF_BASE_DLOG(INFO) << "invokeJavaMethod, method = " << method.c_str();
 
   // arguments count
-  std::vector<std::shared_ptr<CtxValue>> argv;
+  std::vector<LocalValue> argv;
+  argv.reserve(info.Length());
   for (size_t i = 0; i < info.Length(); ++i) {
-    argv.push_back(info[i]);
+    argv.push_back(info.GetLocalValue(i));
   }
   std::string call_info = name + "." + method;
   std::vector<std::string> method_arg_types = ConvertUtils::GetMethodArgTypesFromSignature(method_info.signature_);
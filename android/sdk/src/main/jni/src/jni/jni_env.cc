@@ -60,6 +60,8 @@ void JNIEnvironment::init(JavaVM* j_vm, JNIEnv* j_env) {
 
   wrapper_.j_fetch_resource_method_id = j_env->GetMethodID(
       j_hippy_bridge_cls, "fetchResourceWithUri", "(Ljava/lang/String;J)V");
+  wrapper_.j_request_frame_method_id =
+      j_env->GetMethodID(j_hippy_bridge_cls, "requestFrame", "(J)V");
   j_env->DeleteLocalRef(j_hippy_bridge_cls);
 
   if (j_env->ExceptionCheck()) {
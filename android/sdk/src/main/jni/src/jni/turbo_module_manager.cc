@@ -77,13 +77,14 @@ void GetTurboModule(const CallbackInfo& info, void* data) {
   auto context = v8_ctx->context_persistent_.Get(v8_ctx->isolate_);
   v8::Context::Scope context_scope(context);
 
-  if (!info[0] || !ctx->IsString(info[0])) {
+  LocalValue name_value = info.GetLocalValue(0);
+  if (name_value.IsEmpty() || !ctx->IsString(name_value)) {
     TDF_BASE_LOG(ERROR) << "cannot find TurboModule as param is invalid";
     info.GetReturnValue()->SetUndefined();
   }
 
   unicode_string_view name;
-  ctx->GetValueString(info[0], &name);
+  ctx->GetValueString(name_value, &name);
   auto turbo_manager = runtime->GetTurboManager();
   if (!turbo_manager) {
     TDF_BASE_LOG(ERROR) << "turbo_manager error";
@@ -23,6 +23,8 @@
 #include "loader/adr_loader.h"
 
 #include <android/asset_manager_jni.h>
+
+#include <algorithm>
 #include <future>
 
 #include "bridge/runtime.h"
@@ -34,6 +36,8 @@
 using unicode_string_view = tdf::base::unicode_string_view;
 using StringViewUtils = hippy::base::StringViewUtils;
 using HippyFile = hippy::base::HippyFile;
+using SourceBuffer = hippy::base::SourceBuffer;
+using SourceStream = hippy::base::SourceStream;
 using u8string = unicode_string_view::u8string;
 using char8_t_ = unicode_string_view::char8_t_;
 
@@ -41,6 +45,14 @@ static std::atomic<int64_t> global_request_id{0};
 static jclass j_context_holder_class;
 static jmethodID j_get_app_context_method_id;
 
+ADRLoader::~ADRLoader() {
+  // reads queued for a page that is gone are dropped instead of run
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& handle : pending_reads_) {
+    handle.Cancel();
+  }
+}
+
 bool ADRLoader::RequestUntrustedContent(const unicode_string_view& uri,
                                         std::function<void(u8string)> cb) {
   auto uri_obj = Uri::Create(uri);
@@ -124,6 +136,135 @@ bool ADRLoader::RequestUntrustedContent(const unicode_string_view& uri,
   }
 }
 
+bool ADRLoader::RequestSourceBuffer(const unicode_string_view& uri,
+                                    std::function<void(std::shared_ptr<SourceBuffer>)> cb) {
+  auto uri_obj = Uri::Create(uri);
+  if (uri_obj) {
+    unicode_string_view schema = uri_obj->GetScheme();
+    unicode_string_view path = uri_obj->GetPath();
+    if (!StringViewUtils::IsEmpty(schema) && !StringViewUtils::IsEmpty(path)) {
+      TDF_BASE_DCHECK(schema.encoding() == unicode_string_view::Encoding::Utf16);
+      std::u16string schema_str = schema.utf16_value();
+      if (schema_str == u"file") {
+        return MapFile(path, cb);
+      } else if (schema_str == u"asset") {
+        return MapAsset(path, cb);
+      }
+    }
+  }
+  // other schemes and bad uris go through the copying path, which reports errors
+  return UriLoader::RequestSourceBuffer(uri, std::move(cb));
+}
+
+// AASSET_MODE_BUFFER maps uncompressed assets straight from the apk, compressed
+// ones are inflated once into a buffer owned by the asset
+static std::shared_ptr<SourceBuffer> OpenAssetBuffer(const unicode_string_view& path,
+                                                     AAssetManager* aasset_manager) {
+  if (!aasset_manager) {
+    return nullptr;
+  }
+  unicode_string_view owner(""_u8s);
+  std::string asset_path = StringViewUtils::ToConstCharPointer(path, owner);
+  if (!asset_path.empty() && asset_path[0] == '/') {
+    asset_path = asset_path.substr(1);
+  }
+  AAsset* asset = AAssetManager_open(aasset_manager, asset_path.c_str(), AASSET_MODE_BUFFER);
+  if (!asset) {
+    TDF_BASE_DLOG(INFO) << "OpenAssetBuffer fail, asset_path = " << asset_path;
+    return nullptr;
+  }
+  auto buffer = reinterpret_cast<const uint8_t*>(AAsset_getBuffer(asset));
+  size_t length = 0;
+  if (!buffer || !hippy::base::numeric_cast<off_t, size_t>(AAsset_getLength(asset), length) || length == 0) {
+    AAsset_close(asset);
+    return nullptr;
+  }
+  TDF_BASE_DLOG(INFO) << "OpenAssetBuffer asset_path = " << asset_path << ", length = " << length
+                      << ", is_allocated = " << AAsset_isAllocated(asset);
+  return std::make_shared<SourceBuffer>(buffer, length, [asset] {
+    AAsset_close(asset);
+  });
+}
+
+static std::shared_ptr<SourceStream> OpenAssetStream(const unicode_string_view& path,
+                                                     AAssetManager* aasset_manager) {
+  if (!aasset_manager) {
+    return nullptr;
+  }
+  unicode_string_view owner(""_u8s);
+  std::string asset_path = StringViewUtils::ToConstCharPointer(path, owner);
+  if (!asset_path.empty() && asset_path[0] == '/') {
+    asset_path = asset_path.substr(1);
+  }
+  AAsset* asset = AAssetManager_open(aasset_manager, asset_path.c_str(), AASSET_MODE_STREAMING);
+  if (!asset) {
+    TDF_BASE_DLOG(INFO) << "OpenAssetStream fail, asset_path = " << asset_path;
+    return nullptr;
+  }
+  auto reader = [asset](uint8_t* buffer, size_t size, size_t* length) {
+    int ret = AAsset_read(asset, buffer, size);
+    if (ret < 0) {
+      TDF_BASE_DLOG(WARNING) << "OpenAssetStream read fail";
+      return false;
+    }
+    *length = static_cast<size_t>(ret);
+    return true;
+  };
+  return std::make_shared<SourceStream>(std::move(reader), [asset] {
+    AAsset_close(asset);
+  });
+}
+
+std::shared_ptr<SourceStream> ADRLoader::RequestSourceStream(const unicode_string_view& uri) {
+  auto uri_obj = Uri::Create(uri);
+  if (!uri_obj) {
+    return nullptr;
+  }
+  unicode_string_view schema = uri_obj->GetScheme();
+  unicode_string_view path = uri_obj->GetPath();
+  if (StringViewUtils::IsEmpty(schema) || StringViewUtils::IsEmpty(path)) {
+    return nullptr;
+  }
+  TDF_BASE_DCHECK(schema.encoding() == unicode_string_view::Encoding::Utf16);
+  std::u16string schema_str = schema.utf16_value();
+  if (schema_str == u"file") {
+    return SourceStream::FromFile(path);
+  } else if (schema_str == u"asset") {
+    return OpenAssetStream(path, GetAAssetManager());
+  }
+  return nullptr;
+}
+
+bool ADRLoader::MapFile(const unicode_string_view& path,
+                        const std::function<void(std::shared_ptr<SourceBuffer>)>& cb) {
+  std::shared_ptr<WorkerTaskRunner> runner = runner_.lock();
+  if (!runner) {
+    return false;
+  }
+  std::string dedup_key = "file+map:" + StringViewUtils::ToU8StdStr(path);
+  auto handle = runner->PostDedupTask<std::shared_ptr<SourceBuffer>>(dedup_key, [path] {
+    return SourceBuffer::FromFile(path);
+  }, cb);
+  AddPendingRead(std::move(handle));
+
+  return true;
+}
+
+bool ADRLoader::MapAsset(const unicode_string_view& path,
+                         const std::function<void(std::shared_ptr<SourceBuffer>)>& cb) {
+  std::shared_ptr<WorkerTaskRunner> runner = runner_.lock();
+  if (!runner) {
+    return false;
+  }
+  std::string dedup_key = "asset+map:" + StringViewUtils::ToU8StdStr(path);
+  auto handle = runner->PostDedupTask<std::shared_ptr<SourceBuffer>>(dedup_key, [path] {
+    return OpenAssetBuffer(path, GetAAssetManager());
+  }, cb);
+  AddPendingRead(std::move(handle));
+
+  return true;
+}
+
 AAssetManager* ADRLoader::GetAAssetManager() {
   auto j_env = JNIEnvironment::GetInstance()->AttachCurrentThread();
   auto j_context = j_env->CallStaticObjectMethod(j_context_holder_class, j_get_app_context_method_id);
@@ -139,13 +280,13 @@ bool ADRLoader::LoadByFile(const unicode_string_view& path,
   if (!runner) {
     return false;
   }
-  std::unique_ptr<CommonTask> task = std::make_unique<CommonTask>();
-  task->func_ = [path, cb] {
+  std::string dedup_key = "file:" + StringViewUtils::ToU8StdStr(path);
+  auto handle = runner->PostDedupTask<u8string>(dedup_key, [path] {
     u8string ret;
     HippyFile::ReadFile(path, ret, false);
-    cb(std::move(ret));
-  };
-  runner->PostTask(std::move(task));
+    return ret;
+  }, cb);
+  AddPendingRead(std::move(handle));
 
   return true;
 }
@@ -158,18 +299,28 @@ bool ADRLoader::LoadByAsset(const unicode_string_view& path,
   if (!runner) {
     return false;
   }
-  std::unique_ptr<CommonTask> task = std::make_unique<CommonTask>();
-  task->func_ = [path, is_auto_fill, cb] {
+  std::string dedup_key = (is_auto_fill ? "asset+fill:" : "asset:") + StringViewUtils::ToU8StdStr(path);
+  auto handle = runner->PostDedupTask<u8string>(dedup_key, [path, is_auto_fill] {
     u8string ret;
     auto aasset_manager = GetAAssetManager();
     ReadAsset(path, aasset_manager, ret, is_auto_fill);
-    cb(std::move(ret));
-  };
-  runner->PostTask(std::move(task));
+    return ret;
+  }, cb);
+  AddPendingRead(std::move(handle));
 
   return true;
 }
 
+void ADRLoader::AddPendingRead(WorkerTaskRunner::TaskHandle handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_reads_.erase(std::remove_if(pending_reads_.begin(), pending_reads_.end(),
+                                      [](const WorkerTaskRunner::TaskHandle& pending) {
+                                        return !pending.IsPending();
+                                      }),
+                       pending_reads_.end());
+  pending_reads_.push_back(std::move(handle));
+}
+
 bool ADRLoader::LoadByJni(const unicode_string_view& uri,
                           const std::function<void(u8string)>& cb) {
   std::shared_ptr<JNIEnvironment> instance = JNIEnvironment::GetInstance();
@@ -22,10 +22,17 @@
 
 #include "performance/memory.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <functional>
+
 #include "bridge/runtime.h"
 #include "jni/jni_env.h"
 #include "jni/jni_register.h"
 #include "jni/jni_utils.h"
+#include "core/vm/v8/v8_heap_profiler.h"
 
 namespace hippy {
 namespace bridge {
@@ -47,6 +54,18 @@ REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
              "writeHeapSnapshot",
              "(JLjava/lang/String;Lcom/tencent/mtt/hippy/common/Callback;)Z",
              WriteHeapSnapshot)
+REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
+             "startSamplingHeapProfiler",
+             "(JJI)Z",
+             StartSamplingHeapProfiler)
+REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
+             "writeSamplingHeapProfile",
+             "(JLjava/lang/String;Lcom/tencent/mtt/hippy/common/Callback;)Z",
+             WriteSamplingHeapProfile)
+REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
+             "stopSamplingHeapProfiler",
+             "(J)V",
+             StopSamplingHeapProfiler)
 
 jint ThrowNoSuchMethodError(JNIEnv* j_env, const char* msg){
   auto j_class = j_env->FindClass("java/lang/NoSuchMethodException" );
@@ -56,8 +75,7 @@ jint ThrowNoSuchMethodError(JNIEnv* j_env, const char* msg){
 
 using unicode_string_view = tdf::base::unicode_string_view;
 using V8VM = hippy::vm::V8VM;
-
-#ifndef V8_X5_LITE
+using V8HeapProfiler = hippy::vm::V8HeapProfiler;
 
 // [Heap] write result code
 enum HEAP_WRITE : int8_t {
@@ -67,65 +85,55 @@ enum HEAP_WRITE : int8_t {
   HEAP_WRITE_ERR_SAVE = -3
 };
 
-// [Heap] HeapSnapshot OutputStream
-class HeapSnapshotOutputStreamAdapter : public v8::OutputStream {
- private:
-  std::ofstream file_;
- public:
-  static constexpr uint16_t kChunkSize = 1024;
-  enum SaveResult : int8_t {
-    kInit = 0,
-    kOk = 1,
-    kError = 2
-  };
-  SaveResult save_res_ = kInit;
-  void EndOfStream() override {
-    save_res_ = kOk;
-    file_.close();
-  }
-  int GetChunkSize() override {
-    return kChunkSize;
+// [Heap] creates the parent dir of file_path if needed and opens it for writing
+static HEAP_WRITE OpenHeapFile(const unicode_string_view& file_path, int* fd) {
+  TDF_BASE_DLOG(INFO) << "OpenHeapFile file_path = " << file_path;
+  size_t pos = base::StringViewUtils::FindLastOf(file_path, EXTEND_LITERAL('/'));
+  unicode_string_view parent_dir = base::StringViewUtils::SubStr(file_path, 0, pos);
+  // no file or no permission
+  if (base::HippyFile::CheckDir(parent_dir, F_OK) && base::HippyFile::CreateDir(parent_dir, S_IRWXU)) {
+    TDF_BASE_DLOG(WARNING) << "OpenHeapFile create dir fail, parent_dir = " << parent_dir;
+    return HEAP_WRITE_ERR_FILE;
   }
-  WriteResult WriteAsciiChunk(char *data, int size) override {
-    if (file_.is_open()) {
-      file_.write(data, size);
-    }
-    return kContinue;
-  }
-  WriteResult WriteHeapStatsChunk(v8::HeapStatsUpdate *data, int count) override {
-    save_res_ = kError;
-    return kAbort;
+  unicode_string_view owner(""_u8s);
+  const char* path = base::StringViewUtils::ToConstCharPointer(file_path, owner);
+  *fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (*fd < 0) {
+    TDF_BASE_DLOG(WARNING) << "OpenHeapFile open fail, errno = " << errno;
+    return HEAP_WRITE_ERR_FILE;
   }
+  return HEAP_WRITE_OK;
+}
 
-  int SetFilePath(const tdf::base::unicode_string_view &snapshot_file_path) {
-    TDF_BASE_DLOG(INFO) << "HeapSnapshotOutputStreamAdapter SetFilePath heap_snapshot_file_path = "
-                        << snapshot_file_path;
-    int result_code = 0;
-    size_t pos = base::StringViewUtils::FindLastOf(snapshot_file_path, EXTEND_LITERAL('/'));
-    tdf::base::unicode_string_view
-        snapshot_parent_dir = base::StringViewUtils::SubStr(snapshot_file_path, 0, pos);
-    int check_parent_dir_code = base::HippyFile::CheckDir(snapshot_parent_dir, F_OK);
-    // no file or no permission
-    if (check_parent_dir_code) {
-      TDF_BASE_DLOG(INFO)
-      << "HeapSnapshotOutputStreamAdapter SetFilePath check_heap_snapshot_parent_dir_code = "
-      << check_parent_dir_code;
-      result_code = base::HippyFile::CreateDir(snapshot_parent_dir, S_IRWXU);
-    }
-    if (result_code) {
-      save_res_ = kError;
-    } else {
-      save_res_ = kInit;
-      TDF_BASE_DLOG(INFO) << "HeapSnapshotOutputStreamAdapter open file " << snapshot_file_path;
-      tdf::base::unicode_string_view owner(""_u8s);
-      const char *path = base::StringViewUtils::ToConstCharPointer(snapshot_file_path, owner);
-      file_.open(path, std::ios::out | std::ios::ate | std::ios::binary);
-    }
-    TDF_BASE_DLOG(INFO) << "HeapSnapshotOutputStreamAdapter SetFilePath result " << result_code;
-    return result_code;
+// [Heap] calls back with an Integer of code
+static void CallbackHeapWriteResult(JNIEnv* j_env, const std::shared_ptr<JavaRef>& cb, HEAP_WRITE code) {
+  jclass j_cb_class = j_env->GetObjectClass(cb->GetObj());
+  jmethodID j_cb_method =
+      j_env->GetMethodID(j_cb_class, "callback", "(Ljava/lang/Object;Ljava/lang/Throwable;)V");
+  j_env->DeleteLocalRef(j_cb_class);
+  jclass j_int_class = j_env->FindClass("java/lang/Integer");
+  jmethodID j_int_constructor = j_env->GetMethodID(j_int_class, "<init>", "(I)V");
+  jobject j_code = j_env->NewObject(j_int_class, j_int_constructor, static_cast<jint>(code));
+  j_env->DeleteLocalRef(j_int_class);
+  JNIEnvironment::ClearJEnvException(j_env);
+  j_env->CallVoidMethod(cb->GetObj(), j_cb_method, j_code, nullptr);
+  JNIEnvironment::ClearJEnvException(j_env);
+  j_env->DeleteLocalRef(j_code);
+}
+
+// [Heap] writes to file_path through write_func, which gets the opened fd
+static HEAP_WRITE WriteHeapFile(const unicode_string_view& file_path, const std::function<bool(int)>& write_func) {
+  int fd = -1;
+  HEAP_WRITE code = OpenHeapFile(file_path, &fd);
+  if (code != HEAP_WRITE_OK) {
+    return code;
   }
-};
-#endif
+  bool is_written = write_func(fd);
+  if (close(fd) != 0) {
+    is_written = false;
+  }
+  return is_written ? HEAP_WRITE_OK : HEAP_WRITE_ERR_SAVE;
+}
 
 // [Heap] GetHeapStatistics
 jboolean GetHeapStatistics(__unused JNIEnv *j_env,
@@ -316,76 +324,79 @@ jboolean WriteHeapSnapshot(__unused JNIEnv *j_env,
 #ifndef V8_X5_LITE
   TDF_BASE_DLOG(INFO) << "WriteHeapSnapshot begin, j_runtime_id = " << j_runtime_id;
   auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
-  // callback
-  jclass j_cb_class = j_env->GetObjectClass(j_callback);
-  jmethodID j_cb_method =
-      j_env->GetMethodID(j_cb_class, "callback", "(Ljava/lang/Object;Ljava/lang/Throwable;)V");
   std::shared_ptr<JavaRef> cb = std::make_shared<JavaRef>(j_env, j_callback);
-  j_env->DeleteLocalRef(j_cb_class);
-  // callback code
-  jclass j_int_class = j_env->FindClass("java/lang/Integer");
-  jmethodID j_int_constructor = j_env->GetMethodID(j_int_class, "<init>", "(I)V");
-  std::shared_ptr<JavaRef>
-      int_obj = std::make_shared<JavaRef>(j_env, j_env->AllocObject(j_int_class));
-  std::shared_ptr<JavaRef> ret_code_obj = std::make_shared<JavaRef>(j_env, int_obj->GetObj());
-  j_env->DeleteLocalRef(j_int_class);
   // error: runtime_id invalid
   if (!runtime) {
     TDF_BASE_DLOG(WARNING) << "WriteHeapSnapshot, j_runtime_id invalid";
-    j_env->CallVoidMethod(ret_code_obj->GetObj(),
-                          j_int_constructor,
-                          static_cast<jint>(HEAP_WRITE_ERR_RUN));
-    JNIEnvironment::ClearJEnvException(j_env);
-    j_env->CallVoidMethod(cb->GetObj(), j_cb_method, ret_code_obj->GetObj(), nullptr);
-    JNIEnvironment::ClearJEnvException(j_env);
+    CallbackHeapWriteResult(j_env, cb, HEAP_WRITE_ERR_RUN);
     return JNI_FALSE;
   }
   const unicode_string_view heap_snapshot_path = JniUtils::ToStrView(j_env, j_heap_snapshot_path);
-  TDF_BASE_DLOG(INFO) << "WriteHeapSnapshot thread start";
-  auto heap_snapshot_stream = std::make_shared<HeapSnapshotOutputStreamAdapter>();
-  int set_file_err = heap_snapshot_stream->SetFilePath(heap_snapshot_path);
-  // error: file_path invalid
-  if (set_file_err) {
-    TDF_BASE_DLOG(WARNING) << "WriteHeapSnapshot thread, set_file_err = " << set_file_err;
-    j_env->CallVoidMethod(ret_code_obj->GetObj(),
-                          j_int_constructor,
-                          static_cast<jint>(HEAP_WRITE_ERR_FILE));
-    JNIEnvironment::ClearJEnvException(j_env);
-    j_env->CallVoidMethod(cb->GetObj(), j_cb_method, ret_code_obj->GetObj(), nullptr);
-    JNIEnvironment::ClearJEnvException(j_env);
-    return JNI_FALSE;
-  }
   v8::Isolate *isolate = std::static_pointer_cast<V8VM>(runtime->GetEngine()->GetVM())->isolate_;
-  v8::HandleScope handle_scope(isolate);
-  // v8 TakeHeapSnapshot and Serialize
-  auto heap_snapshot = isolate->GetHeapProfiler()->TakeHeapSnapshot();
-  heap_snapshot->Serialize(heap_snapshot_stream.get());
-  const_cast<v8::HeapSnapshot *>(heap_snapshot)->Delete();
-  // error: save heapSnapshots error
-  if (heap_snapshot_stream->save_res_ != HeapSnapshotOutputStreamAdapter::kOk) {
-    TDF_BASE_DLOG(WARNING) << "WriteHeapSnapshot RequestInterrupt, save heapSnapshots = "
-                           << heap_snapshot_stream->save_res_;
-    j_env->CallVoidMethod(ret_code_obj->GetObj(),
-                          j_int_constructor,
-                          static_cast<jint>(HEAP_WRITE_ERR_SAVE));
-    JNIEnvironment::ClearJEnvException(j_env);
-    j_env->CallVoidMethod(cb->GetObj(), j_cb_method, ret_code_obj->GetObj(), nullptr);
-    JNIEnvironment::ClearJEnvException(j_env);
-    return JNI_FALSE;
-  }
-  j_env->CallVoidMethod(ret_code_obj->GetObj(),
-                        j_int_constructor,
-                        static_cast<jint>(HEAP_WRITE_OK));
-  JNIEnvironment::ClearJEnvException(j_env);
-  j_env->CallVoidMethod(cb->GetObj(), j_cb_method, ret_code_obj->GetObj(), nullptr);
-  JNIEnvironment::ClearJEnvException(j_env);
-  TDF_BASE_DLOG(INFO) << "WriteHeapSnapshot thread end";
-  return JNI_TRUE;
+  HEAP_WRITE code = WriteHeapFile(heap_snapshot_path, [isolate](int fd) {
+    return V8HeapProfiler::WriteHeapSnapshot(isolate, fd);
+  });
+  TDF_BASE_DLOG(INFO) << "WriteHeapSnapshot end, code = " << static_cast<int>(code);
+  CallbackHeapWriteResult(j_env, cb, code);
+  return code == HEAP_WRITE_OK ? JNI_TRUE : JNI_FALSE;
 #else
   ThrowNoSuchMethodError(j_env, "X5 lite has no WriteHeapSnapshot method");
   return JNI_FALSE;
 #endif
 }
+// [Heap] StartSamplingHeapProfiler
+jboolean StartSamplingHeapProfiler(__unused JNIEnv *j_env,
+                                   __unused jobject j_object,
+                                   jlong j_runtime_id,
+                                   jlong j_sample_interval,
+                                   jint j_stack_depth) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "StartSamplingHeapProfiler, j_runtime_id invalid";
+    return JNI_FALSE;
+  }
+  v8::Isolate *isolate = std::static_pointer_cast<V8VM>(runtime->GetEngine()->GetVM())->isolate_;
+  uint64_t sample_interval = j_sample_interval > 0 ? static_cast<uint64_t>(j_sample_interval)
+                                                   : V8HeapProfiler::kDefaultSampleInterval;
+  int stack_depth = j_stack_depth > 0 ? j_stack_depth : V8HeapProfiler::kDefaultStackDepth;
+  bool is_started = V8HeapProfiler::StartSamplingHeapProfiler(isolate, sample_interval, stack_depth);
+  TDF_BASE_DLOG(INFO) << "StartSamplingHeapProfiler, is_started = " << is_started;
+  return is_started ? JNI_TRUE : JNI_FALSE;
+}
+// [Heap] WriteSamplingHeapProfile
+jboolean WriteSamplingHeapProfile(__unused JNIEnv *j_env,
+                                  __unused jobject j_object,
+                                  jlong j_runtime_id,
+                                  jstring j_heap_profile_path,
+                                  jobject j_callback) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  std::shared_ptr<JavaRef> cb = std::make_shared<JavaRef>(j_env, j_callback);
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "WriteSamplingHeapProfile, j_runtime_id invalid";
+    CallbackHeapWriteResult(j_env, cb, HEAP_WRITE_ERR_RUN);
+    return JNI_FALSE;
+  }
+  const unicode_string_view heap_profile_path = JniUtils::ToStrView(j_env, j_heap_profile_path);
+  v8::Isolate *isolate = std::static_pointer_cast<V8VM>(runtime->GetEngine()->GetVM())->isolate_;
+  HEAP_WRITE code = WriteHeapFile(heap_profile_path, [isolate](int fd) {
+    return V8HeapProfiler::WriteSamplingHeapProfile(isolate, fd);
+  });
+  TDF_BASE_DLOG(INFO) << "WriteSamplingHeapProfile end, code = " << static_cast<int>(code);
+  CallbackHeapWriteResult(j_env, cb, code);
+  return code == HEAP_WRITE_OK ? JNI_TRUE : JNI_FALSE;
+}
+// [Heap] StopSamplingHeapProfiler
+void StopSamplingHeapProfiler(__unused JNIEnv *j_env,
+                              __unused jobject j_object,
+                              jlong j_runtime_id) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "StopSamplingHeapProfiler, j_runtime_id invalid";
+    return;
+  }
+  v8::Isolate *isolate = std::static_pointer_cast<V8VM>(runtime->GetEngine()->GetVM())->isolate_;
+  V8HeapProfiler::StopSamplingHeapProfiler(isolate);
+}
 
 //#endif
 
@@ -0,0 +1,91 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "v8/cpu_profiler.h"
+
+#include "bridge/runtime.h"
+#include "jni/jni_env.h"
+#include "jni/jni_utils.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace v8_engine {
+
+REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
+             "startCpuProfiling",
+             "(JII)Z",
+             StartCpuProfiling)
+
+REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
+             "stopCpuProfiling",
+             "(JLjava/lang/String;Lcom/tencent/mtt/hippy/common/Callback;)Z",
+             StopCpuProfiling)
+
+jboolean StartCpuProfiling(JNIEnv *j_env,
+                           jobject j_object,
+                           jlong j_runtime_id,
+                           jint j_sampling_interval_us,
+                           jint j_max_duration_ms) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "StartCpuProfiling, j_runtime_id invalid";
+    return JNI_FALSE;
+  }
+  uint32_t max_duration_ms = j_max_duration_ms > 0 ? static_cast<uint32_t>(j_max_duration_ms) : 0;
+  bool is_started = runtime->GetEngine()->StartCpuProfiling(j_sampling_interval_us, max_duration_ms);
+  return is_started ? JNI_TRUE : JNI_FALSE;
+}
+
+jboolean StopCpuProfiling(JNIEnv *j_env,
+                          jobject j_object,
+                          jlong j_runtime_id,
+                          jstring j_file_path,
+                          jobject j_callback) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  if (!runtime) {
+    TDF_BASE_DLOG(WARNING) << "StopCpuProfiling, j_runtime_id invalid";
+    return JNI_FALSE;
+  }
+  auto file_path = JniUtils::ToStrView(j_env, j_file_path);
+  auto cb = std::make_shared<JavaRef>(j_env, j_callback);
+  bool has_profile = runtime->GetEngine()->StopCpuProfiling(file_path, [cb](bool is_written) {
+    auto env = JNIEnvironment::GetInstance()->AttachCurrentThread();
+    auto j_cb = cb->GetObj();
+    auto j_cb_class = env->GetObjectClass(j_cb);
+    auto j_cb_method_id = env->GetMethodID(j_cb_class, "callback",
+                                             "(Ljava/lang/Object;Ljava/lang/Throwable;)V");
+    auto j_boolean_class = env->FindClass("java/lang/Boolean");
+    auto j_value_of = env->GetStaticMethodID(j_boolean_class, "valueOf", "(Z)Ljava/lang/Boolean;");
+    auto j_is_written = env->CallStaticObjectMethod(j_boolean_class, j_value_of,
+                                                      is_written ? JNI_TRUE : JNI_FALSE);
+    env->CallVoidMethod(j_cb, j_cb_method_id, j_is_written, nullptr);
+    JNIEnvironment::ClearJEnvException(env);
+    env->DeleteLocalRef(j_is_written);
+    env->DeleteLocalRef(j_boolean_class);
+    env->DeleteLocalRef(j_cb_class);
+  });
+  return has_profile ? JNI_TRUE : JNI_FALSE;
+}
+
+}
+}
+}
@@ -0,0 +1,103 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "v8/hang_watchdog.h"
+
+#include "bridge/runtime.h"
+#include "jni/jni_env.h"
+#include "jni/jni_utils.h"
+#include "v8/stack_trace.h"
+
+namespace hippy {
+inline namespace driver {
+inline namespace v8_engine {
+
+using unicode_string_view = tdf::base::unicode_string_view;
+
+REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
+             "setHangWatchdog",
+             "(JJLcom/tencent/mtt/hippy/v8/V8$HangCallback;)V",
+             SetHangWatchdog)
+
+void SetHangWatchdog(JNIEnv *j_env,
+                     jobject j_object,
+                     jlong j_runtime_id,
+                     jlong j_threshold_ms,
+                     jobject j_callback) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  TDF_BASE_CHECK(runtime);
+  // the previous watchdog stops here
+  runtime->SetHangWatchdog(nullptr);
+  if (j_threshold_ms <= 0 || !j_callback) {
+    return;
+  }
+
+  auto cb = std::make_shared<JavaRef>(j_env, j_callback);
+  auto watchdog = std::make_shared<HangWatchdog>(
+      runtime->GetEngine()->GetJSRunner(),
+      hippy::base::checked_numeric_cast<jlong, uint64_t>(j_threshold_ms),
+      [cb](const HangWatchdog::HangInfo& info) {
+        auto env = JNIEnvironment::GetInstance()->AttachCurrentThread();
+        auto j_cb = cb->GetObj();
+        auto j_cb_class = env->GetObjectClass(j_cb);
+        auto j_cb_method_id = env->GetMethodID(j_cb_class, "onHang",
+                                                 "(JLjava/lang/String;Ljava/lang/String;)V");
+        auto j_origin = JniUtils::StrViewToJString(
+            env, unicode_string_view(info.origin ? info.origin : "unknown"));
+        auto j_stack = JniUtils::StrViewToJString(env, info.js_stack);
+        env->CallVoidMethod(j_cb, j_cb_method_id,
+                              hippy::base::checked_numeric_cast<uint64_t, jlong>(info.elapsed_ms),
+                              j_origin, j_stack);
+        JNIEnvironment::ClearJEnvException(env);
+        env->DeleteLocalRef(j_origin);
+        env->DeleteLocalRef(j_stack);
+        env->DeleteLocalRef(j_cb_class);
+      });
+
+  // the interrupt runs inside the stalled task, so the stack is the one that
+  // hangs; nothing that must die on the js thread is locked on the watchdog thread
+  std::weak_ptr<hippy::InterruptQueue> weak_queue = runtime->GetInterruptQueue();
+  std::weak_ptr<Scope> weak_scope = runtime->GetScope();
+  watchdog->SetStackSampler([weak_queue, weak_scope](std::function<void(unicode_string_view)> done) {
+    auto queue = weak_queue.lock();
+    if (!queue) {
+      done(unicode_string_view());
+      return;
+    }
+    auto task = std::make_unique<JavaScriptTask>();
+    task->callback = [weak_scope, done = std::move(done)]() {
+      auto scope = weak_scope.lock();
+      if (!scope) {
+        done(unicode_string_view());
+        return;
+      }
+      auto ctx = std::static_pointer_cast<hippy::napi::V8Ctx>(scope->GetContext());
+      done(CaptureCurrentStackTrace(ctx));
+    };
+    queue->PostTask(std::move(task));
+  });
+  runtime->SetHangWatchdog(watchdog);
+}
+
+}
+}
+}
@@ -43,14 +43,12 @@ void InterruptQueue::PostTask(std::unique_ptr<Task> task) {
 
   if (task_runner_) {
     auto weak_self = weak_from_this();
-    auto js_task = std::make_unique<JavaScriptTask>();
-    js_task->callback = [weak_self]() {
+    task_runner_->PostFunction([weak_self]() {
       auto self = weak_self.lock();
       if (self) {
         self->Run();
       }
-    };
-    task_runner_->PostTask(std::move(js_task));
+    });
   }
 
   isolate_->RequestInterrupt([](v8::Isolate* isolate, void* data) {
@@ -42,26 +42,29 @@ REGISTER_JNI("com/tencent/mtt/hippy/v8/V8", // NOLINT(cert-err58-cpp)
               "(JLcom/tencent/mtt/hippy/common/Callback;)V",
               GetCurrentStackTrace)
 
-
-void GetCurrentStackTrace(JNIEnv *j_env,
-                          jobject j_object,
-                          jlong j_runtime_id,
-                          jobject j_callback) {
-  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
-  TDF_BASE_CHECK(runtime);
-
-  auto ctx = std::static_pointer_cast<hippy::napi::V8Ctx>( runtime->GetScope()->GetContext());
+tdf::base::unicode_string_view CaptureCurrentStackTrace(const std::shared_ptr<hippy::napi::V8Ctx>& ctx) {
   v8::Isolate *isolate = ctx->isolate_;
   v8::HandleScope handle_scope(isolate);
 #if V8_MAJOR_VERSION >= 9
   std::ostringstream trace;
   v8::Message::PrintCurrentStackTrace(isolate, trace);
   auto trace_str = trace.str();
-  auto trace_info = tdf::base::unicode_string_view::new_from_utf8(trace_str.c_str(), trace_str.length());
+  return tdf::base::unicode_string_view::new_from_utf8(trace_str.c_str(), trace_str.length());
 #else
   auto trace = v8::StackTrace::CurrentStackTrace(isolate, kFrameLimit);
-  auto trace_info = ctx->GetStackTrace(trace);
+  return ctx->GetStackTrace(trace);
 #endif
+}
+
+void GetCurrentStackTrace(JNIEnv *j_env,
+                          jobject j_object,
+                          jlong j_runtime_id,
+                          jobject j_callback) {
+  auto runtime = Runtime::Find(hippy::base::checked_numeric_cast<jlong, int32_t>(j_runtime_id));
+  TDF_BASE_CHECK(runtime);
+
+  auto ctx = std::static_pointer_cast<hippy::napi::V8Ctx>( runtime->GetScope()->GetContext());
+  auto trace_info = CaptureCurrentStackTrace(ctx);
 
   auto j_cb_class = j_env->GetObjectClass(j_callback);
   auto j_cb_method_id = j_env->GetMethodID(j_cb_class, "callback",
@@ -0,0 +1,123 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Counts heap allocations per posted task once the runner is warm, for a
+// JavaScriptTask holding a std::function and for TaskRunner::PostFunction.
+// The captures mirror CallFunction in java2js.cc: a weak scope, a shared
+// java reference and a few plain values.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+
+#include "core/base/task_runner.h"
+#include "core/task/javascript_task.h"
+
+namespace {
+
+constexpr int kWarmUpCount = 100000;
+constexpr int kPostCount = 200000;
+
+std::atomic<uint64_t> g_allocation_count(0);
+
+}  // namespace
+
+void* operator new(size_t size) {
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+namespace {
+
+using TaskRunner = hippy::base::TaskRunner;
+
+struct Payload {
+  std::weak_ptr<int> scope;
+  std::shared_ptr<int> java_ref;
+  uint64_t id;
+  uint32_t flags;
+};
+
+template <typename Post>
+void RunCase(const char* name, Post post) {
+  auto runner = std::make_shared<TaskRunner>();
+  runner->Start();
+  auto scope = std::make_shared<int>(0);
+  auto java_ref = std::make_shared<int>(0);
+  std::atomic<int> counter(0);
+
+  auto post_all = [&](int count) {
+    int target = counter.load() + count;
+    for (int i = 0; i < count; ++i) {
+      Payload payload{scope, java_ref, static_cast<uint64_t>(i), 0};
+      post(*runner, [payload, &counter] {
+        if (!payload.scope.expired()) {
+          counter.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+    }
+    while (counter.load(std::memory_order_relaxed) < target) {
+      std::this_thread::yield();
+    }
+  };
+
+  post_all(kWarmUpCount);
+  uint64_t allocation_count = g_allocation_count.load();
+  auto start = std::chrono::steady_clock::now();
+  post_all(kPostCount);
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  allocation_count = g_allocation_count.load() - allocation_count;
+  runner->Terminate();
+
+  printf("%-16s | %.3f allocations per task | %4.0f ns per post and run\n", name,
+         static_cast<double>(allocation_count) / kPostCount, elapsed / kPostCount);
+}
+
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+  RunCase("std::function", [](TaskRunner& runner, auto&& callable) {
+    auto task = std::make_shared<JavaScriptTask>();
+    task->callback = std::forward<decltype(callable)>(callable);
+    runner.PostTask(std::move(task));
+  });
+  RunCase("PostFunction", [](TaskRunner& runner, auto&& callable) {
+    runner.PostFunction(std::forward<decltype(callable)>(callable));
+  });
+  return 0;
+}
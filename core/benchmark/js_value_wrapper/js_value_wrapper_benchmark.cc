@@ -0,0 +1,88 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Converts a 10k element payload between v8 and JSValueWrapper in both
+// directions and reports the time per conversion:
+//   hippy_js_value_wrapper_benchmark [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "core/base/js_value_wrapper.h"
+#include "core/napi/js_ctx.h"
+#include "core/napi/v8/v8_ctx.h"
+#include "core/vm/v8/v8_vm.h"
+
+using CtxValue = hippy::napi::CtxValue;
+using JSValueWrapper = hippy::base::JSValueWrapper;
+using V8Ctx = hippy::napi::V8Ctx;
+using V8VM = hippy::vm::V8VM;
+using V8VMInitParam = hippy::vm::V8VMInitParam;
+
+namespace {
+
+constexpr int kDefaultIterations = 100;
+constexpr char kPayloadScript[] =
+    "Array.from({ length: 10000 }, (_, i) => ({ id: i, name: 'View' + i, visible: i % 2 === 0,"
+    " props: { style: { width: i, height: 20 }, children: [i, i + 1] } }))";
+
+template <typename Convert>
+void Run(const char* name, Convert convert, int iterations) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    convert();
+  }
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  fprintf(stdout, "%-16s %lld us per conversion\n", name,
+          static_cast<long long>(duration.count() / iterations));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : kDefaultIterations;
+  if (iterations <= 0) {
+    iterations = kDefaultIterations;
+  }
+
+  auto vm = std::make_shared<V8VM>(std::make_shared<V8VMInitParam>());
+  auto ctx = std::static_pointer_cast<V8Ctx>(vm->CreateContext());
+  ctx->SetExternalData(nullptr);
+
+  std::shared_ptr<CtxValue> payload = ctx->RunScript(kPayloadScript, "payload.js");
+  if (!ctx->IsArray(payload)) {
+    fprintf(stderr, "payload script failed\n");
+    return 1;
+  }
+  std::shared_ptr<JSValueWrapper> wrapper = ctx->ToJsValueWrapper(payload);
+  if (!wrapper || *ctx->ToJsValueWrapper(ctx->CreateCtxValue(wrapper)) != *wrapper) {
+    fprintf(stderr, "payload does not survive a round trip\n");
+    return 1;
+  }
+
+  Run("v8 to wrapper", [&ctx, &payload] { ctx->ToJsValueWrapper(payload); }, iterations);
+  Run("wrapper to v8", [&ctx, &wrapper] { ctx->CreateCtxValue(wrapper); }, iterations);
+  return 0;
+}
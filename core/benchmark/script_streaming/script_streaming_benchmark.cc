@@ -0,0 +1,167 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Streams a large generated script from a file through the pipeline of
+// LoadUntrustedContent, parsing it on a worker while it is read, and checks
+// that it gives the same result as running the whole file. Reports the time
+// spent on the js thread by both:
+//   hippy_script_streaming_benchmark [function count]
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "base/unicode_string_view.h"
+#include "core/base/source_buffer.h"
+#include "core/base/source_stream.h"
+#include "core/base/string_view_utils.h"
+#include "core/napi/js_ctx.h"
+#include "core/napi/v8/v8_ctx.h"
+#include "core/napi/v8/v8_streamed_script.h"
+#include "core/task/worker_task_runner.h"
+#include "core/vm/v8/v8_vm.h"
+
+using unicode_string_view = tdf::base::unicode_string_view;
+using CtxValue = hippy::napi::CtxValue;
+using SourceBuffer = hippy::base::SourceBuffer;
+using SourceStream = hippy::base::SourceStream;
+using StringViewUtils = hippy::base::StringViewUtils;
+using V8Ctx = hippy::napi::V8Ctx;
+using V8StreamedScript = hippy::napi::V8StreamedScript;
+using V8VM = hippy::vm::V8VM;
+using V8VMInitParam = hippy::vm::V8VMInitParam;
+
+namespace {
+
+constexpr int kDefaultFunctionCount = 50000;
+constexpr char kFileName[] = "streaming.js";
+
+// non ascii names make v8 join multi byte characters split between chunks
+std::string GenerateScript(int function_count) {
+  std::string script = "var checksum = 0;\n";
+  for (int i = 0; i < function_count; ++i) {
+    std::string index = std::to_string(i);
+    script += "function f" + index + "(x) { var s = '\xe6\xb5\x8b\xe8\xaf\x95-" + index +
+              "'; return x + s.length * " + index + "; }\n";
+    script += "checksum = f" + index + "(checksum) % 1000000007;\n";
+  }
+  script += "'checksum:' + checksum;\n";
+  return script;
+}
+
+std::string ToStdString(const std::shared_ptr<V8Ctx>& ctx, const std::shared_ptr<CtxValue>& value) {
+  unicode_string_view result;
+  if (!value || !ctx->GetValueString(value, &result)) {
+    return "";
+  }
+  return StringViewUtils::ToU8StdStr(result);
+}
+
+std::string RunBuffered(const std::shared_ptr<V8VM>& vm, const std::string& path, long long* js_us) {
+  auto ctx = std::static_pointer_cast<V8Ctx>(vm->CreateContext());
+  ctx->SetExternalData(nullptr);
+  auto start = std::chrono::steady_clock::now();
+  auto source = SourceBuffer::FromFile(unicode_string_view(path));
+  auto value = ctx->RunScript(source, kFileName, false, nullptr);
+  *js_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count();
+  return ToStdString(ctx, value);
+}
+
+std::string RunStreamed(const std::shared_ptr<V8VM>& vm,
+                        const std::shared_ptr<WorkerTaskRunner>& runner,
+                        const std::string& path,
+                        long long* js_us) {
+  auto ctx = std::static_pointer_cast<V8Ctx>(vm->CreateContext());
+  ctx->SetExternalData(nullptr);
+  auto start = std::chrono::steady_clock::now();
+  auto stream = SourceStream::FromFile(unicode_string_view(path));
+  auto script = stream ? V8StreamedScript::Start(vm->isolate_, stream) : nullptr;
+  if (!script) {
+    fprintf(stderr, "v8 cannot stream %s\n", path.c_str());
+    return "";
+  }
+  long long started_us = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count();
+
+  std::promise<void> parsed;
+  auto task = std::make_unique<CommonTask>();
+  task->func_ = [script, &parsed] {
+    script->Parse();
+    parsed.set_value();
+  };
+  runner->PostTask(std::move(task));
+  parsed.get_future().wait();
+
+  start = std::chrono::steady_clock::now();
+  auto value = ctx->RunScript(script, stream->TakeContent(), kFileName);
+  *js_us = started_us + std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count();
+  return ToStdString(ctx, value);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int function_count = argc > 1 ? atoi(argv[1]) : kDefaultFunctionCount;
+  if (function_count <= 0) {
+    function_count = kDefaultFunctionCount;
+  }
+
+  char path[] = "/tmp/hippy_script_streamingXXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    fprintf(stderr, "cannot create the script file\n");
+    return 1;
+  }
+  std::string script = GenerateScript(function_count);
+  bool is_written = write(fd, script.c_str(), script.length()) == static_cast<ssize_t>(script.length());
+  close(fd);
+  if (!is_written) {
+    unlink(path);
+    fprintf(stderr, "cannot write the script file\n");
+    return 1;
+  }
+
+  auto vm = std::make_shared<V8VM>(std::make_shared<V8VMInitParam>());
+  auto runner = std::make_shared<WorkerTaskRunner>(1);
+  long long buffered_us = 0;
+  long long streamed_us = 0;
+  std::string buffered = RunBuffered(vm, path, &buffered_us);
+  std::string streamed = RunStreamed(vm, runner, path, &streamed_us);
+  runner->Terminate();
+  unlink(path);
+
+  fprintf(stdout, "script of %zu bytes, %s\n", script.length(), buffered.c_str());
+  fprintf(stdout, "%-9s %lld us on the js thread\n", "buffered", buffered_us);
+  fprintf(stdout, "%-9s %lld us on the js thread\n", "streamed", streamed_us);
+  if (buffered.empty() || buffered != streamed) {
+    fprintf(stderr, "streamed result \"%s\" does not match \"%s\"\n", streamed.c_str(), buffered.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,295 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Compares TaskRunner with a runner that takes a mutex and notifies a
+// condition variable for every post, as TaskRunner did before the MPSC queue:
+//   - posts per second with 1 and 4 producer threads
+//   - wake up latency of a parked runner
+// and TaskRunner's timer wheel with the priority queue it replaced, on a
+// setTimeout/clearTimeout debounce churn of 100k timers
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdio>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "core/base/base_time.h"
+#include "core/base/task.h"
+#include "core/base/task_runner.h"
+
+using Task = hippy::base::Task;
+using TaskRunner = hippy::base::TaskRunner;
+
+namespace {
+
+constexpr int kPostCount = 400000;
+constexpr int kWakeUpCount = 2000;
+constexpr auto kWakeUpInterval = std::chrono::microseconds(500);
+constexpr int kTimerCount = 100000;
+constexpr uint64_t kMaxTimerDelay = 60 * 1000;
+
+class CountTask : public Task {
+ public:
+  explicit CountTask(std::atomic<int>& counter) : counter_(counter) {}
+
+  bool isPriorityTask() override { return false; }
+  void Run() override { counter_.fetch_add(1, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<int>& counter_;
+};
+
+class StampTask : public Task {
+ public:
+  StampTask(std::vector<uint64_t>& latencies, std::atomic<int>& counter)
+      : post_time_(hippy::base::MonotonicallyIncreasingTimeInUs()), latencies_(latencies), counter_(counter) {}
+
+  bool isPriorityTask() override { return false; }
+  void Run() override {
+    latencies_.push_back(hippy::base::MonotonicallyIncreasingTimeInUs() - post_time_);
+    counter_.fetch_add(1, std::memory_order_release);
+  }
+
+ private:
+  uint64_t post_time_;
+  std::vector<uint64_t>& latencies_;
+  std::atomic<int>& counter_;
+};
+
+class TimerTask : public Task {
+ public:
+  TimerTask() { live_count_.fetch_add(1, std::memory_order_relaxed); }
+  ~TimerTask() override { live_count_.fetch_sub(1, std::memory_order_relaxed); }
+
+  bool isPriorityTask() override { return false; }
+  void Run() override {}
+
+  static int LiveCount() { return live_count_.load(std::memory_order_relaxed); }
+
+ private:
+  static std::atomic<int> live_count_;
+};
+
+std::atomic<int> TimerTask::live_count_(0);
+
+// the old TaskRunner delayed queue: cancel sets a flag and the entry stays
+// in the heap until its deadline
+class HeapTimers {
+ public:
+  void PostDelayedTask(std::shared_ptr<Task> task, uint64_t delay_in_milliseconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push({hippy::base::MonotonicallyIncreasingTime() + delay_in_milliseconds, std::move(task)});
+  }
+
+  void CancelTask(const std::shared_ptr<Task>& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task->canceled_ = true;
+  }
+
+ private:
+  struct Entry {
+    uint64_t deadline;
+    std::shared_ptr<Task> task;
+    bool operator<(const Entry& other) const { return deadline > other.deadline; }
+  };
+
+  std::mutex mutex_;
+  std::priority_queue<Entry> queue_;
+};
+
+// the old TaskRunner queue: lock and notify per post, lock per run
+class LockedRunner {
+ public:
+  LockedRunner() : thread_([this] { Run(); }) {}
+
+  ~LockedRunner() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_terminated_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  void PostTask(std::shared_ptr<Task> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void Run() {
+    for (;;) {
+      std::shared_ptr<Task> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return is_terminated_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        task = std::move(queue_.front());
+        queue_.pop();
+      }
+      bool canceled;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        canceled = task->canceled_;
+      }
+      if (!canceled) {
+        task->Run();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::queue<std::shared_ptr<Task>> queue_;
+  bool is_terminated_ = false;
+  std::thread thread_;
+};
+
+template <typename Post>
+void RunPostCase(const char* name, int producer_count, Post post) {
+  std::atomic<int> counter(0);
+  int per_producer = kPostCount / producer_count;
+  int total = per_producer * producer_count;
+  // tasks are created up front, the case measures the queue and not malloc
+  std::vector<std::vector<std::shared_ptr<Task>>> tasks(producer_count);
+  for (auto& list : tasks) {
+    for (int i = 0; i < per_producer; ++i) {
+      list.push_back(std::make_shared<CountTask>(counter));
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  for (int p = 0; p < producer_count; ++p) {
+    producers.emplace_back([&tasks, &post, p] {
+      for (auto& task : tasks[p]) {
+        post(std::move(task));
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  while (counter.load(std::memory_order_relaxed) < total) {
+    std::this_thread::yield();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%-12s producers %d | %8.0f k posts/s\n", name, producer_count, total / elapsed / 1000);
+}
+
+template <typename Post>
+void RunWakeUpCase(const char* name, Post post) {
+  std::atomic<int> counter(0);
+  std::vector<uint64_t> latencies;
+  latencies.reserve(kWakeUpCount);
+  for (int i = 0; i < kWakeUpCount; ++i) {
+    // let the runner park before every post
+    std::this_thread::sleep_for(kWakeUpInterval);
+    post(std::make_shared<StampTask>(latencies, counter));
+    while (counter.load(std::memory_order_acquire) <= i) {
+      std::this_thread::yield();
+    }
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    return static_cast<unsigned long long>(latencies[static_cast<size_t>(p * (latencies.size() - 1))]);
+  };
+  printf("%-12s wake up us | p50 %4llu p90 %4llu p99 %4llu max %5llu\n", name, percentile(0.5),
+         percentile(0.9), percentile(0.99), percentile(1));
+}
+
+// every new timer clears the previous one, like a debounced input handler
+template <typename Timers>
+void RunTimerChurnCase(const char* name, Timers& timers) {
+  std::mt19937 random(42);
+  std::uniform_int_distribution<uint64_t> delay(1, kMaxTimerDelay);
+  int live_before = TimerTask::LiveCount();
+  std::shared_ptr<Task> previous;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kTimerCount; ++i) {
+    auto task = std::make_shared<TimerTask>();
+    timers.PostDelayedTask(task, delay(random));
+    if (previous) {
+      timers.CancelTask(previous);
+    }
+    previous = std::move(task);
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  previous.reset();
+  printf("%-12s %d timers | %5.0f ns per schedule and cancel | %6d cancelled timers still held\n", name,
+         kTimerCount, elapsed / kTimerCount, TimerTask::LiveCount() - live_before - 1);
+}
+
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+  printf("cpus %u\n", std::thread::hardware_concurrency());
+  for (int producer_count : {1, 4}) {
+    {
+      LockedRunner runner;
+      RunPostCase("locked", producer_count, [&runner](std::shared_ptr<Task> task) {
+        runner.PostTask(std::move(task));
+      });
+    }
+    {
+      auto runner = std::make_shared<TaskRunner>();
+      runner->Start();
+      RunPostCase("task runner", producer_count, [&runner](std::shared_ptr<Task> task) {
+        runner->PostTask(std::move(task));
+      });
+      runner->Terminate();
+    }
+  }
+  {
+    LockedRunner runner;
+    RunWakeUpCase("locked", [&runner](std::shared_ptr<Task> task) { runner.PostTask(std::move(task)); });
+  }
+  {
+    auto runner = std::make_shared<TaskRunner>();
+    runner->Start();
+    RunWakeUpCase("task runner", [&runner](std::shared_ptr<Task> task) { runner->PostTask(std::move(task)); });
+    runner->Terminate();
+  }
+  {
+    HeapTimers timers;
+    RunTimerChurnCase("heap", timers);
+  }
+  {
+    auto runner = std::make_shared<TaskRunner>();
+    runner->Start();
+    RunTimerChurnCase("timer wheel", *runner);
+    runner->Terminate();
+  }
+  return 0;
+}
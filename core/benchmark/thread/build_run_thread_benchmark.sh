@@ -0,0 +1,35 @@
+#! /bin/bash
+# usage: build_run_thread_benchmark.sh [js nice value] [js cpu affinity mask]
+# needs ANDROID_NDK and a device reachable by adb
+
+CMAKE=`which cmake`
+MAKE=`which make`
+ADB=`which adb`
+
+if [ -z "${ANDROID_NDK}" ]; then
+  echo "ANDROID_NDK is not set"
+  exit 1
+fi
+
+BASH_SOURCE_DIR=$(cd `dirname "${BASH_SOURCE[0]}"` && pwd)
+BUILD_DIR="${BASH_SOURCE_DIR}"/../../out
+
+rm -rf "${BUILD_DIR}"/threadbenchmark
+mkdir -p "${BUILD_DIR}"/threadbenchmark
+cd "${BUILD_DIR}"/threadbenchmark
+
+#cmake generate make file
+"${CMAKE}" "${BASH_SOURCE_DIR}" \
+  -DCMAKE_TOOLCHAIN_FILE="${ANDROID_NDK}"/build/cmake/android.toolchain.cmake \
+  -DANDROID_ABI=arm64-v8a \
+  -DANDROID_PLATFORM=android-21
+
+echo "Start build in directory: `pwd`"
+${MAKE}
+
+#run hippy_thread_benchmark on the device
+BENCHMARK_RUN_PATH="${BUILD_DIR}"/threadbenchmark/hippy_thread_benchmark
+if [ -x "${BENCHMARK_RUN_PATH}" ];then
+"${ADB}" push "${BENCHMARK_RUN_PATH}" /data/local/tmp/hippy_thread_benchmark
+"${ADB}" shell /data/local/tmp/hippy_thread_benchmark "$@"
+fi
@@ -0,0 +1,130 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures how long js tasks wait for the js thread while every core is busy
+// with background work, with the default scheduling and with the options
+// given on the command line:
+//   hippy_thread_benchmark [js nice value] [js cpu affinity mask]
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/base/task_stats.h"
+#include "core/base/thread.h"
+#include "core/task/javascript_task_runner.h"
+
+using Thread = hippy::base::Thread;
+using TaskStats = hippy::base::TaskStats;
+
+namespace {
+
+constexpr int kTaskCount = 500;
+constexpr auto kPostInterval = std::chrono::milliseconds(4);
+constexpr auto kTaskWork = std::chrono::microseconds(500);
+constexpr int kDefaultPriority = -8;
+constexpr char kOrigin[] = "benchmark";
+
+class LoadThread : public Thread {
+ public:
+  explicit LoadThread(std::atomic<bool>& running) : Thread(Options("hippy.load")), running_(running) {}
+
+  void Run() override {
+    volatile uint64_t sink = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+      sink = sink + 1;
+    }
+  }
+
+ private:
+  std::atomic<bool>& running_;
+};
+
+void Spin(std::chrono::microseconds duration) {
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+void RunCase(const char* name, const Thread::Options& options, uint32_t load_thread_count) {
+  std::atomic<bool> running(true);
+  std::vector<std::unique_ptr<LoadThread>> load_threads;
+  for (uint32_t i = 0; i < load_thread_count; ++i) {
+    load_threads.push_back(std::make_unique<LoadThread>(running));
+    load_threads.back()->Start();
+  }
+
+  auto runner = std::make_shared<JavaScriptTaskRunner>(options);
+  runner->SetTaskStatsEnabled(true);
+  runner->Start();
+  for (int i = 0; i < kTaskCount; ++i) {
+    runner->PostFunction([] { Spin(kTaskWork); }, JavaScriptTaskRunner::Priority::kNormal, kOrigin);
+    std::this_thread::sleep_for(kPostInterval);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  runner->Terminate();
+
+  running = false;
+  for (auto& thread : load_threads) {
+    thread->Join();
+  }
+
+  for (const auto& stats : runner->GetTaskStats().GetSnapshot()) {
+    if (stats.origin != kOrigin) {
+      continue;
+    }
+    printf("%-26s tasks %4llu | wait us p50 %6llu p90 %6llu p99 %6llu max %6llu | run us p50 %6llu p99 %6llu\n",
+           name,
+           static_cast<unsigned long long>(stats.queue_wait.Count()),
+           static_cast<unsigned long long>(stats.queue_wait.Percentile(0.5)),
+           static_cast<unsigned long long>(stats.queue_wait.Percentile(0.9)),
+           static_cast<unsigned long long>(stats.queue_wait.Percentile(0.99)),
+           static_cast<unsigned long long>(stats.queue_wait.Max()),
+           static_cast<unsigned long long>(stats.run_time.Percentile(0.5)),
+           static_cast<unsigned long long>(stats.run_time.Percentile(0.99)));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+  int priority = argc > 1 ? atoi(argv[1]) : kDefaultPriority;
+  uint64_t affinity_mask = argc > 2 ? strtoull(argv[2], nullptr, 0) : 0;
+  auto cpu_count = static_cast<uint32_t>(sysconf(_SC_NPROCESSORS_ONLN));
+  // buckets are powers of two, percentiles are bucket upper bounds
+  printf("cpus %u, js nice %d, js affinity 0x%llx\n", cpu_count, priority,
+         static_cast<unsigned long long>(affinity_mask));
+
+  Thread::Options tuned;
+  tuned.set_priority(priority).set_affinity_mask(affinity_mask);
+
+  RunCase("idle, default", Thread::Options(), 0);
+  RunCase("loaded, default", Thread::Options(), cpu_count * 2);
+  RunCase("loaded, tuned", tuned, cpu_count * 2);
+  return 0;
+}
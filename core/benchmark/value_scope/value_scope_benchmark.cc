@@ -0,0 +1,166 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Makes the bridge call of java2js, hippyBridge(action, params) with params
+// read by a v8::ValueDeserializer, once with every value held as a persistent
+// CtxValue and once inside a ValueScope. Reports the global handle bytes in
+// use while the bridge function runs and the time per call:
+//   hippy_value_scope_benchmark [calls]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "base/unicode_string_view.h"
+#include "core/napi/callback_info.h"
+#include "core/napi/js_ctx.h"
+#include "core/napi/v8/v8_ctx.h"
+#include "core/napi/v8/v8_ctx_value.h"
+#include "core/napi/value_scope.h"
+#include "core/vm/v8/v8_vm.h"
+
+using unicode_string_view = tdf::base::unicode_string_view;
+using CallbackInfo = hippy::napi::CallbackInfo;
+using CtxValue = hippy::napi::CtxValue;
+using FuncWrapper = hippy::napi::FuncWrapper;
+using LocalValue = hippy::napi::LocalValue;
+using V8Ctx = hippy::napi::V8Ctx;
+using V8CtxValue = hippy::napi::V8CtxValue;
+using ValueScope = hippy::napi::ValueScope;
+using V8VM = hippy::vm::V8VM;
+using V8VMInitParam = hippy::vm::V8VMInitParam;
+
+namespace {
+
+constexpr int kDefaultCalls = 100000;
+constexpr int kProbeCalls = 100;
+constexpr char kAction[] = "callBack";
+constexpr char kBridgeScript[] = "(function(action, params) { probe(); return params.length; })";
+constexpr char kPayloadScript[] =
+    "Array.from({ length: 20 }, (_, i) => ({ id: i, name: 'View', props: { style: { width: i } } }))";
+
+v8::Isolate* isolate = nullptr;
+bool probe_enabled = false;
+size_t peak_global_handles = 0;
+
+size_t UsedGlobalHandles() {
+  v8::HeapStatistics statistics;
+  isolate->GetHeapStatistics(&statistics);
+  return statistics.used_global_handles_size();
+}
+
+void Probe(const CallbackInfo& info, void* data) {
+  if (!probe_enabled) {
+    return;
+  }
+  size_t used = UsedGlobalHandles();
+  if (used > peak_global_handles) {
+    peak_global_handles = used;
+  }
+}
+
+v8::Local<v8::Value> Deserialize(const std::shared_ptr<V8Ctx>& ctx, const std::string& payload) {
+  v8::Local<v8::Context> context = ctx->context_persistent_.Get(isolate);
+  v8::ValueDeserializer deserializer(isolate, reinterpret_cast<const uint8_t*>(payload.c_str()),
+                                     payload.length());
+  if (!deserializer.ReadHeader(context).FromMaybe(false)) {
+    return v8::Local<v8::Value>();
+  }
+  return deserializer.ReadValue(context).FromMaybe(v8::Local<v8::Value>());
+}
+
+// java2js before ValueScope
+void CallPersistent(const std::shared_ptr<V8Ctx>& ctx,
+                    const std::shared_ptr<CtxValue>& bridge,
+                    const std::string& payload) {
+  std::shared_ptr<CtxValue> action = ctx->CreateString(kAction);
+  std::shared_ptr<CtxValue> params;
+  {
+    v8::HandleScope handle_scope(isolate);
+    v8::Context::Scope context_scope(ctx->context_persistent_.Get(isolate));
+    params = std::make_shared<V8CtxValue>(isolate, Deserialize(ctx, payload));
+  }
+  std::shared_ptr<CtxValue> argv[] = {action, params};
+  ctx->CallFunction(bridge, 2, argv);
+}
+
+void CallScoped(const std::shared_ptr<V8Ctx>& ctx,
+                const std::shared_ptr<CtxValue>& bridge,
+                const std::string& payload) {
+  ValueScope value_scope(ctx);
+  v8::Context::Scope context_scope(ctx->context_persistent_.Get(isolate));
+  LocalValue action = ctx->CreateStringLocal(kAction);
+  LocalValue params = hippy::napi::ToLocalValue(Deserialize(ctx, payload));
+  LocalValue argv[] = {action, params};
+  ctx->CallFunctionLocal(bridge, 2, argv);
+}
+
+template <typename Call>
+void Run(const char* name, Call call, int calls) {
+  size_t baseline = UsedGlobalHandles();
+  peak_global_handles = baseline;
+  probe_enabled = true;
+  for (int i = 0; i < kProbeCalls; ++i) {
+    call();
+  }
+  probe_enabled = false;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < calls; ++i) {
+    call();
+  }
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+  fprintf(stdout, "%-10s global handles in use during a call: +%zu bytes, %lld ns per call\n", name,
+          peak_global_handles - baseline, static_cast<long long>(duration.count() / calls));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int calls = argc > 1 ? atoi(argv[1]) : kDefaultCalls;
+  if (calls <= 0) {
+    calls = kDefaultCalls;
+  }
+
+  auto vm = std::make_shared<V8VM>(std::make_shared<V8VMInitParam>());
+  isolate = vm->isolate_;
+  auto ctx = std::static_pointer_cast<V8Ctx>(vm->CreateContext());
+  ctx->SetExternalData(nullptr);
+
+  auto wrapper = std::make_unique<FuncWrapper>(Probe, nullptr);
+  ctx->SetProperty(ctx->GetGlobalObject(), ctx->CreateString("probe"), ctx->CreateFunction(wrapper));
+  std::shared_ptr<CtxValue> bridge = ctx->RunScript(kBridgeScript, "bridge.js");
+  std::shared_ptr<CtxValue> payload_value = ctx->RunScript(kPayloadScript, "payload.js");
+  if (!ctx->IsFunction(bridge) || !ctx->IsArray(payload_value)) {
+    fprintf(stderr, "benchmark scripts failed\n");
+    return 1;
+  }
+  std::string reused_buffer;
+  std::string payload = ctx->GetSerializationBuffer(payload_value, reused_buffer);
+
+  Run("persistent", [&ctx, &bridge, &payload] { CallPersistent(ctx, bridge, payload); }, calls);
+  Run("scoped", [&ctx, &bridge, &payload] { CallScoped(ctx, bridge, payload); }, calls);
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest.h>
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "core/code_cache_manager.h"
+
+namespace {
+
+using unicode_string_view = tdf::base::unicode_string_view;
+
+constexpr auto kWaitTimeout = std::chrono::seconds(5);
+constexpr uint32_t kVersionTag = 0x1234;
+
+class CodeCacheManagerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    char dir[] = "/tmp/code_cache_manager_test_XXXXXX";
+    ASSERT_TRUE(mkdtemp(dir));
+    dir_ = dir;
+    runner_ = std::make_shared<WorkerTaskRunner>(1);
+    manager_ = MakeManager(kVersionTag);
+    source_ = std::string(2 * CodeCacheManager::kMinSourceSize, 'x');
+  }
+
+  void TearDown() override {
+    runner_->Terminate();
+    DIR* dir = opendir(dir_.c_str());
+    ASSERT_TRUE(dir);
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+      unlink((dir_ + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+    rmdir(dir_.c_str());
+  }
+
+  std::shared_ptr<CodeCacheManager> MakeManager(uint32_t version_tag) {
+    return std::make_shared<CodeCacheManager>(unicode_string_view(dir_), version_tag, runner_);
+  }
+
+  CodeCacheManager::Entry Lookup(const std::shared_ptr<CodeCacheManager>& manager, const std::string& source) {
+    return manager->Lookup(reinterpret_cast<const uint8_t*>(source.c_str()), source.length());
+  }
+
+  // caches are written on the worker, Load misses until the write is renamed in place
+  std::shared_ptr<hippy::base::SourceBuffer> WaitForCache(const std::shared_ptr<CodeCacheManager>& manager,
+                                                          const std::string& key) {
+    auto deadline = std::chrono::steady_clock::now() + kWaitTimeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+      auto cache = manager->Load(key);
+      if (cache) {
+        return cache;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return nullptr;
+  }
+
+  std::string ToString(const std::shared_ptr<hippy::base::SourceBuffer>& buffer) {
+    return std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size());
+  }
+
+  std::string dir_;
+  std::shared_ptr<WorkerTaskRunner> runner_;
+  std::shared_ptr<CodeCacheManager> manager_;
+  std::string source_;
+};
+
+}  // namespace
+
+TEST_F(CodeCacheManagerTest, saved_cache_is_found_by_next_lookup) {
+  auto entry = Lookup(manager_, source_);
+  ASSERT_FALSE(entry.key.empty());
+  ASSERT_FALSE(entry.cache);
+
+  manager_->Save(entry.key, "cache");
+  ASSERT_TRUE(WaitForCache(manager_, entry.key));
+  auto hit = Lookup(manager_, source_);
+  ASSERT_EQ(entry.key, hit.key);
+  ASSERT_TRUE(hit.cache);
+  ASSERT_EQ("cache", ToString(hit.cache));
+}
+
+TEST_F(CodeCacheManagerTest, small_source_is_not_cached) {
+  auto entry = Lookup(manager_, std::string(CodeCacheManager::kMinSourceSize - 1, 'x'));
+  ASSERT_TRUE(entry.key.empty());
+  ASSERT_FALSE(entry.cache);
+}
+
+TEST_F(CodeCacheManagerTest, changed_source_misses) {
+  auto entry = Lookup(manager_, source_);
+  manager_->Save(entry.key, "cache");
+  ASSERT_TRUE(WaitForCache(manager_, entry.key));
+
+  std::string changed = source_;
+  changed.back() = 'y';
+  auto miss = Lookup(manager_, changed);
+  ASSERT_NE(entry.key, miss.key);
+  ASSERT_FALSE(miss.cache);
+}
+
+TEST_F(CodeCacheManagerTest, removed_cache_misses) {
+  auto entry = Lookup(manager_, source_);
+  manager_->Save(entry.key, "cache");
+  ASSERT_TRUE(WaitForCache(manager_, entry.key));
+
+  // what the vm does with a cache it rejected
+  manager_->Remove(entry.key);
+  ASSERT_FALSE(Lookup(manager_, source_).cache);
+}
+
+TEST_F(CodeCacheManagerTest, other_version_tag_misses_and_is_removed_as_stale) {
+  auto entry = Lookup(manager_, source_);
+  manager_->Save(entry.key, "cache");
+  ASSERT_TRUE(WaitForCache(manager_, entry.key));
+
+  auto upgraded = MakeManager(kVersionTag + 1);
+  auto miss = Lookup(upgraded, source_);
+  ASSERT_NE(entry.key, miss.key);
+  ASSERT_FALSE(miss.cache);
+
+  upgraded->RemoveStale();
+  auto deadline = std::chrono::steady_clock::now() + kWaitTimeout;
+  while (manager_->Load(entry.key) && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_FALSE(manager_->Load(entry.key));
+}
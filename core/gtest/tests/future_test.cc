@@ -0,0 +1,86 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest.h>
+
+#include <functional>
+#include <memory>
+#include <tuple>
+
+#include "core/base/future.h"
+
+using hippy::base::Executor;
+using hippy::base::MakeReadyFuture;
+using hippy::base::MakeResolver;
+using hippy::base::Promise;
+
+TEST(FutureTest, resolver_sets_value_once_called) {
+  Promise<int> promise;
+  int result = 0;
+  promise.GetFuture().Then(Executor(), [&result](int value) { result = value; });
+  auto resolver = MakeResolver(promise, -1);
+  resolver(7);
+  resolver = nullptr;
+  ASSERT_EQ(7, result);
+}
+
+TEST(FutureTest, dropped_resolver_sets_fallback) {
+  Promise<std::shared_ptr<int>> promise;
+  bool called = false;
+  std::shared_ptr<int> result = std::make_shared<int>(0);
+  promise.GetFuture().Then(Executor(), [&called, &result](std::shared_ptr<int> value) {
+    called = true;
+    result = std::move(value);
+  });
+  {
+    std::function<void(std::shared_ptr<int>)> resolver = MakeResolver<std::shared_ptr<int>>(promise, nullptr);
+    auto copy = resolver;
+    resolver = nullptr;
+    ASSERT_FALSE(called);
+  }
+  ASSERT_TRUE(called);
+  ASSERT_EQ(nullptr, result);
+}
+
+TEST(FutureTest, when_all_waits_for_both_values) {
+  Promise<bool> first;
+  std::tuple<bool, int> result(false, 0);
+  bool called = false;
+  hippy::base::WhenAll(first.GetFuture(), MakeReadyFuture(3)).Then(Executor(), [&](std::tuple<bool, int> value) {
+    called = true;
+    result = value;
+  });
+  ASSERT_FALSE(called);
+  first.SetValue(true);
+  ASSERT_TRUE(called);
+  ASSERT_EQ(std::make_tuple(true, 3), result);
+}
+
+TEST(FutureTest, is_ready_until_the_value_is_handed_on) {
+  Promise<int> promise;
+  auto future = promise.GetFuture();
+  ASSERT_FALSE(future.IsReady());
+  promise.SetValue(1);
+  ASSERT_TRUE(future.IsReady());
+  future.Then(Executor(), [](int) {});
+  ASSERT_FALSE(future.IsReady());
+}
@@ -0,0 +1,120 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "core/task/hang_watchdog.h"
+
+namespace {
+
+constexpr auto kWaitTimeout = std::chrono::seconds(5);
+constexpr uint64_t kThresholdInMs = 100;
+
+class HangWatchdogTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    runner_ = std::make_shared<hippy::base::TaskRunner>();
+    runner_->Start();
+  }
+
+  void TearDown() override {
+    watchdog_.reset();
+    release_.set_value();
+    runner_->Terminate();
+  }
+
+  // keeps the runner inside one task until TearDown
+  void Stall() {
+    auto released = release_.get_future().share();
+    std::promise<void> started;
+    auto is_started = started.get_future();
+    runner_->PostFunction([released, &started] {
+      started.set_value();
+      released.wait();
+    }, hippy::base::TaskRunner::Priority::kNormal, "stall");
+    is_started.wait();
+  }
+
+  std::shared_ptr<hippy::base::TaskRunner> runner_;
+  std::unique_ptr<HangWatchdog> watchdog_;
+  std::promise<void> release_;
+};
+
+}  // namespace
+
+TEST_F(HangWatchdogTest, stalled_task_is_reported) {
+  std::promise<HangWatchdog::HangInfo> hang;
+  watchdog_ = std::make_unique<HangWatchdog>(
+      runner_, kThresholdInMs, [&hang](const HangWatchdog::HangInfo& info) { hang.set_value(info); });
+  ASSERT_TRUE(runner_->IsRunningTaskWatched());
+  Stall();
+
+  auto reported = hang.get_future();
+  ASSERT_EQ(std::future_status::ready, reported.wait_for(kWaitTimeout));
+  auto info = reported.get();
+  ASSERT_GE(info.elapsed_ms, kThresholdInMs);
+  ASSERT_EQ(std::string("stall"), info.origin);
+}
+
+TEST_F(HangWatchdogTest, running_task_is_published_only_while_watched) {
+  Stall();
+  hippy::base::TaskRunner::RunningTask running_task;
+  ASSERT_FALSE(runner_->GetRunningTask(running_task));
+}
+
+TEST_F(HangWatchdogTest, hang_is_reported_when_stack_is_never_sampled) {
+  std::promise<tdf::base::unicode_string_view::Encoding> js_stack_encoding;
+  watchdog_ = std::make_unique<HangWatchdog>(
+      runner_, kThresholdInMs, [&js_stack_encoding](const HangWatchdog::HangInfo& info) {
+        js_stack_encoding.set_value(info.js_stack.encoding());
+      });
+  // like a thread stalled in native code that never reaches an interrupt check
+  watchdog_->SetStackSampler([](std::function<void(tdf::base::unicode_string_view)>) {});
+  Stall();
+
+  // the runner stays stalled until TearDown, the report must not wait for it
+  auto reported = js_stack_encoding.get_future();
+  ASSERT_EQ(std::future_status::ready, reported.wait_for(kWaitTimeout));
+  ASSERT_EQ(tdf::base::unicode_string_view::Encoding::Unknown, reported.get());
+}
+
+TEST_F(HangWatchdogTest, sampled_stack_is_reported) {
+  std::promise<std::string> js_stack;
+  watchdog_ = std::make_unique<HangWatchdog>(
+      runner_, kThresholdInMs, [&js_stack](const HangWatchdog::HangInfo& info) {
+        js_stack.set_value(info.js_stack.latin1_value());
+      });
+  watchdog_->SetStackSampler([](std::function<void(tdf::base::unicode_string_view)> done) {
+    std::thread([done = std::move(done)] { done(tdf::base::unicode_string_view("at stall")); }).detach();
+  });
+  Stall();
+
+  auto reported = js_stack.get_future();
+  ASSERT_EQ(std::future_status::ready, reported.wait_for(kWaitTimeout));
+  ASSERT_EQ("at stall", reported.get());
+}
@@ -0,0 +1,170 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/task/idle_task.h"
+#include "core/task/javascript_task_runner.h"
+
+namespace {
+
+constexpr auto kWaitTimeout = std::chrono::seconds(5);
+
+std::shared_ptr<IdleTask> MakeIdleTask(IdleTask::Function callback) {
+  auto task = std::make_shared<IdleTask>();
+  task->callback = std::move(callback);
+  return task;
+}
+
+class JavaScriptTaskRunnerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    runner_ = std::make_shared<JavaScriptTaskRunner>();
+    runner_->Start();
+  }
+
+  void TearDown() override { runner_->Terminate(); }
+
+  // holds the runner inside a task until the returned promise is set, so
+  // everything posted meanwhile is queued at once
+  std::promise<void> Block() {
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> blocked;
+    auto is_blocked = blocked.get_future();
+    runner_->PostFunction([released, &blocked] {
+      blocked.set_value();
+      released.wait();
+    });
+    is_blocked.wait();
+    return release;
+  }
+
+  std::shared_ptr<JavaScriptTaskRunner> runner_;
+};
+
+}  // namespace
+
+TEST_F(JavaScriptTaskRunnerTest, idle_tasks_run_after_every_queued_task) {
+  // only touched on the runner thread until done is set
+  std::vector<std::string> order;
+  std::promise<void> done;
+  auto release = Block();
+  for (int i = 0; i < 3; ++i) {
+    runner_->PostIdleTask(MakeIdleTask([&order, i](const IdleTask::IdleCbParam&) {
+      order.push_back("idle" + std::to_string(i));
+    }));
+    runner_->PostFunction([&order, i] { order.push_back("task" + std::to_string(i)); });
+  }
+  runner_->PostIdleTask(MakeIdleTask([&done](const IdleTask::IdleCbParam&) { done.set_value(); }));
+  release.set_value();
+
+  ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(kWaitTimeout));
+  std::vector<std::string> expected = {"task0", "task1", "task2", "idle0", "idle1", "idle2"};
+  ASSERT_EQ(expected, order);
+}
+
+TEST_F(JavaScriptTaskRunnerTest, task_posted_by_idle_task_runs_before_next_idle_task) {
+  std::vector<std::string> order;
+  std::promise<void> done;
+  auto release = Block();
+  runner_->PostIdleTask(MakeIdleTask([this, &order](const IdleTask::IdleCbParam&) {
+    order.push_back("idle0");
+    runner_->PostFunction([&order] { order.push_back("task"); });
+  }));
+  runner_->PostIdleTask(MakeIdleTask([&order, &done](const IdleTask::IdleCbParam&) {
+    order.push_back("idle1");
+    done.set_value();
+  }));
+  release.set_value();
+
+  ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(kWaitTimeout));
+  std::vector<std::string> expected = {"idle0", "task", "idle1"};
+  ASSERT_EQ(expected, order);
+}
+
+TEST_F(JavaScriptTaskRunnerTest, idle_deadline_ends_before_next_delayed_task) {
+  constexpr uint64_t kDelay = 30;
+  std::promise<uint64_t> time_remaining;
+  std::promise<void> delayed_done;
+  auto release = Block();
+  auto delayed = std::make_shared<hippy::base::InlineTask>(
+      hippy::base::InlineTask::Callback([&delayed_done] { delayed_done.set_value(); }));
+  runner_->PostDelayedTask(delayed, kDelay);
+  runner_->PostIdleTask(MakeIdleTask([&time_remaining](const IdleTask::IdleCbParam& param) {
+    time_remaining.set_value(param.res_time);
+  }));
+  release.set_value();
+
+  auto remaining = time_remaining.get_future();
+  ASSERT_EQ(std::future_status::ready, remaining.wait_for(kWaitTimeout));
+  ASSERT_LE(remaining.get(), kDelay);
+  ASSERT_EQ(std::future_status::ready, delayed_done.get_future().wait_for(kWaitTimeout));
+}
+
+TEST_F(JavaScriptTaskRunnerTest, cancelled_idle_task_does_not_run) {
+  bool cancelled_ran = false;
+  std::promise<void> done;
+  auto release = Block();
+  auto cancelled = MakeIdleTask([&cancelled_ran](const IdleTask::IdleCbParam&) { cancelled_ran = true; });
+  runner_->PostIdleTask(cancelled);
+  runner_->PostIdleTask(MakeIdleTask([&done](const IdleTask::IdleCbParam&) { done.set_value(); }));
+  runner_->CancelTask(cancelled);
+  release.set_value();
+
+  ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(kWaitTimeout));
+  ASSERT_FALSE(cancelled_ran);
+}
+
+TEST_F(JavaScriptTaskRunnerTest, only_moved_deadlines_count_as_saved_wake_ups) {
+  // every delay is coalesced onto a 50ms grid
+  runner_->SetTimerSlackPolicy({50, 0}, {50, 0});
+  std::promise<void> done;
+  auto release = Block();
+  // due at the same time without any slack, nothing is saved by batching them
+  for (int i = 0; i < 3; ++i) {
+    runner_->PostDelayedTask(std::make_shared<hippy::base::InlineTask>(hippy::base::InlineTask::Callback([] {})),
+                             20);
+  }
+  // three more with different delays that the slack moves onto one deadline
+  for (int i = 0; i < 3; ++i) {
+    runner_->PostDelayedTask(std::make_shared<hippy::base::InlineTask>(hippy::base::InlineTask::Callback([] {})),
+                             61 + 10 * i, JavaScriptTaskRunner::TimerPrecision::kCoalesced);
+  }
+  runner_->PostDelayedTask(std::make_shared<hippy::base::InlineTask>(
+                               hippy::base::InlineTask::Callback([&done] { done.set_value(); })),
+                           300);
+  release.set_value();
+
+  ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(kWaitTimeout));
+  auto stats = runner_->GetTimerStats();
+  ASSERT_EQ(7u, stats.delayed_task_count);
+  ASSERT_LE(stats.coalesced_task_count, 3u);
+  ASSERT_LE(stats.saved_wake_up_count, stats.coalesced_task_count);
+  ASSERT_LE(stats.saved_wake_up_count, 2u);
+}
@@ -0,0 +1,133 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/base/sequenced_thread_pool.h"
+
+namespace {
+
+using SequencedThreadPool = hippy::base::SequencedThreadPool;
+using TaskRunner = hippy::base::TaskRunner;
+
+constexpr auto kWaitTimeout = std::chrono::seconds(5);
+constexpr int kTaskCount = 100;
+
+class SequencedThreadPoolTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    for (auto& runner : runners_) {
+      runner->Terminate();
+    }
+    pool_.reset();
+  }
+
+  void CreatePool(uint32_t max_thread_count, size_t runner_count) {
+    pool_ = std::make_unique<SequencedThreadPool>(max_thread_count);
+    for (size_t i = 0; i < runner_count; ++i) {
+      auto runner = std::make_shared<TaskRunner>();
+      pool_->Attach(runner);
+      runners_.push_back(std::move(runner));
+    }
+  }
+
+  // metrics are counted once a task has returned
+  SequencedThreadPool::Metrics WaitForTaskCount(uint64_t task_count) {
+    auto deadline = std::chrono::steady_clock::now() + kWaitTimeout;
+    SequencedThreadPool::Metrics metrics = pool_->GetMetrics();
+    while (metrics.task_count < task_count && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      metrics = pool_->GetMetrics();
+    }
+    return metrics;
+  }
+
+  std::unique_ptr<SequencedThreadPool> pool_;
+  std::vector<std::shared_ptr<TaskRunner>> runners_;
+};
+
+}  // namespace
+
+TEST_F(SequencedThreadPoolTest, sequences_keep_posting_order_on_a_shared_thread) {
+  CreatePool(1, 2);
+  // only touched on the pool thread until done is set
+  std::vector<int> orders[2];
+  std::thread::id thread_ids[2];
+  std::promise<void> done[2];
+  for (size_t r = 0; r < 2; ++r) {
+    for (int i = 0; i < kTaskCount; ++i) {
+      runners_[r]->PostFunction([&orders, &thread_ids, &done, r, i] {
+        orders[r].push_back(i);
+        thread_ids[r] = std::this_thread::get_id();
+        if (i == kTaskCount - 1) {
+          done[r].set_value();
+        }
+      });
+    }
+  }
+
+  for (auto& promise : done) {
+    ASSERT_EQ(std::future_status::ready, promise.get_future().wait_for(kWaitTimeout));
+  }
+  for (auto& order : orders) {
+    ASSERT_EQ(static_cast<size_t>(kTaskCount), order.size());
+    for (int i = 0; i < kTaskCount; ++i) {
+      ASSERT_EQ(i, order[i]);
+    }
+  }
+  ASSERT_EQ(thread_ids[0], thread_ids[1]);
+  ASSERT_EQ(static_cast<uint64_t>(2 * kTaskCount), WaitForTaskCount(2 * kTaskCount).task_count);
+}
+
+TEST_F(SequencedThreadPoolTest, threads_are_capped) {
+  CreatePool(2, 3);
+  auto metrics = pool_->GetMetrics();
+  ASSERT_EQ(2u, metrics.thread_count);
+  ASSERT_EQ(3u, metrics.sequence_count);
+}
+
+TEST_F(SequencedThreadPoolTest, contended_tasks_are_counted_per_task) {
+  CreatePool(1, 2);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::promise<void> blocked;
+  auto is_blocked = blocked.get_future();
+  runners_[0]->PostFunction([released, &blocked] {
+    blocked.set_value();
+    released.wait();
+  });
+  ASSERT_EQ(std::future_status::ready, is_blocked.wait_for(kWaitTimeout));
+  // both sequences are ready once the blocking task returns, the first of the
+  // two tasks runs while the other one waits for the thread
+  runners_[0]->PostFunction([] {});
+  runners_[1]->PostFunction([] {});
+  release.set_value();
+
+  auto metrics = WaitForTaskCount(3);
+  ASSERT_EQ(3u, metrics.task_count);
+  ASSERT_EQ(1u, metrics.contended_task_count);
+}
@@ -0,0 +1,84 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest.h>
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+#include "core/base/source_buffer.h"
+
+namespace {
+
+using SourceBuffer = hippy::base::SourceBuffer;
+using unicode_string_view = tdf::base::unicode_string_view;
+
+class SourceBufferTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/source_buffer_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    path_ = path;
+    // more than a page, so the content spans several mapped pages
+    content_ = std::string(3 * 4096, 'x') + "end";
+    std::ofstream(path_, std::ios::binary) << content_;
+  }
+
+  void TearDown() override { unlink(path_.c_str()); }
+
+  std::string Read(const std::shared_ptr<SourceBuffer>& buffer) {
+    return std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size());
+  }
+
+  std::string path_;
+  std::string content_;
+};
+
+}  // namespace
+
+TEST_F(SourceBufferTest, own_file_is_read_in_full) {
+  ASSERT_EQ(0, chmod(path_.c_str(), 0644));
+  auto buffer = SourceBuffer::FromFile(unicode_string_view(path_));
+  ASSERT_TRUE(buffer);
+  ASSERT_EQ(content_, Read(buffer));
+}
+
+TEST_F(SourceBufferTest, file_others_may_write_survives_truncation) {
+  ASSERT_EQ(0, chmod(path_.c_str(), 0666));
+  auto buffer = SourceBuffer::FromFile(unicode_string_view(path_));
+  ASSERT_TRUE(buffer);
+  // a mapping would raise SIGBUS on the next read
+  ASSERT_EQ(0, truncate(path_.c_str(), 0));
+  ASSERT_EQ(content_, Read(buffer));
+}
+
+TEST_F(SourceBufferTest, missing_or_empty_file_is_null) {
+  ASSERT_EQ(0, truncate(path_.c_str(), 0));
+  ASSERT_FALSE(SourceBuffer::FromFile(unicode_string_view(path_)));
+  ASSERT_FALSE(SourceBuffer::FromFile(unicode_string_view(path_ + ".missing")));
+}
@@ -0,0 +1,74 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "core/task/worker_task_runner.h"
+
+namespace {
+
+constexpr auto kWaitTimeout = std::chrono::seconds(5);
+
+}  // namespace
+
+TEST(WorkerTaskRunnerTest, dedup_tasks_produce_once) {
+  auto runner = std::make_shared<WorkerTaskRunner>(1);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  auto blocker = std::make_unique<CommonTask>();
+  blocker->func_ = [released] { released.wait(); };
+  runner->PostTask(std::move(blocker));
+
+  std::atomic<int> produce_count(0);
+  std::promise<int> first;
+  std::promise<int> second;
+  auto produce = [&produce_count] { return ++produce_count; };
+  runner->PostDedupTask<int>("key", produce, [&first](int value) { first.set_value(value); });
+  runner->PostDedupTask<int>("key", produce, [&second](int value) { second.set_value(value); });
+  release.set_value();
+
+  auto first_result = first.get_future();
+  auto second_result = second.get_future();
+  ASSERT_EQ(std::future_status::ready, first_result.wait_for(kWaitTimeout));
+  ASSERT_EQ(std::future_status::ready, second_result.wait_for(kWaitTimeout));
+  ASSERT_EQ(1, first_result.get());
+  ASSERT_EQ(1, second_result.get());
+  ASSERT_EQ(1, produce_count.load());
+  runner->Terminate();
+}
+
+TEST(WorkerTaskRunnerTest, dedup_task_after_terminate_is_dropped) {
+  auto runner = std::make_shared<WorkerTaskRunner>(1);
+  runner->Terminate();
+  bool produced = false;
+  auto handle = runner->PostDedupTask<int>("key", [&produced] {
+    produced = true;
+    return 0;
+  }, [](int) {});
+  ASSERT_FALSE(handle.IsPending());
+  ASSERT_FALSE(produced);
+}
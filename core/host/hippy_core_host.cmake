@@ -0,0 +1,111 @@
+#
+# Tencent is pleased to support the open source community by making
+# Hippy available.
+#
+# Copyright (C) 2022 THL A29 Limited, a Tencent company.
+# All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+# Host (linux) build of core, shared by the snapshot generator, the
+# benchmarks and gtest. Including this file defines
+#   hippy_core_host_base  task runners, threads, code cache and logging to
+#                         stderr, without a js engine
+#   hippy_core_host       all of core on v8, defined only when V8_INCLUDE_DIR
+#                         is set, V8_LIBRARY and VERSION_NAME come with it
+# HIPPY_CORE_HOST_COMPILE_OPTIONS and HIPPY_CORE_HOST_COMPILE_DEFINITIONS set
+# before the include apply to the core sources too, e.g. -O2 or NDEBUG.
+
+include_guard(GLOBAL)
+
+if (ANDROID OR NOT "${CMAKE_SYSTEM_NAME}" STREQUAL "Linux")
+  message(FATAL_ERROR "${PROJECT_NAME} only builds for linux hosts")
+endif ()
+
+get_filename_component(HIPPY_CORE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." REALPATH)
+set(HIPPY_BASE_DIR "${HIPPY_CORE_DIR}/third_party/base")
+
+add_library(hippy_core_host_base STATIC
+    ${CMAKE_CURRENT_LIST_DIR}/logging.cc
+    ${HIPPY_CORE_DIR}/src/base/file.cc
+    ${HIPPY_CORE_DIR}/src/base/js_value_wrapper.cc
+    ${HIPPY_CORE_DIR}/src/base/sequenced_thread_pool.cc
+    ${HIPPY_CORE_DIR}/src/base/source_buffer.cc
+    ${HIPPY_CORE_DIR}/src/base/source_stream.cc
+    ${HIPPY_CORE_DIR}/src/base/task.cc
+    ${HIPPY_CORE_DIR}/src/base/task_runner.cc
+    ${HIPPY_CORE_DIR}/src/base/task_stats.cc
+    ${HIPPY_CORE_DIR}/src/base/thread.cc
+    ${HIPPY_CORE_DIR}/src/base/thread_id.cc
+    ${HIPPY_CORE_DIR}/src/base/timer_wheel.cc
+    ${HIPPY_CORE_DIR}/src/code_cache_manager.cc
+    ${HIPPY_CORE_DIR}/src/task/common_task.cc
+    ${HIPPY_CORE_DIR}/src/task/hang_watchdog.cc
+    ${HIPPY_CORE_DIR}/src/task/idle_task.cc
+    ${HIPPY_CORE_DIR}/src/task/javascript_task.cc
+    ${HIPPY_CORE_DIR}/src/task/javascript_task_runner.cc
+    ${HIPPY_CORE_DIR}/src/task/vsync_source.cc
+    ${HIPPY_CORE_DIR}/src/task/worker_task_runner.cc
+    ${HIPPY_BASE_DIR}/src/base/log_settings.cc
+    ${HIPPY_BASE_DIR}/src/base/log_settings_state.cc
+    ${HIPPY_BASE_DIR}/src/base/unicode_string_view.cc)
+target_include_directories(hippy_core_host_base PUBLIC
+    ${HIPPY_CORE_DIR}/include ${HIPPY_BASE_DIR}/include)
+target_compile_definitions(hippy_core_host_base PRIVATE ${HIPPY_CORE_HOST_COMPILE_DEFINITIONS})
+target_compile_options(hippy_core_host_base PRIVATE ${HIPPY_CORE_HOST_COMPILE_OPTIONS})
+target_link_libraries(hippy_core_host_base PUBLIC pthread)
+
+if (V8_INCLUDE_DIR)
+  foreach (__var V8_LIBRARY VERSION_NAME)
+    if (NOT ${__var})
+      message(FATAL_ERROR "The ${__var} variable must be set")
+    endif ()
+  endforeach ()
+
+  add_library(hippy_core_host STATIC
+      ${HIPPY_CORE_DIR}/src/engine.cc
+      ${HIPPY_CORE_DIR}/src/modules/animation_frame_module.cc
+      ${HIPPY_CORE_DIR}/src/modules/console_module.cc
+      ${HIPPY_CORE_DIR}/src/modules/contextify_module.cc
+      ${HIPPY_CORE_DIR}/src/modules/idle_callback_module.cc
+      ${HIPPY_CORE_DIR}/src/modules/performance_observer_module.cc
+      ${HIPPY_CORE_DIR}/src/modules/timer_module.cc
+      ${HIPPY_CORE_DIR}/src/napi/callback_info.cc
+      ${HIPPY_CORE_DIR}/src/napi/property_key.cc
+      ${HIPPY_CORE_DIR}/src/napi/value_scope.cc
+      ${HIPPY_CORE_DIR}/src/napi/v8/v8_ctx.cc
+      ${HIPPY_CORE_DIR}/src/napi/v8/v8_streamed_script.cc
+      ${HIPPY_CORE_DIR}/src/napi/v8/v8_try_catch.cc
+      ${HIPPY_CORE_DIR}/src/scope.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/cpu_profiler_module.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/js_vm.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/memory_module.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/native_source_code_android.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/serializer.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/snapshot_builder.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/snapshot_collector.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/snapshot_data.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/snapshot_deserializer.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/snapshot_serializer.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/v8_cpu_profiler.cc
+      ${HIPPY_CORE_DIR}/src/vm/v8/v8_vm.cc)
+  # no debugger attaches to host builds
+  target_compile_definitions(hippy_core_host PUBLIC
+      "JS_V8" "V8_WITHOUT_INSPECTOR" "VERSION_NAME=${VERSION_NAME}")
+  target_compile_definitions(hippy_core_host PRIVATE ${HIPPY_CORE_HOST_COMPILE_DEFINITIONS})
+  target_include_directories(hippy_core_host PUBLIC ${V8_INCLUDE_DIR})
+  target_compile_options(hippy_core_host PRIVATE ${HIPPY_CORE_HOST_COMPILE_OPTIONS})
+  target_link_libraries(hippy_core_host PUBLIC hippy_core_host_base ${V8_LIBRARY} dl)
+endif ()
@@ -0,0 +1,180 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <new>
+#include <vector>
+
+namespace hippy {
+namespace base {
+
+// Freelist of fixed-size blocks with a per-thread cache. Blocks move between
+// threads in batches, so a steady stream of allocations on one thread and
+// frees on another touches neither malloc nor the global lock on most calls.
+// Memory is kept for reuse and never returned to the system.
+template <size_t BlockSize>
+class BlockPool {
+ public:
+  static void* Allocate() {
+    Cache& cache = LocalCache();
+    if (!cache.head) {
+      cache.Refill();
+    }
+    Block* block = cache.head;
+    cache.head = block->next;
+    --cache.count;
+    return block;
+  }
+
+  static void Free(void* ptr) {
+    Cache& cache = LocalCache();
+    auto* block = static_cast<Block*>(ptr);
+    block->next = cache.head;
+    cache.head = block;
+    if (++cache.count >= 2 * kBatchSize) {
+      cache.Flush(kBatchSize);
+    }
+  }
+
+ private:
+  static constexpr size_t kBatchSize = 32;
+
+  union Block {
+    Block* next;
+    alignas(std::max_align_t) unsigned char storage[BlockSize];
+  };
+
+  struct Global {
+    std::mutex mutex;
+    std::vector<Block*> batches;  // each entry heads a chain of kBatchSize blocks
+  };
+
+  struct Cache {
+    Block* head = nullptr;
+    size_t count = 0;
+
+    ~Cache() {
+      while (count >= kBatchSize) {
+        Flush(kBatchSize);
+      }
+      // the remainder is parked as a short batch, Refill copes with that
+      if (head) {
+        Flush(count);
+      }
+    }
+
+    void Refill() {
+      Global& global = GetGlobal();
+      {
+        std::lock_guard<std::mutex> lock(global.mutex);
+        if (!global.batches.empty()) {
+          head = global.batches.back();
+          global.batches.pop_back();
+          count = 0;
+          for (Block* block = head; block; block = block->next) {
+            ++count;
+          }
+          return;
+        }
+      }
+      auto* slab = static_cast<Block*>(::operator new(sizeof(Block) * kBatchSize));
+      for (size_t i = 0; i < kBatchSize; ++i) {
+        slab[i].next = i + 1 < kBatchSize ? &slab[i + 1] : nullptr;
+      }
+      head = slab;
+      count = kBatchSize;
+    }
+
+    void Flush(size_t n) {
+      Block* batch = head;
+      Block* tail = head;
+      for (size_t i = 1; i < n; ++i) {
+        tail = tail->next;
+      }
+      head = tail->next;
+      tail->next = nullptr;
+      count -= n;
+      Global& global = GetGlobal();
+      std::lock_guard<std::mutex> lock(global.mutex);
+      global.batches.push_back(batch);
+    }
+  };
+
+  static Cache& LocalCache() {
+    thread_local Cache cache;
+    return cache;
+  }
+
+  // the repo builds with -fno-threadsafe-statics, so a function local static
+  // could be set up by two threads allocating for the first time; both
+  // members are constant initialized
+  static Global& GetGlobal() {
+    // leaked on purpose, thread caches may be flushed after static destruction
+    std::call_once(global_once_, [] { global_ = new Global(); });
+    return *global_;
+  }
+
+  inline static std::once_flag global_once_;
+  inline static Global* global_ = nullptr;
+};
+
+constexpr size_t PoolBlockSize(size_t size) {
+  return (size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+}
+
+// std allocator backed by BlockPool for single objects, e.g. for allocate_shared
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&) {}  // NOLINT
+
+  T* allocate(size_t n) {
+    if (n != 1 || alignof(T) > alignof(std::max_align_t)) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(BlockPool<PoolBlockSize(sizeof(T))>::Allocate());
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    if (n != 1 || alignof(T) > alignof(std::max_align_t)) {
+      std::allocator<T>().deallocate(ptr, n);
+      return;
+    }
+    BlockPool<PoolBlockSize(sizeof(T))>::Free(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>&) const { return true; }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+}  // namespace base
+}  // namespace hippy
@@ -0,0 +1,232 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "core/base/common.h"
+
+namespace hippy {
+namespace base {
+
+// Where a continuation runs, e.g. TaskRunner::Schedule or
+// WorkerTaskRunner::Schedule. A default constructed executor runs jobs inline.
+class Executor {
+ public:
+  using Job = std::function<void()>;
+
+  Executor() = default;
+  explicit Executor(std::function<void(Job)> post) : post_(std::move(post)) {}
+
+  void Post(Job job) const {
+    if (post_) {
+      post_(std::move(job));
+    } else {
+      job();
+    }
+  }
+
+ private:
+  std::function<void(Job)> post_;
+};
+
+template <typename T>
+class Future;
+
+template <typename T>
+class FutureState {
+ public:
+  using Continuation = std::function<void(T)>;
+
+  // the first value wins, later ones are dropped and false is returned
+  bool SetValue(T value) {
+    Continuation continuation;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (is_set_) {
+        return false;
+      }
+      is_set_ = true;
+      if (!continuation_) {
+        value_.emplace(std::move(value));
+        return true;
+      }
+      continuation = std::move(continuation_);
+    }
+    continuation(std::move(value));
+    return true;
+  }
+
+  bool IsReady() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return value_.has_value();
+  }
+
+  void OnReady(Continuation continuation) {
+    std::optional<T> value;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!value_) {
+        continuation_ = std::move(continuation);
+        return;
+      }
+      value.swap(value_);
+    }
+    continuation(std::move(*value));
+  }
+
+ private:
+  std::mutex mutex_;
+  bool is_set_ = false;
+  std::optional<T> value_;
+  Continuation continuation_;
+};
+
+// Producer side of a Future, copies share the same state.
+template <typename T>
+class Promise {
+ public:
+  Promise() : state_(std::make_shared<FutureState<T>>()) {}
+
+  bool SetValue(T value) const { return state_->SetValue(std::move(value)); }
+  Future<T> GetFuture() const { return Future<T>(state_); }
+
+ private:
+  std::shared_ptr<FutureState<T>> state_;
+};
+
+// Single-consumer result that is never waited on: the value is handed to the
+// continuation given to Then on the executor given to Then, so a flow can hop
+// between the js and worker threads without parking either of them.
+template <typename T>
+class Future {
+ public:
+  explicit Future(std::shared_ptr<FutureState<T>> state) : state_(std::move(state)) {}
+
+  // f(T) runs on executor once the value is set; returns Future<R> for the
+  // result of f, or nothing when f returns void
+  template <typename F>
+  auto Then(const Executor& executor, F&& f) {
+    using R = std::invoke_result_t<std::decay_t<F>, T>;
+    auto fn = MakeCopyable(std::forward<F>(f));
+    if constexpr (std::is_void_v<R>) {
+      state_->OnReady([executor, fn](T value) {
+        executor.Post(MakeCopyable([fn, value = std::move(value)]() mutable {
+          fn(std::move(value));
+        }));
+      });
+    } else {
+      Promise<R> promise;
+      state_->OnReady([executor, fn, promise](T value) {
+        executor.Post(MakeCopyable([fn, promise, value = std::move(value)]() mutable {
+          promise.SetValue(fn(std::move(value)));
+        }));
+      });
+      return promise.GetFuture();
+    }
+  }
+
+  // true once the value is set, until Then hands it on
+  bool IsReady() const { return state_->IsReady(); }
+
+ private:
+  std::shared_ptr<FutureState<T>> state_;
+};
+
+// Callback for producers that may drop a request without answering it, e.g. a
+// loader destroyed with reads still queued. The first call sets promise; if
+// every copy is destroyed uncalled, promise gets fallback instead.
+template <typename T>
+std::function<void(T)> MakeResolver(Promise<T> promise, T fallback) {
+  class Resolver {
+   public:
+    Resolver(Promise<T> promise, T fallback) : promise_(std::move(promise)), fallback_(std::move(fallback)) {}
+    ~Resolver() { promise_.SetValue(std::move(fallback_)); }
+    void SetValue(T value) { promise_.SetValue(std::move(value)); }
+
+   private:
+    Promise<T> promise_;
+    T fallback_;
+  };
+  auto resolver = std::make_shared<Resolver>(std::move(promise), std::move(fallback));
+  return [resolver](T value) { resolver->SetValue(std::move(value)); };
+}
+
+template <typename T>
+Future<std::decay_t<T>> MakeReadyFuture(T&& value) {
+  Promise<std::decay_t<T>> promise;
+  promise.SetValue(std::forward<T>(value));
+  return promise.GetFuture();
+}
+
+// runs f() on executor and returns a Future for its result
+template <typename F>
+auto Async(const Executor& executor, F&& f) {
+  using R = std::invoke_result_t<std::decay_t<F>>;
+  Promise<R> promise;
+  executor.Post(MakeCopyable([fn = std::forward<F>(f), promise]() mutable {
+    promise.SetValue(fn());
+  }));
+  return promise.GetFuture();
+}
+
+// completes, on whichever thread sets the last value, once both are set
+template <typename A, typename B>
+Future<std::tuple<A, B>> WhenAll(Future<A> a, Future<B> b) {
+  struct Join {
+    std::mutex mutex;
+    std::optional<A> a;
+    std::optional<B> b;
+    Promise<std::tuple<A, B>> promise;
+
+    void TrySet(std::unique_lock<std::mutex>& lock) {
+      if (!a || !b) {
+        return;
+      }
+      std::tuple<A, B> values(std::move(*a), std::move(*b));
+      lock.unlock();
+      promise.SetValue(std::move(values));
+    }
+  };
+  auto join = std::make_shared<Join>();
+  a.Then(Executor(), [join](A value) {
+    std::unique_lock<std::mutex> lock(join->mutex);
+    join->a.emplace(std::move(value));
+    join->TrySet(lock);
+  });
+  b.Then(Executor(), [join](B value) {
+    std::unique_lock<std::mutex> lock(join->mutex);
+    join->b.emplace(std::move(value));
+    join->TrySet(lock);
+  });
+  return join->promise.GetFuture();
+}
+
+}  // namespace base
+}  // namespace hippy
@@ -0,0 +1,134 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "core/base/block_pool.h"
+#include "core/base/task.h"
+
+namespace hippy {
+namespace base {
+
+// Move-only void() callable stored in place, never allocates.
+template <size_t Capacity>
+class InlineFunction {
+ public:
+  InlineFunction() = default;
+
+  template <typename F, typename Callable = std::decay_t<F>,
+            typename = std::enable_if_t<!std::is_same<Callable, InlineFunction>::value>>
+  InlineFunction(F&& f) {  // NOLINT
+    static_assert(sizeof(Callable) <= Capacity, "callable exceeds the inline storage of the task");
+    static_assert(alignof(Callable) <= alignof(std::max_align_t), "callable is over-aligned");
+    new (&storage_) Callable(std::forward<F>(f));
+    ops_ = &OpsFor<Callable>::kOps;
+  }
+
+  InlineFunction(InlineFunction&& other) noexcept {
+    if (other.ops_) {
+      other.ops_->move(&other.storage_, &storage_);
+      ops_ = other.ops_;
+      other.Reset();
+    }
+  }
+
+  InlineFunction& operator=(InlineFunction&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      if (other.ops_) {
+        other.ops_->move(&other.storage_, &storage_);
+        ops_ = other.ops_;
+        other.Reset();
+      }
+    }
+    return *this;
+  }
+
+  InlineFunction(const InlineFunction&) = delete;
+  InlineFunction& operator=(const InlineFunction&) = delete;
+
+  ~InlineFunction() { Reset(); }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  void operator()() { ops_->invoke(&storage_); }
+
+ private:
+  struct Ops {
+    void (*invoke)(void*);
+    void (*move)(void*, void*);
+    void (*destroy)(void*);
+  };
+
+  template <typename Callable>
+  struct OpsFor {
+    static void Invoke(void* p) { (*static_cast<Callable*>(p))(); }
+    static void Move(void* from, void* to) { new (to) Callable(std::move(*static_cast<Callable*>(from))); }
+    static void Destroy(void* p) { static_cast<Callable*>(p)->~Callable(); }
+    static constexpr Ops kOps{&Invoke, &Move, &Destroy};
+  };
+
+  void Reset() {
+    if (ops_) {
+      ops_->destroy(&storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  std::aligned_storage_t<Capacity, alignof(std::max_align_t)> storage_;
+  const Ops* ops_ = nullptr;
+};
+
+// Task whose callback lives inside the task object and whose control block
+// comes from BlockPool, so posting it costs no heap allocation once warm.
+class InlineTask : public Task {
+ public:
+  static constexpr size_t kInlineCapacity = 128;
+  using Callback = InlineFunction<kInlineCapacity>;
+
+  template <typename F>
+  static std::shared_ptr<InlineTask> Create(F&& callable) {
+    return std::allocate_shared<InlineTask>(PoolAllocator<InlineTask>(), Callback(std::forward<F>(callable)));
+  }
+
+  explicit InlineTask(Callback callback) : callback_(std::move(callback)) {}
+
+  bool isPriorityTask() override { return false; }
+
+  void Run() override {
+    if (callback_) {
+      callback_();
+    }
+  }
+
+ private:
+  Callback callback_;
+};
+
+}  // namespace base
+}  // namespace hippy
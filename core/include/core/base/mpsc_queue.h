@@ -0,0 +1,91 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "core/base/block_pool.h"
+
+namespace hippy {
+namespace base {
+
+// Lock-free multi-producer single-consumer queue (Vyukov's intrusive node queue).
+// Push may be called from any thread, Pop/IsEmpty only from the consumer thread.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+  ~MpscQueue() {
+    T value;
+    while (Pop(value)) {
+    }
+    delete tail_;
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  void Push(T value) {
+    auto* node = new Node(std::move(value));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    // between the exchange and this store the consumer sees the queue as empty,
+    // so producers must notify the consumer only after Push returns
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  bool Pop(T& value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (!next) {
+      return false;
+    }
+    value = std::move(next->value);
+    tail_ = next;
+    delete tail;
+    return true;
+  }
+
+  bool IsEmpty() const {
+    return tail_->next.load(std::memory_order_acquire) == nullptr;
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    explicit Node(T v) : value(std::move(v)) {}
+
+    static void* operator new(size_t) { return BlockPool<PoolBlockSize(sizeof(Node))>::Allocate(); }
+    static void operator delete(void* ptr) { BlockPool<PoolBlockSize(sizeof(Node))>::Free(ptr); }
+
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  std::atomic<Node*> head_;
+  Node* tail_;
+};
+
+}  // namespace base
+}  // namespace hippy
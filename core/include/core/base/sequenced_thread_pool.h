@@ -0,0 +1,104 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "core/base/task_runner.h"
+#include "core/base/thread.h"
+
+namespace hippy {
+namespace base {
+
+// Runs many TaskRunners as sequences on a capped number of threads. A runner is
+// pinned to one thread for its whole life, so its isolate is always entered
+// from the same thread and its tasks keep their posting order. Ready sequences
+// on a thread are served round-robin, one task at a time. A task that blocks
+// its thread, e.g. Scope::RunJSSync called from js or the inspector's pause
+// loop, stalls every sequence on that thread.
+class SequencedThreadPool {
+ public:
+  struct Metrics {
+    uint32_t thread_count = 0;
+    uint32_t sequence_count = 0;
+    uint64_t task_count = 0;
+    // tasks that ran while another sequence of their thread had a ready task
+    uint64_t contended_task_count = 0;
+  };
+
+  // every thread of the pool is started with the scheduling options of options
+  explicit SequencedThreadPool(uint32_t max_thread_count, const Thread::Options& options = Thread::Options());
+  ~SequencedThreadPool();
+
+  SequencedThreadPool(const SequencedThreadPool&) = delete;
+  SequencedThreadPool& operator=(const SequencedThreadPool&) = delete;
+
+  // the runner must not be started, it is detached again by its Terminate
+  void Attach(std::shared_ptr<TaskRunner> runner);
+  Metrics GetMetrics();
+
+ private:
+  class Worker : public Thread, public TaskRunnerHost {
+   public:
+    Worker(const char* name, const Thread::Options& options);
+    ~Worker() override;
+
+    void Run() override;
+    void WakeUp(bool force) override;
+    void Add(std::shared_ptr<TaskRunner> runner);
+    void Terminate();
+    size_t SequenceCount();
+
+    std::atomic<uint64_t> task_count_;
+    std::atomic<uint64_t> contended_task_count_;
+
+   private:
+    void DetachDrained(std::vector<std::shared_ptr<TaskRunner>>& runners);
+    void Wait(const std::vector<std::shared_ptr<TaskRunner>>& runners,
+              TaskRunner::DelayedTimeInMs now,
+              TaskRunner::DelayedTimeInMs next_wake_up);
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<TaskRunner>> runners_;  // guarded by mutex_
+    uint32_t generation_;  // bumped whenever runners_ changes, guarded by mutex_
+    bool pending_;  // guarded by mutex_
+    bool terminated_;  // guarded by mutex_
+    std::atomic<bool> is_waiting_;
+    size_t cursor_;  // worker thread only
+  };
+
+  std::mutex mutex_;
+  uint32_t max_thread_count_;
+  Thread::Options options_;
+  std::vector<std::unique_ptr<Worker>> workers_;  // guarded by mutex_
+};
+
+}  // namespace base
+}  // namespace hippy
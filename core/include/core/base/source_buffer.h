@@ -0,0 +1,69 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+
+#include "base/unicode_string_view.h"
+
+namespace hippy {
+namespace base {
+
+// Read only bytes of a script that the vm can use in place: a mapped file,
+// memory mapped by someone else (e.g. an uncompressed apk asset) or an owned
+// heap buffer. They are released with the last reference, which the vm keeps
+// for as long as a string made from them is alive.
+class SourceBuffer {
+ public:
+  using unicode_string_view = tdf::base::unicode_string_view;
+  using u8string = unicode_string_view::u8string;
+  using Releaser = std::function<void()>;
+
+  SourceBuffer(const uint8_t* data, size_t size, Releaser releaser);
+  ~SourceBuffer();
+
+  SourceBuffer(const SourceBuffer&) = delete;
+  SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+  // Maps the whole file when this app owns it and nobody else may write it,
+  // otherwise, or when it cannot be mapped, reads a copy. Truncating a mapped
+  // file crashes the vm that reads it, so the app must replace its files
+  // rather than rewrite them. nullptr when the file is missing or empty.
+  static std::shared_ptr<SourceBuffer> FromFile(const unicode_string_view& file_path);
+  // nullptr when content is empty
+  static std::shared_ptr<SourceBuffer> FromString(u8string content);
+
+  inline const uint8_t* data() const { return data_; }
+  inline size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  Releaser releaser_;
+};
+
+}  // namespace base
+}  // namespace hippy
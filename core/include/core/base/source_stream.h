@@ -0,0 +1,75 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+
+#include "base/unicode_string_view.h"
+#include "core/base/source_buffer.h"
+
+namespace hippy {
+namespace base {
+
+// Bytes of a script read in chunks by the one that consumes them, e.g. the vm
+// parsing it on a worker thread while the rest is still being read. The bytes
+// read so far are kept, so that the whole script can be taken at the end.
+// Read from one thread at a time.
+class SourceStream {
+ public:
+  using unicode_string_view = tdf::base::unicode_string_view;
+  using u8string = unicode_string_view::u8string;
+  // fills up to size bytes of buffer, *length is 0 at the end, false on error
+  using Reader = std::function<bool(uint8_t* buffer, size_t size, size_t* length)>;
+  using Releaser = std::function<void()>;
+
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  SourceStream(Reader reader, Releaser releaser);
+  ~SourceStream();
+
+  SourceStream(const SourceStream&) = delete;
+  SourceStream& operator=(const SourceStream&) = delete;
+
+  // nullptr when the file cannot be opened
+  static std::shared_ptr<SourceStream> FromFile(const unicode_string_view& file_path);
+
+  // Reads the next chunk of at most size bytes, 0 at the end or after an
+  // error. Short reads are only returned at the end.
+  size_t Read(uint8_t* buffer, size_t size);
+  inline bool HasFailed() const { return is_failed_; }
+  // the bytes read so far, nullptr when none were read or reading failed
+  std::shared_ptr<SourceBuffer> TakeContent();
+
+ private:
+  Reader reader_;
+  Releaser releaser_;
+  u8string content_;
+  bool is_finished_;
+  bool is_failed_;
+};
+
+}  // namespace base
+}  // namespace hippy
@@ -24,6 +24,8 @@
 
 #include <stdint.h>
 
+#include <atomic>
+
 namespace hippy {
 namespace base {
 
@@ -37,7 +39,13 @@ class Task {
   virtual void Run() = 0;
 
   TaskId id_;
-  bool canceled_ = false;
+  std::atomic<bool> canceled_{false};
+  // static string naming where the task was posted, reported by HangWatchdog
+  const char* origin_ = nullptr;
+  // in microseconds, stamped by runners only while their task stats are enabled
+  uint64_t enqueue_time_ = 0;
+  // set by TaskRunner while the timer slack has moved the deadline of the task
+  bool is_deadline_coalesced_ = false;
 };
 
 }  // namespace base
@@ -24,52 +24,167 @@
 
 #include <stdint.h>
 
+#include <array>
+#include <atomic>
 #include <condition_variable>  // NOLINT(build/c++11)
 #include <memory>
 #include <mutex>  // NOLINT(build/c++11)
-#include <queue>
 #include <utility>
 #include <vector>
 
+#include "core/base/future.h"
+#include "core/base/inline_task.h"
+#include "core/base/mpsc_queue.h"
+#include "core/base/task_stats.h"
 #include "core/base/thread.h"
+#include "core/base/timer_wheel.h"
 
 namespace hippy {
 namespace base {
 
 class Task;
-class TaskRunner : public Thread {
+
+// Drives TaskRunners that do not own a thread, see SequencedThreadPool
+class TaskRunnerHost {
+ public:
+  virtual ~TaskRunnerHost() = default;
+  // force is set when the host has to recompute its wake up time
+  virtual void WakeUp(bool force) = 0;
+};
+
+class TaskRunner : public Thread, public std::enable_shared_from_this<TaskRunner> {
  public:
   using DelayedTimeInMs = uint64_t;
 
+  // tasks of the same priority run in FIFO order, the levels share the thread
+  // by weighted round-robin so lower levels are never starved
+  enum class Priority : uint32_t {
+    kInput = 0,  // native to js calls and input events
+    kNormal,
+    kBackground,  // bookkeeping that can wait, e.g. code cache
+    kCount
+  };
+
+  // lets the deadline of a kCoalesced delayed task move up to the next
+  // multiple of window, so timers due close together share one wake up
+  struct TimerSlack {
+    DelayedTimeInMs window = 0;
+    DelayedTimeInMs min_delay = 0;  // shorter delays keep their exact deadline
+  };
+  enum class TimerPrecision { kPrecise, kCoalesced };
+  struct TimerStats {
+    uint64_t delayed_task_count = 0;    // delayed tasks that became due
+    uint64_t wake_up_count = 0;         // times one or more delayed tasks became due
+    uint64_t coalesced_task_count = 0;  // deadlines moved by the slack
+    // wake ups avoided because a moved deadline became due together with
+    // other tasks, timers that were due together anyway are not counted
+    uint64_t saved_wake_up_count = 0;
+  };
+  struct RunningTask {
+    uint64_t sequence = 0;  // changes whenever a task starts or ends
+    Task::TaskId task_id = 0;
+    const char* origin = nullptr;
+    uint64_t start_time_in_us = 0;  // MonotonicallyIncreasingTimeInUs when the task started
+  };
+
   TaskRunner();
+  explicit TaskRunner(const Options& options);
   virtual ~TaskRunner();
 
   void Run() override;
   void Terminate();
+  // runs at kInput when task->isPriorityTask(), otherwise at kNormal
   void PostTask(std::shared_ptr<Task> task);
+  void PostTask(std::shared_ptr<Task> task, Priority priority);
+  // hot path posting, the callable is stored inside a pooled InlineTask
+  template <typename F>
+  void PostFunction(F&& callable,
+                    Priority priority = Priority::kNormal,
+                    const char* origin = nullptr) {
+    std::shared_ptr<InlineTask> task = InlineTask::Create(std::forward<F>(callable));
+    task->origin_ = origin;
+    PostTask(std::move(task), priority);
+  }
   void PostDelayedTask(std::shared_ptr<Task> task,
-                       DelayedTimeInMs delay_in_milliseconds);
+                       DelayedTimeInMs delay_in_milliseconds,
+                       TimerPrecision precision = TimerPrecision::kPrecise);
   void CancelTask(const std::shared_ptr<Task>& task);
+  void SetTimerSlack(TimerSlack slack);
+  TimerStats GetTimerStats();
+
+  // continuations posted to the executor run as tasks of this runner, jobs
+  // are dropped once the runner is gone
+  Executor Schedule(Priority priority = Priority::kNormal);
+
+  // hosted mode, the runner is driven by host on host_thread_id instead of Start
+  void AttachToHost(TaskRunnerHost* host, ThreadId host_thread_id);
+  void DetachFromHost();
+  // host thread only, runs at most one ready task without blocking and
+  // returns false when nothing was ready
+  bool RunNextTask(DelayedTimeInMs now, bool allow_idle, DelayedTimeInMs& next_wake_up);
+  inline bool IsTerminated() const { return is_terminated_; }
+  // consumer thread only
+  bool HasPendingTask() const;
+  // any thread, returns false while the runner is between tasks or nothing
+  // watches it, a task that started before the first watcher is not seen
+  bool GetRunningTask(RunningTask& running_task) const;
+  // counted, the runner publishes its running task only while watched
+  inline void AddRunningTaskWatcher() {
+    running_task_watcher_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  inline void RemoveRunningTaskWatcher() {
+    running_task_watcher_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  inline bool IsRunningTaskWatched() const {
+    return running_task_watcher_count_.load(std::memory_order_relaxed) > 0;
+  }
+  // off by default, while off it costs one branch per posted and per run task
+  inline void SetTaskStatsEnabled(bool enabled) {
+    is_task_stats_enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  inline bool IsTaskStatsEnabled() const {
+    return is_task_stats_enabled_.load(std::memory_order_relaxed);
+  }
+  inline TaskStats& GetTaskStats() { return task_stats_; }
 
  protected:
-  void PostTaskNoLock(std::shared_ptr<Task> task);
-  std::shared_ptr<Task> popTaskFromDelayedQueueNoLock(DelayedTimeInMs now);
+  void PostTaskNoLock(std::shared_ptr<Task> task, Priority priority);
+  bool PopTask(std::shared_ptr<Task>& task);
+  void RunTask(const std::shared_ptr<Task>& task);
+  void RunAndRecordTask(const std::shared_ptr<Task>& task, uint64_t start_time);
+  void WakeUpIfWaiting();
+  void WakeUpHost(bool force);
+  void PopTasksFromDelayedQueueNoLock(DelayedTimeInMs now);
   std::shared_ptr<Task> GetNext();
+  // Called on the runner thread with mutex_ held when nothing else is ready to
+  // run, next_wake_up is the due time of the earliest delayed task. A hook for
+  // runners with an idle queue, the base runner has none and returns nullptr.
+  virtual std::shared_ptr<Task> GetIdleTaskNoLock(DelayedTimeInMs now,
+                                                  DelayedTimeInMs next_wake_up);
 
  protected:
-  bool is_terminated_;
-  std::queue<std::shared_ptr<Task>> task_queue_;
-
-  using DelayedEntry = std::pair<DelayedTimeInMs, std::shared_ptr<Task>>;
-  struct DelayedEntryCompare {
-    bool operator()(const DelayedEntry& left, const DelayedEntry& right) const {
-      return left.first > right.first;
-    }
-  };
-  std::priority_queue<DelayedEntry,
-                      std::vector<DelayedEntry>,
-                      DelayedEntryCompare>
-      delayed_task_queue_;
+  std::atomic<bool> is_terminated_;
+  // immediate tasks are pushed without taking mutex_, the runner thread is the
+  // only consumer; mutex_ is taken only to wake up a sleeping runner
+  static constexpr size_t kPriorityCount = static_cast<size_t>(Priority::kCount);
+  static const std::array<uint32_t, kPriorityCount> kPriorityWeights;
+  std::array<MpscQueue<std::shared_ptr<Task>>, kPriorityCount> task_queues_;
+  std::array<uint32_t, kPriorityCount> credits_;  // runner thread only
+  std::atomic<bool> is_waiting_;
+  std::atomic<TaskRunnerHost*> host_;
+  // written by the runner thread only, read by GetRunningTask
+  std::atomic<uint64_t> running_sequence_;
+  std::atomic<Task::TaskId> running_task_id_;
+  std::atomic<const char*> running_task_origin_;
+  std::atomic<uint64_t> running_task_start_time_;
+  std::atomic<uint32_t> running_task_watcher_count_;
+  std::atomic<bool> is_task_stats_enabled_;
+  TaskStats task_stats_;
+
+  // guarded by mutex_
+  TimerWheel delayed_task_queue_;
+  TimerSlack timer_slack_;
+  TimerStats timer_stats_;
 
   std::mutex mutex_;
   std::condition_variable cv_;
@@ -0,0 +1,109 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hippy {
+namespace base {
+
+// log2 buckets, bucket 0 holds 0 and bucket i holds [2^(i-1), 2^i)
+class Histogram {
+ public:
+  static constexpr size_t kBucketCount = 40;
+
+  void Add(uint64_t value);
+  void Merge(const Histogram& other);
+  // upper bound of the bucket holding the given quantile, 0 < quantile <= 1
+  uint64_t Percentile(double quantile) const;
+
+  inline uint64_t Count() const { return count_; }
+  inline uint64_t Sum() const { return sum_; }
+  inline uint64_t Max() const { return max_; }
+  inline const std::array<uint64_t, kBucketCount>& Buckets() const { return buckets_; }
+
+ private:
+  std::array<uint64_t, kBucketCount> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+};
+
+// Queue wait and run time histograms per post site, filled in by a runner
+// while its task stats are enabled. Times are in microseconds.
+class TaskStats {
+ public:
+  struct OriginStats {
+    std::string origin;  // "unknown" for tasks posted without an origin
+    Histogram queue_wait;  // tasks that did not go through a queue are not counted
+    Histogram run_time;
+  };
+  struct LongTask {
+    const char* origin;
+    uint64_t start_time;  // on the clock of MonotonicallyIncreasingTimeInUs
+    uint64_t queue_wait;
+    uint64_t duration;
+  };
+  using LongTaskObserver = std::function<void(const LongTask& long_task)>;
+  using ObserverId = uint32_t;
+
+  // the threshold of PerformanceObserver long tasks
+  static constexpr uint64_t kDefaultLongTaskThresholdInUs = 50 * 1000;
+
+  TaskStats() = default;
+  TaskStats(const TaskStats&) = delete;
+  TaskStats& operator=(const TaskStats&) = delete;
+
+  // queue_wait is UINT64_MAX when unknown, observers run on the recording thread
+  void Record(const char* origin, uint64_t queue_wait, uint64_t start_time, uint64_t duration);
+  // any thread, tags with the same text posted from different places are merged
+  std::vector<OriginStats> GetSnapshot();
+  void Reset();
+
+  ObserverId AddLongTaskObserver(LongTaskObserver observer);
+  void RemoveLongTaskObserver(ObserverId id);
+  void SetLongTaskThreshold(uint64_t threshold);
+
+ private:
+  struct Entry {
+    Histogram queue_wait;
+    Histogram run_time;
+  };
+
+  std::mutex mutex_;
+  // keyed by the address of the tag, every tag is a string literal
+  std::unordered_map<const char*, Entry> entries_;
+  std::vector<std::pair<ObserverId, LongTaskObserver>> long_task_observers_;
+  ObserverId next_observer_id_ = 1;
+  uint64_t long_task_threshold_ = kDefaultLongTaskThresholdInUs;
+};
+
+}  // namespace base
+}  // namespace hippy
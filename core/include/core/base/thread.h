@@ -24,6 +24,9 @@
 
 #include <pthread.h>
 
+#include <climits>
+#include <cstdint>
+
 #include "core/base/thread_id.h"
 
 namespace hippy {
@@ -33,16 +36,38 @@ class Thread {
  public:
   class Options {
    public:
-    Options() : name_("hippy:<unknown>"), stack_size_(0) {}
+    static constexpr int kDefaultPriority = INT_MIN;
+
+    Options() : name_("hippy:<unknown>"), stack_size_(0), priority_(kDefaultPriority), affinity_mask_(0) {}
     explicit Options(const char* name, size_t stack_size = 0)
-        : name_(name), stack_size_(stack_size) {}
+        : name_(name), stack_size_(stack_size), priority_(kDefaultPriority), affinity_mask_(0) {}
 
     const char* name() const { return name_; }
     size_t stack_size() const { return stack_size_; }
+    // nice value, -20 (highest) to 19 (lowest). On iOS it only picks the qos
+    // class: below 0 is user interactive, above 0 is utility.
+    int priority() const { return priority_; }
+    // bit n allows cpu n, 0 leaves the thread unrestricted. Linux only.
+    uint64_t affinity_mask() const { return affinity_mask_; }
+
+    Options& set_stack_size(size_t stack_size) {
+      stack_size_ = stack_size;
+      return *this;
+    }
+    Options& set_priority(int priority) {
+      priority_ = priority;
+      return *this;
+    }
+    Options& set_affinity_mask(uint64_t affinity_mask) {
+      affinity_mask_ = affinity_mask;
+      return *this;
+    }
 
    private:
     const char* name_;
     size_t stack_size_;
+    int priority_;
+    uint64_t affinity_mask_;
   };
 
  public:
@@ -58,12 +83,16 @@ class Thread {
   void Join() const;
 
   inline const char* name() const { return name_; }
+  inline int priority() const { return priority_; }
+  inline uint64_t affinity_mask() const { return affinity_mask_; }
 
   static const int kMaxThreadNameLength = 16;
 
  protected:
   char name_[kMaxThreadNameLength]{};
   size_t stack_size_;
+  int priority_;
+  uint64_t affinity_mask_;
   pthread_t thread_{};
 
   ThreadId thread_id_;
@@ -0,0 +1,112 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/base/task.h"
+
+namespace hippy {
+namespace base {
+
+// Hierarchical timing wheel used by TaskRunner for delayed tasks.
+// Level 0 has 256 slots with 1ms resolution, each of the three upper levels has
+// 64 slots that are 64 times coarser than the level below, so ~18.6 hours are
+// covered before deadlines are clamped. Insert and cancel are O(1), cancelled
+// entries are released immediately. Not thread safe, callers provide locking.
+class TimerWheel {
+ public:
+  using TimeInMs = uint64_t;
+
+  static constexpr TimeInMs kNoDeadline = UINT64_MAX;
+
+  explicit TimerWheel(TimeInMs now);
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  void Schedule(std::shared_ptr<Task> task, TimeInMs deadline);
+  // removes every pending entry of the task, returns false if none was found
+  bool Cancel(Task::TaskId id);
+  // moves the tasks whose deadline <= now into expired, in deadline order
+  void Advance(TimeInMs now, std::vector<std::shared_ptr<Task>>& expired);
+  // earliest time at which Advance may produce or cascade tasks,
+  // kNoDeadline when the wheel is empty
+  TimeInMs NextWakeUp() const;
+
+  inline bool IsEmpty() const { return entries_.empty(); }
+  inline size_t Size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    std::shared_ptr<Task> task;
+    Task::TaskId id;
+    TimeInMs deadline;
+    Entry* prev = nullptr;
+    Entry* next = nullptr;
+    uint32_t level = 0;
+    uint32_t slot = 0;
+  };
+
+  struct Slot {
+    Entry* head = nullptr;
+  };
+
+  static constexpr uint32_t kLevelCount = 4;
+  static constexpr uint32_t kRootBits = 8;
+  static constexpr uint32_t kLevelBits = 6;
+  static constexpr uint32_t kRootSize = 1u << kRootBits;
+  static constexpr uint32_t kLevelSize = 1u << kLevelBits;
+  static constexpr uint32_t kMaxBits = kRootBits + kLevelBits * (kLevelCount - 1);
+
+  static inline uint32_t Shift(uint32_t level) {
+    return level == 0 ? 0 : kRootBits + kLevelBits * (level - 1);
+  }
+  static inline uint32_t SlotCount(uint32_t level) {
+    return level == 0 ? kRootSize : kLevelSize;
+  }
+
+  void Place(Entry* entry);
+  void Link(Entry* entry, uint32_t level, uint32_t slot);
+  void Unlink(Entry* entry);
+  void Cascade(uint32_t level);
+  void Expire(Slot& list, std::vector<std::shared_ptr<Task>>& expired);
+  void Release(Entry* entry);
+  // first occupied slot at or after from (circular), -1 when the level is empty
+  int32_t FindOccupied(uint32_t level, uint32_t from) const;
+
+  TimeInMs current_;  // next tick that has not been processed yet
+  std::array<std::vector<Slot>, kLevelCount> slots_;
+  std::array<std::vector<uint64_t>, kLevelCount> occupied_;
+  Slot overdue_;  // entries scheduled for ticks that were already processed
+  std::unordered_multimap<Task::TaskId, Entry*> entries_;
+};
+
+}  // namespace base
+}  // namespace hippy
@@ -22,11 +22,15 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/unicode_string_view.h"
+#include "core/base/source_buffer.h"
+#include "core/base/source_stream.h"
 
 namespace hippy {
 namespace base {
@@ -45,6 +49,23 @@ class UriLoader {
   virtual bool RequestUntrustedContent(
       const unicode_string_view& uri,
       u8string& content) = 0;
+
+  // Content for scripts, which the vm runs without copying it. Loaders
+  // override it to map files; by default the u8string content is wrapped.
+  // cb gets nullptr when there is no content.
+  virtual bool RequestSourceBuffer(const unicode_string_view& uri,
+                                   std::function<void(std::shared_ptr<SourceBuffer>)> cb) {
+    return RequestUntrustedContent(uri, [cb = std::move(cb)](u8string content) {
+      cb(SourceBuffer::FromString(std::move(content)));
+    });
+  }
+
+  // Content for scripts that the vm parses on a worker thread while reading
+  // it. Opening is cheap, the reads happen on the thread that parses. nullptr
+  // when uri cannot be streamed, callers then use RequestSourceBuffer.
+  virtual std::shared_ptr<SourceStream> RequestSourceStream(const unicode_string_view& uri) {
+    return nullptr;
+  }
 };
 }  // namespace base
 }  // namespace hippy
@@ -0,0 +1,93 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "base/unicode_string_view.h"
+#include "core/base/source_buffer.h"
+#include "core/task/worker_task_runner.h"
+
+// Code caches of the scripts an engine runs, in one directory. A cache is
+// keyed by a hash of the script source and the vm's cache version tag, so
+// it follows the content instead of the file name and caches of another vm
+// build or flag set are never looked up. Caches are written on the worker
+// runner after the script ran and are only replaced when the vm rejects them.
+class CodeCacheManager : public std::enable_shared_from_this<CodeCacheManager> {
+ public:
+  using unicode_string_view = tdf::base::unicode_string_view;
+  using SourceBuffer = hippy::base::SourceBuffer;
+
+  // sources below this size are compiled faster than their cache is read
+  static const size_t kMinSourceSize;
+
+  // what Lookup found for a source, key is empty when the source is too
+  // small to be cached and cache is nullptr on a miss
+  struct Entry {
+    std::string key;
+    std::shared_ptr<SourceBuffer> cache;
+  };
+
+  // version_tag changes whenever the vm would reject existing caches, for v8
+  // it is v8::ScriptCompiler::CachedDataVersionTag()
+  CodeCacheManager(const unicode_string_view& cache_dir,
+                   uint32_t version_tag,
+                   std::shared_ptr<WorkerTaskRunner> runner);
+
+  CodeCacheManager(const CodeCacheManager&) = delete;
+  CodeCacheManager& operator=(const CodeCacheManager&) = delete;
+
+  // not a cryptographic hash, a collision only costs a rejected cache
+  static uint64_t Hash(const uint8_t* data, size_t size);
+
+  std::string GetKey(const uint8_t* data, size_t size) const;
+  // GetKey and Load in one, it hashes the whole source and reads the cache,
+  // so loaders call it on a worker thread before the source is run
+  Entry Lookup(const uint8_t* data, size_t size);
+  // nullptr on a miss
+  std::shared_ptr<SourceBuffer> Load(const std::string& key);
+  // no op while a cache for key is still being written
+  void Save(const std::string& key, std::string data);
+  // for caches the vm rejected
+  void Remove(const std::string& key);
+  // removes caches of other version tags left by previous vm builds
+  void RemoveStale();
+
+  inline const std::string& GetCacheDir() const { return cache_dir_; }
+  inline uint32_t GetVersionTag() const { return version_tag_; }
+
+ private:
+  std::string GetPath(const std::string& key) const;
+  bool PostTask(std::function<void()> func);
+
+  std::string cache_dir_;
+  uint32_t version_tag_;
+  std::weak_ptr<WorkerTaskRunner> runner_;
+  std::mutex mutex_;
+  std::unordered_set<std::string> saving_keys_;
+};
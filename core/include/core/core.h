@@ -26,21 +26,31 @@
 #include "core/base/common.h"
 #include "core/base/file.h"
 #include "core/base/macros.h"
+#include "core/base/sequenced_thread_pool.h"
+#include "core/base/source_buffer.h"
+#include "core/base/source_stream.h"
 #include "core/base/task.h"
 #include "core/base/task_runner.h"
 #include "core/base/thread.h"
 #include "core/base/thread_id.h"
 #include "core/base/uri_loader.h"
 #include "core/base/string_view_utils.h"
+#include "core/code_cache_manager.h"
 #include "core/engine.h"
+#include "core/engine_pool.h"
 #include "core/modules/console_module.h"
 #include "core/modules/contextify_module.h"
+#include "core/modules/animation_frame_module.h"
+#include "core/modules/idle_callback_module.h"
 #include "core/modules/module_base.h"
+#include "core/modules/performance_observer_module.h"
 #include "core/modules/timer_module.h"
 #include "core/napi/callback_info.h"
 #include "core/napi/js_ctx.h"
 #include "core/napi/js_ctx_value.h"
 #include "core/napi/js_try_catch.h"
+#include "core/napi/property_key.h"
+#include "core/napi/value_scope.h"
 #include "core/scope.h"
 #include "core/vm/js_vm.h"
 #include "core/vm/native_source_code.h"
@@ -48,10 +58,14 @@
 #ifdef JS_V8
 #include "core/napi/v8/v8_ctx.h"
 #include "core/napi/v8/v8_ctx_value.h"
+#include "core/napi/v8/v8_streamed_script.h"
 #include "core/napi/v8/v8_try_catch.h"
 #include "core/inspector/bridge.h"
 #include "core/vm/v8/v8_vm.h"
+#include "core/vm/v8/v8_heap_profiler.h"
+#include "core/vm/v8/v8_cpu_profiler.h"
 #include "core/vm/v8/memory_module.h"
+#include "core/vm/v8/cpu_profiler_module.h"
 #ifndef V8_WITHOUT_INSPECTOR
 #include "core/inspector/v8_inspector_client_impl.h"
 #endif
@@ -63,6 +77,9 @@
 #endif
 
 #include "core/task/common_task.h"
+#include "core/task/hang_watchdog.h"
+#include "core/task/idle_task.h"
 #include "core/task/javascript_task.h"
 #include "core/task/javascript_task_runner.h"
+#include "core/task/vsync_source.h"
 #include "core/task/worker_task_runner.h"
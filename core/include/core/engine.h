@@ -22,12 +22,18 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
+#include "base/unicode_string_view.h"
 #include "core/base/common.h"
+#include "core/base/sequenced_thread_pool.h"
+#include "core/code_cache_manager.h"
 #include "core/task/javascript_task_runner.h"
 #include "core/task/worker_task_runner.h"
 #include "core/vm/js_vm.h"
@@ -44,10 +50,35 @@ class Engine: public std::enable_shared_from_this<Engine> {
   using VM = hippy::vm::VM;
   using VMInitParam = hippy::vm::VMInitParam;
   using RegisterFunction = hippy::base::RegisterFunction;
+  using unicode_string_view = tdf::base::unicode_string_view;
+
+  // Scheduling of the threads engines start, per role. Names in the options
+  // are ignored and unset fields keep the os defaults. The v8 inspector has
+  // no thread of its own, it runs on the js thread.
+  struct ThreadingConfig {
+    hippy::base::Thread::Options js_thread;
+    hippy::base::Thread::Options worker_thread;
+  };
 
   Engine();
   virtual ~Engine();
 
+  // applies to engines and shared threads set up after this call
+  static void SetThreadingConfig(const ThreadingConfig& config);
+
+  // Engines set up after this call run their js runner as a sequence on a
+  // shared pool of at most max_thread_count threads and share one worker pool,
+  // instead of owning two threads each. An engine blocking its js thread
+  // stalls the engines it shares it with, see SetSharedThreadsAllowed.
+  static void EnableSharedThreads(uint32_t max_thread_count);
+  static hippy::base::SequencedThreadPool::Metrics GetSharedThreadMetrics();
+
+  // Engines that block their js thread, e.g. in the inspector's pause loop,
+  // keep threads of their own. Before AsyncInit.
+  inline void SetSharedThreadsAllowed(bool is_allowed) {
+    is_shared_threads_allowed_ = is_allowed;
+  }
+
   void AsyncInit(const std::shared_ptr<VMInitParam>& param = nullptr,
                  std::unique_ptr<RegisterMap> map = std::make_unique<RegisterMap>());
   int32_t SyncInit(const std::shared_ptr<VM>& vm);
@@ -72,6 +103,29 @@ class Engine: public std::enable_shared_from_this<Engine> {
   inline std::shared_ptr<WorkerTaskRunner> GetWorkerTaskRunner() {
     return worker_task_runner_;
   }
+  // parses streamed scripts, a thread of its own so that a long parse does
+  // not hold up the tasks of the worker
+  inline std::shared_ptr<WorkerTaskRunner> GetScriptStreamingRunner() {
+    return script_streaming_runner_;
+  }
+  // contexts of scopes created after this call cache the scripts they run
+  inline void SetCodeCacheManager(std::shared_ptr<CodeCacheManager> code_cache_manager) {
+    code_cache_manager_ = std::move(code_cache_manager);
+  }
+  inline std::shared_ptr<CodeCacheManager> GetCodeCacheManager() {
+    return code_cache_manager_;
+  }
+#ifdef JS_V8
+  using CpuProfileCallback = std::function<void(bool is_written)>;
+  // Profiles the js cpu time of the vm, js thread only. A max_duration_ms
+  // other than 0 stops the profiler after that long, its profile is then kept
+  // for StopCpuProfiling.
+  bool StartCpuProfiling(int sampling_interval_us, uint32_t max_duration_ms);
+  // Writes the profile as a devtools .cpuprofile to file_path on a worker,
+  // where callback is called once it is written. js thread only, false if
+  // there is no profile.
+  bool StopCpuProfiling(const unicode_string_view& file_path, CpuProfileCallback callback);
+#endif
 #if defined(JS_V8) && !defined(V8_WITHOUT_INSPECTOR)
   inline void SetInspectorClient(std::shared_ptr<hippy::inspector::V8InspectorClientImpl> inspector_client) {
     inspector_client_ = inspector_client;
@@ -87,11 +141,21 @@ class Engine: public std::enable_shared_from_this<Engine> {
 
  private:
   static const uint32_t kDefaultWorkerPoolSize;
+  static const uint32_t kScriptStreamingPoolSize;
 
   std::shared_ptr<JavaScriptTaskRunner> js_runner_;
   std::shared_ptr<WorkerTaskRunner> worker_task_runner_;
+  std::shared_ptr<WorkerTaskRunner> script_streaming_runner_;
+  bool use_shared_threads_;
+  bool is_shared_threads_allowed_;
   std::shared_ptr<VM> vm_;
   std::unique_ptr<RegisterMap> map_;
+  std::shared_ptr<CodeCacheManager> code_cache_manager_;
+#ifdef JS_V8
+  // js thread only
+  uint32_t cpu_profiling_id_ = 0;
+  std::shared_ptr<std::string> cpu_profile_;
+#endif
 #if defined(JS_V8) && !defined(V8_WITHOUT_INSPECTOR)
   std::shared_ptr<hippy::inspector::V8InspectorClientImpl> inspector_client_;
 #endif
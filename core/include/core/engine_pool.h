@@ -0,0 +1,94 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "core/engine.h"
+#include "core/task/worker_task_runner.h"
+
+// Keeps engines pre-created in the background so that an instance can start
+// without waiting for its threads and vm. Pooled engines have their threads
+// running and their vm created (or being created) with the pool's init param,
+// no scope has been created on them yet. The vm created callback a caller
+// would have passed to AsyncInit is its own business, see RunVMCreatedCallback.
+// Engines are started on a thread of the pool, never on the caller's.
+class EnginePool {
+ public:
+  using VMInitParam = hippy::vm::VMInitParam;
+  using RegisterFunction = hippy::base::RegisterFunction;
+  // bytes the system can still hand out, UINT64_MAX when unknown
+  using MemoryProvider = std::function<uint64_t()>;
+
+  struct Config {
+    uint32_t size = 1;
+    // the pool is not refilled while less memory than this is available
+    uint64_t min_available_memory = 0;
+    std::shared_ptr<VMInitParam> param;
+  };
+
+  explicit EnginePool(const Config& config, MemoryProvider memory_provider = nullptr);
+  ~EnginePool();
+
+  EnginePool(const EnginePool&) = delete;
+  EnginePool& operator=(const EnginePool&) = delete;
+
+  // Hands out a pooled engine, one with its vm ready when there is one, and
+  // schedules a refill. nullptr when the pool is empty.
+  std::shared_ptr<Engine> Take();
+  // schedules topping the pool up to its size, skipped while memory is low
+  void Fill();
+  // terminates all idle engines, e.g. on memory pressure
+  void Trim();
+  size_t IdleCount();
+
+  inline const std::shared_ptr<VMInitParam>& GetInitParam() const { return config_.param; }
+
+  // runs cb with the vm of engine on its js thread, after the vm is created
+  // and before any task posted later
+  static void RunVMCreatedCallback(const std::shared_ptr<Engine>& engine, RegisterFunction cb);
+  // MemAvailable of /proc/meminfo on linux, UINT64_MAX elsewhere
+  static uint64_t GetAvailableMemory();
+
+ private:
+  struct Entry {
+    std::shared_ptr<Engine> engine;
+    std::shared_ptr<std::atomic<bool>> is_vm_ready;
+  };
+
+  // runs on refill_runner_
+  void FillOnRefillThread();
+
+  Config config_;
+  MemoryProvider memory_provider_;
+  std::shared_ptr<WorkerTaskRunner> refill_runner_;
+  std::mutex mutex_;
+  // guarded by mutex_
+  std::deque<Entry> entries_;
+  bool is_fill_scheduled_;
+  uint64_t trim_count_;
+};
@@ -0,0 +1,60 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+
+#include "core/modules/module_base.h"
+#include "core/napi/callback_info.h"
+#include "core/napi/js_ctx.h"
+#include "core/napi/js_ctx_value.h"
+
+// Runs every requestAnimationFrame callback of a frame in one js task when the
+// scope's VsyncSource ticks, without a bridge round trip per frame.
+class AnimationFrameModule : public ModuleBase {
+ public:
+  AnimationFrameModule();
+  ~AnimationFrameModule();
+
+  void RequestAnimationFrame(const hippy::napi::CallbackInfo& info, void* data);
+  void CancelAnimationFrame(const hippy::napi::CallbackInfo& info, void* data);
+
+  virtual std::shared_ptr<CtxValue> BindFunction(std::shared_ptr<Scope> scope, std::shared_ptr<CtxValue> rest_args[]) override;
+
+ private:
+  using CallbackId = uint32_t;
+  using CtxValue = hippy::napi::CtxValue;
+
+  void RequestFrame(const std::shared_ptr<Scope>& scope);
+  void RunFrame(const std::shared_ptr<Scope>& scope, uint64_t frame_time);
+
+  CallbackId next_id_;
+  bool is_frame_requested_;
+  // ordered by id, so callbacks run in request order
+  std::map<CallbackId, std::shared_ptr<CtxValue>> callbacks_;
+  // callbacks of the frame being run, cancelAnimationFrame can still remove them
+  std::map<CallbackId, std::shared_ptr<CtxValue>> running_callbacks_;
+};
@@ -22,6 +22,10 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+
+#include "core/base/source_buffer.h"
 #include "core/base/string_view_utils.h"
 #include "core/modules/module_base.h"
 #include "core/napi/callback_info.h"
@@ -41,5 +45,24 @@ class ContextifyModule : public ModuleBase {
 
   virtual std::shared_ptr<CtxValue> BindFunction(std::shared_ptr<Scope> scope, std::shared_ptr<CtxValue> rest_args[]) override;
  private:
+  using ScriptRunner = std::function<void(const std::shared_ptr<Scope>& scope,
+                                          const std::shared_ptr<hippy::base::SourceBuffer>& source,
+                                          const unicode_string_view& file_name)>;
+
+#ifdef JS_V8
+  // parses the script on the script streaming runner while the loader reads
+  // it, false when uri cannot be streamed or a code cache would be used
+  bool LoadStreamedContent(const std::shared_ptr<Scope>& scope,
+                           const unicode_string_view& uri,
+                           const std::weak_ptr<CtxValue>& weak_function);
+#endif
+  // runs source on the js thread with __HIPPYCURDIR__ set to its directory
+  // and calls back js
+  void PostRunTask(const std::shared_ptr<Scope>& scope,
+                   const std::weak_ptr<CtxValue>& weak_function,
+                   const unicode_string_view& uri,
+                   std::shared_ptr<hippy::base::SourceBuffer> source,
+                   ScriptRunner run_script);
+
   std::unordered_map<unicode_string_view, std::shared_ptr<CtxValue>> cb_func_map_;
 };
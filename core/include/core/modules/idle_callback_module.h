@@ -0,0 +1,70 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "core/base/task.h"
+#include "core/modules/module_base.h"
+#include "core/napi/callback_info.h"
+#include "core/napi/js_ctx.h"
+#include "core/napi/js_ctx_value.h"
+
+class IdleTask;
+class JavaScriptTask;
+
+class IdleCallbackModule : public ModuleBase {
+ public:
+  IdleCallbackModule();
+  ~IdleCallbackModule();
+
+  void RequestIdleCallback(const hippy::napi::CallbackInfo& info, void* data);
+  void CancelIdleCallback(const hippy::napi::CallbackInfo& info, void* data);
+
+  virtual std::shared_ptr<CtxValue> BindFunction(std::shared_ptr<Scope> scope, std::shared_ptr<CtxValue> rest_args[]) override;
+
+ private:
+  using TaskId = hippy::base::Task::TaskId;
+  using CtxValue = hippy::napi::CtxValue;
+  using Ctx = hippy::napi::Ctx;
+
+  void Invoke(TaskId task_id,
+              const std::weak_ptr<Scope>& weak_scope,
+              const std::weak_ptr<CtxValue>& weak_function,
+              bool did_time_out,
+              uint64_t res_time);
+  void Cancel(TaskId task_id, const std::shared_ptr<Scope>& scope);
+
+  struct TaskEntry {
+    TaskEntry(std::shared_ptr<CtxValue> func,
+              std::weak_ptr<IdleTask> task): func(func), task(task) {}
+
+    std::shared_ptr<CtxValue> func;
+    std::weak_ptr<IdleTask> task;
+    // posted only when the caller passes a timeout
+    std::weak_ptr<JavaScriptTask> timeout_task;
+  };
+
+  std::unordered_map<TaskId, std::shared_ptr<TaskEntry>> task_map_;
+};
@@ -0,0 +1,61 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/base/task_stats.h"
+#include "core/modules/module_base.h"
+#include "core/napi/callback_info.h"
+#include "core/napi/js_ctx.h"
+#include "core/napi/js_ctx_value.h"
+
+class JavaScriptTaskRunner;
+
+// Feeds long tasks of the js runner to PerformanceObserver, entries are
+// batched and delivered in a task of their own like on the web.
+class PerformanceObserverModule : public ModuleBase {
+ public:
+  PerformanceObserverModule();
+  ~PerformanceObserverModule();
+
+  void ObserveLongTask(const hippy::napi::CallbackInfo& info, void* data);
+  void DisconnectLongTask(const hippy::napi::CallbackInfo& info, void* data);
+
+  virtual std::shared_ptr<CtxValue> BindFunction(std::shared_ptr<Scope> scope, std::shared_ptr<CtxValue> rest_args[]) override;
+
+ private:
+  using CtxValue = hippy::napi::CtxValue;
+  using TaskStats = hippy::base::TaskStats;
+
+  void Disconnect();
+  void Deliver(const std::shared_ptr<Scope>& scope);
+
+  std::weak_ptr<JavaScriptTaskRunner> runner_;
+  TaskStats::ObserverId observer_id_;
+  std::shared_ptr<CtxValue> callback_;
+  // js thread only
+  std::vector<TaskStats::LongTask> pending_entries_;
+  bool is_delivery_posted_;
+};
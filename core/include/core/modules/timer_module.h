@@ -52,8 +52,7 @@ class TimerModule : public ModuleBase {
   using CtxValue = hippy::napi::CtxValue;
   using Ctx = hippy::napi::Ctx;
 
-  std::shared_ptr<CtxValue> Start(const hippy::napi::CallbackInfo& info,
-                                  bool repeat);
+  hippy::napi::LocalValue Start(const hippy::napi::CallbackInfo& info, bool repeat);
   void RemoveTask(const std::shared_ptr<JavaScriptTask>& task);
   void Cancel(TaskId task_id, const std::shared_ptr<Scope>& scope);
 
@@ -29,6 +29,7 @@
 
 #include "base/unicode_string_view.h"
 #include "core/base/macros.h"
+#include "core/napi/value_scope.h"
 
 namespace hippy {
 namespace napi {
@@ -51,12 +52,16 @@ class ReturnValue {
   ReturnValue(const ReturnValue &) = delete;
   ReturnValue &operator=(const ReturnValue &) = delete;
 
-  void SetUndefined() { value_ = nullptr; }
-  void Set(std::shared_ptr<CtxValue> value) { value_ = value; }
+  void SetUndefined() { value_ = nullptr; local_value_ = LocalValue(); }
+  void Set(std::shared_ptr<CtxValue> value) { value_ = value; local_value_ = LocalValue(); }
+  // the value must come from the value scope of the callback
+  void Set(const LocalValue& value) { value_ = nullptr; local_value_ = value; }
   std::shared_ptr<CtxValue> Get() const { return value_; }
+  LocalValue GetLocal() const { return local_value_; }
 
  private:
   std::shared_ptr<CtxValue> value_;
+  LocalValue local_value_;
 };
 
 class ExceptionValue {
@@ -75,27 +80,44 @@ class ExceptionValue {
   std::shared_ptr<CtxValue> value_;
 };
 
+// Vms with cheap local handles pass the receiver and the arguments as
+// LocalValue together with a converter; operator[] and GetReceiver only create
+// a CtxValue for the ones a callback keeps.
 class CallbackInfo {
  public:
+  using PersistentConverter = std::shared_ptr<CtxValue> (*)(void* data, const LocalValue& value);
+
   CallbackInfo();
   CallbackInfo(const CallbackInfo &) = delete;
   CallbackInfo &operator=(const CallbackInfo &) = delete;
 
   inline void SetReceiver(std::shared_ptr<CtxValue> receiver) { receiver_ = receiver; }
-  inline std::shared_ptr<CtxValue> GetReceiver() const { return receiver_; }
-  inline size_t Length() const { return values_.size(); }
+  inline void SetReceiver(const LocalValue& receiver) { local_receiver_ = receiver; }
+  std::shared_ptr<CtxValue> GetReceiver() const;
+  inline size_t Length() const { return converter_ ? local_values_.size() : values_.size(); }
   inline std::any GetSlot() const { return slot_; }
   inline void SetSlot(std::any slot) { slot_ = slot;}
   inline ReturnValue* GetReturnValue() const { return ret_value_.get(); }
   inline ExceptionValue* GetExceptionValue() const { return exception_value_.get(); }
+  inline void SetPersistentConverter(PersistentConverter converter, void* data) {
+    converter_ = converter;
+    converter_data_ = data;
+  }
 
   void AddValue(const std::shared_ptr<CtxValue>& value);
+  void AddValue(const LocalValue& value);
   std::shared_ptr<CtxValue> operator[](size_t index) const;
+  // valid during the callback, empty when index is out of range
+  LocalValue GetLocalValue(size_t index) const;
 
  private:
   std::any slot_;
-  std::shared_ptr<CtxValue> receiver_;
-  std::vector<std::shared_ptr<CtxValue>> values_;
+  mutable std::shared_ptr<CtxValue> receiver_;
+  LocalValue local_receiver_;
+  mutable std::vector<std::shared_ptr<CtxValue>> values_;
+  std::vector<LocalValue> local_values_;
+  PersistentConverter converter_;
+  void* converter_data_;
   std::unique_ptr<ReturnValue> ret_value_;
   std::unique_ptr<ExceptionValue> exception_value_;
 };
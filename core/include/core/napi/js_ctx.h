@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
@@ -33,6 +34,8 @@
 #include "core/base/js_value_wrapper.h"
 #include "core/napi/callback_info.h"
 #include "core/napi/js_ctx_value.h"
+#include "core/napi/property_key.h"
+#include "core/napi/value_scope.h"
 
 namespace hippy {
 namespace napi {
@@ -222,6 +225,61 @@ class Ctx {
       const std::shared_ptr<JSValueWrapper>& wrapper) = 0;
 
   virtual void SetExternalData(void* data) = 0;
+
+  // Scoped values, see core/napi/value_scope.h. The defaults keep every value
+  // in an arena that the enclosing ValueScope trims, vms with cheap local
+  // handles override them.
+  virtual void EnterValueScope(ValueScope* scope);
+  virtual void ExitValueScope(ValueScope* scope);
+  virtual LocalValue ToLocal(const std::shared_ptr<CtxValue>& value);
+  virtual std::shared_ptr<CtxValue> ToPersistent(const LocalValue& value);
+
+  virtual LocalValue CreateNumberLocal(double number);
+  virtual LocalValue CreateStringLocal(const unicode_string_view& string);
+  virtual LocalValue CreateNullLocal();
+  virtual LocalValue CallFunctionLocal(const std::shared_ptr<CtxValue>& function,
+                                       size_t argument_count,
+                                       const LocalValue arguments[]);
+
+  virtual bool GetValueNumber(const LocalValue& value, double* result);
+  virtual bool GetValueNumber(const LocalValue& value, int32_t* result);
+  virtual bool GetValueBoolean(const LocalValue& value, bool* result);
+  virtual bool GetValueString(const LocalValue& value, unicode_string_view* result);
+  virtual bool IsNullOrUndefined(const LocalValue& value);
+  virtual bool IsString(const LocalValue& value);
+  virtual bool IsFunction(const LocalValue& value);
+  virtual bool IsArray(const LocalValue& value);
+  virtual bool IsMap(const LocalValue& value);
+  virtual uint32_t GetArrayLength(const LocalValue& value);
+  virtual LocalValue CopyArrayElementLocal(const LocalValue& value, uint32_t index);
+
+  // Interned property keys, see core/napi/property_key.h. Only PropertyKeyId
+  // names are interned: looking a key up by id is an index, by name a hash
+  // lookup that returns an invalid key for any other name.
+  inline PropertyKey GetPropertyKey(PropertyKeyId id) const {
+    return PropertyKey(static_cast<uint32_t>(id));
+  }
+  PropertyKey GetPropertyKey(const unicode_string_view& name) const;
+  unicode_string_view GetPropertyKeyName(const PropertyKey& key) const;
+
+  virtual std::shared_ptr<CtxValue> GetProperty(
+      const std::shared_ptr<CtxValue>& object,
+      const PropertyKey& key);
+  virtual bool SetProperty(std::shared_ptr<CtxValue> object,
+                           const PropertyKey& key,
+                           std::shared_ptr<CtxValue> value);
+  virtual bool SetProperty(std::shared_ptr<CtxValue> object,
+                           const PropertyKey& key,
+                           std::shared_ptr<CtxValue> value,
+                           const PropertyAttribute& attr);
+  virtual bool HasNamedProperty(const std::shared_ptr<CtxValue>& value,
+                                const PropertyKey& key);
+  virtual std::shared_ptr<CtxValue> CopyNamedProperty(
+      const std::shared_ptr<CtxValue>& value,
+      const PropertyKey& key);
+
+ protected:
+  std::deque<std::shared_ptr<CtxValue>> local_arena_;
 };
 
 }
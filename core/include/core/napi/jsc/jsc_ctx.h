@@ -202,6 +202,23 @@ class JSCCtx : public Ctx {
   
   virtual void SetExternalData(void* data) override;
 
+  // scoped values use the arena fallback of Ctx
+  using Ctx::GetValueNumber;
+  using Ctx::GetValueBoolean;
+  using Ctx::GetValueString;
+  using Ctx::IsNullOrUndefined;
+  using Ctx::IsString;
+  using Ctx::IsFunction;
+  using Ctx::IsArray;
+  using Ctx::IsMap;
+  using Ctx::GetArrayLength;
+
+  // interned keys use the name based defaults of Ctx
+  using Ctx::GetProperty;
+  using Ctx::SetProperty;
+  using Ctx::HasNamedProperty;
+  using Ctx::CopyNamedProperty;
+
   unicode_string_view GetExceptionMsg(const std::shared_ptr<CtxValue>& exception);
 
   JSGlobalContextRef context_;
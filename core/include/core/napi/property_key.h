@@ -0,0 +1,76 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace hippy {
+namespace napi {
+
+// Property names read on hot paths. The vm interns each of them once, the
+// first time it is used.
+enum class PropertyKeyId : uint32_t {
+  kHippyBridge,
+  kCurDir,
+  kLength,
+  kJsHeapSizeLimit,
+  kTotalJSHeapSize,
+  kUsedJSHeapSize,
+  kJsNumberOfNativeContexts,
+  kJsNumberOfDetachedContexts,
+  kCount
+};
+
+constexpr const char* kPropertyKeyNames[] = {
+    "hippyBridge",
+    "__HIPPYCURDIR__",
+    "length",
+    "jsHeapSizeLimit",
+    "totalJSHeapSize",
+    "usedJSHeapSize",
+    "jsNumberOfNativeContexts",
+    "jsNumberOfDetachedContexts"
+};
+
+static_assert(sizeof(kPropertyKeyNames) / sizeof(kPropertyKeyNames[0]) ==
+                  static_cast<uint32_t>(PropertyKeyId::kCount),
+              "every PropertyKeyId needs a name");
+
+// A PropertyKeyId as returned by Ctx::GetPropertyKey, invalid for names
+// that are not interned.
+class PropertyKey {
+ public:
+  static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+  PropertyKey() : index_(kInvalidIndex) {}
+  explicit PropertyKey(uint32_t index) : index_(index) {}
+
+  inline bool IsValid() const { return index_ != kInvalidIndex; }
+  inline uint32_t GetIndex() const { return index_; }
+
+ private:
+  uint32_t index_;
+};
+
+}  // namespace napi
+}  // namespace hippy
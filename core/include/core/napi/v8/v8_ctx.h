@@ -22,10 +22,18 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "base/logging.h"
 #include "base/unicode_string_view.h"
+#include "core/base/source_buffer.h"
+#include "core/code_cache_manager.h"
 #include "core/napi/js_ctx.h"
 #include "core/napi/js_ctx_value.h"
+#include "core/napi/v8/v8_streamed_script.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wconversion"
@@ -35,12 +43,29 @@
 namespace hippy {
 namespace napi {
 
+// The internalized PropertyKeyId names of one isolate, created on first use
+// and shared by all contexts of the isolate. Reset before the isolate is
+// disposed. Snapshot creator isolates go without a table: v8 refuses to
+// serialize while global handles are alive.
+class V8PropertyKeys {
+ public:
+  explicit V8PropertyKeys(v8::Isolate* isolate) : isolate_(isolate) {}
+
+  v8::Local<v8::String> Get(PropertyKeyId id);
+  void Reset();
+
+ private:
+  v8::Isolate* isolate_;
+  v8::Global<v8::String> keys_[static_cast<uint32_t>(PropertyKeyId::kCount)];
+};
+
 class V8Ctx : public Ctx {
  public:
   using unicode_string_view = tdf::base::unicode_string_view;
   using JSValueWrapper = hippy::base::JSValueWrapper;
 
-  explicit V8Ctx(v8::Isolate* isolate) : isolate_(isolate) {
+  explicit V8Ctx(v8::Isolate* isolate, std::shared_ptr<V8PropertyKeys> property_keys = nullptr)
+      : isolate_(isolate), property_keys_(std::move(property_keys)) {
     v8::HandleScope handle_scope(isolate);
     v8::Local<v8::ObjectTemplate> global = v8::ObjectTemplate::New(isolate);
     v8::Local<v8::Context> context = v8::Context::New(isolate, nullptr, global);
@@ -94,6 +119,16 @@ class V8Ctx : public Ctx {
   virtual std::shared_ptr<CtxValue> GetProperty(
       const std::shared_ptr<CtxValue>& object,
       std::shared_ptr<CtxValue> key) override;
+  virtual std::shared_ptr<CtxValue> GetProperty(
+      const std::shared_ptr<CtxValue>& object,
+      const PropertyKey& key) override;
+  virtual bool SetProperty(std::shared_ptr<CtxValue> object,
+                           const PropertyKey& key,
+                           std::shared_ptr<CtxValue> value) override;
+  virtual bool SetProperty(std::shared_ptr<CtxValue> object,
+                           const PropertyKey& key,
+                           std::shared_ptr<CtxValue> value,
+                           const PropertyAttribute& attr) override;
   virtual std::shared_ptr<CtxValue> CreateObject() override;
   virtual std::shared_ptr<CtxValue> CreateNumber(double number) override;
   virtual std::shared_ptr<CtxValue> CreateBoolean(bool b) override;
@@ -153,6 +188,11 @@ class V8Ctx : public Ctx {
   virtual std::shared_ptr<CtxValue> CopyNamedProperty(
       const std::shared_ptr<CtxValue>& value,
       const unicode_string_view& utf8name) override;
+  virtual bool HasNamedProperty(const std::shared_ptr<CtxValue>& value,
+                                const PropertyKey& key) override;
+  virtual std::shared_ptr<CtxValue> CopyNamedProperty(
+      const std::shared_ptr<CtxValue>& value,
+      const PropertyKey& key) override;
   // Function Helpers
 
   virtual bool IsString(const std::shared_ptr<CtxValue>& value) override;
@@ -169,9 +209,34 @@ class V8Ctx : public Ctx {
       bool is_use_code_cache,
       unicode_string_view* cache,
       bool is_copy);
+  // utf-8 source used in place when it is ascii, otherwise transcoded once
+  // into a two byte buffer owned by the vm
+  std::shared_ptr<CtxValue> RunScript(
+      const std::shared_ptr<hippy::base::SourceBuffer>& source,
+      const unicode_string_view& file_name,
+      bool is_use_code_cache,
+      unicode_string_view* cache);
+  // As above with the entry CodeCacheManager::Lookup found for source off the
+  // js thread, so the source is not hashed again here
+  std::shared_ptr<CtxValue> RunScript(
+      const std::shared_ptr<hippy::base::SourceBuffer>& source,
+      const unicode_string_view& file_name,
+      const CodeCacheManager::Entry& cache_entry);
+  // Compiles what script parsed, source being the whole script read by its
+  // stream. Runs source as above when the script has not been parsed.
+  std::shared_ptr<CtxValue> RunScript(
+      const std::shared_ptr<V8StreamedScript>& script,
+      const std::shared_ptr<hippy::base::SourceBuffer>& source,
+      const unicode_string_view& file_name);
 
   virtual void SetDefaultContext(const std::shared_ptr<v8::SnapshotCreator>& creator);
 
+  // With a manager, named scripts run without an explicit cache use and
+  // produce code caches through it. nullptr turns it off.
+  inline void SetCodeCacheManager(std::shared_ptr<CodeCacheManager> code_cache_manager) {
+    code_cache_manager_ = std::move(code_cache_manager);
+  }
+
   virtual void ThrowException(const std::shared_ptr<CtxValue>& exception) override;
   virtual void ThrowException(const unicode_string_view& exception) override;
   virtual void HandleUncaughtException(const std::shared_ptr<CtxValue>& exception) override;
@@ -184,6 +249,32 @@ class V8Ctx : public Ctx {
 
   void SetExternalData(void* data) override;
 
+  // Scoped values are v8::Local handles of a v8::HandleScope held by the
+  // ValueScope, or of the scope of the native callback they are used in.
+  virtual void EnterValueScope(ValueScope* scope) override;
+  virtual void ExitValueScope(ValueScope* scope) override;
+  virtual LocalValue ToLocal(const std::shared_ptr<CtxValue>& value) override;
+  virtual std::shared_ptr<CtxValue> ToPersistent(const LocalValue& value) override;
+  virtual LocalValue CreateNumberLocal(double number) override;
+  virtual LocalValue CreateStringLocal(const unicode_string_view& string) override;
+  virtual LocalValue CreateNullLocal() override;
+  virtual LocalValue CallFunctionLocal(const std::shared_ptr<CtxValue>& function,
+                                       size_t argument_count,
+                                       const LocalValue arguments[]) override;
+  virtual bool GetValueNumber(const LocalValue& value, double* result) override;
+  virtual bool GetValueNumber(const LocalValue& value, int32_t* result) override;
+  virtual bool GetValueBoolean(const LocalValue& value, bool* result) override;
+  virtual bool GetValueString(const LocalValue& value, unicode_string_view* result) override;
+  virtual bool IsNullOrUndefined(const LocalValue& value) override;
+  virtual bool IsString(const LocalValue& value) override;
+  virtual bool IsFunction(const LocalValue& value) override;
+  virtual bool IsArray(const LocalValue& value) override;
+  virtual bool IsMap(const LocalValue& value) override;
+  virtual uint32_t GetArrayLength(const LocalValue& value) override;
+  virtual LocalValue CopyArrayElementLocal(const LocalValue& value, uint32_t index) override;
+  LocalValue ConvertMapToArrayLocal(const LocalValue& value);
+  void* GetExternal(const LocalValue& object);
+
   std::string GetSerializationBuffer(const std::shared_ptr<CtxValue>& value, std::string& reused_buffer);
   unicode_string_view ToStringView(v8::Local<v8::String> str) const;
   unicode_string_view GetMsgDesc(v8::Local<v8::Message> message) const;
@@ -191,6 +282,10 @@ class V8Ctx : public Ctx {
   unicode_string_view GetStackTrace(v8::Local<v8::StackTrace> trace) const;
   std::shared_ptr<CtxValue> CreateError(v8::Local<v8::Message> message) const;
   v8::Local<v8::String> CreateV8String(const unicode_string_view& string) const;
+  // from the isolate's table, internalized on every call without one
+  v8::Local<v8::String> GetV8PropertyKey(const PropertyKey& key);
+  // the interned key for PropertyKeyId names, a plain string otherwise
+  v8::Local<v8::String> CreateV8PropertyKey(const unicode_string_view& name);
   void SetAlignedPointerInEmbedderData(int index, intptr_t address);
 
   v8::Isolate* isolate_;
@@ -199,13 +294,56 @@ class V8Ctx : public Ctx {
   std::unordered_map<void*, void*> func_external_data_map_;
 
  private:
+  // Hashes the source on the calling thread. The key is empty, and the
+  // manager stays out, without a manager or file name, for sources below
+  // CodeCacheManager::kMinSourceSize, and when is_use_code_cache is true: the
+  // caller then brings its own cache and one script must not get two.
+  CodeCacheManager::Entry LookUpCodeCache(const void* data,
+                                          size_t size,
+                                          const unicode_string_view& file_name,
+                                          bool is_use_code_cache) const;
+  std::shared_ptr<CtxValue> RunScriptWithCodeCacheManager(
+      v8::Local<v8::Context> context,
+      v8::Local<v8::String> source,
+      const v8::ScriptOrigin& origin,
+      const CodeCacheManager::Entry& cache_entry,
+      v8::ScriptCompiler::StreamedSource* streamed_source);
+  v8::MaybeLocal<v8::String> CreateV8Source(const std::shared_ptr<hippy::base::SourceBuffer>& source);
   v8::Local<v8::FunctionTemplate> CreateTemplate(const std::unique_ptr<FuncWrapper>& wrapper) const;
   std::shared_ptr<CtxValue> InternalRunScript(
       v8::Local<v8::Context> context,
       v8::Local<v8::String> source,
       const unicode_string_view& file_name,
       bool is_use_code_cache,
-      unicode_string_view* cache);
+      unicode_string_view* cache,
+      const CodeCacheManager::Entry& cache_entry = CodeCacheManager::Entry(),
+      v8::ScriptCompiler::StreamedSource* streamed_source = nullptr);
+
+  // Walk with local handles and build the wrapper in place, false when the
+  // value holds something a JSValueWrapper can not represent.
+  bool ToJsValueWrapper(v8::Local<v8::Context> context,
+                        v8::Local<v8::Value> value,
+                        JSValueWrapper* result);
+  // object_prototype, Object.prototype, is looked up once by the caller and
+  // shared by every object of the wrapper
+  v8::Local<v8::Value> CreateV8Value(v8::Local<v8::Context> context,
+                                     const JSValueWrapper& wrapper,
+                                     v8::Local<v8::Value> object_prototype);
+  std::string ToUtf8String(v8::Local<v8::String> str) const;
+  bool HasMapKey(v8::Local<v8::Context> context,
+                 const std::shared_ptr<CtxValue>& value,
+                 v8::Local<v8::String> key);
+  std::shared_ptr<CtxValue> CopyMapValue(v8::Local<v8::Context> context,
+                                         const std::shared_ptr<CtxValue>& value,
+                                         v8::Local<v8::String> key);
+  bool DefineProperty(v8::Local<v8::Context> context,
+                      const std::shared_ptr<CtxValue>& object,
+                      v8::Local<v8::String> key,
+                      const std::shared_ptr<CtxValue>& value,
+                      const PropertyAttribute& attr);
+
+  std::shared_ptr<CodeCacheManager> code_cache_manager_;
+  std::shared_ptr<V8PropertyKeys> property_keys_;
 };
 
 }
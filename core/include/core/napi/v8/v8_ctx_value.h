@@ -22,7 +22,10 @@
 
 #pragma once
 
+#include <cstring>
+
 #include "core/napi/js_ctx_value.h"
+#include "core/napi/value_scope.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wconversion"
@@ -45,5 +48,20 @@ struct V8CtxValue : public CtxValue {
   v8::Isolate* isolate_;
 };
 
+// A v8::Local is the address of its slot in the current v8::HandleScope,
+// LocalValue carries that address as is.
+static_assert(sizeof(v8::Local<v8::Value>) == sizeof(void*), "v8::Local is not pointer sized");
+
+inline LocalValue ToLocalValue(v8::Local<v8::Value> value) {
+  return LocalValue(reinterpret_cast<void*>(*value));
+}
+
+inline v8::Local<v8::Value> ToV8Local(const LocalValue& value) {
+  v8::Local<v8::Value> local;
+  void* handle = value.GetHandle();
+  memcpy(static_cast<void*>(&local), &handle, sizeof(handle));
+  return local;
+}
+
 }
 }
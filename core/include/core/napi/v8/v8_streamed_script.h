@@ -0,0 +1,81 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+
+#include "core/base/source_stream.h"
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wconversion"
+#include "v8/v8.h"
+#pragma clang diagnostic pop
+
+namespace hippy {
+namespace napi {
+
+// A script that v8 parses on a worker thread while its bytes are read. It is
+// started on the js thread, parsed on a worker and then compiled and run on
+// the js thread by V8Ctx::RunScript.
+class V8StreamedScript {
+ public:
+  using SourceStream = hippy::base::SourceStream;
+
+  explicit V8StreamedScript(std::shared_ptr<SourceStream> stream);
+  ~V8StreamedScript() = default;
+
+  V8StreamedScript(const V8StreamedScript&) = delete;
+  V8StreamedScript& operator=(const V8StreamedScript&) = delete;
+
+  // nullptr when v8 cannot stream the script, on the js thread
+  static std::shared_ptr<V8StreamedScript> Start(v8::Isolate* isolate,
+                                                 std::shared_ptr<SourceStream> stream);
+
+  // Parses while reading the stream, on a worker thread. Does nothing once
+  // canceled.
+  void Parse();
+  // Makes a running Parse stop reading and waits for it, so that the isolate
+  // can go away. On the js thread.
+  void Cancel();
+  bool IsParsed();
+  inline bool IsCanceled() const { return is_canceled_.load(std::memory_order_acquire); }
+
+  inline const std::shared_ptr<SourceStream>& GetStream() const { return stream_; }
+  inline v8::ScriptCompiler::StreamedSource* GetStreamedSource() const { return source_.get(); }
+
+ private:
+  std::shared_ptr<SourceStream> stream_;
+  std::unique_ptr<v8::ScriptCompiler::StreamedSource> source_;
+  std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> task_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool is_parsing_;
+  bool is_parsed_;
+  std::atomic<bool> is_canceled_;
+};
+
+}  // namespace napi
+}  // namespace hippy
@@ -0,0 +1,78 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace hippy {
+namespace napi {
+
+class Ctx;
+
+// Handle to a js value which is only valid until the ValueScope it was created
+// in exits. It is a v8::Local under V8 and a slot of the arena of the Ctx
+// otherwise, so creating one neither allocates a CtxValue nor registers a
+// persistent handle in the vm.
+class LocalValue {
+ public:
+  LocalValue() : handle_(nullptr) {}
+  explicit LocalValue(void* handle) : handle_(handle) {}
+
+  inline bool IsEmpty() const { return handle_ == nullptr; }
+  inline void* GetHandle() const { return handle_; }
+
+ private:
+  void* handle_;
+};
+
+// Values created by the *Local methods of Ctx live until the innermost
+// ValueScope exits. Scopes must nest on the js thread like v8::HandleScope,
+// native callbacks of the vm already run inside one.
+class ValueScope {
+ public:
+  // large enough for a v8::HandleScope
+  static constexpr size_t kEngineScopeSize = 4 * sizeof(void*);
+
+  explicit ValueScope(std::shared_ptr<Ctx> ctx);
+  ~ValueScope();
+  ValueScope(const ValueScope&) = delete;
+  ValueScope& operator=(const ValueScope&) = delete;
+
+  inline const std::shared_ptr<Ctx>& GetCtx() const { return ctx_; }
+  inline void* GetEngineScope() { return engine_scope_; }
+  inline size_t GetArenaMark() const { return arena_mark_; }
+  inline void SetArenaMark(size_t mark) { arena_mark_ = mark; }
+
+ private:
+  // scopes only live on the stack
+  void* operator new(size_t size);
+  void operator delete(void*, size_t);
+
+  std::shared_ptr<Ctx> ctx_;
+  size_t arena_mark_;
+  alignas(void*) unsigned char engine_scope_[kEngineScopeSize];
+};
+
+}  // namespace napi
+}  // namespace hippy
@@ -23,16 +23,19 @@
 #pragma once
 
 #include <any>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "base/unicode_string_view.h"
 #include "core/base/common.h"
+#include "core/base/source_buffer.h"
 #include "core/base/task.h"
 #include "core/base/uri_loader.h"
 #include "core/engine.h"
 #include "core/napi/js_ctx.h"
+#include "core/task/vsync_source.h"
 #include "core/task/worker_task_runner.h"
 
 class JavaScriptTaskRunner;
@@ -79,11 +82,17 @@ class Scope {
   void RunJS(const unicode_string_view& js,
              const unicode_string_view& name,
              bool is_copy = true);
+  // the vm uses the buffer in place where it can
+  void RunJS(const std::shared_ptr<hippy::base::SourceBuffer>& source,
+             const unicode_string_view& name);
 
+  // blocks the calling thread, with shared threads also the engines on it
   std::shared_ptr<CtxValue> RunJSSync(const unicode_string_view& data,
                                       const unicode_string_view& name,
                                       bool is_copy = true);
 
+  inline std::weak_ptr<Engine> GetEngine() { return engine_; }
+
   inline std::shared_ptr<JavaScriptTaskRunner> GetTaskRunner() {
     TDF_BASE_CHECK(engine_.lock());
     return engine_.lock()->GetJSRunner();
@@ -95,6 +104,13 @@ class Scope {
 
   inline std::shared_ptr<UriLoader> GetUriLoader() { return loader_; }
 
+  inline void SetVsyncSource(std::shared_ptr<VsyncSource> vsync_source) {
+    vsync_source_ = vsync_source;
+  }
+
+  // falls back to a TimerVsyncSource when the platform has not set one
+  std::shared_ptr<VsyncSource> GetVsyncSource();
+
   inline auto& GetJsModuleArray() {
     return js_module_array;
   }
@@ -119,8 +135,15 @@ class Scope {
     turbo_host_object_map_[name] = host_object;
   }
 
-  inline void AddWillExitCallback(std::function<void()> cb) { // cb will run in the js thread
-    will_exit_cbs_.push_back(cb);
+  // cb will run in the js thread, the id returned removes it again
+  inline uint32_t AddWillExitCallback(std::function<void()> cb) {
+    uint32_t id = ++will_exit_cb_id_;
+    will_exit_cbs_[id] = std::move(cb);
+    return id;
+  }
+
+  inline void RemoveWillExitCallback(uint32_t id) {
+    will_exit_cbs_.erase(id);
   }
 
  private:
@@ -140,9 +163,11 @@ class Scope {
   std::unordered_map<std::string, std::shared_ptr<ModuleBase>> module_object_map_;
   std::vector<std::shared_ptr<CtxValue>> js_module_array;
   std::shared_ptr<UriLoader> loader_;
+  std::shared_ptr<VsyncSource> vsync_source_;
   std::unique_ptr<ScopeWrapper> wrapper_;
   std::vector<std::unique_ptr<hippy::napi::FuncWrapper>> func_wrapper_holder_;
   std::unordered_map<std::string, std::shared_ptr<CtxValue>> turbo_instance_map_;
   std::unordered_map<std::string, std::any> turbo_host_object_map_;
-  std::vector<std::function<void()>> will_exit_cbs_;
+  std::map<uint32_t, std::function<void()>> will_exit_cbs_;
+  uint32_t will_exit_cb_id_ = 0;
 };
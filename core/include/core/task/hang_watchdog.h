@@ -0,0 +1,82 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "base/unicode_string_view.h"
+#include "core/base/task_runner.h"
+#include "core/base/thread.h"
+
+// Watches a task runner from its own thread and reports tasks that run longer
+// than a threshold. The runner only publishes which task is running and when
+// it started, and only while a watchdog is attached, all the checks happen
+// here. Tasks that started before the watchdog are not seen.
+class HangWatchdog : public hippy::base::Thread {
+ public:
+  using unicode_string_view = tdf::base::unicode_string_view;
+  using TaskRunner = hippy::base::TaskRunner;
+
+  struct HangInfo {
+    hippy::base::Task::TaskId task_id;
+    const char* origin;   // nullptr when the poster did not name it
+    uint64_t elapsed_ms;  // since the task started, the stall is seen one check late at most
+    // empty when no sampler is set, or the stall did not yield a stack within one check interval
+    unicode_string_view js_stack;
+  };
+  using HangCallback = std::function<void(const HangInfo& info)>;
+  // asks the stalled thread for its stack, done may be called on any thread and
+  // at any time, a late call is ignored
+  using StackSampler = std::function<void(std::function<void(unicode_string_view)> done)>;
+
+  // starts watching right away, cb is always called on the watchdog thread, so
+  // a hang is reported even when the stalled thread never yields its stack
+  HangWatchdog(std::weak_ptr<TaskRunner> runner, uint64_t threshold_ms, HangCallback cb);
+  ~HangWatchdog() override;
+
+  inline void SetStackSampler(StackSampler sampler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sampler_ = std::move(sampler);
+  }
+
+  void Run() override;
+  void Terminate();
+
+ private:
+  void Report(const TaskRunner::RunningTask& running_task, uint64_t elapsed_ms);
+  unicode_string_view SampleStack(const StackSampler& sampler);
+
+  std::weak_ptr<TaskRunner> runner_;
+  uint64_t threshold_ms_;
+  uint64_t check_interval_ms_;
+  HangCallback cb_;
+  StackSampler sampler_;
+  bool is_terminated_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
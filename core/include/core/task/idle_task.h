@@ -0,0 +1,49 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+
+#include "core/base/task.h"
+
+class IdleTask : public hippy::base::Task {
+ public:
+  struct IdleCbParam {
+    bool did_time_out;
+    uint64_t res_time;  // ms left before the deadline when the callback starts
+  };
+
+  bool isPriorityTask() override;
+  void Run() override;
+
+  // set by the task runner right before Run
+  inline void SetDeadline(uint64_t deadline) { deadline_ = deadline; }
+
+  using Function = std::function<void(const IdleCbParam&)>;
+  Function callback = nullptr;
+
+ private:
+  uint64_t deadline_ = 0;
+};
@@ -22,12 +22,19 @@
 
 #pragma once
 
-#include "core/base/task_runner.h"
 #include <atomic>
+#include <deque>
+#include <memory>
+
+#include "core/base/task_runner.h"
+
+class IdleTask;
 
 class JavaScriptTaskRunner : public hippy::base::TaskRunner {
  public:
   JavaScriptTaskRunner();
+  // the thread keeps its own name, only the scheduling options are used
+  explicit JavaScriptTaskRunner(const Options& options);
   ~JavaScriptTaskRunner() = default;
 
  public:
@@ -37,6 +44,30 @@ class JavaScriptTaskRunner : public hippy::base::TaskRunner {
   void PauseThreadForInspector();
   void ResumeThreadForInspector();
 
+  // idle tasks only run when no posted or due delayed task is pending
+  void PostIdleTask(std::shared_ptr<IdleTask> task);
+
+  // slack applied to js timers in the foreground and once the runtimes
+  // on this runner are all in the background
+  void SetTimerSlackPolicy(TimerSlack foreground, TimerSlack background);
+  void SetBackground(bool background);
+
+  // no slack for timers under a frame, a few ms for the rest
+  static const TimerSlack kDefaultForegroundTimerSlack;
+  // background timers fire on whole seconds
+  static const TimerSlack kDefaultBackgroundTimerSlack;
+
+ protected:
+  std::shared_ptr<hippy::base::Task> GetIdleTaskNoLock(DelayedTimeInMs now,
+                                                       DelayedTimeInMs next_wake_up) override;
+
  private:
+  static constexpr DelayedTimeInMs kMaxIdlePeriodInMs = 50;
+
   std::atomic_bool is_inspector_call_pause_{false};
+  std::deque<std::shared_ptr<IdleTask>> idle_task_queue_;  // guarded by mutex_
+  // guarded by mutex_
+  TimerSlack foreground_timer_slack_;
+  TimerSlack background_timer_slack_;
+  bool is_background_ = false;
 };
@@ -0,0 +1,55 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+
+#include "core/base/task_runner.h"
+
+// Display frame ticks for requestAnimationFrame. Platforms implement it on top
+// of their display callback, tests can tick the callbacks by hand.
+class VsyncSource {
+ public:
+  // frame_time_in_ms is on the clock of hippy::base::MonotonicallyIncreasingTime
+  using FrameCallback = std::function<void(uint64_t frame_time_in_ms)>;
+
+  virtual ~VsyncSource() = default;
+  // asks for one tick at the next frame, cb may be called on any thread
+  virtual void RequestFrame(FrameCallback cb) = 0;
+};
+
+// Used when the platform provides no display callback, ticks on a 16ms grid.
+class TimerVsyncSource : public VsyncSource {
+ public:
+  static constexpr uint64_t kFrameIntervalInMs = 16;
+
+  explicit TimerVsyncSource(std::weak_ptr<hippy::base::TaskRunner> runner);
+
+  void RequestFrame(FrameCallback cb) override;
+
+ private:
+  std::weak_ptr<hippy::base::TaskRunner> runner_;
+};
@@ -24,34 +24,86 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <condition_variable>  // NOLINT(build/c++11)
 #include <map>
 #include <memory>
 #include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "core/base/base_time.h"
+#include "core/base/future.h"
 #include "core/base/macros.h"
+#include "core/base/task_stats.h"
 #include "core/base/thread.h"
 #include "core/task/common_task.h"
 
-class WorkerTaskRunner {
+class WorkerTaskRunner : public std::enable_shared_from_this<WorkerTaskRunner> {
  public:
-  explicit WorkerTaskRunner(uint32_t pool_size);
+  static const uint32_t kDefaultTaskPriority;
+  static const uint32_t kHighPriorityTaskPriority;
+  static const uint32_t kLowPriorityTaskPriority;
+  // deadlines are MonotonicallyIncreasingTime() values in milliseconds
+  static const uint64_t kNoDeadline;
+
+  // Cancels a posted task. A task that has already started is not affected.
+  class TaskHandle {
+   public:
+    TaskHandle() = default;
+    explicit TaskHandle(std::weak_ptr<hippy::base::Task> task) : task_(std::move(task)) {}
+
+    void Cancel();
+    // false once the task has finished, been dropped or been canceled
+    bool IsPending() const;
+
+   private:
+    std::weak_ptr<hippy::base::Task> task_;
+  };
+
+  // the threads keep their own name, only the scheduling options are used
+  explicit WorkerTaskRunner(uint32_t pool_size,
+                            const hippy::base::Thread::Options& options = hippy::base::Thread::Options());
   ~WorkerTaskRunner() = default;
 
   // std::future cannot be canceled, so it needs to be executed immediately when it cannot be executed in other threads
   void PostPromiseTask(std::unique_ptr<CommonTask> task,
                        uint32_t priority = WorkerTaskRunner::kDefaultTaskPriority);
-  void PostTask(std::unique_ptr<CommonTask> task,
-                uint32_t priority = WorkerTaskRunner::kDefaultTaskPriority);
-  std::unique_ptr<CommonTask> GetNext();
+  // the task is dropped without running if it has not started by deadline
+  TaskHandle PostTask(std::unique_ptr<CommonTask> task,
+                      uint32_t priority = WorkerTaskRunner::kDefaultTaskPriority,
+                      uint64_t deadline = WorkerTaskRunner::kNoDeadline);
+  // Runs produce on a worker and hands its result to consume on the same
+  // thread. While a task with the same dedup_key is queued or running, consume
+  // is attached to that task instead of posting another one. produce is
+  // skipped when every attached consumer is canceled or past its deadline.
+  // Tasks sharing a key must produce the same T.
+  template <typename T>
+  TaskHandle PostDedupTask(const std::string& dedup_key,
+                           std::function<T()> produce,
+                           std::function<void(T)> consume,
+                           uint32_t priority = WorkerTaskRunner::kDefaultTaskPriority,
+                           uint64_t deadline = WorkerTaskRunner::kNoDeadline);
+  // continuations posted to the executor run as worker tasks
+  hippy::base::Executor Schedule(uint32_t priority = WorkerTaskRunner::kDefaultTaskPriority);
+  std::shared_ptr<CommonTask> GetNext();
   void Terminate();
 
+  // off by default, while off it costs one branch per posted and per run task
+  inline void SetTaskStatsEnabled(bool enabled) {
+    is_task_stats_enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  inline bool IsTaskStatsEnabled() const {
+    return is_task_stats_enabled_.load(std::memory_order_relaxed);
+  }
+  inline hippy::base::TaskStats& GetTaskStats() { return task_stats_; }
+
  private:
   class WorkerThread : public hippy::base::Thread {
    public:
-    explicit WorkerThread(WorkerTaskRunner*);
+    WorkerThread(WorkerTaskRunner* runner, const Options& options);
     ~WorkerThread();
     WorkerThread(const WorkerThread &) = delete;
     WorkerThread &operator=(const WorkerThread &) = delete;
@@ -62,13 +114,41 @@ class WorkerTaskRunner {
     WorkerTaskRunner* runner_;
   };
 
-  static const uint32_t kDefaultTaskPriority;
-  static const uint32_t kHighPriorityTaskPriority;
-  static const uint32_t kLowPriorityTaskPriority;
-  using Entry = std::pair<uint32_t, std::unique_ptr<CommonTask>>;
+  class DedupWaiter : public CommonTask {
+   public:
+    explicit DedupWaiter(uint64_t deadline) : deadline_(deadline) {}
+    bool IsLive(uint64_t now) const { return !canceled_ && now <= deadline_; }
+
+   private:
+    uint64_t deadline_;
+  };
+
+  template <typename T>
+  class TypedDedupWaiter : public DedupWaiter {
+   public:
+    TypedDedupWaiter(std::function<void(T)> consume, uint64_t deadline)
+        : DedupWaiter(deadline), consume_(std::move(consume)) {}
+    void Consume(const T& result) { consume_(result); }
+
+   private:
+    std::function<void(T)> consume_;
+  };
+
+  using DedupGroup = std::vector<std::shared_ptr<DedupWaiter>>;
+
+  void EnqueueNoLock(std::shared_ptr<CommonTask> task, uint32_t priority, uint64_t deadline);
+  void RunTask(const std::shared_ptr<CommonTask>& task);
+  bool HasLiveWaiter(const std::string& dedup_key);
+  DedupGroup TakeDedupGroup(const std::string& dedup_key);
+
+  struct Entry {
+    uint32_t priority;
+    uint64_t deadline;
+    std::shared_ptr<CommonTask> task;
+  };
   struct EntryCompare {
     bool operator()(const Entry& left, const Entry& right) const {
-      return left.first > right.first;
+      return left.priority > right.priority;
     }
   };
   std::priority_queue<Entry, std::vector<Entry>, EntryCompare> task_queue_;
@@ -77,4 +157,53 @@ class WorkerTaskRunner {
   uint32_t pool_size_;
   bool terminated_ = false;
   std::vector<std::unique_ptr<WorkerThread>> thread_pool_;
+  std::unordered_map<std::string, DedupGroup> dedup_groups_;
+  std::atomic<bool> is_task_stats_enabled_{false};
+  hippy::base::TaskStats task_stats_;
 };
+
+template <typename T>
+WorkerTaskRunner::TaskHandle WorkerTaskRunner::PostDedupTask(const std::string& dedup_key,
+                                                             std::function<T()> produce,
+                                                             std::function<void(T)> consume,
+                                                             uint32_t priority,
+                                                             uint64_t deadline) {
+  auto waiter = std::make_shared<TypedDedupWaiter<T>>(std::move(consume), deadline);
+  std::weak_ptr<WorkerTaskRunner> weak_runner = weak_from_this();
+  auto task = std::make_shared<CommonTask>();
+  task->func_ = [weak_runner, dedup_key, produce = std::move(produce)] {
+    auto runner = weak_runner.lock();
+    if (!runner) {
+      return;
+    }
+    if (!runner->HasLiveWaiter(dedup_key)) {
+      runner->TakeDedupGroup(dedup_key);
+      return;
+    }
+    T result = produce();
+    DedupGroup group = runner->TakeDedupGroup(dedup_key);
+    uint64_t now = hippy::base::MonotonicallyIncreasingTime();
+    for (auto& group_waiter : group) {
+      if (group_waiter->IsLive(now)) {
+        static_cast<TypedDedupWaiter<T>*>(group_waiter.get())->Consume(result);
+      }
+    }
+  };
+  {
+    // the group and its task are added under one lock, so a group never
+    // exists without a task that will take it
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (terminated_) {
+      return TaskHandle();
+    }
+    auto it = dedup_groups_.find(dedup_key);
+    if (it != dedup_groups_.end()) {
+      it->second.push_back(waiter);
+      return TaskHandle(waiter);
+    }
+    dedup_groups_[dedup_key].push_back(waiter);
+    EnqueueNoLock(std::move(task), priority, kNoDeadline);
+  }
+  cv_.notify_one();
+  return TaskHandle(waiter);
+}
@@ -0,0 +1,50 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "core/modules/module_base.h"
+#include "core/napi/callback_info.h"
+#include "core/napi/js_ctx_value.h"
+
+class Scope;
+
+// Start(samplingIntervalUs, maxDurationMs) and Stop(filePath, callback) of the
+// cpu profiler of the engine, see Engine::StartCpuProfiling.
+class CpuProfilerModule : public ModuleBase {
+ public:
+  using CtxValue = hippy::napi::CtxValue;
+
+  CpuProfilerModule() : next_callback_id_(0) {}
+  void Start(const hippy::napi::CallbackInfo& info, void* data);
+  void Stop(const hippy::napi::CallbackInfo& info, void* data);
+
+  virtual std::shared_ptr<CtxValue> BindFunction(std::shared_ptr<Scope> scope, std::shared_ptr<CtxValue> rest_args[]) override;
+
+ private:
+  uint32_t next_callback_id_;
+  std::unordered_map<uint32_t, std::shared_ptr<CtxValue>> cb_func_map_;
+};
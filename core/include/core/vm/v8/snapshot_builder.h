@@ -0,0 +1,60 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "base/unicode_string_view.h"
+
+namespace hippy {
+namespace vm {
+
+// Makes a startup snapshot: bootstraps a scope on a V8SnapshotVM, runs the
+// given scripts on it and serializes the heap behind SnapshotData's header.
+// Used on the device through jni and at build time by the host snapshot
+// generator, a blob only loads into the v8 build and sdk version it was
+// made with.
+class SnapshotBuilder {
+ public:
+  using unicode_string_view = tdf::base::unicode_string_view;
+
+  // values are part of the jni interface
+  enum class Result {
+    kSuccess, kFailed, kRunScriptError, kSnapshotBlobInvalid, kSaveSnapshotFailed
+  };
+
+  // global_config is the json set as __HIPPYNATIVEGLOBAL__, base_path the
+  // __HIPPYCURDIR__ of the scripts
+  static Result Build(const std::vector<unicode_string_view>& scripts,
+                      const unicode_string_view& base_path,
+                      const unicode_string_view& global_config,
+                      std::vector<uint8_t>& snapshot);
+  static Result BuildToFile(const std::vector<unicode_string_view>& scripts,
+                            const unicode_string_view& base_path,
+                            const unicode_string_view& global_config,
+                            const unicode_string_view& snapshot_path);
+};
+
+}  // namespace vm
+}  // namespace hippy
@@ -21,12 +21,25 @@
  */
 #pragma once
 
-#include <vector>
+#include <stdint.h>
 
-extern std::vector<intptr_t> external_references;
+namespace hippy {
+namespace vm {
 
-#define REGISTER_EXTERNAL_REFERENCES(FUNC_NAME)                           \
-static auto register_invoke_##FUNC_NAME = []() {                          \
-  external_references.push_back(reinterpret_cast<intptr_t>(FUNC_NAME));   \
-  return 0;                                                               \
+// Native callbacks a snapshot may point at. v8 stores them as indexes into
+// this table, so it is sorted by name instead of following the order of the
+// static initializers, which differs between binaries. A snapshot made by
+// another binary linking the same modules (e.g. the host snapshot generator)
+// therefore resolves to the same callbacks.
+void RegisterExternalReference(const char* name, intptr_t address);
+// null terminated, complete once static initialization is over
+const intptr_t* GetExternalReferences();
+
+}  // namespace vm
+}  // namespace hippy
+
+#define REGISTER_EXTERNAL_REFERENCES(FUNC_NAME)                                        \
+static auto register_invoke_##FUNC_NAME = []() {                                       \
+  ::hippy::vm::RegisterExternalReference(#FUNC_NAME, reinterpret_cast<intptr_t>(FUNC_NAME)); \
+  return 0;                                                                            \
 }();
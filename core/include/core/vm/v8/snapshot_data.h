@@ -24,7 +24,12 @@
 
 #include <any>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "base/unicode_string_view.h"
+#include "core/base/source_buffer.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wconversion"
@@ -54,9 +59,17 @@ struct SnapshotData {
 
   std::vector<uint8_t> buffer_holder; // hold v8::StartupData data
   std::any external_buffer_holder;    // hold DirectBuffer to avoid copying
+  // read only mapping of a snapshot file, shared by every engine of the
+  // process that maps the same unchanged file
+  std::shared_ptr<hippy::base::SourceBuffer> mapping_holder;
 
   void WriteMetaData(v8::StartupData data);
   bool ReadMetadata();                // use meta data in buffer_holder
-  bool ReadMetaData(uint8_t* external_buffer_pointer, size_t length);
+  // Only the header is read, the payload stays untouched until v8
+  // deserializes it.
+  bool ReadMetaData(const uint8_t* external_buffer_pointer, size_t length);
+  // maps file_path, or reuses the mapping of an earlier call for the same
+  // path, size and modification time, then reads its header
+  bool MapFile(const tdf::base::unicode_string_view& file_path);
 };
 
@@ -0,0 +1,61 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wconversion"
+#include "v8/v8.h"
+#include "v8/v8-profiler.h"
+#pragma clang diagnostic pop
+
+namespace hippy {
+namespace vm {
+
+// One cpu profiling session of an isolate at a time, outside of devtools.
+// The v8 profiler and its sampling thread only live while a session runs.
+// Every method must be called on the js thread.
+class V8CpuProfiler {
+ public:
+  static constexpr int kDefaultSamplingInterval = 1000;  // us
+
+  explicit V8CpuProfiler(v8::Isolate* isolate);
+  ~V8CpuProfiler();
+
+  // Samples the js stacks every sampling_interval_us. A max_duration_ms other
+  // than 0 caps the samples recorded to those taken in that long.
+  bool Start(int sampling_interval_us, uint32_t max_duration_ms);
+  // Serializes the profile in the .cpuprofile format of devtools, false if
+  // no session was running.
+  bool Stop(std::string* profile);
+  inline bool IsProfiling() { return profiler_ != nullptr; }
+
+ private:
+  v8::Isolate* isolate_;
+  v8::CpuProfiler* profiler_;
+};
+
+}  // namespace vm
+}  // namespace hippy
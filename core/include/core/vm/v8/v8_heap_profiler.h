@@ -0,0 +1,64 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wconversion"
+#include "v8/v8.h"
+#include "v8/v8-profiler.h"
+#pragma clang diagnostic pop
+
+namespace hippy {
+namespace vm {
+
+// Heap snapshots and sampled allocation profiles written straight to a file
+// descriptor. Neither the serialized snapshot nor the profile is ever held in
+// memory, the writer only keeps one chunk of kChunkSize bytes. Every method
+// must be called on the js thread, fd stays open and owned by the caller.
+class V8HeapProfiler {
+ public:
+  static constexpr int kChunkSize = 64 * 1024;
+  static constexpr uint64_t kDefaultSampleInterval = 512 * 1024;
+  static constexpr int kDefaultStackDepth = 16;
+
+  // The snapshot graph built by v8 still grows with the heap, but it is
+  // deleted as soon as it is serialized and writing stops at the first
+  // failed write instead of running to the end.
+  static bool WriteHeapSnapshot(v8::Isolate* isolate, int fd);
+
+  // Samples an allocation about every sample_interval bytes with stacks of
+  // up to stack_depth frames. It is cheap enough to stay on in canary builds.
+  // Returns false if the sampling heap profiler is already running.
+  static bool StartSamplingHeapProfiler(v8::Isolate* isolate,
+                                        uint64_t sample_interval = kDefaultSampleInterval,
+                                        int stack_depth = kDefaultStackDepth);
+  // Writes the live allocations sampled since the start in the .heapprofile
+  // format of devtools, sampling goes on.
+  static bool WriteSamplingHeapProfile(v8::Isolate* isolate, int fd);
+  static void StopSamplingHeapProfiler(v8::Isolate* isolate);
+};
+
+}  // namespace vm
+}  // namespace hippy
@@ -25,10 +25,13 @@
 #include "core/vm/js_vm.h"
 
 #include <any>
+#include <memory>
+#include <string>
 
 #include "base/unicode_string_view.h"
 #include "core/napi/js_ctx.h"
 #include "core/vm/v8/snapshot_data.h"
+#include "core/vm/v8/v8_cpu_profiler.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wconversion"
@@ -36,6 +39,10 @@
 #pragma clang diagnostic pop
 
 namespace hippy {
+namespace napi {
+class V8PropertyKeys;
+}
+
 namespace vm {
 
 struct V8VMInitParam : public VMInitParam {
@@ -87,14 +94,25 @@ class V8VM : public VM {
 
   virtual std::shared_ptr<Ctx> CreateContext();
 
-  static v8::Local<v8::String> CreateV8String(v8::Isolate* isolate, const unicode_string_view& str_view);
+  static v8::Local<v8::String> CreateV8String(v8::Isolate* isolate,
+                                              const unicode_string_view& str_view,
+                                              v8::NewStringType type = v8::NewStringType::kNormal);
   static unicode_string_view ToStringView(v8::Isolate* isolate, v8::Local<v8::String> str);
 
   static void PlatformDestroy();
 
+  // js thread only, see V8CpuProfiler
+  bool StartCpuProfiling(int sampling_interval_us = V8CpuProfiler::kDefaultSamplingInterval,
+                         uint32_t max_duration_ms = 0);
+  bool StopCpuProfiling(std::string* profile);
+  bool IsCpuProfiling();
+
   v8::Isolate* isolate_;
   v8::Isolate::CreateParams create_params_;
   SnapshotData snapshot_data_;
+  std::unique_ptr<V8CpuProfiler> cpu_profiler_;
+  // shared by the contexts of isolate_, which come and go with pooled engines
+  std::shared_ptr<hippy::napi::V8PropertyKeys> property_keys_;
 };
 
 class V8SnapshotVM : public VM {
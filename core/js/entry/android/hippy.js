@@ -26,6 +26,7 @@ require('../../global/DynamicLoad.js');
 require('../../global/Platform.js'); // Hippy.device.platform
 require('../../bridge/android/js2native.js');
 require('../../global/TimerModule.js'); // setTimeout clearTimeout setInterval clearInterval
+require('../../global/IdleCallbackModule.js'); // requestIdleCallback cancelIdleCallback
 require('../../global/ConsoleModule.js'); // console
 require('../../global/UIManagerModule.js'); // Hippy.document
 require('../../global/Network.js'); // Headers fetch Response
@@ -0,0 +1,40 @@
+/*
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2017-2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* eslint-disable no-undef */
+
+const idle = internalBinding('IdleCallbackModule');
+
+global.requestIdleCallback = (cb, options) => {
+  const timeout = options && Number.isFinite(options.timeout) ? options.timeout : 0;
+  return idle.RequestIdleCallback((didTimeout, timeRemaining) => {
+    const start = Date.now();
+    cb({
+      didTimeout,
+      timeRemaining: () => Math.max(0, timeRemaining - (Date.now() - start)),
+    });
+  }, timeout);
+};
+
+global.cancelIdleCallback = (handle) => {
+  if (Number.isInteger(handle) && handle > 0) {
+    idle.CancelIdleCallback(handle);
+  }
+};
@@ -36,3 +36,77 @@ global.performance = global.performance || new class Performance {
   }
 };
 
+
+const PerformanceObserverModule = internalBinding('PerformanceObserverModule');
+const longTaskObservers = new Set();
+
+class PerformanceObserverEntryList {
+  constructor(entries) {
+    this.entries = entries;
+  }
+  getEntries() {
+    return this.entries.slice();
+  }
+  getEntriesByType(type) {
+    return this.entries.filter(entry => entry.entryType === type);
+  }
+  getEntriesByName(name, type) {
+    return this.entries.filter(entry => entry.name === name && (!type || entry.entryType === type));
+  }
+}
+
+// startTime and now are native monotonic ms, moved onto the clock of performance.now()
+const dispatchLongTasks = (entries, now) => {
+  const offset = global.performance.now() - now;
+  entries.forEach((entry) => {
+    entry.startTime += offset;
+  });
+  longTaskObservers.forEach((observer) => {
+    observer.callback(new PerformanceObserverEntryList(entries), observer);
+  });
+};
+
+global.PerformanceObserver = global.PerformanceObserver || class PerformanceObserver {
+  static get supportedEntryTypes() {
+    return PerformanceObserverModule ? ['longtask'] : [];
+  }
+  constructor(callback) {
+    if (typeof callback !== 'function') {
+      throw new TypeError('Invalid arguments');
+    }
+    this.callback = callback;
+  }
+  observe(options) {
+    const types = (options && (options.entryTypes || [options.type])) || [];
+    if (!PerformanceObserverModule || types.indexOf('longtask') === -1 || longTaskObservers.has(this)) {
+      return;
+    }
+    longTaskObservers.add(this);
+    if (longTaskObservers.size === 1) {
+      PerformanceObserverModule.ObserveLongTask(dispatchLongTasks);
+    }
+  }
+  disconnect() {
+    if (longTaskObservers.delete(this) && longTaskObservers.size === 0) {
+      PerformanceObserverModule.DisconnectLongTask();
+    }
+  }
+};
+
+
+const CpuProfilerModule = internalBinding('CpuProfilerModule');
+
+// start({ samplingInterval, maxDuration }) samples the js stacks every samplingInterval us,
+// for at most maxDuration ms when it is given. stop(filePath, callback) writes the
+// .cpuprofile of devtools to filePath and calls back with whether it was written.
+if (CpuProfilerModule) {
+  Hippy.cpuProfiler = {
+    start(options) {
+      const { samplingInterval, maxDuration } = options || {};
+      return CpuProfilerModule.Start(samplingInterval, maxDuration);
+    },
+    stop(filePath, callback) {
+      return CpuProfilerModule.Stop(filePath, callback);
+    },
+  };
+}
@@ -18,20 +18,22 @@
  * limitations under the License.
  */
 
+/* eslint-disable no-undef */
+
+const frame = internalBinding('AnimationFrameModule');
+
 global.requestAnimationFrame = (cb) => {
-  if (cb) {
-    if (__GLOBAL__.canRequestAnimationFrame) {
-      __GLOBAL__.canRequestAnimationFrame = false;
-      __GLOBAL__.requestAnimationFrameId = __GLOBAL__.moduleCallId;
-      __GLOBAL__.requestAnimationFrameQueue[__GLOBAL__.requestAnimationFrameId] = [];
-      __GLOBAL__.requestAnimationFrameQueue[__GLOBAL__.requestAnimationFrameId].push(cb);
-      Hippy.bridge.callNativeWithCallbackId('AnimationFrameModule', 'requestAnimationFrame', true);
-    } else if (__GLOBAL__.requestAnimationFrameQueue[__GLOBAL__.requestAnimationFrameId]) {
-      __GLOBAL__.requestAnimationFrameQueue[__GLOBAL__.requestAnimationFrameId].push(cb);
-    }
-    return '';
+  if (typeof cb !== 'function') {
+    throw new TypeError('Invalid arguments');
   }
-  throw new TypeError('Invalid arguments');
+  // frameTime and now are native monotonic ms, moved onto the clock of performance.now()
+  return frame.RequestAnimationFrame((frameTime, now) => {
+    cb(global.performance ? global.performance.now() - (now - frameTime) : frameTime);
+  });
 };
 
-global.cancelAnimationFrame = () => {};
+global.cancelAnimationFrame = (handle) => {
+  if (Number.isInteger(handle) && handle > 0) {
+    frame.CancelAnimationFrame(handle);
+  }
+};
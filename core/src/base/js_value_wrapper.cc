@@ -124,6 +124,62 @@ JSValueWrapper& JSValueWrapper::operator=(const JSValueWrapper& rhs) noexcept {
   type_ = rhs.type_;
   return *this;
 }
+JSValueWrapper& JSValueWrapper::operator=(JSValueWrapper&& rhs) noexcept {
+  if (this == &rhs) {
+    return *this;
+  }
+
+  switch (rhs.type_) {
+    case Type::Null:
+    case Type::Undefined:
+      deallocate();
+      break;
+    case Type::Int32:
+      deallocate();
+      int32_value_ = rhs.int32_value_;
+      break;
+    case Type::UInt32:
+      deallocate();
+      uint32_value_ = rhs.uint32_value_;
+      break;
+    case Type::Double:
+      deallocate();
+      double_value_ = rhs.double_value_;
+      break;
+    case Type::Boolean:
+      deallocate();
+      bool_value_ = rhs.bool_value_;
+      break;
+    case Type::Object:
+      if (type_ != Type::Object) {
+        deallocate();
+        new (&object_value_) JSObjectType(std::move(rhs.object_value_));
+      } else {
+        object_value_ = std::move(rhs.object_value_);
+      }
+      break;
+    case Type::Array:
+      if (type_ != Type::Array) {
+        deallocate();
+        new (&array_value_) JSArrayType(std::move(rhs.array_value_));
+      } else {
+        array_value_ = std::move(rhs.array_value_);
+      }
+      break;
+    case Type::String:
+      if (type_ != Type::String) {
+        deallocate();
+        new (&string_value_) std::string(std::move(rhs.string_value_));
+      } else {
+        string_value_ = std::move(rhs.string_value_);
+      }
+      break;
+    default:
+      break;
+  }
+  type_ = rhs.type_;
+  return *this;
+}
 JSValueWrapper& JSValueWrapper::operator=(const int32_t rhs) noexcept {
   deallocate();
   type_ = Type::Int32;
@@ -264,6 +320,35 @@ JSValueWrapper::JSValueWrapper(const JSValueWrapper& source)
   }
 }
 
+JSValueWrapper::JSValueWrapper(JSValueWrapper&& source) noexcept
+    : type_(source.type_) {
+  switch (type_) {
+    case Type::Int32:
+      int32_value_ = source.int32_value_;
+      break;
+    case Type::UInt32:
+      uint32_value_ = source.uint32_value_;
+      break;
+    case Type::Double:
+      double_value_ = source.double_value_;
+      break;
+    case Type::Boolean:
+      bool_value_ = source.bool_value_;
+      break;
+    case Type::String:
+      new (&string_value_) std::string(std::move(source.string_value_));
+      break;
+    case Type::Object:
+      new (&object_value_) JSObjectType(std::move(source.object_value_));
+      break;
+    case Type::Array:
+      new (&array_value_) JSArrayType(std::move(source.array_value_));
+      break;
+    default:
+      break;
+  }
+}
+
 inline void JSValueWrapper::deallocate() {
   switch (type_) {
     case Type::String:
@@ -273,7 +358,7 @@ inline void JSValueWrapper::deallocate() {
       array_value_.~vector();
       break;
     case Type::Object:
-      object_value_.clear();
+      object_value_.~JSObjectType();
       break;
     default:
       break;
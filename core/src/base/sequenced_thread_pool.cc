@@ -0,0 +1,229 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/base/sequenced_thread_pool.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/logging.h"
+#include "core/base/base_time.h"
+#include "core/base/timer_wheel.h"
+
+namespace hippy {
+namespace base {
+
+SequencedThreadPool::SequencedThreadPool(uint32_t max_thread_count, const Thread::Options& options)
+    : max_thread_count_(std::max<uint32_t>(max_thread_count, 1)), options_(options) {}
+
+SequencedThreadPool::~SequencedThreadPool() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& worker : workers_) {
+    worker->Terminate();
+  }
+}
+
+void SequencedThreadPool::Attach(std::shared_ptr<TaskRunner> runner) {
+  TDF_BASE_DCHECK(runner);
+  std::lock_guard<std::mutex> lock(mutex_);
+  Worker* target = nullptr;
+  size_t min_count = SIZE_MAX;
+  for (auto& worker : workers_) {
+    size_t count = worker->SequenceCount();
+    if (count < min_count) {
+      min_count = count;
+      target = worker.get();
+    }
+  }
+  if (!target || (min_count > 0 && workers_.size() < max_thread_count_)) {
+    std::string name = "hippy.js." + std::to_string(workers_.size());
+    auto worker = std::make_unique<Worker>(name.c_str(), options_);
+    worker->Start();
+    target = worker.get();
+    workers_.push_back(std::move(worker));
+  }
+  TDF_BASE_DLOG(INFO) << "SequencedThreadPool Attach, thread = " << target->name();
+  target->Add(std::move(runner));
+}
+
+SequencedThreadPool::Metrics SequencedThreadPool::GetMetrics() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Metrics metrics;
+  metrics.thread_count = static_cast<uint32_t>(workers_.size());
+  for (auto& worker : workers_) {
+    metrics.sequence_count += static_cast<uint32_t>(worker->SequenceCount());
+    metrics.task_count += worker->task_count_.load(std::memory_order_relaxed);
+    metrics.contended_task_count += worker->contended_task_count_.load(std::memory_order_relaxed);
+  }
+  return metrics;
+}
+
+SequencedThreadPool::Worker::Worker(const char* name, const Thread::Options& options)
+    : Thread(options),
+      task_count_(0),
+      contended_task_count_(0),
+      generation_(0),
+      pending_(false),
+      terminated_(false),
+      is_waiting_(false),
+      cursor_(0) {
+  SetName(name);
+}
+
+SequencedThreadPool::Worker::~Worker() = default;
+
+void SequencedThreadPool::Worker::Add(std::shared_ptr<TaskRunner> runner) {
+  runner->AttachToHost(this, Id());
+  std::lock_guard<std::mutex> lock(mutex_);
+  runners_.push_back(std::move(runner));
+  ++generation_;
+  pending_ = true;
+  cv_.notify_one();
+}
+
+size_t SequencedThreadPool::Worker::SequenceCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return runners_.size();
+}
+
+void SequencedThreadPool::Worker::Terminate() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    terminated_ = true;
+    pending_ = true;
+  }
+  cv_.notify_one();
+  Join();
+}
+
+// runners call this after the seq_cst fence in TaskRunner::WakeUpIfWaiting,
+// which pairs with the fence in Wait
+void SequencedThreadPool::Worker::WakeUp(bool force) {
+  if (force || is_waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = true;
+    cv_.notify_one();
+  }
+}
+
+void SequencedThreadPool::Worker::Run() {
+  std::vector<std::shared_ptr<TaskRunner>> runners;
+  uint32_t generation = UINT32_MAX;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (terminated_) {
+        break;
+      }
+      if (generation != generation_) {
+        runners = runners_;
+        generation = generation_;
+        cursor_ = 0;
+      }
+    }
+
+    TaskRunner::DelayedTimeInMs now = MonotonicallyIncreasingTime();
+    TaskRunner::DelayedTimeInMs next_wake_up = TimerWheel::kNoDeadline;
+    size_t count = runners.size();
+    size_t ready_count = 0;
+    if (count > 1) {
+      for (auto& runner : runners) {
+        if (runner->HasPendingTask()) {
+          ++ready_count;
+        }
+      }
+    }
+    bool ran = false;
+    // idle tasks are only offered once no sequence has regular work
+    for (int pass = 0; pass < 2 && !ran; ++pass) {
+      for (size_t i = 0; i < count && !ran; ++i) {
+        size_t index = (cursor_ + i) % count;
+        TaskRunner::DelayedTimeInMs wake_up = TimerWheel::kNoDeadline;
+        if (runners[index]->RunNextTask(now, pass == 1, wake_up)) {
+          task_count_.fetch_add(1, std::memory_order_relaxed);
+          if (ready_count > 1) {
+            contended_task_count_.fetch_add(1, std::memory_order_relaxed);
+          }
+          cursor_ = index + 1;
+          ran = true;
+        }
+        next_wake_up = std::min(next_wake_up, wake_up);
+      }
+    }
+
+    DetachDrained(runners);
+    if (!ran) {
+      Wait(runners, now, next_wake_up);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& runner : runners_) {
+    runner->DetachFromHost();
+  }
+  runners_.clear();
+}
+
+void SequencedThreadPool::Worker::DetachDrained(std::vector<std::shared_ptr<TaskRunner>>& runners) {
+  for (auto& runner : runners) {
+    if (!runner->IsTerminated() || runner->HasPendingTask()) {
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::find(runners_.begin(), runners_.end(), runner);
+      if (it == runners_.end()) {
+        continue;
+      }
+      runners_.erase(it);
+      ++generation_;
+    }
+    runner->DetachFromHost();
+  }
+}
+
+void SequencedThreadPool::Worker::Wait(const std::vector<std::shared_ptr<TaskRunner>>& runners,
+                                       TaskRunner::DelayedTimeInMs now,
+                                       TaskRunner::DelayedTimeInMs next_wake_up) {
+  is_waiting_.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  for (auto& runner : runners) {
+    if (runner->HasPendingTask()) {
+      is_waiting_.store(false, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!pending_) {
+    if (next_wake_up == TimerWheel::kNoDeadline) {
+      cv_.wait(lock);
+    } else if (next_wake_up > now) {
+      cv_.wait_for(lock, std::chrono::milliseconds(next_wake_up - now));
+    }
+  }
+  pending_ = false;
+  is_waiting_.store(false, std::memory_order_relaxed);
+}
+
+}  // namespace base
+}  // namespace hippy
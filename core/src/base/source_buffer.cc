@@ -0,0 +1,140 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/base/source_buffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+#include "base/logging.h"
+#include "core/base/common.h"
+#include "core/base/string_view_utils.h"
+
+namespace hippy {
+namespace base {
+
+namespace {
+
+constexpr size_t kReadChunkSize = 64 * 1024;
+
+// The vm reads external strings for as long as they live, and touching a
+// mapped page past the end of a truncated file raises SIGBUS. Only files that
+// this app owns and nobody else may write are mapped, so only the app itself
+// can truncate them, and it replaces its files instead.
+bool IsSafeToMap(const struct stat& st) {
+  return S_ISREG(st.st_mode) && st.st_uid == geteuid() && !(st.st_mode & (S_IWGRP | S_IWOTH));
+}
+
+// reads from fd rather than reopening the path, which may name another file by now
+bool ReadAll(int fd, size_t size_hint, SourceBuffer::u8string& content) {
+  // one spare byte tells a file that grew since fstat from one that did not
+  content.resize(size_hint + 1);
+  size_t length = 0;
+  for (;;) {
+    if (length == content.size()) {
+      content.resize(content.size() + kReadChunkSize);
+    }
+    ssize_t count = read(fd, &content[length], content.size() - length);
+    if (count == 0) {
+      content.resize(length);
+      return true;
+    }
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    length += static_cast<size_t>(count);
+  }
+}
+
+std::shared_ptr<SourceBuffer> CopyFile(int fd, size_t size_hint, const tdf::base::unicode_string_view& file_path) {
+  SourceBuffer::u8string content;
+  if (!ReadAll(fd, size_hint, content)) {
+    TDF_BASE_DLOG(WARNING) << "SourceBuffer read fail, file_path = " << file_path << ", errno = " << errno;
+    close(fd);
+    return nullptr;
+  }
+  close(fd);
+  return SourceBuffer::FromString(std::move(content));
+}
+
+}  // namespace
+
+SourceBuffer::SourceBuffer(const uint8_t* data, size_t size, Releaser releaser)
+    : data_(data), size_(size), releaser_(std::move(releaser)) {}
+
+SourceBuffer::~SourceBuffer() {
+  if (releaser_) {
+    releaser_();
+  }
+}
+
+std::shared_ptr<SourceBuffer> SourceBuffer::FromFile(const unicode_string_view& file_path) {
+  auto path_str = StringViewUtils::Convert(file_path, unicode_string_view::Encoding::Utf8).utf8_value();
+  int fd = open(reinterpret_cast<const char*>(path_str.c_str()), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    TDF_BASE_DLOG(INFO) << "SourceBuffer open fail, file_path = " << file_path;
+    return nullptr;
+  }
+  struct stat st{};
+  size_t size = 0;
+  if (fstat(fd, &st) != 0 || !numeric_cast<off_t, size_t>(st.st_size, size) || size == 0) {
+    close(fd);
+    TDF_BASE_DLOG(INFO) << "SourceBuffer empty file, file_path = " << file_path;
+    return nullptr;
+  }
+  if (!IsSafeToMap(st)) {
+    TDF_BASE_DLOG(INFO) << "SourceBuffer copied, file_path = " << file_path << ", size = " << size;
+    return CopyFile(fd, size, file_path);
+  }
+  void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (address == MAP_FAILED) {
+    TDF_BASE_DLOG(WARNING) << "SourceBuffer mmap fail, file_path = " << file_path << ", errno = " << errno;
+    return CopyFile(fd, size, file_path);
+  }
+  close(fd);
+  // the script is compiled front to back right after loading
+  madvise(address, size, MADV_WILLNEED);
+  TDF_BASE_DLOG(INFO) << "SourceBuffer mapped, file_path = " << file_path << ", size = " << size;
+  return std::make_shared<SourceBuffer>(static_cast<const uint8_t*>(address), size, [address, size] {
+    munmap(address, size);
+  });
+}
+
+std::shared_ptr<SourceBuffer> SourceBuffer::FromString(u8string content) {
+  if (content.empty()) {
+    return nullptr;
+  }
+  auto holder = std::make_shared<u8string>(std::move(content));
+  return std::make_shared<SourceBuffer>(reinterpret_cast<const uint8_t*>(holder->c_str()), holder->length(),
+                                        [holder] {});
+}
+
+}  // namespace base
+}  // namespace hippy
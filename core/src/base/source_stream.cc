@@ -0,0 +1,97 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/base/source_stream.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <utility>
+
+#include "base/logging.h"
+#include "core/base/string_view_utils.h"
+
+namespace hippy {
+namespace base {
+
+SourceStream::SourceStream(Reader reader, Releaser releaser)
+    : reader_(std::move(reader)), releaser_(std::move(releaser)), is_finished_(false), is_failed_(false) {}
+
+SourceStream::~SourceStream() {
+  if (releaser_) {
+    releaser_();
+  }
+}
+
+std::shared_ptr<SourceStream> SourceStream::FromFile(const unicode_string_view& file_path) {
+  auto path_str = StringViewUtils::Convert(file_path, unicode_string_view::Encoding::Utf8).utf8_value();
+  int fd = open(reinterpret_cast<const char*>(path_str.c_str()), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    TDF_BASE_DLOG(INFO) << "SourceStream open fail, file_path = " << file_path;
+    return nullptr;
+  }
+  auto reader = [fd](uint8_t* buffer, size_t size, size_t* length) {
+    ssize_t ret;
+    do {
+      ret = read(fd, buffer, size);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+      TDF_BASE_DLOG(WARNING) << "SourceStream read fail, errno = " << errno;
+      return false;
+    }
+    *length = static_cast<size_t>(ret);
+    return true;
+  };
+  return std::make_shared<SourceStream>(std::move(reader), [fd] {
+    close(fd);
+  });
+}
+
+size_t SourceStream::Read(uint8_t* buffer, size_t size) {
+  size_t offset = 0;
+  while (!is_finished_ && offset < size) {
+    size_t length = 0;
+    if (!reader_(buffer + offset, size - offset, &length)) {
+      is_failed_ = true;
+      is_finished_ = true;
+      return 0;
+    }
+    if (length == 0) {
+      is_finished_ = true;
+      break;
+    }
+    offset += length;
+  }
+  content_.append(reinterpret_cast<const unicode_string_view::char8_t_*>(buffer), offset);
+  return offset;
+}
+
+std::shared_ptr<SourceBuffer> SourceStream::TakeContent() {
+  if (is_failed_) {
+    return nullptr;
+  }
+  return SourceBuffer::FromString(std::move(content_));
+}
+
+}  // namespace base
+}  // namespace hippy
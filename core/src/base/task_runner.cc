@@ -22,6 +22,8 @@
 
 #include "core/base/task_runner.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "core/base/base_time.h"
 #include "core/base/macros.h"
@@ -31,9 +33,24 @@
 namespace hippy {
 namespace base {
 
-TaskRunner::TaskRunner() : Thread(Options("Task Runner")) {
-  is_terminated_ = false;
-}
+// consecutive tasks a level may run before lower levels get their turn
+const std::array<uint32_t, TaskRunner::kPriorityCount> TaskRunner::kPriorityWeights = {8, 4, 1};
+
+TaskRunner::TaskRunner() : TaskRunner(Options("Task Runner")) {}
+
+TaskRunner::TaskRunner(const Options& options)
+    : Thread(options),
+      is_terminated_(false),
+      credits_(kPriorityWeights),
+      is_waiting_(false),
+      host_(nullptr),
+      running_sequence_(0),
+      running_task_id_(0),
+      running_task_origin_(nullptr),
+      running_task_start_time_(0),
+      running_task_watcher_count_(0),
+      is_task_stats_enabled_(false),
+      delayed_task_queue_(MonotonicallyIncreasingTime()) {}
 
 TaskRunner::~TaskRunner() = default;
 
@@ -47,103 +64,308 @@ void TaskRunner::Run() {
     }
     // TDF_BASE_DLOG(INFO) <<  "run task, id = %d", task->id_);
 
-    bool is_cancel;
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      is_cancel = task->canceled_;
-    }
-    if (!is_cancel) {
-      task->Run();
-    }
+    RunTask(task);
   }
 }
 
 void TaskRunner::Terminate() {
+  bool in_task;
   {
     std::unique_lock<std::mutex> lock(mutex_);
-    TDF_BASE_DLOG(INFO) << "TaskRunner::Terminate task_queue_ size = " << task_queue_.size();
     if (is_terminated_) {
       TDF_BASE_DLOG(INFO) << "TaskRunner has been terminated";
       return;
     }
     is_terminated_ = true;
-    if (this->Id() == hippy::base::ThreadId::GetCurrent()) {
-      TDF_BASE_DLOG(ERROR) << "terminate in task";
-      return;
-    }
+    in_task = this->Id() == hippy::base::ThreadId::GetCurrent();
   }
   cv_.notify_one();
+  // the host detaches the runner once the queued tasks are drained
+  WakeUpHost(true);
+  if (in_task) {
+    TDF_BASE_DLOG(ERROR) << "terminate in task";
+    return;
+  }
+  if (host_.load()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return host_.load() == nullptr; });
+    TDF_BASE_DLOG(INFO) << "TaskRunner Terminate detached";
+    return;
+  }
   TDF_BASE_DLOG(INFO) << "TaskRunner Terminate join begin";
   Join();
   TDF_BASE_DLOG(INFO) << "TaskRunner Terminate join end";
 }
 
 void TaskRunner::PostTask(std::shared_ptr<Task> task) {
+  Priority priority = task->isPriorityTask() ? Priority::kInput : Priority::kNormal;
+  PostTask(std::move(task), priority);
+}
+
+void TaskRunner::PostTask(std::shared_ptr<Task> task, Priority priority) {
   TDF_BASE_DLOG(INFO) << "TaskRunner::PostTask task id = " << task->id_;
+  PostTaskNoLock(std::move(task), priority);
+  WakeUpIfWaiting();
+}
+
+void TaskRunner::PostDelayedTask(
+    std::shared_ptr<Task> task,
+    TaskRunner::DelayedTimeInMs delay_in_milliseconds,
+    TimerPrecision precision) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (is_terminated_) {
+      return;
+    }
+
+    DelayedTimeInMs deadline = MonotonicallyIncreasingTime() + delay_in_milliseconds;
+    DelayedTimeInMs window = timer_slack_.window;
+    task->is_deadline_coalesced_ = false;
+    if (precision == TimerPrecision::kCoalesced && window > 1 &&
+        delay_in_milliseconds >= timer_slack_.min_delay) {
+      // aligning to a grid instead of to other timers keeps this O(1)
+      DelayedTimeInMs aligned = (deadline + window - 1) / window * window;
+      if (aligned != deadline) {
+        deadline = aligned;
+        ++timer_stats_.coalesced_task_count;
+        task->is_deadline_coalesced_ = true;
+      }
+    }
+    delayed_task_queue_.Schedule(std::move(task), deadline);
+
+    cv_.notify_one();
+  }
+  // hosts take their own lock before mutex_, see SequencedThreadPool::Worker
+  WakeUpHost(true);
+}
+
+void TaskRunner::CancelTask(const std::shared_ptr<Task>& task) {
+  if (!task) {
+    return;
+  }
+  task->canceled_ = true;
+
+  // release the delayed entry now instead of keeping it until its deadline
   std::lock_guard<std::mutex> lock(mutex_);
+  delayed_task_queue_.Cancel(task->id_);
+}
 
-  PostTaskNoLock(std::move(task));
+Executor TaskRunner::Schedule(Priority priority) {
+  std::weak_ptr<TaskRunner> weak_runner = weak_from_this();
+  return Executor([weak_runner, priority](Executor::Job job) {
+    auto runner = weak_runner.lock();
+    if (runner) {
+      runner->PostFunction(std::move(job), priority);
+    }
+  });
+}
 
-  cv_.notify_one();
+void TaskRunner::SetTimerSlack(TimerSlack slack) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  timer_slack_ = slack;
 }
 
-void TaskRunner::PostDelayedTask(
-    std::shared_ptr<Task> task,
-    TaskRunner::DelayedTimeInMs delay_in_milliseconds) {
+TaskRunner::TimerStats TaskRunner::GetTimerStats() {
   std::lock_guard<std::mutex> lock(mutex_);
+  return timer_stats_;
+}
 
+void TaskRunner::PostTaskNoLock(std::shared_ptr<Task> task, Priority priority) {
   if (is_terminated_) {
     return;
   }
 
-  DelayedTimeInMs deadline = MonotonicallyIncreasingTime() + delay_in_milliseconds;
-  delayed_task_queue_.push(std::make_pair(deadline, std::move(task)));
+  if (IsTaskStatsEnabled()) {
+    task->enqueue_time_ = MonotonicallyIncreasingTimeInUs();
+  }
+  task_queues_[static_cast<size_t>(priority)].Push(std::move(task));
+}
 
-  cv_.notify_one();
+bool TaskRunner::PopTask(std::shared_ptr<Task>& task) {
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < kPriorityCount; ++i) {
+      if (credits_[i] > 0 && task_queues_[i].Pop(task)) {
+        --credits_[i];
+        return true;
+      }
+    }
+    // every level with credit left is empty, start a new round
+    credits_ = kPriorityWeights;
+  }
+  return false;
 }
 
-void TaskRunner::CancelTask(const std::shared_ptr<Task>& task) {
-  std::lock_guard<std::mutex> lock(mutex_);
+bool TaskRunner::HasPendingTask() const {
+  for (const auto& queue : task_queues_) {
+    if (!queue.IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
 
-  if (!task) {
+// nested runs, e.g. the inspector pause loop, restore the outer task when done
+void TaskRunner::RunTask(const std::shared_ptr<Task>& task) {
+  if (task->canceled_) {
     return;
   }
-  task->canceled_ = true;
+  if (!IsRunningTaskWatched()) {
+    if (IsTaskStatsEnabled()) {
+      RunAndRecordTask(task, MonotonicallyIncreasingTimeInUs());
+    } else {
+      task->Run();
+    }
+    return;
+  }
+  // plain stores, only this thread writes them; GetRunningTask uses the
+  // sequence to detect a torn read
+  Task::TaskId outer_task_id = running_task_id_.load(std::memory_order_relaxed);
+  const char* outer_origin = running_task_origin_.load(std::memory_order_relaxed);
+  uint64_t outer_start_time = running_task_start_time_.load(std::memory_order_relaxed);
+  uint64_t start_time = MonotonicallyIncreasingTimeInUs();
+  uint64_t sequence = running_sequence_.load(std::memory_order_relaxed);
+  running_sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  running_task_id_.store(task->id_, std::memory_order_relaxed);
+  running_task_origin_.store(task->origin_, std::memory_order_relaxed);
+  running_task_start_time_.store(start_time, std::memory_order_relaxed);
+  running_sequence_.store(sequence + 2, std::memory_order_release);
+
+  if (IsTaskStatsEnabled()) {
+    RunAndRecordTask(task, start_time);
+  } else {
+    task->Run();
+  }
+
+  running_sequence_.store(sequence + 3, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  running_task_id_.store(outer_task_id, std::memory_order_relaxed);
+  running_task_origin_.store(outer_origin, std::memory_order_relaxed);
+  running_task_start_time_.store(outer_start_time, std::memory_order_relaxed);
+  running_sequence_.store(sequence + 4, std::memory_order_release);
 }
 
-void TaskRunner::PostTaskNoLock(std::shared_ptr<Task> task) {
-  if (is_terminated_) {
-    return;
+void TaskRunner::RunAndRecordTask(const std::shared_ptr<Task>& task, uint64_t start_time) {
+  task->Run();
+  uint64_t duration = MonotonicallyIncreasingTimeInUs() - start_time;
+  // tasks posted before the stats were enabled have no enqueue time
+  uint64_t queue_wait = task->enqueue_time_ ? start_time - task->enqueue_time_ : UINT64_MAX;
+  task->enqueue_time_ = 0;
+  task_stats_.Record(task->origin_, queue_wait, start_time, duration);
+}
+
+bool TaskRunner::GetRunningTask(RunningTask& running_task) const {
+  uint64_t sequence;
+  Task::TaskId task_id;
+  const char* origin;
+  uint64_t start_time;
+  do {
+    sequence = running_sequence_.load(std::memory_order_acquire);
+    task_id = running_task_id_.load(std::memory_order_relaxed);
+    origin = running_task_origin_.load(std::memory_order_relaxed);
+    start_time = running_task_start_time_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((sequence & 1) || sequence != running_sequence_.load(std::memory_order_relaxed));
+  if (task_id == 0) {
+    return false;
   }
+  running_task.sequence = sequence;
+  running_task.task_id = task_id;
+  running_task.origin = origin;
+  running_task.start_time_in_us = start_time;
+  return true;
+}
 
-  task_queue_.push(std::move(task));
+// pairs with the fence in GetNext: either the runner sees the pushed task
+// before it sleeps, or we see is_waiting_ and notify under the lock
+void TaskRunner::WakeUpIfWaiting() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (is_waiting_.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_one();
+  }
+  WakeUpHost(false);
 }
 
-std::shared_ptr<Task> TaskRunner::GetNext() {
-  std::unique_lock<std::mutex> lock(mutex_);
+void TaskRunner::WakeUpHost(bool force) {
+  TaskRunnerHost* host = host_.load(std::memory_order_acquire);
+  if (host) {
+    host->WakeUp(force);
+  }
+}
 
-  for (;;) {
-    DelayedTimeInMs now = MonotonicallyIncreasingTime();
-    std::shared_ptr<Task> task = popTaskFromDelayedQueueNoLock(now);
-    while (task) {
-      PostTaskNoLock(std::move(task));
-      task = popTaskFromDelayedQueueNoLock(now);
+void TaskRunner::AttachToHost(TaskRunnerHost* host, ThreadId host_thread_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  thread_id_ = host_thread_id;
+  host_.store(host, std::memory_order_release);
+}
+
+void TaskRunner::DetachFromHost() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    host_.store(nullptr, std::memory_order_release);
+  }
+  cv_.notify_all();
+}
+
+bool TaskRunner::RunNextTask(DelayedTimeInMs now,
+                             bool allow_idle,
+                             DelayedTimeInMs& next_wake_up) {
+  std::shared_ptr<Task> task;
+  if (!PopTask(task)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PopTasksFromDelayedQueueNoLock(now);
+    if (!PopTask(task)) {
+      next_wake_up = delayed_task_queue_.NextWakeUp();
+      if (allow_idle && !is_terminated_) {
+        task = GetIdleTaskNoLock(now, next_wake_up);
+      }
+      if (!task) {
+        return false;
+      }
     }
+  }
 
-    if (!task_queue_.empty()) {
-      std::shared_ptr<Task> result = std::move(task_queue_.front());
-      task_queue_.pop();
+  RunTask(task);
+  return true;
+}
+
+std::shared_ptr<Task> TaskRunner::GetNext() {
+  for (;;) {
+    std::shared_ptr<Task> result;
+    if (PopTask(result)) {
       return result;
     }
 
+    std::unique_lock<std::mutex> lock(mutex_);
+    DelayedTimeInMs now = MonotonicallyIncreasingTime();
+    PopTasksFromDelayedQueueNoLock(now);
+    if (HasPendingTask()) {
+      continue;
+    }
+
     if (is_terminated_) {
       TDF_BASE_DLOG(INFO) << "TaskRunner terminate";
       return nullptr;
     }
 
-    if (task_queue_.empty() && !delayed_task_queue_.empty()) {
-      const DelayedEntry& delayed_task = delayed_task_queue_.top();
-      DelayedTimeInMs wait_in_ms = delayed_task.first - now;
+    is_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (HasPendingTask()) {
+      is_waiting_.store(false, std::memory_order_relaxed);
+      continue;
+    }
+
+    DelayedTimeInMs next_wake_up = delayed_task_queue_.NextWakeUp();
+    std::shared_ptr<Task> idle_task = GetIdleTaskNoLock(now, next_wake_up);
+    if (idle_task) {
+      is_waiting_.store(false, std::memory_order_relaxed);
+      return idle_task;
+    }
+
+    if (next_wake_up != TimerWheel::kNoDeadline) {
+      DelayedTimeInMs wait_in_ms = next_wake_up - now;
       bool notified =
           cv_.wait_for(lock, std::chrono::milliseconds(wait_in_ms)) ==
           std::cv_status::timeout;
@@ -151,22 +373,39 @@ std::shared_ptr<Task> TaskRunner::GetNext() {
     } else {
       cv_.wait(lock);
     }
+    is_waiting_.store(false, std::memory_order_relaxed);
   }
 }
 
-std::shared_ptr<Task> TaskRunner::popTaskFromDelayedQueueNoLock(
-    TaskRunner::DelayedTimeInMs now) {
-  if (delayed_task_queue_.empty())
-    return {};
-
-  const DelayedEntry& deadline_and_task = delayed_task_queue_.top();
-  if (deadline_and_task.first > now)
-    return {};
+std::shared_ptr<Task> TaskRunner::GetIdleTaskNoLock(DelayedTimeInMs now,
+                                                    DelayedTimeInMs next_wake_up) {
+  HIPPY_USE(now);
+  HIPPY_USE(next_wake_up);
+  return nullptr;
+}
 
-  std::shared_ptr<Task> result =
-      std::move(const_cast<DelayedEntry&>(deadline_and_task).second);
-  delayed_task_queue_.pop();
-  return result;
+void TaskRunner::PopTasksFromDelayedQueueNoLock(TaskRunner::DelayedTimeInMs now) {
+  std::vector<std::shared_ptr<Task>> expired;
+  delayed_task_queue_.Advance(now, expired);
+  if (!expired.empty()) {
+    ++timer_stats_.wake_up_count;
+    timer_stats_.delayed_task_count += expired.size();
+  }
+  uint64_t coalesced_count = 0;
+  for (auto& task : expired) {
+    if (task->is_deadline_coalesced_) {
+      task->is_deadline_coalesced_ = false;
+      ++coalesced_count;
+    }
+  }
+  // each moved deadline saves at most one wake up, and a batch of n tasks
+  // saves at most n - 1
+  if (coalesced_count > 0) {
+    timer_stats_.saved_wake_up_count += std::min<uint64_t>(coalesced_count, expired.size() - 1);
+  }
+  for (auto& task : expired) {
+    PostTaskNoLock(std::move(task), Priority::kNormal);
+  }
 }
 
 }  // namespace base
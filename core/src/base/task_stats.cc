@@ -0,0 +1,140 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/base/task_stats.h"
+
+#include <algorithm>
+#include <map>
+
+namespace hippy {
+namespace base {
+
+constexpr size_t Histogram::kBucketCount;
+constexpr uint64_t TaskStats::kDefaultLongTaskThresholdInUs;
+
+void Histogram::Add(uint64_t value) {
+  size_t bucket = 0;
+  while (bucket < kBucketCount - 1 && value >> bucket) {
+    ++bucket;
+  }
+  ++buckets_[bucket];
+  ++count_;
+  sum_ += value;
+  max_ = std::max(max_, value);
+}
+
+void Histogram::Merge(const Histogram& other) {
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+uint64_t Histogram::Percentile(double quantile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(quantile * static_cast<double>(count_));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= rank && buckets_[i] > 0) {
+      // the last bucket is open ended
+      return i == 0 ? 0 : std::min(max_, (static_cast<uint64_t>(1) << i) - 1);
+    }
+  }
+  return max_;
+}
+
+void TaskStats::Record(const char* origin, uint64_t queue_wait, uint64_t start_time, uint64_t duration) {
+  std::vector<LongTaskObserver> observers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[origin];
+    if (queue_wait != UINT64_MAX) {
+      entry.queue_wait.Add(queue_wait);
+    }
+    entry.run_time.Add(duration);
+    if (duration < long_task_threshold_ || long_task_observers_.empty()) {
+      return;
+    }
+    for (const auto& item : long_task_observers_) {
+      observers.push_back(item.second);
+    }
+  }
+  LongTask long_task{origin, start_time, queue_wait, duration};
+  for (const auto& observer : observers) {
+    observer(long_task);
+  }
+}
+
+std::vector<TaskStats::OriginStats> TaskStats::GetSnapshot() {
+  std::map<std::string, OriginStats> merged;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& item : entries_) {
+      std::string origin = item.first ? item.first : "unknown";
+      OriginStats& stats = merged[origin];
+      stats.origin = origin;
+      stats.queue_wait.Merge(item.second.queue_wait);
+      stats.run_time.Merge(item.second.run_time);
+    }
+  }
+  std::vector<OriginStats> snapshot;
+  snapshot.reserve(merged.size());
+  for (auto& item : merged) {
+    snapshot.push_back(std::move(item.second));
+  }
+  return snapshot;
+}
+
+void TaskStats::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+TaskStats::ObserverId TaskStats::AddLongTaskObserver(LongTaskObserver observer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ObserverId id = next_observer_id_++;
+  long_task_observers_.emplace_back(id, std::move(observer));
+  return id;
+}
+
+void TaskStats::RemoveLongTaskObserver(ObserverId id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  long_task_observers_.erase(
+      std::remove_if(long_task_observers_.begin(), long_task_observers_.end(),
+                     [id](const std::pair<ObserverId, LongTaskObserver>& item) {
+                       return item.first == id;
+                     }),
+      long_task_observers_.end());
+}
+
+void TaskStats::SetLongTaskThreshold(uint64_t threshold) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  long_task_threshold_ = threshold;
+}
+
+}  // namespace base
+}  // namespace hippy
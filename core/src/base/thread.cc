@@ -22,10 +22,20 @@
 
 #include "core/base/thread.h"
 
+#include <cerrno>
 #include <climits>
 #include <cstdio>
 #include <cstring>
 
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread/qos.h>
+#endif
+
 #include "base/logging.h"
 #include "core/base/macros.h"
 
@@ -34,9 +44,14 @@ namespace base {
 
 static void* ThreadEntry(void* arg);
 
-Thread::Thread(const Options& options) : stack_size_(options.stack_size()) {
-  if (stack_size_ > 0 && static_cast<size_t>(stack_size_) < PTHREAD_STACK_MIN) {
-    stack_size_ = PTHREAD_STACK_MIN;
+Thread::Thread(const Options& options)
+    : stack_size_(options.stack_size()),
+      priority_(options.priority()),
+      affinity_mask_(options.affinity_mask()) {
+  // PTHREAD_STACK_MIN is a long from sysconf on newer glibc
+  size_t min_stack_size = static_cast<size_t>(PTHREAD_STACK_MIN);
+  if (stack_size_ > 0 && stack_size_ < min_stack_size) {
+    stack_size_ = min_stack_size;
   }
 
   SetName(options.name());
@@ -63,6 +78,18 @@ void Thread::Start() {
     }
   }
 
+#if defined(__APPLE__)
+  if (priority_ != Options::kDefaultPriority) {
+    qos_class_t qos_class = QOS_CLASS_DEFAULT;
+    if (priority_ < 0) {
+      qos_class = QOS_CLASS_USER_INTERACTIVE;
+    } else if (priority_ > 0) {
+      qos_class = QOS_CLASS_UTILITY;
+    }
+    pthread_attr_set_qos_class_np(&attr, qos_class, 0);
+  }
+#endif
+
   result = pthread_create(&thread_, &attr, ThreadEntry, this);
   TDF_BASE_CHECK(result == 0) << "pthread_create() returns " << result;
   thread_id_.InitId(thread_);
@@ -79,13 +106,39 @@ void Thread::SetName(const char* name) {
 }
 
 static void SetThreadName(const char* name) {
-#ifdef ANDROID
+#if defined(ANDROID) || defined(__linux__)
   pthread_setname_np(pthread_self(), name);
 #else
   pthread_setname_np(name);
 #endif
 }
 
+// bionic has no pthread_attr_setaffinity_np and nice values are per thread on
+// linux, so both are applied by the new thread itself before it runs
+static void ApplySchedulingOptions(const Thread* thread) {
+#if defined(__linux__)
+  if (thread->priority() != Thread::Options::kDefaultPriority) {
+    auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, thread->priority()) != 0) {
+      TDF_BASE_DLOG(WARNING) << "setpriority failed, thread = " << thread->name() << ", errno = " << errno;
+    }
+  }
+  uint64_t affinity_mask = thread->affinity_mask();
+  if (affinity_mask) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; ++cpu) {
+      if (affinity_mask & (static_cast<uint64_t>(1) << cpu)) {
+        CPU_SET(cpu, &cpu_set);
+      }
+    }
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      TDF_BASE_DLOG(WARNING) << "sched_setaffinity failed, thread = " << thread->name() << ", errno = " << errno;
+    }
+  }
+#endif
+}
+
 static void* ThreadEntry(void* arg) {
   if (arg == nullptr) {
     return reinterpret_cast<void*>(+false);
@@ -93,6 +146,7 @@ static void* ThreadEntry(void* arg) {
 
   auto* thread = reinterpret_cast<Thread*>(arg);
   SetThreadName(thread->name());
+  ApplySchedulingOptions(thread);
   thread->Run();
 
   return reinterpret_cast<void*>(+true);
@@ -0,0 +1,246 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/base/timer_wheel.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace hippy {
+namespace base {
+
+constexpr TimerWheel::TimeInMs TimerWheel::kNoDeadline;
+
+TimerWheel::TimerWheel(TimeInMs now) : current_(now) {
+  for (uint32_t level = 0; level < kLevelCount; ++level) {
+    slots_[level].resize(SlotCount(level));
+    occupied_[level].resize((SlotCount(level) + 63) / 64, 0);
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  for (auto& item : entries_) {
+    delete item.second;
+  }
+}
+
+void TimerWheel::Schedule(std::shared_ptr<Task> task, TimeInMs deadline) {
+  TDF_BASE_DCHECK(task);
+  auto* entry = new Entry();
+  entry->id = task->id_;
+  entry->task = std::move(task);
+  entry->deadline = deadline;
+  entries_.emplace(entry->id, entry);
+  Place(entry);
+}
+
+bool TimerWheel::Cancel(Task::TaskId id) {
+  auto range = entries_.equal_range(id);
+  if (range.first == range.second) {
+    return false;
+  }
+  for (auto it = range.first; it != range.second; ++it) {
+    Unlink(it->second);
+    delete it->second;
+  }
+  entries_.erase(range.first, range.second);
+  return true;
+}
+
+void TimerWheel::Advance(TimeInMs now, std::vector<std::shared_ptr<Task>>& expired) {
+  Expire(overdue_, expired);
+  while (current_ <= now && !entries_.empty()) {
+    uint32_t index = static_cast<uint32_t>(current_ & (kRootSize - 1));
+    if (index == 0) {
+      for (uint32_t level = 1; level < kLevelCount; ++level) {
+        Cascade(level);
+        if (((current_ >> Shift(level)) & (kLevelSize - 1)) != 0) {
+          break;
+        }
+      }
+    }
+
+    Expire(slots_[0][index], expired);
+
+    // jump over ticks where nothing expires or cascades
+    ++current_;
+    if (current_ <= now) {
+      current_ = std::min(NextWakeUp(), now + 1);
+    }
+  }
+  if (entries_.empty() && current_ <= now) {
+    current_ = now + 1;
+  }
+}
+
+TimerWheel::TimeInMs TimerWheel::NextWakeUp() const {
+  if (entries_.empty()) {
+    return kNoDeadline;
+  }
+
+  if (overdue_.head) {
+    return current_ - 1;
+  }
+
+  TimeInMs result = kNoDeadline;
+  uint32_t index = static_cast<uint32_t>(current_ & (kRootSize - 1));
+  int32_t slot = FindOccupied(0, index);
+  if (slot >= 0) {
+    result = current_ + static_cast<TimeInMs>(slot - index);
+  } else if ((slot = FindOccupied(0, 0)) >= 0) {
+    result = current_ + kRootSize - index + static_cast<TimeInMs>(slot);
+  }
+
+  for (uint32_t level = 1; level < kLevelCount; ++level) {
+    uint32_t shift = Shift(level);
+    TimeInMs mask = (static_cast<TimeInMs>(1) << shift) - 1;
+    TimeInMs boundary = (current_ & mask) == 0 ? current_ : ((current_ >> shift) + 1) << shift;
+    uint32_t start = static_cast<uint32_t>((boundary >> shift) & (kLevelSize - 1));
+    slot = FindOccupied(level, start);
+    if (slot < 0) {
+      slot = FindOccupied(level, 0);
+    }
+    if (slot >= 0) {
+      TimeInMs distance = (static_cast<uint32_t>(slot) - start) & (kLevelSize - 1);
+      result = std::min(result, boundary + (distance << shift));
+    }
+  }
+  return result;
+}
+
+void TimerWheel::Place(Entry* entry) {
+  if (entry->deadline < current_) {
+    // the tick has already been processed, hand it out on the next Advance
+    Link(entry, kLevelCount, 0);
+    return;
+  }
+  TimeInMs deadline = entry->deadline;
+  TimeInMs delta = deadline - current_;
+  constexpr TimeInMs kMaxDelta = (static_cast<TimeInMs>(1) << kMaxBits) - 1;
+  if (delta > kMaxDelta) {
+    // re-placed with the real deadline when the top level cascades
+    deadline = current_ + kMaxDelta;
+    delta = kMaxDelta;
+  }
+
+  uint32_t level = 0;
+  while (level + 1 < kLevelCount && delta >= (static_cast<TimeInMs>(1) << (Shift(level + 1)))) {
+    ++level;
+  }
+  uint32_t slot = static_cast<uint32_t>((deadline >> Shift(level)) & (SlotCount(level) - 1));
+  Link(entry, level, slot);
+}
+
+void TimerWheel::Link(Entry* entry, uint32_t level, uint32_t slot) {
+  Slot& list = level < kLevelCount ? slots_[level][slot] : overdue_;
+  entry->level = level;
+  entry->slot = slot;
+  entry->prev = nullptr;
+  entry->next = list.head;
+  if (list.head) {
+    list.head->prev = entry;
+  }
+  list.head = entry;
+  if (level < kLevelCount) {
+    occupied_[level][slot >> 6] |= static_cast<uint64_t>(1) << (slot & 63);
+  }
+}
+
+void TimerWheel::Unlink(Entry* entry) {
+  Slot& list = entry->level < kLevelCount ? slots_[entry->level][entry->slot] : overdue_;
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    list.head = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  }
+  entry->prev = nullptr;
+  entry->next = nullptr;
+  if (!list.head && entry->level < kLevelCount) {
+    occupied_[entry->level][entry->slot >> 6] &= ~(static_cast<uint64_t>(1) << (entry->slot & 63));
+  }
+}
+
+void TimerWheel::Cascade(uint32_t level) {
+  uint32_t slot = static_cast<uint32_t>((current_ >> Shift(level)) & (kLevelSize - 1));
+  Entry* entry = slots_[level][slot].head;
+  slots_[level][slot].head = nullptr;
+  occupied_[level][0] &= ~(static_cast<uint64_t>(1) << slot);
+  while (entry) {
+    Entry* next = entry->next;
+    Place(entry);
+    entry = next;
+  }
+}
+
+void TimerWheel::Expire(Slot& list, std::vector<std::shared_ptr<Task>>& expired) {
+  Entry* entry = list.head;
+  if (!entry) {
+    return;
+  }
+  // entries are linked at the head, hand them out in the order they were scheduled
+  while (entry->next) {
+    entry = entry->next;
+  }
+  while (entry) {
+    Entry* prev = entry->prev;
+    Unlink(entry);
+    expired.push_back(std::move(entry->task));
+    Release(entry);
+    entry = prev;
+  }
+}
+
+void TimerWheel::Release(Entry* entry) {
+  auto range = entries_.equal_range(entry->id);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == entry) {
+      entries_.erase(it);
+      break;
+    }
+  }
+  delete entry;
+}
+
+int32_t TimerWheel::FindOccupied(uint32_t level, uint32_t from) const {
+  const std::vector<uint64_t>& bits = occupied_[level];
+  uint32_t word = from >> 6;
+  if (word >= bits.size()) {
+    return -1;
+  }
+  uint64_t current = bits[word] & (~static_cast<uint64_t>(0) << (from & 63));
+  while (true) {
+    if (current) {
+      return static_cast<int32_t>((word << 6) + __builtin_ctzll(current));
+    }
+    if (++word >= bits.size()) {
+      return -1;
+    }
+    current = bits[word];
+  }
+}
+
+}  // namespace base
+}  // namespace hippy
@@ -0,0 +1,206 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/code_cache_manager.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "base/logging.h"
+#include "core/base/file.h"
+#include "core/base/string_view_utils.h"
+#include "core/task/common_task.h"
+
+using HippyFile = hippy::base::HippyFile;
+using StringViewUtils = hippy::base::StringViewUtils;
+
+const size_t CodeCacheManager::kMinSourceSize = 1024;
+
+constexpr char kTempFilePostfix[] = ".tmp";
+// hash, source size and version tag in hex, e.g. 0123456789abcdef_1f4a0_89abcdef
+constexpr char kKeyFormat[] = "%016llx_%zx_%08x";
+
+static bool CreateDirs(const std::string& dir) {
+  for (size_t pos = dir.find('/', 1); pos != std::string::npos; pos = dir.find('/', pos + 1)) {
+    std::string parent = dir.substr(0, pos);
+    if (access(parent.c_str(), F_OK) && mkdir(parent.c_str(), S_IRWXU) && errno != EEXIST) {
+      return false;
+    }
+  }
+  return !access(dir.c_str(), F_OK) || !mkdir(dir.c_str(), S_IRWXU) || errno == EEXIST;
+}
+
+static bool EndsWith(const std::string& str, const std::string& postfix) {
+  return str.length() >= postfix.length() &&
+      str.compare(str.length() - postfix.length(), postfix.length(), postfix) == 0;
+}
+
+CodeCacheManager::CodeCacheManager(const unicode_string_view& cache_dir,
+                                   uint32_t version_tag,
+                                   std::shared_ptr<WorkerTaskRunner> runner)
+    : cache_dir_(StringViewUtils::ToU8StdStr(cache_dir)),
+      version_tag_(version_tag),
+      runner_(runner) {
+  if (!cache_dir_.empty() && cache_dir_.back() != '/') {
+    cache_dir_.push_back('/');
+  }
+}
+
+// FNV-1a over 64 bit words, a bundle is hashed on every run so this has to go
+// at memory speed
+uint64_t CodeCacheManager::Hash(const uint8_t* data, size_t size) {
+  constexpr uint64_t kOffsetBasis = 0xcbf29ce484222325ULL;
+  constexpr uint64_t kPrime = 0x100000001b3ULL;
+  uint64_t hash = kOffsetBasis;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * kPrime;
+    hash ^= hash >> 32;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ data[i]) * kPrime;
+  }
+  return hash;
+}
+
+std::string CodeCacheManager::GetKey(const uint8_t* data, size_t size) const {
+  char key[64];
+  snprintf(key, sizeof(key), kKeyFormat, static_cast<unsigned long long>(Hash(data, size)),
+           size, version_tag_);
+  return key;
+}
+
+CodeCacheManager::Entry CodeCacheManager::Lookup(const uint8_t* data, size_t size) {
+  Entry entry;
+  if (size < kMinSourceSize) {
+    return entry;
+  }
+  entry.key = GetKey(data, size);
+  entry.cache = Load(entry.key);
+  return entry;
+}
+
+std::shared_ptr<hippy::base::SourceBuffer> CodeCacheManager::Load(const std::string& key) {
+  std::string path = GetPath(key);
+  if (access(path.c_str(), R_OK)) {
+    TDF_BASE_DLOG(INFO) << "CodeCacheManager miss, key = " << key;
+    return nullptr;
+  }
+  auto cache = SourceBuffer::FromFile(StringViewUtils::ConstCharPointerToStrView(path.c_str(),
+                                                                               path.length()));
+  TDF_BASE_DLOG(INFO) << "CodeCacheManager hit, key = " << key
+                      << ", size = " << (cache ? cache->size() : 0);
+  return cache;
+}
+
+void CodeCacheManager::Save(const std::string& key, std::string data) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!saving_keys_.insert(key).second) {
+      return;
+    }
+  }
+  std::weak_ptr<CodeCacheManager> weak_manager = weak_from_this();
+  bool is_posted = PostTask([weak_manager, key, data = std::move(data)] {
+    auto manager = weak_manager.lock();
+    if (!manager) {
+      return;
+    }
+    // written aside and renamed so that a reader never maps a partial cache
+    std::string path = manager->GetPath(key);
+    std::string temp_path = path + kTempFilePostfix;
+    bool ret = CreateDirs(manager->cache_dir_) &&
+        HippyFile::SaveFile(StringViewUtils::ConstCharPointerToStrView(temp_path.c_str(),
+                                                                       temp_path.length()),
+                            data) &&
+        rename(temp_path.c_str(), path.c_str()) == 0;
+    if (!ret) {
+      unlink(temp_path.c_str());
+    }
+    TDF_BASE_DLOG(INFO) << "CodeCacheManager save, key = " << key << ", size = " << data.size()
+                        << ", ret = " << ret;
+    std::lock_guard<std::mutex> lock(manager->mutex_);
+    manager->saving_keys_.erase(key);
+  });
+  if (!is_posted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    saving_keys_.erase(key);
+  }
+}
+
+void CodeCacheManager::Remove(const std::string& key) {
+  TDF_BASE_DLOG(INFO) << "CodeCacheManager remove, key = " << key;
+  // an unlinked cache stays readable for whoever still maps it
+  unlink(GetPath(key).c_str());
+}
+
+void CodeCacheManager::RemoveStale() {
+  std::weak_ptr<CodeCacheManager> weak_manager = weak_from_this();
+  PostTask([weak_manager] {
+    auto manager = weak_manager.lock();
+    if (!manager) {
+      return;
+    }
+    DIR* dir = opendir(manager->cache_dir_.c_str());
+    if (!dir) {
+      return;
+    }
+    char tag_postfix[16];
+    snprintf(tag_postfix, sizeof(tag_postfix), "_%08x", manager->version_tag_);
+    unsigned long long hash;
+    size_t size;
+    uint32_t tag;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+      std::string name = entry->d_name;
+      bool is_cache = sscanf(name.c_str(), kKeyFormat, &hash, &size, &tag) == 3;
+      if (is_cache && (!EndsWith(name, tag_postfix) || EndsWith(name, kTempFilePostfix))) {
+        TDF_BASE_DLOG(INFO) << "CodeCacheManager remove stale, name = " << name;
+        unlink((manager->cache_dir_ + name).c_str());
+      }
+    }
+    closedir(dir);
+  });
+}
+
+std::string CodeCacheManager::GetPath(const std::string& key) const {
+  return cache_dir_ + key;
+}
+
+bool CodeCacheManager::PostTask(std::function<void()> func) {
+  auto runner = runner_.lock();
+  if (!runner) {
+    return false;
+  }
+  auto task = std::make_unique<CommonTask>();
+  task->func_ = std::move(func);
+  task->origin_ = "CodeCacheManager";
+  return runner->PostTask(std::move(task), WorkerTaskRunner::kLowPriorityTaskPriority).IsPending();
+}
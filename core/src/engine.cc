@@ -22,24 +22,125 @@
 
 #include "core/engine.h"
 
+#include <mutex>
+
+#include "core/base/file.h"
 #include "core/scope.h"
+#include "core/task/common_task.h"
 #include "core/task/javascript_task.h"
+#ifdef JS_V8
+#include "core/vm/v8/v8_vm.h"
+#endif
 
 constexpr uint32_t Engine::kDefaultWorkerPoolSize = 1;
+constexpr uint32_t Engine::kScriptStreamingPoolSize = 1;
 constexpr char kUseSnapshotStringValue[] = "1";
 
-Engine::Engine() : vm_(nullptr) {}
+namespace {
+std::mutex shared_threads_mutex;
+std::shared_ptr<hippy::base::SequencedThreadPool> shared_js_thread_pool;
+std::shared_ptr<WorkerTaskRunner> shared_worker_task_runner;
+std::shared_ptr<WorkerTaskRunner> shared_script_streaming_runner;
+Engine::ThreadingConfig threading_config;
+}  // namespace
+
+Engine::Engine() : use_shared_threads_(false), is_shared_threads_allowed_(true), vm_(nullptr) {}
 
 Engine::~Engine() {
   TDF_BASE_DLOG(INFO) << "~Engine";
 }
 
+void Engine::SetThreadingConfig(const ThreadingConfig& config) {
+  std::lock_guard<std::mutex> lock(shared_threads_mutex);
+  threading_config = config;
+}
+
+void Engine::EnableSharedThreads(uint32_t max_thread_count) {
+  std::lock_guard<std::mutex> lock(shared_threads_mutex);
+  if (shared_js_thread_pool) {
+    TDF_BASE_DLOG(WARNING) << "shared threads have been enabled";
+    return;
+  }
+  shared_js_thread_pool = std::make_shared<hippy::base::SequencedThreadPool>(max_thread_count,
+                                                                            threading_config.js_thread);
+  shared_worker_task_runner = std::make_shared<WorkerTaskRunner>(kDefaultWorkerPoolSize,
+                                                                 threading_config.worker_thread);
+  shared_script_streaming_runner = std::make_shared<WorkerTaskRunner>(kScriptStreamingPoolSize,
+                                                                      threading_config.worker_thread);
+}
+
+hippy::base::SequencedThreadPool::Metrics Engine::GetSharedThreadMetrics() {
+  std::lock_guard<std::mutex> lock(shared_threads_mutex);
+  if (!shared_js_thread_pool) {
+    return {};
+  }
+  return shared_js_thread_pool->GetMetrics();
+}
+
 void Engine::TerminateRunner() {
   TDF_BASE_DLOG(INFO) << "~TerminateRunner";
-  worker_task_runner_->Terminate();
+  if (!use_shared_threads_) {
+    worker_task_runner_->Terminate();
+    script_streaming_runner_->Terminate();
+  }
   js_runner_->Terminate();
 }
 
+#ifdef JS_V8
+bool Engine::StartCpuProfiling(int sampling_interval_us, uint32_t max_duration_ms) {
+  auto vm = std::static_pointer_cast<hippy::vm::V8VM>(vm_);
+  if (!vm || !vm->StartCpuProfiling(sampling_interval_us, max_duration_ms)) {
+    return false;
+  }
+  cpu_profile_ = nullptr;
+  uint32_t profiling_id = ++cpu_profiling_id_;
+  if (max_duration_ms > 0) {
+    std::weak_ptr<Engine> weak_engine = weak_from_this();
+    auto task = std::make_shared<JavaScriptTask>();
+    task->origin_ = "CpuProfiling";
+    task->callback = [weak_engine, profiling_id] {
+      auto engine = weak_engine.lock();
+      if (!engine || engine->cpu_profiling_id_ != profiling_id) {
+        return;
+      }
+      auto profile = std::make_shared<std::string>();
+      if (std::static_pointer_cast<hippy::vm::V8VM>(engine->vm_)->StopCpuProfiling(profile.get())) {
+        TDF_BASE_DLOG(INFO) << "cpu profiling reached its max duration";
+        engine->cpu_profile_ = std::move(profile);
+      }
+    };
+    js_runner_->PostDelayedTask(task, max_duration_ms);
+  }
+  return true;
+}
+
+bool Engine::StopCpuProfiling(const unicode_string_view& file_path, CpuProfileCallback callback) {
+  auto vm = std::static_pointer_cast<hippy::vm::V8VM>(vm_);
+  // kept when the profiler was stopped by its max duration
+  std::shared_ptr<std::string> profile = std::move(cpu_profile_);
+  if (vm && vm->IsCpuProfiling()) {
+    profile = std::make_shared<std::string>();
+    if (!vm->StopCpuProfiling(profile.get())) {
+      profile = nullptr;
+    }
+  }
+  if (!profile) {
+    TDF_BASE_DLOG(WARNING) << "StopCpuProfiling no profile";
+    return false;
+  }
+  auto task = std::make_unique<CommonTask>();
+  task->func_ = [file_path, profile, callback] {
+    bool is_written = hippy::base::HippyFile::SaveFile(file_path, *profile);
+    TDF_BASE_DLOG(INFO) << "cpu profile " << file_path << " is_written = " << is_written;
+    if (callback) {
+      callback(is_written);
+    }
+  };
+  worker_task_runner_->PostTask(std::move(task));
+  return true;
+}
+#endif
+
 std::shared_ptr<Scope> Engine::AsyncCreateScope(const std::string& name,
                                                 std::unordered_map<std::string, std::string> init_param,
                                                 std::unique_ptr<RegisterMap> map) {
@@ -80,10 +181,24 @@ std::shared_ptr<Scope> Engine::SyncCreateScope(const std::string& name,
 
 void Engine::SetupThreads() {
   TDF_BASE_DLOG(INFO) << "Engine SetupThreads";
-  js_runner_ = std::make_shared<JavaScriptTaskRunner>();
+  ThreadingConfig config;
+  {
+    std::lock_guard<std::mutex> lock(shared_threads_mutex);
+    if (shared_js_thread_pool && is_shared_threads_allowed_) {
+      js_runner_ = std::make_shared<JavaScriptTaskRunner>();
+      use_shared_threads_ = true;
+      shared_js_thread_pool->Attach(js_runner_);
+      worker_task_runner_ = shared_worker_task_runner;
+      script_streaming_runner_ = shared_script_streaming_runner;
+      return;
+    }
+    config = threading_config;
+  }
+  js_runner_ = std::make_shared<JavaScriptTaskRunner>(config.js_thread);
   js_runner_->Start();
 
-  worker_task_runner_ = std::make_shared<WorkerTaskRunner>(kDefaultWorkerPoolSize);
+  worker_task_runner_ = std::make_shared<WorkerTaskRunner>(kDefaultWorkerPoolSize, config.worker_thread);
+  script_streaming_runner_ = std::make_shared<WorkerTaskRunner>(kScriptStreamingPoolSize, config.worker_thread);
 }
 
 void Engine::CreateVM(const std::shared_ptr<VMInitParam>& param) {
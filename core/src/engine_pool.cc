@@ -0,0 +1,187 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/engine_pool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "base/logging.h"
+#include "core/task/javascript_task.h"
+
+namespace {
+// engines are started one pool at a time, off the threads that take them
+constexpr uint32_t kRefillThreadCount = 1;
+}  // namespace
+
+EnginePool::EnginePool(const Config& config, MemoryProvider memory_provider)
+    : config_(config),
+      memory_provider_(std::move(memory_provider)),
+      refill_runner_(std::make_shared<WorkerTaskRunner>(kRefillThreadCount)),
+      is_fill_scheduled_(false),
+      trim_count_(0) {
+  if (!memory_provider_) {
+    memory_provider_ = GetAvailableMemory;
+  }
+}
+
+EnginePool::~EnginePool() {
+  // waits for a running refill, refill tasks hold this
+  refill_runner_->Terminate();
+  Trim();
+}
+
+std::shared_ptr<Engine> EnginePool::Take() {
+  std::shared_ptr<Engine> engine;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.begin();
+    for (auto entry = entries_.begin(); entry != entries_.end(); ++entry) {
+      if (entry->is_vm_ready->load(std::memory_order_acquire)) {
+        it = entry;
+        break;
+      }
+    }
+    if (it != entries_.end()) {
+      TDF_BASE_DLOG(INFO) << "EnginePool Take, is_vm_ready = " << it->is_vm_ready->load();
+      engine = std::move(it->engine);
+      entries_.erase(it);
+    }
+  }
+  // also refills a pool emptied by Trim once memory allows it again
+  Fill();
+  return engine;
+}
+
+void EnginePool::Fill() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (is_fill_scheduled_ || entries_.size() >= config_.size) {
+    return;
+  }
+  is_fill_scheduled_ = true;
+  auto task = std::make_unique<CommonTask>();
+  task->func_ = [this] { FillOnRefillThread(); };
+  refill_runner_->PostTask(std::move(task));
+}
+
+void EnginePool::FillOnRefillThread() {
+  // engines taken while a batch was being started are replaced by the next one
+  for (;;) {
+    size_t missing_count;
+    uint64_t trim_count;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (entries_.size() >= config_.size) {
+        is_fill_scheduled_ = false;
+        return;
+      }
+      missing_count = config_.size - entries_.size();
+      trim_count = trim_count_;
+    }
+    uint64_t available_memory = memory_provider_();
+    if (available_memory < config_.min_available_memory) {
+      TDF_BASE_DLOG(INFO) << "EnginePool Fill skipped, available_memory = " << available_memory;
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_fill_scheduled_ = false;
+      return;
+    }
+    // only starts the threads here, the vm is created on the new js thread
+    std::deque<Entry> entries;
+    for (size_t i = 0; i < missing_count; ++i) {
+      auto engine = std::make_shared<Engine>();
+      auto is_vm_ready = std::make_shared<std::atomic<bool>>(false);
+      auto map = std::make_unique<Engine::RegisterMap>();
+      map->insert({hippy::base::kVMCreateCBKey, [is_vm_ready](void*) {
+        is_vm_ready->store(true, std::memory_order_release);
+      }});
+      engine->AsyncInit(config_.param, std::move(map));
+      entries.push_back(Entry{engine, is_vm_ready});
+    }
+    bool is_trimmed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_trimmed = trim_count != trim_count_;
+      if (is_trimmed) {
+        is_fill_scheduled_ = false;
+      } else {
+        std::move(entries.begin(), entries.end(), std::back_inserter(entries_));
+      }
+    }
+    if (is_trimmed) {
+      // the memory was asked back while the batch was starting
+      TDF_BASE_DLOG(INFO) << "EnginePool Fill dropped, count = " << entries.size();
+      for (auto& entry : entries) {
+        entry.engine->TerminateRunner();
+      }
+      return;
+    }
+  }
+}
+
+void EnginePool::Trim() {
+  std::deque<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+    ++trim_count_;
+  }
+  TDF_BASE_DLOG(INFO) << "EnginePool Trim, count = " << entries.size();
+  for (auto& entry : entries) {
+    entry.engine->TerminateRunner();
+  }
+}
+
+size_t EnginePool::IdleCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void EnginePool::RunVMCreatedCallback(const std::shared_ptr<Engine>& engine, RegisterFunction cb) {
+  std::weak_ptr<Engine> weak_engine = engine;
+  auto task = std::make_shared<JavaScriptTask>();
+  task->callback = [weak_engine, cb = std::move(cb)] {
+    auto live_engine = weak_engine.lock();
+    if (!live_engine || !live_engine->GetVM()) {
+      return;
+    }
+    cb(live_engine->GetVM().get());
+  };
+  engine->GetJSRunner()->PostTask(std::move(task));
+}
+
+uint64_t EnginePool::GetAvailableMemory() {
+#if defined(__linux__)
+  std::ifstream meminfo("/proc/meminfo");
+  std::string line;
+  unsigned long long available_in_kb;  // NOLINT(runtime/int)
+  while (std::getline(meminfo, line)) {
+    if (sscanf(line.c_str(), "MemAvailable: %llu kB", &available_in_kb) == 1) {
+      return available_in_kb * 1024;
+    }
+  }
+#endif
+  return UINT64_MAX;
+}
@@ -0,0 +1,157 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/modules/animation_frame_module.h"
+
+#include "base/logging.h"
+#include "core/base/base_time.h"
+#include "core/base/common.h"
+#include "core/base/macros.h"
+#include "core/task/javascript_task_runner.h"
+#include "core/task/vsync_source.h"
+
+GEN_INVOKE_CB(AnimationFrameModule, RequestAnimationFrame) // NOLINT(cert-err58-cpp)
+GEN_INVOKE_CB(AnimationFrameModule, CancelAnimationFrame) // NOLINT(cert-err58-cpp)
+
+namespace napi = ::hippy::napi;
+
+using CtxValue = hippy::napi::CtxValue;
+using RegisterFunction = hippy::base::RegisterFunction;
+using RegisterMap = hippy::base::RegisterMap;
+
+AnimationFrameModule::AnimationFrameModule() : next_id_(1), is_frame_requested_(false) {}
+
+AnimationFrameModule::~AnimationFrameModule() = default;
+
+void AnimationFrameModule::RequestAnimationFrame(const napi::CallbackInfo& info, void* data) {
+  auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
+  auto scope = scope_wrapper->scope.lock();
+  TDF_BASE_CHECK(scope);
+  auto context = scope->GetContext();
+
+  std::shared_ptr<CtxValue> function = info[0];
+  if (!context->IsFunction(function)) {
+    info.GetExceptionValue()->Set(context, "The first argument must be function.");
+    return;
+  }
+
+  CallbackId id = next_id_++;
+  callbacks_[id] = function;
+  RequestFrame(scope);
+
+  info.GetReturnValue()->Set(context->CreateNumber(id));
+}
+
+void AnimationFrameModule::CancelAnimationFrame(const napi::CallbackInfo& info, void* data) {
+  auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
+  auto scope = scope_wrapper->scope.lock();
+  TDF_BASE_CHECK(scope);
+  auto context = scope->GetContext();
+
+  int32_t argument1 = 0;
+  if (!context->GetValueNumber(info[0], &argument1)) {
+    info.GetExceptionValue()->Set(context, "The first argument must be int32.");
+    return;
+  }
+
+  CallbackId id = hippy::base::checked_numeric_cast<int32_t, CallbackId>(argument1);
+  callbacks_.erase(id);
+  running_callbacks_.erase(id);
+  // a frame that is already requested is left to tick, it finds nothing to run
+}
+
+void AnimationFrameModule::RequestFrame(const std::shared_ptr<Scope>& scope) {
+  if (is_frame_requested_) {
+    return;
+  }
+  std::shared_ptr<JavaScriptTaskRunner> runner = scope->GetTaskRunner();
+  std::shared_ptr<VsyncSource> vsync_source = scope->GetVsyncSource();
+  if (!runner || !vsync_source) {
+    return;
+  }
+  is_frame_requested_ = true;
+  std::weak_ptr<Scope> weak_scope = scope;
+  std::weak_ptr<JavaScriptTaskRunner> weak_runner = runner;
+  vsync_source->RequestFrame([this, weak_scope, weak_runner](uint64_t frame_time) {
+    std::shared_ptr<JavaScriptTaskRunner> js_runner = weak_runner.lock();
+    if (!js_runner) {
+      return;
+    }
+    js_runner->PostFunction([this, weak_scope, frame_time] {
+      std::shared_ptr<Scope> frame_scope = weak_scope.lock();
+      if (frame_scope) {
+        RunFrame(frame_scope, frame_time);
+      }
+    }, JavaScriptTaskRunner::Priority::kInput, "requestAnimationFrame");
+  });
+}
+
+void AnimationFrameModule::RunFrame(const std::shared_ptr<Scope>& scope, uint64_t frame_time) {
+  is_frame_requested_ = false;
+  if (callbacks_.empty()) {
+    return;
+  }
+  // callbacks requested from inside this frame belong to the next one
+  running_callbacks_.swap(callbacks_);
+  std::shared_ptr<hippy::napi::Ctx> context = scope->GetContext();
+  // the callbacks convert the frame time to the time base of performance.now()
+  std::shared_ptr<CtxValue> argv[] = {
+      context->CreateNumber(static_cast<double>(frame_time)),
+      context->CreateNumber(static_cast<double>(hippy::base::MonotonicallyIncreasingTime()))};
+  while (!running_callbacks_.empty()) {
+    auto it = running_callbacks_.begin();
+    std::shared_ptr<CtxValue> function = std::move(it->second);
+    running_callbacks_.erase(it);
+    context->CallFunction(function, arraysize(argv), argv);
+  }
+
+  std::unique_ptr<RegisterMap>& map = scope->GetRegisterMap();
+  if (map) {
+    auto it = map->find(hippy::base::kAsyncTaskEndKey);
+    if (it != map->end()) {
+      RegisterFunction f = it->second;
+      if (f) {
+        f(nullptr);
+      }
+    }
+  }
+}
+
+std::shared_ptr<CtxValue> AnimationFrameModule::BindFunction(std::shared_ptr<Scope> scope,
+                                                             std::shared_ptr<CtxValue>* rest_args) {
+  auto context = scope->GetContext();
+  auto object = context->CreateObject();
+
+  auto key = context->CreateString("RequestAnimationFrame");
+  auto wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokeAnimationFrameModuleRequestAnimationFrame, nullptr);
+  auto value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  key = context->CreateString("CancelAnimationFrame");
+  wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokeAnimationFrameModuleCancelAnimationFrame, nullptr);
+  value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  return object;
+}
@@ -27,28 +27,33 @@
 #include <string>
 
 #include "base/logging.h"
+#include "core/base/future.h"
 #include "core/base/uri_loader.h"
 #include "core/napi/js_try_catch.h"
 #include "core/task/common_task.h"
 #include "core/task/javascript_task.h"
+#include "core/task/javascript_task_runner.h"
 #include "core/vm/native_source_code.h"
 #if JS_V8
 #include "core/napi/v8/v8_ctx.h"
+#include "core/napi/v8/v8_streamed_script.h"
 #endif
 
 GEN_INVOKE_CB(ContextifyModule, RunInThisContext) // NOLINT(cert-err58-cpp)
 GEN_INVOKE_CB(ContextifyModule, LoadUntrustedContent) // NOLINT(cert-err58-cpp)
 
 using unicode_string_view = tdf::base::unicode_string_view;
-using u8string = unicode_string_view::u8string;
 using Ctx = hippy::napi::Ctx;
 using CtxValue = hippy::napi::CtxValue;
 using CallbackInfo = hippy::napi::CallbackInfo;
 using TryCatch = hippy::napi::TryCatch;
 using UriLoader = hippy::base::UriLoader;
+using SourceBuffer = hippy::base::SourceBuffer;
+using SourceStream = hippy::base::SourceStream;
 using StringViewUtils = hippy::base::StringViewUtils;
-
-constexpr char kCurDir[] = "__HIPPYCURDIR__";
+#ifdef JS_V8
+using V8StreamedScript = hippy::napi::V8StreamedScript;
+#endif
 
 void ContextifyModule::RunInThisContext(const hippy::napi::CallbackInfo& info, void* data) { // NOLINT(readability-convert-member-functions-to-static)
   auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
@@ -129,84 +134,212 @@ void ContextifyModule::LoadUntrustedContent(const CallbackInfo& info, void* data
   std::weak_ptr<Scope> weak_scope = scope;
   std::weak_ptr<hippy::napi::CtxValue> weak_function = function;
 
-  std::function<void(u8string)> cb = [this, weak_scope, weak_function, encode, uri](u8string code) {
-    auto scope = weak_scope.lock();
-    if (!scope) {
+#ifdef JS_V8
+  if (LoadStreamedContent(scope, uri, weak_function)) {
+    info.GetReturnValue()->SetUndefined();
+    return;
+  }
+#endif
+
+#ifdef JS_V8
+  // the source is hashed and its code cache read on the worker, not on the js
+  // thread where it then runs
+  std::shared_ptr<Engine> engine = scope->GetEngine().lock();
+  std::shared_ptr<CodeCacheManager> manager = engine ? engine->GetCodeCacheManager() : nullptr;
+  hippy::base::Executor lookup_executor;
+  if (manager) {
+    lookup_executor = engine->GetWorkerTaskRunner()->Schedule();
+  }
+  std::function<void(std::shared_ptr<SourceBuffer>)> cb = [this, weak_scope, weak_function, encode, uri,
+                                                           manager, lookup_executor](
+      std::shared_ptr<SourceBuffer> source) {
+#else
+  std::function<void(std::shared_ptr<SourceBuffer>)> cb = [this, weak_scope, weak_function, encode, uri](
+      std::shared_ptr<SourceBuffer> source) {
+#endif
+    auto live_scope = weak_scope.lock();
+    if (!live_scope) {
       return;
     }
 
-    unicode_string_view cur_dir;
-    unicode_string_view file_name;
-    size_t pos = StringViewUtils::FindLastOf(uri, '/', '/', u'/', U'/');
-    if (pos != StringViewUtils::npos) {
-      cur_dir = StringViewUtils::SubStr(uri, 0, pos + 1);
-      size_t len = StringViewUtils::GetLength(uri);
-      file_name = StringViewUtils::SubStr(uri, pos + 1, len);
+    if (!source) {
+      TDF_BASE_DLOG(WARNING) << "Load uri = " << uri << ", code empty";
     } else {
-      cur_dir = "";
-      file_name = uri;
+      TDF_BASE_DLOG(INFO) << "Load uri = " << uri << ", len = " << source->size()
+                          << ", encode = " << encode;
     }
+#ifdef JS_V8
+    lookup_executor.Post([this, weak_scope, weak_function, uri, manager, source = std::move(source)] {
+      CodeCacheManager::Entry cache_entry;
+      if (manager && source) {
+        cache_entry = manager->Lookup(source->data(), source->size());
+      }
+      auto run_scope = weak_scope.lock();
+      if (!run_scope) {
+        return;
+      }
+      PostRunTask(run_scope, weak_function, uri, source,
+                  [cache_entry](const std::shared_ptr<Scope>& script_scope,
+                                const std::shared_ptr<SourceBuffer>& script_source,
+                                const unicode_string_view& file_name) {
+        auto script_ctx = std::static_pointer_cast<hippy::napi::V8Ctx>(script_scope->GetContext());
+        script_ctx->RunScript(script_source, file_name, cache_entry);
+      });
+    });
+#else
+    PostRunTask(live_scope, weak_function, uri, std::move(source),
+                [](const std::shared_ptr<Scope>& script_scope,
+                   const std::shared_ptr<SourceBuffer>& script_source,
+                   const unicode_string_view& file_name) {
+      script_scope->RunJS(script_source, file_name);
+    });
+#endif
+  };
+  loader->RequestSourceBuffer(uri, cb);
+  info.GetReturnValue()->SetUndefined();
+}
 
-    if (code.empty()) {
-      TDF_BASE_DLOG(WARNING) << "Load uri = " << uri << ", code empty";
-    } else {
-      TDF_BASE_DLOG(INFO) << "Load uri = " << uri << ", len = " << code.length()
-                          << ", encode = " << encode
-                          << ", code = " << unicode_string_view(code);
+#ifdef JS_V8
+bool ContextifyModule::LoadStreamedContent(const std::shared_ptr<Scope>& scope,
+                                           const unicode_string_view& uri,
+                                           const std::weak_ptr<CtxValue>& weak_function) {
+  std::shared_ptr<UriLoader> loader = scope->GetUriLoader();
+  std::shared_ptr<Engine> engine = scope->GetEngine().lock();
+  std::shared_ptr<WorkerTaskRunner> runner = engine ? engine->GetScriptStreamingRunner() : nullptr;
+  if (!loader || !runner) {
+    return false;
+  }
+  // a script compiled from its code cache is not parsed, streaming it would
+  // only parse it twice
+  if (engine->GetCodeCacheManager()) {
+    return false;
+  }
+  std::shared_ptr<SourceStream> stream = loader->RequestSourceStream(uri);
+  if (!stream) {
+    return false;
+  }
+  auto ctx = std::static_pointer_cast<hippy::napi::V8Ctx>(scope->GetContext());
+  std::shared_ptr<V8StreamedScript> script = V8StreamedScript::Start(ctx->isolate_, stream);
+  if (!script) {
+    return false;
+  }
+  TDF_BASE_DLOG(INFO) << "Load uri = " << uri << ", streamed";
+  // the isolate has to outlive a running parse
+  std::weak_ptr<V8StreamedScript> weak_script = script;
+  uint32_t will_exit_cb_id = scope->AddWillExitCallback([weak_script] {
+    auto streamed_script = weak_script.lock();
+    if (streamed_script) {
+      streamed_script->Cancel();
     }
+  });
+
+  std::weak_ptr<Scope> weak_scope = scope;
+  auto task = std::make_unique<CommonTask>();
+  task->func_ = [this, weak_scope, weak_function, uri, script, will_exit_cb_id] {
+    script->Parse();
+    auto live_scope = weak_scope.lock();
+    if (!live_scope) {
+      return;
+    }
+    // nothing is left to cancel, the callback goes on the js thread that owns it
     auto js_task = std::make_shared<JavaScriptTask>();
-    js_task->callback = [this, weak_scope, weak_function,
-                         move_code = std::move(code), cur_dir, file_name, uri]() {
-      auto scope = weak_scope.lock();
-      if (!scope) {
-        return;
+    js_task->callback = [weak_scope, will_exit_cb_id] {
+      auto js_scope = weak_scope.lock();
+      if (js_scope) {
+        js_scope->RemoveWillExitCallback(will_exit_cb_id);
       }
+    };
+    auto js_runner = live_scope->GetTaskRunner();
+    if (js_runner) {
+      js_runner->PostTask(js_task);
+    }
+    std::shared_ptr<SourceBuffer> source = script->GetStream()->TakeContent();
+    if (!source) {
+      TDF_BASE_DLOG(WARNING) << "Load uri = " << uri << ", code empty";
+    } else {
+      TDF_BASE_DLOG(INFO) << "Load uri = " << uri << ", len = " << source->size() << ", parsed";
+    }
+    PostRunTask(live_scope, weak_function, uri, std::move(source),
+                [script](const std::shared_ptr<Scope>& script_scope,
+                         const std::shared_ptr<SourceBuffer>& script_source,
+                         const unicode_string_view& file_name) {
+      auto script_ctx = std::static_pointer_cast<hippy::napi::V8Ctx>(script_scope->GetContext());
+      script_ctx->RunScript(script, script_source, file_name);
+    });
+  };
+  runner->PostTask(std::move(task));
+  return true;
+}
+#endif
+
+void ContextifyModule::PostRunTask(const std::shared_ptr<Scope>& scope,
+                                   const std::weak_ptr<CtxValue>& weak_function,
+                                   const unicode_string_view& uri,
+                                   std::shared_ptr<SourceBuffer> source,
+                                   ScriptRunner run_script) {
+  unicode_string_view cur_dir;
+  unicode_string_view file_name;
+  size_t pos = StringViewUtils::FindLastOf(uri, '/', '/', u'/', U'/');
+  if (pos != StringViewUtils::npos) {
+    cur_dir = StringViewUtils::SubStr(uri, 0, pos + 1);
+    size_t len = StringViewUtils::GetLength(uri);
+    file_name = StringViewUtils::SubStr(uri, pos + 1, len);
+  } else {
+    cur_dir = "";
+    file_name = uri;
+  }
 
-      std::shared_ptr<Ctx> ctx = scope->GetContext();
-      std::shared_ptr<CtxValue> error = nullptr;
-      if (!move_code.empty()) {
-        auto global_object = ctx->GetGlobalObject();
-        auto cur_dir_key = ctx->CreateString(kCurDir);
-        auto last_dir_str_obj = ctx->GetProperty(global_object, cur_dir_key);
-        TDF_BASE_DLOG(INFO) << "__HIPPYCURDIR__ cur_dir = " << cur_dir;
-        auto cur_dir_value = ctx->CreateString(cur_dir);
-        ctx->SetProperty(global_object, cur_dir_key, cur_dir_value);
-        std::shared_ptr<TryCatch> try_catch = CreateTryCatchScope(true, scope->GetContext());
-        try_catch->SetVerbose(true);
-        unicode_string_view view_code(move_code);
-        scope->RunJS(view_code, file_name);
-        ctx->SetProperty(global_object, cur_dir_key, last_dir_str_obj, hippy::napi::PropertyAttribute::ReadOnly);
-        unicode_string_view view_last_dir_str("");
-        ctx->GetValueString(last_dir_str_obj, &view_last_dir_str);
-        TDF_BASE_DLOG(INFO) << "restore __HIPPYCURDIR__ = " << view_last_dir_str;
-        if (try_catch->HasCaught()) {
-          error = try_catch->Exception();
-          TDF_BASE_DLOG(ERROR) << "RequestUntrustedContent error = "
-                               << try_catch->GetExceptionMsg();
-        }
-      } else {
-        unicode_string_view err_msg = uri + " not found";
-        error = ctx->CreateError(unicode_string_view(err_msg));
+  std::weak_ptr<Scope> weak_scope = scope;
+  auto js_task = std::make_shared<JavaScriptTask>();
+  js_task->origin_ = "LoadUntrustedContent";
+  js_task->callback = [this, weak_scope, weak_function, source = std::move(source),
+                       run_script = std::move(run_script), cur_dir, file_name, uri]() {
+    auto live_scope = weak_scope.lock();
+    if (!live_scope) {
+      return;
+    }
+
+    std::shared_ptr<Ctx> ctx = live_scope->GetContext();
+    std::shared_ptr<CtxValue> error = nullptr;
+    if (source) {
+      auto global_object = ctx->GetGlobalObject();
+      auto cur_dir_key = ctx->GetPropertyKey(hippy::napi::PropertyKeyId::kCurDir);
+      auto last_dir_str_obj = ctx->GetProperty(global_object, cur_dir_key);
+      TDF_BASE_DLOG(INFO) << "__HIPPYCURDIR__ cur_dir = " << cur_dir;
+      auto cur_dir_value = ctx->CreateString(cur_dir);
+      ctx->SetProperty(global_object, cur_dir_key, cur_dir_value);
+      std::shared_ptr<TryCatch> try_catch = CreateTryCatchScope(true, live_scope->GetContext());
+      try_catch->SetVerbose(true);
+      run_script(live_scope, source, file_name);
+      ctx->SetProperty(global_object, cur_dir_key, last_dir_str_obj, hippy::napi::PropertyAttribute::ReadOnly);
+      unicode_string_view view_last_dir_str("");
+      ctx->GetValueString(last_dir_str_obj, &view_last_dir_str);
+      TDF_BASE_DLOG(INFO) << "restore __HIPPYCURDIR__ = " << view_last_dir_str;
+      if (try_catch->HasCaught()) {
+        error = try_catch->Exception();
+        TDF_BASE_DLOG(ERROR) << "RequestUntrustedContent error = "
+                             << try_catch->GetExceptionMsg();
       }
+    } else {
+      unicode_string_view err_msg = uri + " not found";
+      error = ctx->CreateError(unicode_string_view(err_msg));
+    }
 
-      std::shared_ptr<CtxValue> function = weak_function.lock();
-      if (function) {
-        TDF_BASE_DLOG(INFO) << "run js cb";
-        if (!error) {
-          error = ctx->CreateNull();
-        }
-        std::shared_ptr<CtxValue> argv[] = {error};
-        ctx->CallFunction(function, 1, argv);
-        RemoveCBFunc(uri);
+    std::shared_ptr<CtxValue> function = weak_function.lock();
+    if (function) {
+      TDF_BASE_DLOG(INFO) << "run js cb";
+      if (!error) {
+        error = ctx->CreateNull();
       }
-    };
-    auto runner = scope->GetTaskRunner();
-    if (runner) {
-      runner->PostTask(js_task);
+      std::shared_ptr<CtxValue> argv[] = {error};
+      ctx->CallFunction(function, 1, argv);
+      RemoveCBFunc(uri);
     }
   };
-  loader->RequestUntrustedContent(uri, cb);
-  info.GetReturnValue()->SetUndefined();
+  auto runner = scope->GetTaskRunner();
+  if (runner) {
+    runner->PostTask(js_task);
+  }
 }
 
 std::shared_ptr<CtxValue> ContextifyModule::BindFunction(std::shared_ptr<Scope> scope,
@@ -0,0 +1,172 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/modules/idle_callback_module.h"
+
+#include "base/logging.h"
+#include "core/base/common.h"
+#include "core/base/macros.h"
+#include "core/task/idle_task.h"
+#include "core/task/javascript_task.h"
+#include "core/task/javascript_task_runner.h"
+
+GEN_INVOKE_CB(IdleCallbackModule, RequestIdleCallback) // NOLINT(cert-err58-cpp)
+GEN_INVOKE_CB(IdleCallbackModule, CancelIdleCallback) // NOLINT(cert-err58-cpp)
+
+namespace napi = ::hippy::napi;
+
+using CtxValue = hippy::napi::CtxValue;
+using RegisterFunction = hippy::base::RegisterFunction;
+using RegisterMap = hippy::base::RegisterMap;
+
+IdleCallbackModule::IdleCallbackModule() = default;
+
+IdleCallbackModule::~IdleCallbackModule() = default;
+
+void IdleCallbackModule::RequestIdleCallback(const napi::CallbackInfo& info, void* data) {
+  auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
+  auto scope = scope_wrapper->scope.lock();
+  TDF_BASE_CHECK(scope);
+  auto context = scope->GetContext();
+
+  std::shared_ptr<CtxValue> function = info[0];
+  if (!context->IsFunction(function)) {
+    info.GetExceptionValue()->Set(context, "The first argument must be function.");
+    return;
+  }
+
+  double timeout = 0;
+  context->GetValueNumber(info[1], &timeout);
+
+  std::shared_ptr<JavaScriptTaskRunner> runner = scope->GetTaskRunner();
+  if (!runner) {
+    return;
+  }
+
+  std::shared_ptr<IdleTask> task = std::make_shared<IdleTask>();
+  task->origin_ = "requestIdleCallback";
+  TaskId task_id = task->id_;
+  std::weak_ptr<Scope> weak_scope = scope;
+  std::shared_ptr<TaskEntry> entry = std::make_shared<TaskEntry>(function, task);
+  std::weak_ptr<CtxValue> weak_function = entry->func;
+
+  task->callback = [this, task_id, weak_scope, weak_function](const IdleTask::IdleCbParam& param) {
+    Invoke(task_id, weak_scope, weak_function, param.did_time_out, param.res_time);
+  };
+
+  if (timeout > 0) {
+    std::shared_ptr<JavaScriptTask> timeout_task = std::make_shared<JavaScriptTask>();
+    timeout_task->origin_ = "requestIdleCallback";
+    timeout_task->callback = [this, task_id, weak_scope, weak_function] {
+      Invoke(task_id, weak_scope, weak_function, true, 0);
+    };
+    entry->timeout_task = timeout_task;
+    runner->PostDelayedTask(timeout_task,
+                            static_cast<hippy::base::TaskRunner::DelayedTimeInMs>(timeout));
+  }
+  runner->PostIdleTask(task);
+  task_map_[task_id] = std::move(entry);
+
+  info.GetReturnValue()->Set(context->CreateNumber(task_id));
+}
+
+void IdleCallbackModule::CancelIdleCallback(const napi::CallbackInfo& info, void* data) {
+  auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
+  auto scope = scope_wrapper->scope.lock();
+  TDF_BASE_CHECK(scope);
+  auto context = scope->GetContext();
+
+  int32_t argument1 = 0;
+  if (!context->GetValueNumber(info[0], &argument1)) {
+    info.GetExceptionValue()->Set(context, "The first argument must be int32.");
+    return;
+  }
+
+  TaskId task_id = hippy::base::checked_numeric_cast<int32_t, TaskId>(argument1);
+  Cancel(task_id, scope);
+  info.GetReturnValue()->Set(context->CreateNumber(task_id));
+}
+
+void IdleCallbackModule::Invoke(TaskId task_id,
+                                const std::weak_ptr<Scope>& weak_scope,
+                                const std::weak_ptr<CtxValue>& weak_function,
+                                bool did_time_out,
+                                uint64_t res_time) {
+  std::shared_ptr<Scope> scope = weak_scope.lock();
+  if (!scope) {
+    return;
+  }
+  std::shared_ptr<CtxValue> function = weak_function.lock();
+  // the idle task and the timeout task race, whichever runs first wins
+  Cancel(task_id, scope);
+  if (function) {
+    std::shared_ptr<hippy::napi::Ctx> context = scope->GetContext();
+    std::shared_ptr<CtxValue> argv[] = {
+        context->CreateBoolean(did_time_out),
+        context->CreateNumber(static_cast<double>(res_time))};
+    context->CallFunction(function, arraysize(argv), argv);
+  }
+
+  std::unique_ptr<RegisterMap>& map = scope->GetRegisterMap();
+  if (map) {
+    auto it = map->find(hippy::base::kAsyncTaskEndKey);
+    if (it != map->end()) {
+      RegisterFunction f = it->second;
+      if (f) {
+        f(nullptr);
+      }
+    }
+  }
+}
+
+void IdleCallbackModule::Cancel(TaskId task_id, const std::shared_ptr<Scope>& scope) {
+  auto item = task_map_.find(task_id);
+  if (item == task_map_.end()) {
+    return;
+  }
+  std::shared_ptr<JavaScriptTaskRunner> runner = scope->GetTaskRunner();
+  if (runner) {
+    runner->CancelTask(item->second->task.lock());
+    runner->CancelTask(item->second->timeout_task.lock());
+  }
+  task_map_.erase(item);
+}
+
+std::shared_ptr<CtxValue> IdleCallbackModule::BindFunction(std::shared_ptr<Scope> scope,
+                                                           std::shared_ptr<CtxValue>* rest_args) {
+  auto context = scope->GetContext();
+  auto object = context->CreateObject();
+
+  auto key = context->CreateString("RequestIdleCallback");
+  auto wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokeIdleCallbackModuleRequestIdleCallback, nullptr);
+  auto value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  key = context->CreateString("CancelIdleCallback");
+  wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokeIdleCallbackModuleCancelIdleCallback, nullptr);
+  value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  return object;
+}
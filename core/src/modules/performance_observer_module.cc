@@ -0,0 +1,150 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/modules/performance_observer_module.h"
+
+#include <unordered_map>
+
+#include "base/logging.h"
+#include "core/base/base_time.h"
+#include "core/task/javascript_task_runner.h"
+
+GEN_INVOKE_CB(PerformanceObserverModule, ObserveLongTask) // NOLINT(cert-err58-cpp)
+GEN_INVOKE_CB(PerformanceObserverModule, DisconnectLongTask) // NOLINT(cert-err58-cpp)
+
+namespace napi = ::hippy::napi;
+
+using CtxValue = hippy::napi::CtxValue;
+using unicode_string_view = tdf::base::unicode_string_view;
+
+PerformanceObserverModule::PerformanceObserverModule() : observer_id_(0), is_delivery_posted_(false) {}
+
+PerformanceObserverModule::~PerformanceObserverModule() {
+  Disconnect();
+}
+
+void PerformanceObserverModule::ObserveLongTask(const napi::CallbackInfo& info, void* data) {
+  auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
+  auto scope = scope_wrapper->scope.lock();
+  TDF_BASE_CHECK(scope);
+  auto context = scope->GetContext();
+
+  std::shared_ptr<CtxValue> function = info[0];
+  if (!context->IsFunction(function)) {
+    info.GetExceptionValue()->Set(context, "The first argument must be function.");
+    return;
+  }
+  std::shared_ptr<JavaScriptTaskRunner> runner = scope->GetTaskRunner();
+  if (!runner) {
+    return;
+  }
+
+  Disconnect();
+  callback_ = function;
+  runner_ = runner;
+  // stays on after disconnect, native readers of the stats may rely on it
+  runner->SetTaskStatsEnabled(true);
+  std::weak_ptr<Scope> weak_scope = scope;
+  observer_id_ = runner->GetTaskStats().AddLongTaskObserver(
+      [this, weak_scope](const TaskStats::LongTask& long_task) {
+        // called on the js thread right after the long task, a live scope
+        // means this module is alive too
+        std::shared_ptr<Scope> live_scope = weak_scope.lock();
+        if (!live_scope) {
+          return;
+        }
+        pending_entries_.push_back(long_task);
+        if (is_delivery_posted_) {
+          return;
+        }
+        std::shared_ptr<JavaScriptTaskRunner> js_runner = runner_.lock();
+        if (!js_runner) {
+          return;
+        }
+        is_delivery_posted_ = true;
+        js_runner->PostFunction([this, weak_scope] {
+          std::shared_ptr<Scope> delivery_scope = weak_scope.lock();
+          if (delivery_scope) {
+            Deliver(delivery_scope);
+          }
+        }, JavaScriptTaskRunner::Priority::kBackground, "PerformanceObserver");
+      });
+}
+
+void PerformanceObserverModule::DisconnectLongTask(const napi::CallbackInfo& info, void* data) {
+  Disconnect();
+}
+
+void PerformanceObserverModule::Disconnect() {
+  std::shared_ptr<JavaScriptTaskRunner> runner = runner_.lock();
+  if (runner && observer_id_) {
+    runner->GetTaskStats().RemoveLongTaskObserver(observer_id_);
+  }
+  observer_id_ = 0;
+  callback_ = nullptr;
+  pending_entries_.clear();
+}
+
+void PerformanceObserverModule::Deliver(const std::shared_ptr<Scope>& scope) {
+  is_delivery_posted_ = false;
+  std::vector<TaskStats::LongTask> entries;
+  entries.swap(pending_entries_);
+  if (!callback_ || entries.empty()) {
+    return;
+  }
+  std::shared_ptr<hippy::napi::Ctx> context = scope->GetContext();
+  std::vector<std::shared_ptr<CtxValue>> values;
+  values.reserve(entries.size());
+  for (const auto& entry : entries) {
+    std::unordered_map<unicode_string_view, std::shared_ptr<CtxValue>> object = {
+        {"name", context->CreateString("self")},
+        {"entryType", context->CreateString("longtask")},
+        {"startTime", context->CreateNumber(static_cast<double>(entry.start_time) / 1000)},
+        {"duration", context->CreateNumber(static_cast<double>(entry.duration) / 1000)},
+        {"origin", context->CreateString(entry.origin ? entry.origin : "unknown")}};
+    values.push_back(context->CreateObject(object));
+  }
+  std::shared_ptr<CtxValue> argv[] = {
+      context->CreateArray(values.size(), values.data()),
+      context->CreateNumber(static_cast<double>(hippy::base::MonotonicallyIncreasingTimeInUs()) / 1000)};
+  context->CallFunction(callback_, arraysize(argv), argv);
+}
+
+std::shared_ptr<CtxValue> PerformanceObserverModule::BindFunction(std::shared_ptr<Scope> scope,
+                                                                  std::shared_ptr<CtxValue>* rest_args) {
+  auto context = scope->GetContext();
+  auto object = context->CreateObject();
+
+  auto key = context->CreateString("ObserveLongTask");
+  auto wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokePerformanceObserverModuleObserveLongTask, nullptr);
+  auto value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  key = context->CreateString("DisconnectLongTask");
+  wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokePerformanceObserverModuleDisconnectLongTask, nullptr);
+  value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  return object;
+}
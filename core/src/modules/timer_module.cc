@@ -39,6 +39,8 @@ namespace napi = ::hippy::napi;
 using unicode_string_view = tdf::base::unicode_string_view;
 using Ctx = hippy::napi::Ctx;
 using CtxValue = hippy::napi::CtxValue;
+using LocalValue = hippy::napi::LocalValue;
+using ValueScope = hippy::napi::ValueScope;
 using RegisterFunction = hippy::base::RegisterFunction;
 using RegisterMap = hippy::base::RegisterMap;
 
@@ -65,39 +67,39 @@ void TimerModule::ClearInterval(const napi::CallbackInfo& info, void* data) {
   auto context = scope->GetContext();
 
   int32_t argument1 = 0;
-  if (!context->GetValueNumber(info[0], &argument1)) {
+  if (!context->GetValueNumber(info.GetLocalValue(0), &argument1)) {
     info.GetExceptionValue()->Set(context, "The first argument must be int32.");
     return;
   }
 
   TaskId task_id = hippy::base::checked_numeric_cast<int32_t, TaskId>(argument1);
   Cancel(task_id, scope);
-  info.GetReturnValue()->Set(context->CreateNumber(task_id));
+  info.GetReturnValue()->Set(context->CreateNumberLocal(task_id));
 }
 
-std::shared_ptr<hippy::napi::CtxValue> TimerModule::Start(
-    const napi::CallbackInfo& info,
-    bool repeat) {
+LocalValue TimerModule::Start(const napi::CallbackInfo& info, bool repeat) {
   auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
   auto scope = scope_wrapper->scope.lock();
   TDF_BASE_CHECK(scope);
   auto context = scope->GetContext();
 
-  std::shared_ptr<CtxValue> function = info[0];
-  if (!context->IsFunction(function)) {
+  if (!context->IsFunction(info.GetLocalValue(0))) {
     info.GetExceptionValue()->Set(context,
                                   "The first argument must be function.");
-    return nullptr;
+    return LocalValue();
   }
+  // the only argument which outlives the call
+  std::shared_ptr<CtxValue> function = info[0];
 
   double number = 0;
-  context->GetValueNumber(info[1], &number);
+  context->GetValueNumber(info.GetLocalValue(1), &number);
 
   hippy::base::TaskRunner::DelayedTimeInMs interval =
       static_cast<hippy::base::TaskRunner::DelayedTimeInMs>(
           std::max(.0, number));
 
   std::shared_ptr<JavaScriptTask> task = std::make_shared<JavaScriptTask>();
+  task->origin_ = repeat ? "setInterval" : "setTimeout";
   std::weak_ptr<JavaScriptTask> weak_task = task;
   std::weak_ptr<Scope> weak_scope = scope;
   std::shared_ptr<TaskEntry> entry = std::make_shared<TaskEntry>(function, task);
@@ -111,7 +113,8 @@ std::shared_ptr<hippy::napi::CtxValue> TimerModule::Start(
     std::shared_ptr<CtxValue> function = weak_function.lock();
     if (function) {
       std::shared_ptr<hippy::napi::Ctx> context = scope->GetContext();
-      context->CallFunction(function, 0, nullptr);
+      ValueScope value_scope(context);
+      context->CallFunctionLocal(function, 0, nullptr);
     }
 
     std::unique_ptr<RegisterMap>& map = scope->GetRegisterMap();
@@ -127,10 +130,12 @@ std::shared_ptr<hippy::napi::CtxValue> TimerModule::Start(
 
     std::shared_ptr<JavaScriptTask> delayed_task = weak_task.lock();
     if (repeat) {
-      if (delayed_task) {
+      // clearInterval may be called from inside the callback
+      if (delayed_task && !delayed_task->canceled_) {
         std::shared_ptr<JavaScriptTaskRunner> runner = scope->GetTaskRunner();
         if (runner) {
-          runner->PostDelayedTask(delayed_task, interval);
+          runner->PostDelayedTask(delayed_task, interval,
+                                  JavaScriptTaskRunner::TimerPrecision::kCoalesced);
         }
       }
     } else {
@@ -140,12 +145,12 @@ std::shared_ptr<hippy::napi::CtxValue> TimerModule::Start(
 
   std::shared_ptr<JavaScriptTaskRunner> runner = scope->GetTaskRunner();
   if (runner) {
-    runner->PostDelayedTask(task, interval);
+    runner->PostDelayedTask(task, interval, JavaScriptTaskRunner::TimerPrecision::kCoalesced);
   }
   std::pair<TaskId, std::shared_ptr<TaskEntry>> item{task->id_, std::move(entry)};
   task_map_.insert(item);
 
-  return context->CreateNumber(task->id_);
+  return context->CreateNumberLocal(task->id_);
 }
 
 void TimerModule::RemoveTask(const std::shared_ptr<JavaScriptTask>& task) {
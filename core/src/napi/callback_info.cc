@@ -27,12 +27,19 @@
 namespace hippy {
 namespace napi {
 
-CallbackInfo::CallbackInfo() {
+CallbackInfo::CallbackInfo() : converter_(nullptr), converter_data_(nullptr) {
   ret_value_ = std::make_unique<ReturnValue>();
   exception_value_ = std::make_unique<ExceptionValue>();
   receiver_ = nullptr;
 }
 
+std::shared_ptr<CtxValue> CallbackInfo::GetReceiver() const {
+  if (!receiver_ && converter_ && !local_receiver_.IsEmpty()) {
+    receiver_ = converter_(converter_data_, local_receiver_);
+  }
+  return receiver_;
+}
+
 void CallbackInfo::AddValue(const std::shared_ptr<CtxValue>& value) {
   if (!value) {
     return;
@@ -40,13 +47,40 @@ void CallbackInfo::AddValue(const std::shared_ptr<CtxValue>& value) {
   values_.push_back(value);
 }
 
+void CallbackInfo::AddValue(const LocalValue& value) {
+  if (value.IsEmpty()) {
+    return;
+  }
+  local_values_.push_back(value);
+}
+
 std::shared_ptr<CtxValue> CallbackInfo::operator[](size_t index) const {
-  if (index < 0 || static_cast<size_t>(index) >= Length()) {
+  if (index >= Length()) {
     return nullptr;
   }
+  if (!converter_) {
+    return values_[index];
+  }
+  if (values_.size() < local_values_.size()) {
+    values_.resize(local_values_.size());
+  }
+  if (!values_[index]) {
+    values_[index] = converter_(converter_data_, local_values_[index]);
+  }
   return values_[index];
 }
 
+LocalValue CallbackInfo::GetLocalValue(size_t index) const {
+  if (index >= Length()) {
+    return LocalValue();
+  }
+  if (converter_) {
+    return local_values_[index];
+  }
+  // the arena fallback of Ctx reads a LocalValue as the address of a CtxValue
+  return LocalValue(&values_[index]);
+}
+
 void ExceptionValue::Set(const std::shared_ptr<Ctx>& context,
                          const unicode_string_view& str) {
   value_ = context->CreateString(str);
@@ -26,6 +26,7 @@
 #include "core/base/string_view_utils.h"
 #include "core/napi/jsc/jsc_ctx_value.h"
 #include "core/napi/callback_info.h"
+#include "core/scope.h"
 #include "core/vm/native_source_code.h"
 #include "core/vm/jsc/jsc_vm.h"
 
@@ -53,6 +54,12 @@ JSValueRef InvokeJsCallback(JSContextRef ctx,
   auto func_wrapper = reinterpret_cast<FuncWrapper*>(func_data->func_wrapper);
   auto js_cb = func_wrapper->cb;
   void* external_data = func_wrapper->data;
+  auto scope = reinterpret_cast<ScopeWrapper*>(func_data->global_external_data)->scope.lock();
+  if (!scope) {
+    return JSValueMakeUndefined(ctx);
+  }
+  // local values of the callback live in the arena of the context
+  ValueScope value_scope(scope->GetContext());
   CallbackInfo cb_info;
   cb_info.SetSlot(func_data->global_external_data);
   auto context = JSContextGetGlobalContext(ctx);
@@ -68,6 +75,10 @@ JSValueRef InvokeJsCallback(JSContextRef ctx,
   }
 
   auto ret_value = std::static_pointer_cast<JSCCtxValue>(cb_info.GetReturnValue()->Get());
+  if (!ret_value) {
+    ret_value = std::static_pointer_cast<JSCCtxValue>(
+        value_scope.GetCtx()->ToPersistent(cb_info.GetReturnValue()->GetLocal()));
+  }
   if (!ret_value) {
     return JSValueMakeUndefined(ctx);
   }
@@ -0,0 +1,90 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/napi/property_key.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "core/napi/js_ctx.h"
+
+namespace hippy {
+namespace napi {
+
+constexpr uint32_t kPropertyKeyIdCount = static_cast<uint32_t>(PropertyKeyId::kCount);
+
+PropertyKey Ctx::GetPropertyKey(const unicode_string_view& name) const {
+  // built with -fno-threadsafe-statics, js threads of several engines may get
+  // here at once; both statics are constant initialized
+  static std::once_flag indexes_once;
+  static std::unordered_map<unicode_string_view, uint32_t>* indexes = nullptr;
+  std::call_once(indexes_once, [] {
+    auto* key_indexes = new std::unordered_map<unicode_string_view, uint32_t>();
+    for (uint32_t i = 0; i < kPropertyKeyIdCount; ++i) {
+      key_indexes->emplace(unicode_string_view(kPropertyKeyNames[i]), i);
+    }
+    indexes = key_indexes;
+  });
+  auto it = indexes->find(name);
+  if (it == indexes->end()) {
+    return PropertyKey();
+  }
+  return PropertyKey(it->second);
+}
+
+tdf::base::unicode_string_view Ctx::GetPropertyKeyName(const PropertyKey& key) const {
+  if (!key.IsValid() || key.GetIndex() >= kPropertyKeyIdCount) {
+    TDF_BASE_DLOG(ERROR) << "GetPropertyKeyName invalid key, index = " << key.GetIndex();
+    return unicode_string_view();
+  }
+  return unicode_string_view(kPropertyKeyNames[key.GetIndex()]);
+}
+
+std::shared_ptr<CtxValue> Ctx::GetProperty(const std::shared_ptr<CtxValue>& object,
+                                           const PropertyKey& key) {
+  return GetProperty(object, GetPropertyKeyName(key));
+}
+
+bool Ctx::SetProperty(std::shared_ptr<CtxValue> object,
+                      const PropertyKey& key,
+                      std::shared_ptr<CtxValue> value) {
+  return SetProperty(object, CreateString(GetPropertyKeyName(key)), value);
+}
+
+bool Ctx::SetProperty(std::shared_ptr<CtxValue> object,
+                      const PropertyKey& key,
+                      std::shared_ptr<CtxValue> value,
+                      const PropertyAttribute& attr) {
+  return SetProperty(object, CreateString(GetPropertyKeyName(key)), value, attr);
+}
+
+bool Ctx::HasNamedProperty(const std::shared_ptr<CtxValue>& value, const PropertyKey& key) {
+  return HasNamedProperty(value, GetPropertyKeyName(key));
+}
+
+std::shared_ptr<CtxValue> Ctx::CopyNamedProperty(const std::shared_ptr<CtxValue>& value,
+                                                 const PropertyKey& key) {
+  return CopyNamedProperty(value, GetPropertyKeyName(key));
+}
+
+}  // namespace napi
+}  // namespace hippy
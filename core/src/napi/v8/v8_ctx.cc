@@ -22,6 +22,10 @@
 
 #include "core/napi/v8/v8_ctx.h"
 
+#include <cstring>
+#include <string>
+#include <utility>
+
 #include "base/unicode_string_view.h"
 #include "core/base/string_view_utils.h"
 #include "core/napi/v8/v8_ctx_value.h"
@@ -43,6 +47,11 @@ using V8VM = hippy::vm::V8VM;
 constexpr static int kInternalIndex = 0;
 constexpr static int kScopeWrapperIndex = 5;
 
+// arguments only become persistent when a callback keeps them
+static std::shared_ptr<CtxValue> ToPersistentValue(void* isolate, const LocalValue& value) {
+  return std::make_shared<V8CtxValue>(reinterpret_cast<v8::Isolate*>(isolate), ToV8Local(value));
+}
+
 void InvokePropertyCallback(v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value>& info) {
   auto isolate = info.GetIsolate();
   v8::HandleScope handle_scope(isolate);
@@ -51,9 +60,9 @@ void InvokePropertyCallback(v8::Local<v8::Name> property, const v8::PropertyCall
 
   CallbackInfo cb_info;
   cb_info.SetSlot(context->GetAlignedPointerFromEmbedderData(kScopeWrapperIndex));
-  cb_info.SetReceiver(std::make_shared<V8CtxValue>(isolate, info.This()));
-  auto name = std::make_shared<V8CtxValue>(isolate, property);
-  cb_info.AddValue(name);
+  cb_info.SetPersistentConverter(ToPersistentValue, isolate);
+  cb_info.SetReceiver(ToLocalValue(info.This()));
+  cb_info.AddValue(ToLocalValue(property));
   auto data = info.Data().As<v8::External>();
   TDF_BASE_CHECK(!data.IsEmpty());
   auto* func_wrapper = reinterpret_cast<FuncWrapper*>(data->Value());
@@ -68,6 +77,12 @@ void InvokePropertyCallback(v8::Local<v8::Name> property, const v8::PropertyCall
     return;
   }
 
+  LocalValue local_ret_value = cb_info.GetReturnValue()->GetLocal();
+  if (!local_ret_value.IsEmpty()) {
+    info.GetReturnValue().Set(ToV8Local(local_ret_value));
+    return;
+  }
+
   auto ret_value = std::static_pointer_cast<V8CtxValue>(cb_info.GetReturnValue()->Get());
   if (!ret_value) {
     info.GetReturnValue().SetUndefined();
@@ -85,9 +100,10 @@ static void InvokeJsCallback(const v8::FunctionCallbackInfo<v8::Value>& info) {
 
   CallbackInfo cb_info;
   cb_info.SetSlot(context->GetAlignedPointerFromEmbedderData(kScopeWrapperIndex));
-  cb_info.SetReceiver(std::make_shared<V8CtxValue>(isolate, info.This()));
+  cb_info.SetPersistentConverter(ToPersistentValue, isolate);
+  cb_info.SetReceiver(ToLocalValue(info.This()));
   for (int i = 0; i < info.Length(); i++) {
-    cb_info.AddValue(std::make_shared<V8CtxValue>(isolate, info[i]));
+    cb_info.AddValue(ToLocalValue(info[i]));
   }
   auto data = info.Data().As<v8::External>();
   TDF_BASE_CHECK(!data.IsEmpty());
@@ -103,6 +119,12 @@ static void InvokeJsCallback(const v8::FunctionCallbackInfo<v8::Value>& info) {
     return;
   }
 
+  LocalValue local_ret_value = cb_info.GetReturnValue()->GetLocal();
+  if (!local_ret_value.IsEmpty()) {
+    info.GetReturnValue().Set(ToV8Local(local_ret_value));
+    return;
+  }
+
   auto ret_value = std::static_pointer_cast<V8CtxValue>(cb_info.GetReturnValue()->Get());
   if (!ret_value) {
     info.GetReturnValue().SetUndefined();
@@ -189,6 +211,109 @@ class ExternalStringResourceImpl : public v8::String::ExternalStringResource {
   size_t length_;
 };
 
+// keeps the source buffer alive while v8 uses the string
+class ExternalSourceOneByteResource : public v8::String::ExternalOneByteStringResource {
+ public:
+  explicit ExternalSourceOneByteResource(std::shared_ptr<hippy::base::SourceBuffer> source)
+      : source_(std::move(source)) {}
+  ~ExternalSourceOneByteResource() override = default;
+  ExternalSourceOneByteResource(const ExternalSourceOneByteResource&) = delete;
+  const ExternalSourceOneByteResource& operator=(const ExternalSourceOneByteResource&) = delete;
+
+  const char* data() const override { return reinterpret_cast<const char*>(source_->data()); }
+  size_t length() const override { return source_->size(); }
+
+ private:
+  std::shared_ptr<hippy::base::SourceBuffer> source_;
+};
+
+class ExternalSourceTwoByteResource : public v8::String::ExternalStringResource {
+ public:
+  explicit ExternalSourceTwoByteResource(std::u16string&& data) : data_(std::move(data)) {}
+  ~ExternalSourceTwoByteResource() override = default;
+  ExternalSourceTwoByteResource(const ExternalSourceTwoByteResource&) = delete;
+  const ExternalSourceTwoByteResource& operator=(const ExternalSourceTwoByteResource&) = delete;
+
+  const uint16_t* data() const override { return reinterpret_cast<const uint16_t*>(data_.c_str()); }
+  size_t length() const override { return data_.length(); }
+
+ private:
+  const std::u16string data_;
+};
+
+static bool IsAscii(const uint8_t* data, size_t size) {
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if (word & kHighBits) {
+      return false;
+    }
+  }
+  for (; i < size; ++i) {
+    if (data[i] & 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// malformed sequences become U+FFFD like in v8::String::NewFromUtf8
+static std::u16string Utf8ToUtf16(const uint8_t* data, size_t size) {
+  constexpr char16_t kReplacement = 0xFFFD;
+  std::u16string result;
+  result.reserve(size);
+  size_t i = 0;
+  while (i < size) {
+    uint8_t lead = data[i];
+    if (lead < 0x80) {
+      result.push_back(lead);
+      ++i;
+      continue;
+    }
+    size_t count;
+    uint32_t code_point;
+    uint32_t min;
+    if ((lead & 0xE0) == 0xC0) {
+      count = 1;
+      code_point = lead & 0x1F;
+      min = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+      count = 2;
+      code_point = lead & 0x0F;
+      min = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+      count = 3;
+      code_point = lead & 0x07;
+      min = 0x10000;
+    } else {
+      result.push_back(kReplacement);
+      ++i;
+      continue;
+    }
+    size_t j = 1;
+    for (; j <= count && i + j < size && (data[i + j] & 0xC0) == 0x80; ++j) {
+      code_point = (code_point << 6) | (data[i + j] & 0x3F);
+    }
+    if (j <= count || code_point < min || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      result.push_back(kReplacement);
+      i += j;
+      continue;
+    }
+    if (code_point >= 0x10000) {
+      code_point -= 0x10000;
+      result.push_back(static_cast<char16_t>(0xD800 + (code_point >> 10)));
+      result.push_back(static_cast<char16_t>(0xDC00 + (code_point & 0x3FF)));
+    } else {
+      result.push_back(static_cast<char16_t>(code_point));
+    }
+    i += j;
+  }
+  return result;
+}
+
 unicode_string_view V8Ctx::GetMsgDesc(v8::Local<v8::Message> message) const {
   if (message.IsEmpty()) {
     return "";
@@ -308,8 +433,26 @@ std::shared_ptr<CtxValue> V8Ctx::GetProperty(
   v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
 
-  auto key = CreateV8String(name);
-  return GetProperty(object, std::make_shared<V8CtxValue>(isolate_, key));
+  auto v8_object = std::static_pointer_cast<V8CtxValue>(object);
+  auto v8_object_handle = v8::Local<v8::Value>::New(isolate_, v8_object->global_value_);
+  auto value = v8::Local<v8::Object>::Cast(v8_object_handle)->Get(
+      context, CreateV8PropertyKey(name)).ToLocalChecked();
+  return std::make_shared<V8CtxValue>(isolate_, value);
+}
+
+std::shared_ptr<CtxValue> V8Ctx::GetProperty(
+    const std::shared_ptr<CtxValue>& object,
+    const PropertyKey& key) {
+  TDF_BASE_CHECK(object && key.IsValid());
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+
+  auto v8_object = std::static_pointer_cast<V8CtxValue>(object);
+  auto v8_object_handle = v8::Local<v8::Value>::New(isolate_, v8_object->global_value_);
+  auto value = v8::Local<v8::Object>::Cast(v8_object_handle)->Get(
+      context, GetV8PropertyKey(key)).ToLocalChecked();
+  return std::make_shared<V8CtxValue>(isolate_, value);
 }
 
 std::shared_ptr<CtxValue> V8Ctx::GetProperty(
@@ -347,11 +490,13 @@ std::shared_ptr<CtxValue> V8Ctx::RunScript(const unicode_string_view& str_view,
   v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
   v8::MaybeLocal<v8::String> source;
+  CodeCacheManager::Entry cache_entry;
 
   unicode_string_view::Encoding encoding = str_view.encoding();
   switch (encoding) {
     case unicode_string_view::Encoding::Latin1: {
       const std::string& str = str_view.latin1_value();
+      cache_entry = LookUpCodeCache(str.c_str(), str.length(), file_name, is_use_code_cache);
       if (is_copy) {
         source = v8::String::NewFromOneByte(
             isolate_, reinterpret_cast<const uint8_t*>(str.c_str()),
@@ -366,6 +511,8 @@ std::shared_ptr<CtxValue> V8Ctx::RunScript(const unicode_string_view& str_view,
     }
     case unicode_string_view::Encoding::Utf16: {
       const std::u16string& str = str_view.utf16_value();
+      cache_entry = LookUpCodeCache(str.c_str(), str.length() * sizeof(char16_t), file_name,
+                                    is_use_code_cache);
       if (is_copy) {
         source = v8::String::NewFromTwoByte(
             isolate_, reinterpret_cast<const uint16_t*>(str.c_str()),
@@ -379,6 +526,8 @@ std::shared_ptr<CtxValue> V8Ctx::RunScript(const unicode_string_view& str_view,
     }
     case unicode_string_view::Encoding::Utf32: {
       const std::u32string& str = str_view.utf32_value();
+      cache_entry = LookUpCodeCache(str.c_str(), str.length() * sizeof(char32_t), file_name,
+                                    is_use_code_cache);
       std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> convert;
       std::string bytes = convert.to_bytes(str);
       std::u16string two_byte(reinterpret_cast<const char16_t*>(bytes.c_str()),
@@ -390,6 +539,7 @@ std::shared_ptr<CtxValue> V8Ctx::RunScript(const unicode_string_view& str_view,
     }
     case unicode_string_view::Encoding::Utf8: {
       const unicode_string_view::u8string& str = str_view.utf8_value();
+      cache_entry = LookUpCodeCache(str.c_str(), str.length(), file_name, is_use_code_cache);
       source = v8::String::NewFromUtf8(
           isolate_, reinterpret_cast<const char*>(str.c_str()),
           v8::NewStringType::kNormal);
@@ -405,7 +555,92 @@ std::shared_ptr<CtxValue> V8Ctx::RunScript(const unicode_string_view& str_view,
     return nullptr;
   }
 
-  return InternalRunScript(context, source.ToLocalChecked(), file_name, is_use_code_cache, cache);
+  return InternalRunScript(context, source.ToLocalChecked(), file_name, is_use_code_cache, cache,
+                           cache_entry);
+}
+
+std::shared_ptr<CtxValue> V8Ctx::RunScript(const std::shared_ptr<hippy::base::SourceBuffer>& source,
+                                           const unicode_string_view& file_name,
+                                           bool is_use_code_cache,
+                                           unicode_string_view* cache) {
+  TDF_BASE_CHECK(source);
+  TDF_BASE_LOG(INFO) << "V8Ctx::RunScript source buffer, file_name = " << file_name
+                     << ", size = " << source->size() << ", is_use_code_cache = " << is_use_code_cache;
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  v8::MaybeLocal<v8::String> v8_source = CreateV8Source(source);
+  if (v8_source.IsEmpty()) {
+    TDF_BASE_DLOG(WARNING) << "v8_source empty, file_name = " << file_name;
+    return nullptr;
+  }
+  CodeCacheManager::Entry cache_entry = LookUpCodeCache(source->data(), source->size(), file_name,
+                                                        is_use_code_cache);
+  return InternalRunScript(context, v8_source.ToLocalChecked(), file_name, is_use_code_cache, cache,
+                           cache_entry);
+}
+
+std::shared_ptr<CtxValue> V8Ctx::RunScript(const std::shared_ptr<hippy::base::SourceBuffer>& source,
+                                           const unicode_string_view& file_name,
+                                           const CodeCacheManager::Entry& cache_entry) {
+  TDF_BASE_CHECK(source);
+  TDF_BASE_LOG(INFO) << "V8Ctx::RunScript source buffer, file_name = " << file_name
+                     << ", size = " << source->size() << ", cache_key = " << cache_entry.key;
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  v8::MaybeLocal<v8::String> v8_source = CreateV8Source(source);
+  if (v8_source.IsEmpty()) {
+    TDF_BASE_DLOG(WARNING) << "v8_source empty, file_name = " << file_name;
+    return nullptr;
+  }
+  if (!code_cache_manager_ || StringViewUtils::IsEmpty(file_name)) {
+    return InternalRunScript(context, v8_source.ToLocalChecked(), file_name, false, nullptr);
+  }
+  return InternalRunScript(context, v8_source.ToLocalChecked(), file_name, false, nullptr, cache_entry);
+}
+
+std::shared_ptr<CtxValue> V8Ctx::RunScript(const std::shared_ptr<V8StreamedScript>& script,
+                                           const std::shared_ptr<hippy::base::SourceBuffer>& source,
+                                           const unicode_string_view& file_name) {
+  TDF_BASE_CHECK(script && source);
+  if (!script->IsParsed()) {
+    TDF_BASE_DLOG(WARNING) << "V8Ctx::RunScript script not parsed, file_name = " << file_name;
+    return RunScript(source, file_name, false, nullptr);
+  }
+  TDF_BASE_LOG(INFO) << "V8Ctx::RunScript streamed, file_name = " << file_name
+                     << ", size = " << source->size();
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  v8::MaybeLocal<v8::String> v8_source = CreateV8Source(source);
+  if (v8_source.IsEmpty()) {
+    TDF_BASE_DLOG(WARNING) << "v8_source empty, file_name = " << file_name;
+    return nullptr;
+  }
+  // scripts are not streamed when a code cache manager would cache them
+  return InternalRunScript(context, v8_source.ToLocalChecked(), file_name, false, nullptr,
+                           CodeCacheManager::Entry(), script->GetStreamedSource());
+}
+
+v8::MaybeLocal<v8::String> V8Ctx::CreateV8Source(const std::shared_ptr<hippy::base::SourceBuffer>& source) {
+  v8::MaybeLocal<v8::String> v8_source;
+  // ascii utf-8 is valid latin1, other sources would need a copy in any case
+  // v8 only owns the resource once the string is created
+  if (IsAscii(source->data(), source->size())) {
+    auto* one_byte = new ExternalSourceOneByteResource(source);
+    v8_source = v8::String::NewExternalOneByte(isolate_, one_byte);
+    if (v8_source.IsEmpty()) {
+      delete one_byte;
+    }
+  } else {
+    auto* two_byte = new ExternalSourceTwoByteResource(Utf8ToUtf16(source->data(), source->size()));
+    v8_source = v8::String::NewExternalTwoByte(isolate_, two_byte);
+    if (v8_source.IsEmpty()) {
+      delete two_byte;
+    }
+  }
+  return v8_source;
 }
 
 void V8Ctx::SetDefaultContext(const std::shared_ptr<v8::SnapshotCreator>& creator) {
@@ -420,7 +655,9 @@ std::shared_ptr<CtxValue> V8Ctx::InternalRunScript(
     v8::Local<v8::String> source,
     const unicode_string_view& file_name,
     bool is_use_code_cache,
-    unicode_string_view* cache) {
+    unicode_string_view* cache,
+    const CodeCacheManager::Entry& cache_entry,
+    v8::ScriptCompiler::StreamedSource* streamed_source) {
   v8::Local<v8::String> v8_file_name = CreateV8String(file_name);
 #if (V8_MAJOR_VERSION == 8 && V8_MINOR_VERSION == 9 && \
      V8_BUILD_NUMBER >= 45) ||                         \
@@ -429,8 +666,13 @@ std::shared_ptr<CtxValue> V8Ctx::InternalRunScript(
 #else
   v8::ScriptOrigin origin(v8_file_name);
 #endif
+  if (!cache_entry.key.empty()) {
+    return RunScriptWithCodeCacheManager(context, source, origin, cache_entry, streamed_source);
+  }
   v8::MaybeLocal<v8::Script> script;
-  if (is_use_code_cache && cache && !StringViewUtils::IsEmpty(*cache)) {
+  if (streamed_source) {
+    script = v8::ScriptCompiler::Compile(context, streamed_source, source, origin);
+  } else if (is_use_code_cache && cache && !StringViewUtils::IsEmpty(*cache)) {
     unicode_string_view::Encoding encoding = cache->encoding();
     if (encoding == unicode_string_view::Encoding::Utf8) {
       const unicode_string_view::u8string& str = cache->utf8_value();
@@ -474,6 +716,68 @@ std::shared_ptr<CtxValue> V8Ctx::InternalRunScript(
   return std::make_shared<V8CtxValue>(isolate_, v8_value);
 }
 
+CodeCacheManager::Entry V8Ctx::LookUpCodeCache(const void* data,
+                                               size_t size,
+                                               const unicode_string_view& file_name,
+                                               bool is_use_code_cache) const {
+  if (!code_cache_manager_ || is_use_code_cache || StringViewUtils::IsEmpty(file_name)) {
+    return CodeCacheManager::Entry();
+  }
+  return code_cache_manager_->Lookup(reinterpret_cast<const uint8_t*>(data), size);
+}
+
+// The cache is produced after the script ran, so that it also holds the
+// functions compiled lazily while running it.
+std::shared_ptr<CtxValue> V8Ctx::RunScriptWithCodeCacheManager(
+    v8::Local<v8::Context> context,
+    v8::Local<v8::String> source,
+    const v8::ScriptOrigin& origin,
+    const CodeCacheManager::Entry& cache_entry,
+    v8::ScriptCompiler::StreamedSource* streamed_source) {
+  const std::string& cache_key = cache_entry.key;
+  const std::shared_ptr<hippy::base::SourceBuffer>& cache = cache_entry.cache;
+  v8::MaybeLocal<v8::Script> script;
+  bool is_cache_accepted = false;
+  if (cache) {
+    auto* cached_data = new v8::ScriptCompiler::CachedData(
+        cache->data(), hippy::base::checked_numeric_cast<size_t, int>(cache->size()),
+        v8::ScriptCompiler::CachedData::BufferNotOwned);
+    v8::ScriptCompiler::Source script_source(source, origin, cached_data);
+    script = v8::ScriptCompiler::Compile(
+        context, &script_source, v8::ScriptCompiler::kConsumeCodeCache);
+    is_cache_accepted = !script_source.GetCachedData()->rejected;
+    if (!is_cache_accepted) {
+      TDF_BASE_LOG(WARNING) << "code cache rejected, key = " << cache_key;
+      code_cache_manager_->Remove(cache_key);
+    }
+  } else if (streamed_source) {
+    script = v8::ScriptCompiler::Compile(context, streamed_source, source, origin);
+  } else {
+    v8::ScriptCompiler::Source script_source(source, origin);
+    script = v8::ScriptCompiler::Compile(context, &script_source);
+  }
+  if (script.IsEmpty()) {
+    return nullptr;
+  }
+
+  v8::Local<v8::Script> local_script = script.ToLocalChecked();
+  v8::MaybeLocal<v8::Value> v8_maybe_value = local_script->Run(context);
+  if (v8_maybe_value.IsEmpty()) {
+    return nullptr;
+  }
+  if (!is_cache_accepted) {
+    std::unique_ptr<v8::ScriptCompiler::CachedData> cached_data(
+        v8::ScriptCompiler::CreateCodeCache(local_script->GetUnboundScript()));
+    if (cached_data && cached_data->length > 0) {
+      code_cache_manager_->Save(cache_key, std::string(reinterpret_cast<const char*>(cached_data->data),
+                                                       hippy::base::checked_numeric_cast<int, size_t>(
+                                                           cached_data->length)));
+    }
+  }
+  v8::Local<v8::Value> v8_value = v8_maybe_value.ToLocalChecked();
+  return std::make_shared<V8CtxValue>(isolate_, v8_value);
+}
+
 void V8Ctx::ThrowException(const std::shared_ptr<CtxValue> &exception) {
   std::shared_ptr<V8CtxValue> ctx_value = std::static_pointer_cast<V8CtxValue>(exception);
   v8::HandleScope handle_scope(isolate_);
@@ -622,6 +926,38 @@ v8::Local<v8::String> V8Ctx::CreateV8String(
   return V8VM::CreateV8String(isolate_, str_view);
 }
 
+v8::Local<v8::String> V8PropertyKeys::Get(PropertyKeyId id) {
+  auto& key = keys_[static_cast<uint32_t>(id)];
+  if (key.IsEmpty()) {
+    auto name = V8VM::CreateV8String(isolate_, kPropertyKeyNames[static_cast<uint32_t>(id)],
+                                     v8::NewStringType::kInternalized);
+    key.Reset(isolate_, name);
+    return name;
+  }
+  return key.Get(isolate_);
+}
+
+void V8PropertyKeys::Reset() {
+  for (auto& key : keys_) {
+    key.Reset();
+  }
+}
+
+v8::Local<v8::String> V8Ctx::GetV8PropertyKey(const PropertyKey& key) {
+  if (!property_keys_) {
+    return V8VM::CreateV8String(isolate_, GetPropertyKeyName(key), v8::NewStringType::kInternalized);
+  }
+  return property_keys_->Get(static_cast<PropertyKeyId>(key.GetIndex()));
+}
+
+v8::Local<v8::String> V8Ctx::CreateV8PropertyKey(const unicode_string_view& name) {
+  auto key = GetPropertyKey(name);
+  if (!key.IsValid()) {
+    return CreateV8String(name);
+  }
+  return GetV8PropertyKey(key);
+}
+
 std::shared_ptr<JSValueWrapper> V8Ctx::ToJsValueWrapper(
     const std::shared_ptr<CtxValue>& value) {
   v8::HandleScope handle_scope(isolate_);
@@ -632,129 +968,152 @@ std::shared_ptr<JSValueWrapper> V8Ctx::ToJsValueWrapper(
   const v8::Global<v8::Value>& global_value = ctx_value->global_value_;
   v8::Local<v8::Value> handle_value =
       v8::Local<v8::Value>::New(isolate_, global_value);
-  if (handle_value->IsUndefined()) {
-    return std::make_shared<JSValueWrapper>(JSValueWrapper::Undefined());
-  } else if (handle_value->IsNull()) {
-    return std::make_shared<JSValueWrapper>(JSValueWrapper::Null());
-  } else if (handle_value->IsBoolean()) {
-    bool v8_value = handle_value->ToBoolean(isolate_)->Value();
-    return std::make_shared<JSValueWrapper>(v8_value);
-  } else if (handle_value->IsString()) {
-    return std::make_shared<JSValueWrapper>(
-        *v8::String::Utf8Value(isolate_, handle_value));
-  } else if (handle_value->IsNumber()) {
-    double v8_value = handle_value->ToNumber(context).ToLocalChecked()->Value();
-    return std::make_shared<JSValueWrapper>(v8_value);
-  } else if (handle_value->IsArray()) {
-    v8::Local<v8::Object> v8_value =
-        handle_value->ToObject(context).ToLocalChecked();
-    // v8::NewStringType::kInternalized
-    v8::Local<v8::Array>::Cast(handle_value);
-    v8::Local<v8::String> len_str =
-        v8::String::NewFromOneByte(isolate_,
-                                   reinterpret_cast<const uint8_t*>("length"),
-                                   v8::NewStringType::kInternalized)
-            .ToLocalChecked();
-    uint32_t len = v8_value->Get(context, len_str)
-        .ToLocalChecked()
-        ->Uint32Value(context)
-        .FromMaybe(0);
-    JSValueWrapper::JSArrayType ret;
+  auto result = std::make_shared<JSValueWrapper>();
+  if (!ToJsValueWrapper(context, handle_value, result.get())) {
+    return nullptr;
+  }
+  return result;
+}
+
+bool V8Ctx::ToJsValueWrapper(v8::Local<v8::Context> context,
+                             v8::Local<v8::Value> value,
+                             JSValueWrapper* result) {
+  if (value->IsUndefined()) {
+    *result = JSValueWrapper::Undefined();
+  } else if (value->IsNull()) {
+    *result = JSValueWrapper::Null();
+  } else if (value->IsBoolean()) {
+    *result = value->BooleanValue(isolate_);
+  } else if (value->IsString()) {
+    *result = JSValueWrapper(ToUtf8String(v8::Local<v8::String>::Cast(value)));
+  } else if (value->IsNumber()) {
+    *result = value->NumberValue(context).FromMaybe(0);
+  } else if (value->IsArray()) {
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Array> array = v8::Local<v8::Array>::Cast(value);
+    uint32_t len = array->Length();
+    JSValueWrapper::JSArrayType ret(len);
     for (uint32_t i = 0; i < len; i++) {
-      v8::Local<v8::Value> element = v8_value->Get(context, i).ToLocalChecked();
-      std::shared_ptr<JSValueWrapper> value_obj =
-          ToJsValueWrapper(std::make_shared<V8CtxValue>(isolate_, element));
-      ret.push_back(*value_obj);
+      v8::Local<v8::Value> element = array->Get(context, i).ToLocalChecked();
+      if (!ToJsValueWrapper(context, element, &ret[i])) {
+        return false;
+      }
     }
-    return std::make_shared<JSValueWrapper>(std::move(ret));
-  } else if (handle_value->IsObject()) {
-    v8::Local<v8::Object> v8_value =
-        handle_value->ToObject(context).ToLocalChecked();
+    *result = JSValueWrapper(std::move(ret));
+  } else if (value->IsObject()) {
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Object> object = v8::Local<v8::Object>::Cast(value);
     JSValueWrapper::JSObjectType ret;
-    v8::MaybeLocal<v8::Array> maybe_props =
-        v8_value->GetOwnPropertyNames(context);
+    v8::MaybeLocal<v8::Array> maybe_props = object->GetOwnPropertyNames(context);
     if (!maybe_props.IsEmpty()) {
       v8::Local<v8::Array> props = maybe_props.ToLocalChecked();
-      for (uint32_t i = 0; i < props->Length(); i++) {
-        v8::Local<v8::Value> props_key =
-            props->Get(context, i).ToLocalChecked();
-        v8::Local<v8::Value> props_value =
-            v8_value->Get(context, props_key).ToLocalChecked();
-
-        std::string key_obj;
-        if (props_key->IsString()) {
-          key_obj = *v8::String::Utf8Value(isolate_, props_key);
-        } else {
+      uint32_t len = props->Length();
+      ret.reserve(len);
+      for (uint32_t i = 0; i < len; i++) {
+        v8::Local<v8::Value> props_key = props->Get(context, i).ToLocalChecked();
+        if (!props_key->IsString()) {
           TDF_BASE_LOG(ERROR)
               << "ToJsValueWrapper parse v8::Object err, props_key illegal";
-          return nullptr;
+          return false;
+        }
+        v8::Local<v8::Value> props_value = object->Get(context, props_key).ToLocalChecked();
+        auto it = ret.try_emplace(ToUtf8String(v8::Local<v8::String>::Cast(props_key))).first;
+        if (!ToJsValueWrapper(context, props_value, &it->second)) {
+          return false;
         }
-
-        std::shared_ptr<JSValueWrapper> value_obj = ToJsValueWrapper(
-            std::make_shared<V8CtxValue>(isolate_, props_value));
-        ret[key_obj] = *value_obj;
       }
     }
-    return std::make_shared<JSValueWrapper>(std::move(ret));
+    *result = JSValueWrapper(std::move(ret));
+  } else {
+    // TDF_BASE_UNIMPLEMENTED();
+    return false;
   }
-
-  // TDF_BASE_UNIMPLEMENTED();
-  return nullptr;
+  return true;
 }
 
 std::shared_ptr<CtxValue> V8Ctx::CreateCtxValue(
     const std::shared_ptr<JSValueWrapper>& wrapper) {
   TDF_BASE_DCHECK(wrapper);
-  if (wrapper->IsUndefined()) {
-    return CreateUndefined();
-  } else if (wrapper->IsNull()) {
-    return CreateNull();
-  } else if (wrapper->IsString()) {
-    std::string str = wrapper->StringValue();
-    unicode_string_view str_view(StringViewUtils::ToU8Pointer(str.c_str()),
-                                 str.length());
-    return CreateString(str_view);
-  } else if (wrapper->IsInt32()) {
-    return CreateNumber(wrapper->Int32Value());
-  } else if (wrapper->IsDouble()) {
-    return CreateNumber(wrapper->DoubleValue());
-  } else if (wrapper->IsBoolean()) {
-    return CreateBoolean(wrapper->BooleanValue());
-  } else if (wrapper->IsArray()) {
-    auto arr = wrapper->ArrayValue();
-    std::shared_ptr<CtxValue> args[arr.size()];
-    for (size_t i = 0; i < arr.size(); ++i) {
-      args[i] = CreateCtxValue(std::make_shared<JSValueWrapper>(arr[i]));
-    }
-    return CreateArray(arr.size(), args);
-  } else if (wrapper->IsObject()) {
-    auto obj = wrapper->ObjectValue();
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
 
-    v8::HandleScope handle_scope(isolate_);
-    v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
-    v8::Context::Scope context_scope(context);
+  // looked up in this scope, a handle made inside the scope of the first
+  // object would be gone by the time the next object uses it
+  v8::Local<v8::Value> object_prototype;
+  if (wrapper->IsArray() || wrapper->IsObject()) {
+    object_prototype = v8::Object::New(isolate_)->GetPrototype();
+  }
+  v8::Local<v8::Value> value = CreateV8Value(context, *wrapper, object_prototype);
+  if (value.IsEmpty()) {
+    return nullptr;
+  }
+  return std::make_shared<V8CtxValue>(isolate_, value);
+}
 
-    v8::Local<v8::Object> v8_obj = v8::Object::New(isolate_);
+v8::Local<v8::Value> V8Ctx::CreateV8Value(v8::Local<v8::Context> context,
+                                          const JSValueWrapper& wrapper,
+                                          v8::Local<v8::Value> object_prototype) {
+  if (wrapper.IsUndefined()) {
+    return v8::Undefined(isolate_);
+  } else if (wrapper.IsNull()) {
+    return v8::Null(isolate_);
+  } else if (wrapper.IsString()) {
+    const std::string& str = wrapper.StringValue();
+    return v8::String::NewFromUtf8(isolate_, str.c_str(), v8::NewStringType::kNormal,
+                                   static_cast<int>(str.length())).ToLocalChecked();
+  } else if (wrapper.IsInt32()) {
+    return v8::Integer::New(isolate_, wrapper.Int32Value());
+  } else if (wrapper.IsUInt32()) {
+    return v8::Integer::NewFromUnsigned(isolate_, wrapper.UInt32Value());
+  } else if (wrapper.IsDouble()) {
+    return v8::Number::New(isolate_, wrapper.DoubleValue());
+  } else if (wrapper.IsBoolean()) {
+    return v8::Boolean::New(isolate_, wrapper.BooleanValue());
+  } else if (wrapper.IsArray()) {
+    v8::EscapableHandleScope handle_scope(isolate_);
+    const auto& arr = wrapper.ArrayValue();
+    std::vector<v8::Local<v8::Value>> elements;
+    elements.reserve(arr.size());
+    for (const auto& element : arr) {
+      v8::Local<v8::Value> element_value = CreateV8Value(context, element, object_prototype);
+      if (element_value.IsEmpty()) {
+        return v8::Local<v8::Value>();
+      }
+      elements.push_back(element_value);
+    }
+    return handle_scope.Escape(v8::Array::New(isolate_, elements.data(), elements.size()));
+  } else if (wrapper.IsObject()) {
+    v8::EscapableHandleScope handle_scope(isolate_);
+    const auto& obj = wrapper.ObjectValue();
+    std::vector<v8::Local<v8::Name>> names;
+    std::vector<v8::Local<v8::Value>> values;
+    names.reserve(obj.size());
+    values.reserve(obj.size());
     for (const auto& p : obj) {
-      auto obj_key = p.first;
-      auto obj_value = p.second;
-      unicode_string_view obj_key_view(
-          StringViewUtils::ToU8Pointer(obj_key.c_str()), obj_key.length());
-      v8::Local<v8::String> key = CreateV8String(obj_key_view);
-      std::shared_ptr<V8CtxValue> ctx_value =
-          std::static_pointer_cast<V8CtxValue>(
-              CreateCtxValue(std::make_shared<JSValueWrapper>(obj_value)));
-      const v8::Global<v8::Value>& global_value = ctx_value->global_value_;
-      TDF_BASE_DCHECK(!global_value.IsEmpty());
-      v8::Local<v8::Value> handle_value =
-          v8::Local<v8::Value>::New(isolate_, global_value);
-      v8_obj->Set(context, key, handle_value).ToChecked();
+      // keys repeat across the objects of a payload, internalize them once
+      names.push_back(v8::String::NewFromUtf8(isolate_, p.first.c_str(),
+                                              v8::NewStringType::kInternalized,
+                                              static_cast<int>(p.first.length())).ToLocalChecked());
+      v8::Local<v8::Value> value = CreateV8Value(context, p.second, object_prototype);
+      if (value.IsEmpty()) {
+        return v8::Local<v8::Value>();
+      }
+      values.push_back(value);
     }
-    return std::make_shared<V8CtxValue>(isolate_, v8_obj);
+    return handle_scope.Escape(v8::Object::New(isolate_, object_prototype, names.data(),
+                                               values.data(), names.size()));
   }
 
   TDF_BASE_UNIMPLEMENTED();
-  return nullptr;
+  return v8::Local<v8::Value>();
+}
+
+std::string V8Ctx::ToUtf8String(v8::Local<v8::String> str) const {
+  std::string result(static_cast<size_t>(str->Utf8Length(isolate_)), '\0');
+  str->WriteUtf8(isolate_, &result[0], static_cast<int>(result.length()), nullptr,
+                 v8::String::NO_NULL_TERMINATION | v8::String::REPLACE_INVALID_UTF8);
+  return result;
 }
 
 unicode_string_view V8Ctx::ToStringView(v8::Local<v8::String> str) const {
@@ -1151,23 +1510,35 @@ bool V8Ctx::HasNamedProperty(const std::shared_ptr<CtxValue>& value,
   v8::HandleScope handle_scope(isolate_);
   v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
+  return HasMapKey(context, value, CreateV8PropertyKey(name));
+}
+
+bool V8Ctx::HasNamedProperty(const std::shared_ptr<CtxValue>& value,
+                             const PropertyKey& key) {
+  if (!value || !key.IsValid()) {
+    return false;
+  }
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  return HasMapKey(context, value, GetV8PropertyKey(key));
+}
+
+bool V8Ctx::HasMapKey(v8::Local<v8::Context> context,
+                      const std::shared_ptr<CtxValue>& value,
+                      v8::Local<v8::String> key) {
   std::shared_ptr<V8CtxValue> ctx_value =
       std::static_pointer_cast<V8CtxValue>(value);
   const v8::Global<v8::Value>& global_value = ctx_value->global_value_;
   v8::Local<v8::Value> handle_value =
       v8::Local<v8::Value>::New(isolate_, global_value);
 
-  if (handle_value.IsEmpty()) {
+  if (handle_value.IsEmpty() || key.IsEmpty()) {
     return false;
   }
 
   if (handle_value->IsMap()) {
     v8::Map* map = v8::Map::Cast(*handle_value);
-    v8::Local<v8::String> key = CreateV8String(name);
-    if (key.IsEmpty()) {
-      return false;
-    }
-
     v8::Maybe<bool> ret = map->Has(context, key);
     return ret.ToChecked();
   }
@@ -1183,13 +1554,31 @@ std::shared_ptr<CtxValue> V8Ctx::CopyNamedProperty(
   v8::HandleScope handle_scope(isolate_);
   v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
+  return CopyMapValue(context, value, CreateV8PropertyKey(name));
+}
+
+std::shared_ptr<CtxValue> V8Ctx::CopyNamedProperty(
+    const std::shared_ptr<CtxValue>& value,
+    const PropertyKey& key) {
+  if (!value || !key.IsValid()) {
+    return nullptr;
+  }
+  v8::HandleScope handle_scope(isolate_);
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  return CopyMapValue(context, value, GetV8PropertyKey(key));
+}
+
+std::shared_ptr<CtxValue> V8Ctx::CopyMapValue(v8::Local<v8::Context> context,
+                                              const std::shared_ptr<CtxValue>& value,
+                                              v8::Local<v8::String> key) {
   std::shared_ptr<V8CtxValue> ctx_value =
       std::static_pointer_cast<V8CtxValue>(value);
   const v8::Global<v8::Value>& global_value = ctx_value->global_value_;
   v8::Local<v8::Value> handle_value =
       v8::Local<v8::Value>::New(isolate_, global_value);
 
-  if (handle_value.IsEmpty()) {
+  if (handle_value.IsEmpty() || key.IsEmpty()) {
     return nullptr;
   }
 
@@ -1199,11 +1588,6 @@ std::shared_ptr<CtxValue> V8Ctx::CopyNamedProperty(
       return nullptr;
     }
 
-    v8::Local<v8::String> key = CreateV8String(name);
-    if (key.IsEmpty()) {
-      return nullptr;
-    }
-
     return std::make_shared<V8CtxValue>(
         isolate_, map->Get(context, key).ToLocalChecked());
   }
@@ -1315,18 +1699,55 @@ bool V8Ctx::SetProperty(std::shared_ptr<CtxValue> object,
   v8::HandleScope handle_scope(isolate_);
   auto context = context_persistent_.Get(isolate_);
   v8::Context::Scope context_scope(context);
-  auto v8_object = std::static_pointer_cast<V8CtxValue>(object);
-  auto handle_v8_object = v8::Local<v8::Value>::New(isolate_, v8_object->global_value_);
   auto v8_key = std::static_pointer_cast<V8CtxValue>(key);
   auto handle_v8_key = v8::Local<v8::Value>::New(isolate_, v8_key->global_value_);
+  return DefineProperty(context, object, handle_v8_key->ToString(context).ToLocalChecked(), value, attr);
+}
+
+bool V8Ctx::SetProperty(std::shared_ptr<CtxValue> object,
+                        const PropertyKey& key,
+                        std::shared_ptr<CtxValue> value) {
+  if (!key.IsValid()) {
+    return false;
+  }
+  v8::HandleScope handle_scope(isolate_);
+  auto context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  auto v8_object = std::static_pointer_cast<V8CtxValue>(object);
+  auto handle_v8_object = v8::Local<v8::Value>::New(isolate_, v8_object->global_value_);
+  auto v8_value = std::static_pointer_cast<V8CtxValue>(value);
+  auto handle_v8_value = v8::Local<v8::Value>::New(isolate_, v8_value->global_value_);
+
+  auto handle_object =  v8::Local<v8::Object>::Cast(handle_v8_object);
+  return handle_object->Set(context, GetV8PropertyKey(key), handle_v8_value).FromMaybe(false);
+}
+
+bool V8Ctx::SetProperty(std::shared_ptr<CtxValue> object,
+                        const PropertyKey& key,
+                        std::shared_ptr<CtxValue> value,
+                        const PropertyAttribute& attr) {
+  if (!key.IsValid()) {
+    return false;
+  }
+  v8::HandleScope handle_scope(isolate_);
+  auto context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  return DefineProperty(context, object, GetV8PropertyKey(key), value, attr);
+}
+
+bool V8Ctx::DefineProperty(v8::Local<v8::Context> context,
+                           const std::shared_ptr<CtxValue>& object,
+                           v8::Local<v8::String> key,
+                           const std::shared_ptr<CtxValue>& value,
+                           const PropertyAttribute& attr) {
+  auto v8_object = std::static_pointer_cast<V8CtxValue>(object);
+  auto handle_v8_object = v8::Local<v8::Value>::New(isolate_, v8_object->global_value_);
   auto v8_value = std::static_pointer_cast<V8CtxValue>(value);
   auto handle_v8_value = v8::Local<v8::Value>::New(isolate_, v8_value->global_value_);
 
   auto handle_object =  v8::Local<v8::Object>::Cast(handle_v8_object);
   auto v8_attr = v8::PropertyAttribute(attr);
-  return handle_object->DefineOwnProperty(context,
-                                          handle_v8_key->ToString(context).ToLocalChecked(),
-                                          handle_v8_value, v8_attr).FromMaybe(false);
+  return handle_object->DefineOwnProperty(context, key, handle_v8_value, v8_attr).FromMaybe(false);
 }
 
 std::shared_ptr<CtxValue> V8Ctx::CreateObject() {
@@ -1435,6 +1856,201 @@ std::shared_ptr<CtxValue> V8Ctx::DefineClass(unicode_string_view name,
   return std::make_shared<V8CtxValue>(isolate_, tpl->GetFunction(context).ToLocalChecked());
 }
 
+// Scoped values
+
+void V8Ctx::EnterValueScope(ValueScope* scope) {
+  static_assert(sizeof(v8::HandleScope) <= ValueScope::kEngineScopeSize,
+                "v8::HandleScope does not fit into ValueScope");
+  // v8::HandleScope hides operator new, the global placement form builds it
+  // in the stack storage of the ValueScope
+  ::new (scope->GetEngineScope()) v8::HandleScope(isolate_);
+}
+
+void V8Ctx::ExitValueScope(ValueScope* scope) {
+  reinterpret_cast<v8::HandleScope*>(scope->GetEngineScope())->~HandleScope();
+}
+
+LocalValue V8Ctx::ToLocal(const std::shared_ptr<CtxValue>& value) {
+  if (!value) {
+    return LocalValue();
+  }
+  auto ctx_value = std::static_pointer_cast<V8CtxValue>(value);
+  return ToLocalValue(v8::Local<v8::Value>::New(isolate_, ctx_value->global_value_));
+}
+
+std::shared_ptr<CtxValue> V8Ctx::ToPersistent(const LocalValue& value) {
+  if (value.IsEmpty()) {
+    return nullptr;
+  }
+  return std::make_shared<V8CtxValue>(isolate_, ToV8Local(value));
+}
+
+LocalValue V8Ctx::CreateNumberLocal(double number) {
+  return ToLocalValue(v8::Number::New(isolate_, number));
+}
+
+LocalValue V8Ctx::CreateStringLocal(const unicode_string_view& string) {
+  if (string.encoding() == unicode_string_view::Encoding::Unknown) {
+    return LocalValue();
+  }
+  return ToLocalValue(CreateV8String(string));
+}
+
+LocalValue V8Ctx::CreateNullLocal() {
+  return ToLocalValue(v8::Null(isolate_));
+}
+
+LocalValue V8Ctx::CallFunctionLocal(const std::shared_ptr<CtxValue>& function,
+                                    size_t argument_count,
+                                    const LocalValue arguments[]) {
+  if (!function) {
+    TDF_BASE_LOG(ERROR) << "function is nullptr";
+    return LocalValue();
+  }
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::Context::Scope context_scope(context);
+  if (context.IsEmpty() || context->Global().IsEmpty()) {
+    TDF_BASE_LOG(ERROR) << "CallFunction context error";
+    return LocalValue();
+  }
+
+  auto ctx_value = std::static_pointer_cast<V8CtxValue>(function);
+  auto handle_value = v8::Local<v8::Value>::New(isolate_, ctx_value->global_value_);
+  if (!handle_value->IsFunction()) {
+    TDF_BASE_LOG(WARNING) << "CallFunction handle_value is not a function";
+    return LocalValue();
+  }
+
+  v8::Local<v8::Value> args[argument_count];
+  for (size_t i = 0; i < argument_count; i++) {
+    if (arguments[i].IsEmpty()) {
+      TDF_BASE_LOG(WARNING) << "CallFunction argument error, i = " << i;
+      return LocalValue();
+    }
+    args[i] = ToV8Local(arguments[i]);
+  }
+
+  v8::MaybeLocal<v8::Value> maybe_result = handle_value.As<v8::Function>()->Call(
+      context, context->Global(), static_cast<int>(argument_count), args);
+  if (maybe_result.IsEmpty()) {
+    TDF_BASE_DLOG(INFO) << "maybe_result is empty";
+    return LocalValue();
+  }
+  return ToLocalValue(maybe_result.ToLocalChecked());
+}
+
+bool V8Ctx::GetValueNumber(const LocalValue& value, double* result) {
+  if (value.IsEmpty() || !result) {
+    return false;
+  }
+  v8::Local<v8::Value> handle_value = ToV8Local(value);
+  if (!handle_value->IsNumber()) {
+    return false;
+  }
+  *result = handle_value.As<v8::Number>()->Value();
+  return true;
+}
+
+bool V8Ctx::GetValueNumber(const LocalValue& value, int32_t* result) {
+  if (value.IsEmpty() || !result) {
+    return false;
+  }
+  v8::Local<v8::Value> handle_value = ToV8Local(value);
+  if (!handle_value->IsInt32()) {
+    return false;
+  }
+  *result = handle_value.As<v8::Int32>()->Value();
+  return true;
+}
+
+bool V8Ctx::GetValueBoolean(const LocalValue& value, bool* result) {
+  if (value.IsEmpty() || !result) {
+    return false;
+  }
+  v8::Local<v8::Value> handle_value = ToV8Local(value);
+  if (!handle_value->IsBoolean() && !handle_value->IsBooleanObject()) {
+    return false;
+  }
+  *result = handle_value->BooleanValue(isolate_);
+  return true;
+}
+
+bool V8Ctx::GetValueString(const LocalValue& value, unicode_string_view* result) {
+  if (value.IsEmpty() || !result) {
+    return false;
+  }
+  v8::Local<v8::Value> handle_value = ToV8Local(value);
+  if (handle_value->IsString()) {
+    *result = ToStringView(handle_value.As<v8::String>());
+    return true;
+  }
+  if (handle_value->IsStringObject()) {
+    *result = ToStringView(handle_value.As<v8::StringObject>()->ValueOf());
+    return true;
+  }
+  return false;
+}
+
+bool V8Ctx::IsNullOrUndefined(const LocalValue& value) {
+  if (value.IsEmpty()) {
+    return true;
+  }
+  return ToV8Local(value)->IsNullOrUndefined();
+}
+
+bool V8Ctx::IsString(const LocalValue& value) {
+  return !value.IsEmpty() && ToV8Local(value)->IsString();
+}
+
+bool V8Ctx::IsFunction(const LocalValue& value) {
+  return !value.IsEmpty() && ToV8Local(value)->IsFunction();
+}
+
+bool V8Ctx::IsArray(const LocalValue& value) {
+  return !value.IsEmpty() && ToV8Local(value)->IsArray();
+}
+
+bool V8Ctx::IsMap(const LocalValue& value) {
+  return !value.IsEmpty() && ToV8Local(value)->IsMap();
+}
+
+uint32_t V8Ctx::GetArrayLength(const LocalValue& value) {
+  if (!IsArray(value)) {
+    return 0;
+  }
+  return ToV8Local(value).As<v8::Array>()->Length();
+}
+
+LocalValue V8Ctx::CopyArrayElementLocal(const LocalValue& value, uint32_t index) {
+  if (!IsArray(value)) {
+    return LocalValue();
+  }
+  v8::Local<v8::Context> context = context_persistent_.Get(isolate_);
+  v8::MaybeLocal<v8::Value> maybe_element = ToV8Local(value).As<v8::Array>()->Get(context, index);
+  if (maybe_element.IsEmpty()) {
+    return LocalValue();
+  }
+  return ToLocalValue(maybe_element.ToLocalChecked());
+}
+
+LocalValue V8Ctx::ConvertMapToArrayLocal(const LocalValue& value) {
+  if (!IsMap(value)) {
+    return LocalValue();
+  }
+  return ToLocalValue(ToV8Local(value).As<v8::Map>()->AsArray());
+}
+
+void* V8Ctx::GetExternal(const LocalValue& object) {
+  if (object.IsEmpty() || !ToV8Local(object)->IsObject()) {
+    return nullptr;
+  }
+  auto handle_object = ToV8Local(object).As<v8::Object>();
+  if (handle_object->InternalFieldCount() <= kInternalIndex) {
+    return nullptr;
+  }
+  return handle_object->GetAlignedPointerFromInternalField(kInternalIndex);
+}
+
 REGISTER_EXTERNAL_REFERENCES(InvokeJsCallback)
 
 }  // namespace napi
@@ -0,0 +1,108 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/napi/v8/v8_streamed_script.h"
+
+#include <utility>
+
+#include "base/logging.h"
+
+namespace hippy {
+namespace napi {
+
+namespace {
+
+// v8 takes the chunks it is given and frees them with delete[]
+class SourceStreamAdapter : public v8::ScriptCompiler::ExternalSourceStream {
+ public:
+  SourceStreamAdapter(std::shared_ptr<hippy::base::SourceStream> stream, const V8StreamedScript* script)
+      : stream_(std::move(stream)), script_(script) {}
+  ~SourceStreamAdapter() override = default;
+
+  size_t GetMoreData(const uint8_t** src) override {
+    if (script_->IsCanceled()) {
+      return 0;
+    }
+    auto chunk = std::make_unique<uint8_t[]>(hippy::base::SourceStream::kChunkSize);
+    size_t length = stream_->Read(chunk.get(), hippy::base::SourceStream::kChunkSize);
+    if (length == 0) {
+      return 0;
+    }
+    *src = chunk.release();
+    return length;
+  }
+
+ private:
+  std::shared_ptr<hippy::base::SourceStream> stream_;
+  const V8StreamedScript* script_;
+};
+
+}  // namespace
+
+V8StreamedScript::V8StreamedScript(std::shared_ptr<SourceStream> stream)
+    : stream_(std::move(stream)), is_parsing_(false), is_parsed_(false), is_canceled_(false) {}
+
+std::shared_ptr<V8StreamedScript> V8StreamedScript::Start(v8::Isolate* isolate,
+                                                          std::shared_ptr<SourceStream> stream) {
+  TDF_BASE_CHECK(stream);
+  auto script = std::make_shared<V8StreamedScript>(stream);
+  script->source_ = std::make_unique<v8::ScriptCompiler::StreamedSource>(
+      std::make_unique<SourceStreamAdapter>(std::move(stream), script.get()),
+      v8::ScriptCompiler::StreamedSource::UTF8);
+  script->task_.reset(v8::ScriptCompiler::StartStreaming(isolate, script->source_.get()));
+  if (!script->task_) {
+    TDF_BASE_DLOG(INFO) << "V8StreamedScript v8 cannot stream the script";
+    return nullptr;
+  }
+  return script;
+}
+
+void V8StreamedScript::Parse() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (IsCanceled() || is_parsed_) {
+      return;
+    }
+    is_parsing_ = true;
+  }
+  task_->Run();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_parsing_ = false;
+    is_parsed_ = !IsCanceled();
+  }
+  cv_.notify_all();
+}
+
+void V8StreamedScript::Cancel() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  is_canceled_.store(true, std::memory_order_release);
+  cv_.wait(lock, [this] { return !is_parsing_; });
+}
+
+bool V8StreamedScript::IsParsed() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_parsed_;
+}
+
+}  // namespace napi
+}  // namespace hippy
@@ -0,0 +1,135 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/napi/value_scope.h"
+
+#include <utility>
+#include <vector>
+
+#include "core/napi/js_ctx.h"
+
+namespace hippy {
+namespace napi {
+
+ValueScope::ValueScope(std::shared_ptr<Ctx> ctx) : ctx_(std::move(ctx)), arena_mark_(0) {
+  ctx_->EnterValueScope(this);
+}
+
+ValueScope::~ValueScope() {
+  ctx_->ExitValueScope(this);
+}
+
+// the arena fallback hands out the address of the arena slot, std::deque
+// keeps it stable while later values are appended
+
+void Ctx::EnterValueScope(ValueScope* scope) {
+  scope->SetArenaMark(local_arena_.size());
+}
+
+void Ctx::ExitValueScope(ValueScope* scope) {
+  TDF_BASE_DCHECK(scope->GetArenaMark() <= local_arena_.size());
+  local_arena_.resize(scope->GetArenaMark());
+}
+
+LocalValue Ctx::ToLocal(const std::shared_ptr<CtxValue>& value) {
+  if (!value) {
+    return LocalValue();
+  }
+  local_arena_.push_back(value);
+  return LocalValue(&local_arena_.back());
+}
+
+std::shared_ptr<CtxValue> Ctx::ToPersistent(const LocalValue& value) {
+  if (value.IsEmpty()) {
+    return nullptr;
+  }
+  return *reinterpret_cast<std::shared_ptr<CtxValue>*>(value.GetHandle());
+}
+
+LocalValue Ctx::CreateNumberLocal(double number) {
+  return ToLocal(CreateNumber(number));
+}
+
+LocalValue Ctx::CreateStringLocal(const unicode_string_view& string) {
+  return ToLocal(CreateString(string));
+}
+
+LocalValue Ctx::CreateNullLocal() {
+  return ToLocal(CreateNull());
+}
+
+LocalValue Ctx::CallFunctionLocal(const std::shared_ptr<CtxValue>& function,
+                                  size_t argument_count,
+                                  const LocalValue arguments[]) {
+  std::vector<std::shared_ptr<CtxValue>> argv(argument_count);
+  for (size_t i = 0; i < argument_count; ++i) {
+    argv[i] = ToPersistent(arguments[i]);
+  }
+  return ToLocal(CallFunction(function, argument_count, argv.data()));
+}
+
+bool Ctx::GetValueNumber(const LocalValue& value, double* result) {
+  return GetValueNumber(ToPersistent(value), result);
+}
+
+bool Ctx::GetValueNumber(const LocalValue& value, int32_t* result) {
+  return GetValueNumber(ToPersistent(value), result);
+}
+
+bool Ctx::GetValueBoolean(const LocalValue& value, bool* result) {
+  return GetValueBoolean(ToPersistent(value), result);
+}
+
+bool Ctx::GetValueString(const LocalValue& value, unicode_string_view* result) {
+  return GetValueString(ToPersistent(value), result);
+}
+
+bool Ctx::IsNullOrUndefined(const LocalValue& value) {
+  return IsNullOrUndefined(ToPersistent(value));
+}
+
+bool Ctx::IsString(const LocalValue& value) {
+  return IsString(ToPersistent(value));
+}
+
+bool Ctx::IsFunction(const LocalValue& value) {
+  return IsFunction(ToPersistent(value));
+}
+
+bool Ctx::IsArray(const LocalValue& value) {
+  return IsArray(ToPersistent(value));
+}
+
+bool Ctx::IsMap(const LocalValue& value) {
+  return IsMap(ToPersistent(value));
+}
+
+uint32_t Ctx::GetArrayLength(const LocalValue& value) {
+  return GetArrayLength(ToPersistent(value));
+}
+
+LocalValue Ctx::CopyArrayElementLocal(const LocalValue& value, uint32_t index) {
+  return ToLocal(CopyArrayElement(ToPersistent(value), index));
+}
+
+}  // namespace napi
+}  // namespace hippy
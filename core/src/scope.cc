@@ -29,7 +29,10 @@
 #include <vector>
 
 #include "base/logging.h"
+#include "core/modules/animation_frame_module.h"
 #include "core/modules/console_module.h"
+#include "core/modules/idle_callback_module.h"
+#include "core/modules/performance_observer_module.h"
 #include "core/modules/timer_module.h"
 #include "core/modules/contextify_module.h"
 #include "core/task/javascript_task.h"
@@ -37,6 +40,7 @@
 #include "core/vm/native_source_code.h"
 #ifdef JS_V8
 #include "core/napi/v8/v8_ctx.h"
+#include "core/vm/v8/cpu_profiler_module.h"
 #include "core/vm/v8/memory_module.h"
 #include "core/vm/v8/snapshot_collector.h"
 #endif
@@ -106,7 +110,7 @@ void Scope::WillExit() {
           }
         }
         for (const auto& will_exit_cb: will_exit_cbs) {
-          will_exit_cb();
+          will_exit_cb.second();
         }
         p.set_value(rst);
       });
@@ -138,6 +142,10 @@ void Scope::CreateContext() {
   context_ = engine->GetVM()->CreateContext();
   TDF_BASE_CHECK(context_);
   context_->SetExternalData(GetScopeWrapperPointer());
+#ifdef JS_V8
+  std::static_pointer_cast<hippy::napi::V8Ctx>(context_)->SetCodeCacheManager(
+      engine->GetCodeCacheManager());
+#endif
   if (map_) {
     auto it = map_->find(hippy::base::kContextCreatedCBKey);
     if (it != map_->end()) {
@@ -150,13 +158,23 @@ void Scope::CreateContext() {
   }
 }
 
+std::shared_ptr<VsyncSource> Scope::GetVsyncSource() {
+  if (!vsync_source_) {
+    vsync_source_ = std::make_shared<TimerVsyncSource>(GetTaskRunner());
+  }
+  return vsync_source_;
+}
 
 void Scope::BindModule() {
   module_object_map_["ConsoleModule"] = std::make_shared<ConsoleModule>();
   module_object_map_["TimerModule"] = std::make_shared<TimerModule>();
+  module_object_map_["IdleCallbackModule"] = std::make_shared<IdleCallbackModule>();
+  module_object_map_["AnimationFrameModule"] = std::make_shared<AnimationFrameModule>();
+  module_object_map_["PerformanceObserverModule"] = std::make_shared<PerformanceObserverModule>();
   module_object_map_["ContextifyModule"] = std::make_shared<ContextifyModule>();
 #ifdef JS_V8
   module_object_map_["MemoryModule"] = std::make_shared<MemoryModule>();
+  module_object_map_["CpuProfilerModule"] = std::make_shared<CpuProfilerModule>();
 #endif
 }
 
@@ -197,7 +215,7 @@ void Scope::RunJS(const unicode_string_view& data,
                   const unicode_string_view& name,
                   bool is_copy) {
   std::weak_ptr<Ctx> weak_context = context_;
-  JavaScriptTask::Function callback = [data, name, is_copy, weak_context] {
+  auto callback = [data, name, is_copy, weak_context] {
 #ifdef JS_V8
     auto context = std::static_pointer_cast<hippy::napi::V8Ctx>(weak_context.lock());
     if (context) {
@@ -215,9 +233,35 @@ void Scope::RunJS(const unicode_string_view& data,
   if (runner->IsJsThread()) {
     callback();
   } else {
-    std::shared_ptr<JavaScriptTask> task = std::make_shared<JavaScriptTask>();
-    task->callback = callback;
-    runner->PostTask(task);
+    runner->PostFunction(std::move(callback), JavaScriptTaskRunner::Priority::kNormal, "RunJS");
+  }
+}
+
+void Scope::RunJS(const std::shared_ptr<hippy::base::SourceBuffer>& source,
+                  const unicode_string_view& name) {
+  TDF_BASE_CHECK(source);
+  std::weak_ptr<Ctx> weak_context = context_;
+  auto callback = [source, name, weak_context] {
+#ifdef JS_V8
+    auto context = std::static_pointer_cast<hippy::napi::V8Ctx>(weak_context.lock());
+    if (context) {
+      context->RunScript(source, name, false, nullptr);
+    }
+#else
+    auto context = weak_context.lock();
+    if (context) {
+      unicode_string_view::u8string code(reinterpret_cast<const unicode_string_view::char8_t_*>(source->data()),
+                                         source->size());
+      context->RunScript(unicode_string_view(std::move(code)), name);
+    }
+#endif
+  };
+
+  auto runner = GetTaskRunner();
+  if (runner->IsJsThread()) {
+    callback();
+  } else {
+    runner->PostFunction(std::move(callback), JavaScriptTaskRunner::Priority::kNormal, "RunJS");
   }
 }
 
@@ -250,6 +294,7 @@ std::shared_ptr<CtxValue> Scope::RunJSSync(const unicode_string_view& data,
   } else {
     std::shared_ptr<JavaScriptTask> task = std::make_shared<JavaScriptTask>();
     task->callback = cb;
+    task->origin_ = "RunJSSync";
     runner->PostTask(task);
   }
   std::shared_ptr<CtxValue> ret = future.get();
@@ -0,0 +1,152 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/task/hang_watchdog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "base/logging.h"
+#include "core/base/base_time.h"
+
+namespace {
+// a stall is noticed between threshold and threshold + threshold / kChecksPerThreshold
+constexpr uint64_t kChecksPerThreshold = 4;
+constexpr uint64_t kMinCheckIntervalInMs = 10;
+}  // namespace
+
+HangWatchdog::HangWatchdog(std::weak_ptr<TaskRunner> runner, uint64_t threshold_ms, HangCallback cb)
+    : Thread(Options("Hippy HangWatchdog")),
+      runner_(std::move(runner)),
+      threshold_ms_(threshold_ms),
+      check_interval_ms_(std::max(threshold_ms / kChecksPerThreshold, kMinCheckIntervalInMs)),
+      cb_(std::move(cb)),
+      is_terminated_(false) {
+  std::shared_ptr<TaskRunner> strong_runner = runner_.lock();
+  if (strong_runner) {
+    strong_runner->AddRunningTaskWatcher();
+  }
+  Start();
+}
+
+HangWatchdog::~HangWatchdog() {
+  Terminate();
+}
+
+void HangWatchdog::Terminate() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_terminated_) {
+      return;
+    }
+    is_terminated_ = true;
+  }
+  cv_.notify_all();
+  Join();
+  std::shared_ptr<TaskRunner> runner = runner_.lock();
+  if (runner) {
+    runner->RemoveRunningTaskWatcher();
+  }
+  TDF_BASE_DLOG(INFO) << "HangWatchdog terminated";
+}
+
+void HangWatchdog::Run() {
+  uint64_t watched_sequence = 0;
+  bool is_reported = false;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_terminated_) {
+    cv_.wait_for(lock, std::chrono::milliseconds(check_interval_ms_));
+    if (is_terminated_) {
+      return;
+    }
+    std::shared_ptr<TaskRunner> runner = runner_.lock();
+    if (!runner) {
+      return;
+    }
+    TaskRunner::RunningTask running_task;
+    if (!runner->GetRunningTask(running_task)) {
+      watched_sequence = 0;
+      continue;
+    }
+    if (running_task.sequence != watched_sequence) {
+      watched_sequence = running_task.sequence;
+      is_reported = false;
+    }
+    // one report per stalled task
+    if (is_reported) {
+      continue;
+    }
+    uint64_t now = hippy::base::MonotonicallyIncreasingTimeInUs();
+    uint64_t elapsed_ms = now > running_task.start_time_in_us ? (now - running_task.start_time_in_us) / 1000 : 0;
+    if (elapsed_ms < threshold_ms_) {
+      continue;
+    }
+    is_reported = true;
+    lock.unlock();
+    Report(running_task, elapsed_ms);
+    lock.lock();
+  }
+}
+
+void HangWatchdog::Report(const TaskRunner::RunningTask& running_task, uint64_t elapsed_ms) {
+  TDF_BASE_DLOG(WARNING) << "HangWatchdog task " << running_task.task_id << " from "
+                         << (running_task.origin ? running_task.origin : "unknown")
+                         << " has run for " << elapsed_ms << "ms";
+  HangInfo info{running_task.task_id, running_task.origin, elapsed_ms, unicode_string_view()};
+  StackSampler sampler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sampler = sampler_;
+  }
+  if (sampler) {
+    info.js_stack = SampleStack(sampler);
+  }
+  cb_(info);
+}
+
+// a stalled thread that never reaches a point where it can be sampled must
+// not hold back the report, so the wait is bounded by one check interval
+tdf::base::unicode_string_view HangWatchdog::SampleStack(const StackSampler& sampler) {
+  struct Sample {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool is_done = false;
+    unicode_string_view js_stack;
+  };
+  auto sample = std::make_shared<Sample>();
+  sampler([sample](unicode_string_view js_stack) {
+    {
+      std::lock_guard<std::mutex> lock(sample->mutex);
+      sample->js_stack = std::move(js_stack);
+      sample->is_done = true;
+    }
+    sample->cv.notify_one();
+  });
+  std::unique_lock<std::mutex> lock(sample->mutex);
+  if (!sample->cv.wait_for(lock, std::chrono::milliseconds(check_interval_ms_),
+                           [&sample] { return sample->is_done; })) {
+    TDF_BASE_DLOG(WARNING) << "HangWatchdog js stack not sampled in " << check_interval_ms_ << "ms";
+    return unicode_string_view();
+  }
+  return std::move(sample->js_stack);
+}
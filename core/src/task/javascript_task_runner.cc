@@ -22,12 +22,25 @@
 
 #include "core/task/javascript_task_runner.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "core/base/task.h"
+#include "core/task/idle_task.h"
 
-JavaScriptTaskRunner::JavaScriptTaskRunner() {
+constexpr JavaScriptTaskRunner::DelayedTimeInMs JavaScriptTaskRunner::kMaxIdlePeriodInMs;
+
+const JavaScriptTaskRunner::TimerSlack JavaScriptTaskRunner::kDefaultForegroundTimerSlack = {8, 16};
+const JavaScriptTaskRunner::TimerSlack JavaScriptTaskRunner::kDefaultBackgroundTimerSlack = {1000, 0};
+
+JavaScriptTaskRunner::JavaScriptTaskRunner() : JavaScriptTaskRunner(Options()) {}
+
+JavaScriptTaskRunner::JavaScriptTaskRunner(const Options& options)
+    : TaskRunner(options),
+      foreground_timer_slack_(kDefaultForegroundTimerSlack),
+      background_timer_slack_(kDefaultBackgroundTimerSlack) {
   SetName("hippy.js");
+  timer_slack_ = foreground_timer_slack_;
 }
 
 bool JavaScriptTaskRunner::IsJsThread() {
@@ -43,12 +56,59 @@ void JavaScriptTaskRunner::PauseThreadForInspector() {
       return;
     }
 
-    if (!task->canceled_) {
-      task->Run();
-    }
+    RunTask(task);
   }
 }
 
 void JavaScriptTaskRunner::ResumeThreadForInspector() {
   is_inspector_call_pause_ = false;
 }
+
+void JavaScriptTaskRunner::SetTimerSlackPolicy(TimerSlack foreground, TimerSlack background) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  foreground_timer_slack_ = foreground;
+  background_timer_slack_ = background;
+  timer_slack_ = is_background_ ? background_timer_slack_ : foreground_timer_slack_;
+}
+
+// only affects timers posted afterwards, pending ones keep their deadline
+void JavaScriptTaskRunner::SetBackground(bool background) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  is_background_ = background;
+  timer_slack_ = is_background_ ? background_timer_slack_ : foreground_timer_slack_;
+}
+
+void JavaScriptTaskRunner::PostIdleTask(std::shared_ptr<IdleTask> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (is_terminated_) {
+      return;
+    }
+    idle_task_queue_.push_back(std::move(task));
+
+    cv_.notify_one();
+  }
+  // a parked host only polls for idle tasks when forced to, and must not be
+  // woken with mutex_ held
+  WakeUpHost(true);
+}
+
+std::shared_ptr<hippy::base::Task> JavaScriptTaskRunner::GetIdleTaskNoLock(
+    DelayedTimeInMs now,
+    DelayedTimeInMs next_wake_up) {
+  // the inspector pause loop only serves the debugger
+  if (is_inspector_call_pause_) {
+    return nullptr;
+  }
+  while (!idle_task_queue_.empty()) {
+    std::shared_ptr<IdleTask> task = std::move(idle_task_queue_.front());
+    idle_task_queue_.pop_front();
+    if (task->canceled_) {
+      continue;
+    }
+    task->SetDeadline(std::min(now + kMaxIdlePeriodInMs, next_wake_up));
+    return task;
+  }
+  return nullptr;
+}
@@ -0,0 +1,44 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/task/vsync_source.h"
+
+#include "core/base/base_time.h"
+#include "core/base/inline_task.h"
+
+constexpr uint64_t TimerVsyncSource::kFrameIntervalInMs;
+
+TimerVsyncSource::TimerVsyncSource(std::weak_ptr<hippy::base::TaskRunner> runner)
+    : runner_(std::move(runner)) {}
+
+void TimerVsyncSource::RequestFrame(FrameCallback cb) {
+  std::shared_ptr<hippy::base::TaskRunner> runner = runner_.lock();
+  if (!runner) {
+    return;
+  }
+  uint64_t now = hippy::base::MonotonicallyIncreasingTime();
+  uint64_t frame_time = (now / kFrameIntervalInMs + 1) * kFrameIntervalInMs;
+  auto task = hippy::base::InlineTask::Create([cb = std::move(cb), frame_time] {
+    cb(frame_time);
+  });
+  runner->PostDelayedTask(std::move(task), frame_time - now);
+}
@@ -27,42 +27,130 @@
 const uint32_t WorkerTaskRunner::kDefaultTaskPriority = 10000;
 const uint32_t WorkerTaskRunner::kHighPriorityTaskPriority = 5000;
 const uint32_t WorkerTaskRunner::kLowPriorityTaskPriority = 15000;
+const uint64_t WorkerTaskRunner::kNoDeadline = UINT64_MAX;
 
-WorkerTaskRunner::WorkerTaskRunner(uint32_t pool_size) : pool_size_(pool_size) {
+void WorkerTaskRunner::TaskHandle::Cancel() {
+  auto task = task_.lock();
+  if (task) {
+    task->canceled_ = true;
+  }
+}
+
+bool WorkerTaskRunner::TaskHandle::IsPending() const {
+  auto task = task_.lock();
+  return task && !task->canceled_;
+}
+
+WorkerTaskRunner::WorkerTaskRunner(uint32_t pool_size, const hippy::base::Thread::Options& options)
+    : pool_size_(pool_size) {
   for (uint32_t i = 0; i < pool_size_; ++i) {
-    thread_pool_.push_back(std::make_unique<WorkerThread>(this));
+    thread_pool_.push_back(std::make_unique<WorkerThread>(this, options));
   }
 }
 
 void WorkerTaskRunner::PostPromiseTask(std::unique_ptr<CommonTask> task, uint32_t priority) {
+  if (IsTaskStatsEnabled()) {
+    task->enqueue_time_ = hippy::base::MonotonicallyIncreasingTimeInUs();
+  }
   std::lock_guard<std::mutex> lock(mutex_);
   if (terminated_) {
     task->Run(); // Run the task immediately
     return;
   }
-  task_queue_.push(std::make_pair(priority, std::move(task)));
+  task_queue_.push(Entry{priority, kNoDeadline, std::move(task)});
   cv_.notify_one();
 }
 
-void WorkerTaskRunner::PostTask(std::unique_ptr<CommonTask> task,
-                                uint32_t priority) {
+WorkerTaskRunner::TaskHandle WorkerTaskRunner::PostTask(std::unique_ptr<CommonTask> task,
+                                                        uint32_t priority,
+                                                        uint64_t deadline) {
+  std::shared_ptr<CommonTask> shared_task = std::move(task);
+  TaskHandle handle(shared_task);
   std::lock_guard<std::mutex> lock(mutex_);
   if (terminated_) {
-    return;
+    return TaskHandle();
   }
-  task_queue_.push(std::make_pair(priority, std::move(task)));
+  EnqueueNoLock(std::move(shared_task), priority, deadline);
   cv_.notify_one();
+  return handle;
+}
+
+void WorkerTaskRunner::EnqueueNoLock(std::shared_ptr<CommonTask> task, uint32_t priority, uint64_t deadline) {
+  if (IsTaskStatsEnabled()) {
+    task->enqueue_time_ = hippy::base::MonotonicallyIncreasingTimeInUs();
+  }
+  task_queue_.push(Entry{priority, deadline, std::move(task)});
+}
+
+hippy::base::Executor WorkerTaskRunner::Schedule(uint32_t priority) {
+  std::weak_ptr<WorkerTaskRunner> weak_runner = weak_from_this();
+  return hippy::base::Executor([weak_runner, priority](hippy::base::Executor::Job job) {
+    auto runner = weak_runner.lock();
+    if (!runner) {
+      return;
+    }
+    auto task = std::make_unique<CommonTask>();
+    task->func_ = std::move(job);
+    runner->PostTask(std::move(task), priority);
+  });
+}
+
+void WorkerTaskRunner::RunTask(const std::shared_ptr<CommonTask>& task) {
+  if (!IsTaskStatsEnabled()) {
+    task->Run();
+    return;
+  }
+  uint64_t start_time = hippy::base::MonotonicallyIncreasingTimeInUs();
+  task->Run();
+  uint64_t duration = hippy::base::MonotonicallyIncreasingTimeInUs() - start_time;
+  uint64_t queue_wait = task->enqueue_time_ ? start_time - task->enqueue_time_ : UINT64_MAX;
+  task_stats_.Record(task->origin_, queue_wait, start_time, duration);
+}
+
+bool WorkerTaskRunner::HasLiveWaiter(const std::string& dedup_key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = dedup_groups_.find(dedup_key);
+  if (it == dedup_groups_.end()) {
+    return false;
+  }
+  uint64_t now = hippy::base::MonotonicallyIncreasingTime();
+  for (auto& waiter : it->second) {
+    if (waiter->IsLive(now)) {
+      return true;
+    }
+  }
+  return false;
 }
 
-std::unique_ptr<CommonTask> WorkerTaskRunner::GetNext() {
+WorkerTaskRunner::DedupGroup WorkerTaskRunner::TakeDedupGroup(const std::string& dedup_key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DedupGroup group;
+  auto it = dedup_groups_.find(dedup_key);
+  if (it != dedup_groups_.end()) {
+    group = std::move(it->second);
+    dedup_groups_.erase(it);
+  }
+  return group;
+}
+
+std::shared_ptr<CommonTask> WorkerTaskRunner::GetNext() {
   std::unique_lock<std::mutex> lock(mutex_);
   while (true) {
     if (!task_queue_.empty()) {
       const Entry& entry = task_queue_.top();
-      std::unique_ptr<CommonTask> result =
-          std::move(const_cast<Entry&>(entry).second);
+      std::shared_ptr<CommonTask> result = std::move(const_cast<Entry&>(entry).task);
+      uint64_t deadline = entry.deadline;
 
       task_queue_.pop();
+      // canceled and expired tasks are dropped here, their captures are
+      // released without running them
+      if (result->canceled_) {
+        continue;
+      }
+      if (deadline != kNoDeadline && hippy::base::MonotonicallyIncreasingTime() > deadline) {
+        TDF_BASE_DLOG(INFO) << "WorkerTaskRunner drop expired task, id = " << result->id_;
+        continue;
+      }
       return result;
     }
 
@@ -84,11 +172,16 @@ void WorkerTaskRunner::Terminate() {
   }
   cv_.notify_all();
   thread_pool_.clear();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dedup_groups_.clear();
+  }
   TDF_BASE_DLOG(INFO) << "WorkerTaskRunner::Terminate end";
 }
 
-WorkerTaskRunner::WorkerThread::WorkerThread(WorkerTaskRunner* runner)
-    : Thread(Options("Hippy WorkerTaskRunner WorkerThread")), runner_(runner) {
+WorkerTaskRunner::WorkerThread::WorkerThread(WorkerTaskRunner* runner, const Options& options)
+    : Thread(options), runner_(runner) {
+  SetName("Hippy WorkerTaskRunner WorkerThread");
   TDF_BASE_DLOG(INFO) << "WorkerThread create";
   Start();
 }
@@ -100,8 +193,8 @@ WorkerTaskRunner::WorkerThread::~WorkerThread() {
 }
 
 void WorkerTaskRunner::WorkerThread::Run() {
-  while (std::unique_ptr<CommonTask> task = runner_->GetNext()) {
-    task->Run();
+  while (std::shared_ptr<CommonTask> task = runner_->GetNext()) {
+    runner_->RunTask(task);
   }
   TDF_BASE_DLOG(INFO) << "WorkerThread Run Terminate";
 }
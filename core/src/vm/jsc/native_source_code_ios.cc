@@ -46,7 +46,7 @@ namespace {
   const uint8_t k_native2js[] = { 40,102,117,110,99,116,105,111,110,40,101,120,112,111,114,116,115,44,32,114,101,113,117,105,114,101,44,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,41,32,123,34,117,115,101,32,115,116,114,105,99,116,34,59,10,10,102,117,110,99,116,105,111,110,32,95,116,111,67,111,110,115,117,109,97,98,108,101,65,114,114,97,121,40,97,114,114,41,32,123,32,114,101,116,117,114,110,32,95,97,114,114,97,121,87,105,116,104,111,117,116,72,111,108,101,115,40,97,114,114,41,32,124,124,32,95,105,116,101,114,97,98,108,101,84,111,65,114,114,97,121,40,97,114,114,41,32,124,124,32,95,117,110,115,117,112,112,111,114,116,101,100,73,116,101,114,97,98,108,101,84,111,65,114,114,97,121,40,97,114,114,41,32,124,124,32,95,110,111,110,73,116,101,114,97,98,108,101,83,112,114,101,97,100,40,41,59,32,125,10,10,102,117,110,99,116,105,111,110,32,95,110,111,110,73,116,101,114,97,98,108,101,83,112,114,101,97,100,40,41,32,123,32,116,104,114,111,119,32,110,101,119,32,84,121,112,101,69,114,114,111,114,40,34,73,110,118,97,108,105,100,32,97,116,116,101,109,112,116,32,116,111,32,115,112,114,101,97,100,32,110,111,110,45,105,116,101,114,97,98,108,101,32,105,110,115,116,97,110,99,101,46,92,110,73,110,32,111,114,100,101,114,32,116,111,32,98,101,32,105,116,101,114,97,98,108,101,44,32,110,111,110,45,97,114,114,97,121,32,111,98,106,101,99,116,115,32,109,117,115,116,32,104,97,118,101,32,97,32,91,83,121,109,98,111,108,46,105,116,101,114,97,116,111,114,93,40,41,32,109,101,116,104,111,100,46,34,41,59,32,125,10,10,102,117,110,99,116,105,111,110,32,95,117,110,115,117,112,112,111,114,116,101,100,73,116,101,114,97,98,108,101,84,111,65,114,114,97,121,40,111,44,32,109,105,110,76,101,110,41,32,123,32,105,102,32,40,33,111,41,32,114,101,116,117,114,110,59,32,105,102,32,40,116,121,112,101,111,102,32,111,32,61,61,61,32,34,115,116,114,105,110,103,34,41,32,114,101,116,117,114,110,32,95,97,114,114,97,121,76,105,107,101,84,111,65,114,114,97,121,40,111,44,32,109,105,110,76,101,110,41,59,32,118,97,114,32,110,32,61,32,79,98,106,101,99,116,46,112,114,111,116,111,116,121,112,101,46,116,111,83,116,114,105,110,103,46,99,97,108,108,40,111,41,46,115,108,105,99,101,40,56,44,32,45,49,41,59,32,105,102,32,40,110,32,61,61,61,32,34,79,98,106,101,99,116,34,32,38,38,32,111,46,99,111,110,115,116,114,117,99,116,111,114,41,32,110,32,61,32,111,46,99,111,110,115,116,114,117,99,116,111,114,46,110,97,109,101,59,32,105,102,32,40,110,32,61,61,61,32,34,77,97,112,34,32,124,124,32,110,32,61,61,61,32,34,83,101,116,34,41,32,114,101,116,117,114,110,32,65,114,114,97,121,46,102,114,111,109,40,111,41,59,32,105,102,32,40,110,32,61,61,61,32,34,65,114,103,117,109,101,110,116,115,34,32,124,124,32,47,94,40,63,58,85,105,124,73,41,110,116,40,63,58,56,124,49,54,124,51,50,41,40,63,58,67,108,97,109,112,101,100,41,63,65,114,114,97,121,36,47,46,116,101,115,116,40,110,41,41,32,114,101,116,117,114,110,32,95,97,114,114,97,121,76,105,107,101,84,111,65,114,114,97,121,40,111,44,32,109,105,110,76,101,110,41,59,32,125,10,10,102,117,110,99,116,105,111,110,32,95,105,116,101,114,97,98,108,101,84,111,65,114,114,97,121,40,105,116,101,114,41,32,123,32,105,102,32,40,116,121,112,101,111,102,32,83,121,109,98,111,108,32,33,61,61,32,34,117,110,100,101,102,105,110,101,100,34,32,38,38,32,105,116,101,114,91,83,121,109,98,111,108,46,105,116,101,114,97,116,111,114,93,32,33,61,32,110,117,108,108,32,124,124,32,105,116,101,114,91,34,64,64,105,116,101,114,97,116,111,114,34,93,32,33,61,32,110,117,108,108,41,32,114,101,116,117,114,110,32,65,114,114,97,121,46,102,114,111,109,40,105,116,101,114,41,59,32,125,10,10,102,117,110,99,116,105,111,110,32,95,97,114,114,97,121,87,105,116,104,111,117,116,72,111,108,101,115,40,97,114,114,41,32,123,32,105,102,32,40,65,114,114,97,121,46,105,115,65,114,114,97,121,40,97,114,114,41,41,32,114,101,116,117,114,110,32,95,97,114,114,97,121,76,105,107,101,84,111,65,114,114,97,121,40,97,114,114,41,59,32,125,10,10,102,117,110,99,116,105,111,110,32,95,97,114,114,97,121,76,105,107,101,84,111,65,114,114,97,121,40,97,114,114,44,32,108,101,110,41,32,123,32,105,102,32,40,108,101,110,32,61,61,32,110,117,108,108,32,124,124,32,108,101,110,32,62,32,97,114,114,46,108,101,110,103,116,104,41,32,108,101,110,32,61,32,97,114,114,46,108,101,110,103,116,104,59,32,102,111,114,32,40,118,97,114,32,105,32,61,32,48,44,32,97,114,114,50,32,61,32,110,101,119,32,65,114,114,97,121,40,108,101,110,41,59,32,105,32,60,32,108,101,110,59,32,105,43,43,41,32,123,32,97,114,114,50,91,105,93,32,61,32,97,114,114,91,105,93,59,32,125,32,114,101,116,117,114,110,32,97,114,114,50,59,32,125,10,10,118,97,114,32,95,114,101,113,117,105,114,101,32,61,32,114,101,113,117,105,114,101,40,39,46,46,47,46,46,47,109,111,100,117,108,101,115,47,105,111,115,47,106,115,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,106,115,39,41,44,10,32,32,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,32,61,32,95,114,101,113,117,105,114,101,46,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,59,10,10,103,108,111,98,97,108,46,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,32,61,32,123,125,59,10,10,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,46,102,108,117,115,104,101,100,81,117,101,117,101,32,61,32,102,117,110,99,116,105,111,110,32,40,41,32,123,10,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,99,97,108,108,73,109,109,101,100,105,97,116,101,115,40,41,59,10,32,32,118,97,114,32,113,117,101,117,101,32,61,32,95,95,71,76,79,66,65,76,95,95,46,95,113,117,101,117,101,59,10,32,32,95,95,71,76,79,66,65,76,95,95,46,95,113,117,101,117,101,32,61,32,91,91,93,44,32,91,93,44,32,91,93,44,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,73,68,93,59,10,32,32,114,101,116,117,114,110,32,113,117,101,117,101,91,48,93,46,108,101,110,103,116,104,32,63,32,113,117,101,117,101,32,58,32,110,117,108,108,59,10,125,59,10,10,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,46,105,110,118,111,107,101,67,97,108,108,98,97,99,107,65,110,100,82,101,116,117,114,110,70,108,117,115,104,101,100,81,117,101,117,101,32,61,32,102,117,110,99,116,105,111,110,32,40,99,98,73,68,44,32,97,114,103,115,41,32,123,10,32,32,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,46,95,95,105,110,118,111,107,101,67,97,108,108,98,97,99,107,40,99,98,73,68,44,32,97,114,103,115,41,59,10,10,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,99,97,108,108,73,109,109,101,100,105,97,116,101,115,40,41,59,10,32,32,114,101,116,117,114,110,32,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,46,102,108,117,115,104,101,100,81,117,101,117,101,40,41,59,10,125,59,10,10,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,46,95,95,105,110,118,111,107,101,67,97,108,108,98,97,99,107,32,61,32,102,117,110,99,116,105,111,110,32,40,99,98,73,68,44,32,97,114,103,115,41,32,123,10,32,32,118,97,114,32,99,97,108,108,98,97,99,107,32,61,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,115,91,99,98,73,68,93,59,10,32,32,105,102,32,40,33,99,97,108,108,98,97,99,107,41,32,114,101,116,117,114,110,59,10,10,32,32,105,102,32,40,33,95,95,71,76,79,66,65,76,95,95,46,95,110,111,116,68,101,108,101,116,101,67,97,108,108,98,97,99,107,73,100,115,91,99,98,73,68,32,38,32,126,49,93,32,38,38,32,33,95,95,71,76,79,66,65,76,95,95,46,95,110,111,116,68,101,108,101,116,101,67,97,108,108,98,97,99,107,73,100,115,91,99,98,73,68,32,124,32,49,93,41,32,123,10,32,32,32,32,100,101,108,101,116,101,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,115,91,99,98,73,68,32,38,32,126,49,93,59,10,32,32,32,32,100,101,108,101,116,101,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,115,91,99,98,73,68,32,124,32,49,93,59,10,32,32,125,10,10,32,32,105,102,32,40,97,114,103,115,32,38,38,32,97,114,103,115,46,108,101,110,103,116,104,32,62,32,49,32,38,38,32,40,97,114,103,115,91,48,93,32,61,61,61,32,110,117,108,108,32,124,124,32,97,114,103,115,91,48,93,32,61,61,61,32,117,110,100,101,102,105,110,101,100,41,41,32,123,10,32,32,32,32,97,114,103,115,46,115,112,108,105,99,101,40,48,44,32,49,41,59,10,32,32,125,10,10,32,32,99,97,108,108,98,97,99,107,46,97,112,112,108,121,40,118,111,105,100,32,48,44,32,95,116,111,67,111,110,115,117,109,97,98,108,101,65,114,114,97,121,40,97,114,103,115,41,41,59,10,125,59,10,10,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,46,99,97,108,108,70,117,110,99,116,105,111,110,82,101,116,117,114,110,70,108,117,115,104,101,100,81,117,101,117,101,32,61,32,102,117,110,99,116,105,111,110,32,40,109,111,100,117,108,101,44,32,109,101,116,104,111,100,44,32,97,114,103,115,41,32,123,10,32,32,105,102,32,40,109,111,100,117,108,101,32,61,61,61,32,39,73,79,83,66,114,105,100,103,101,77,111,100,117,108,101,39,32,124,124,32,109,111,100,117,108,101,32,61,61,61,32,39,65,112,112,82,101,103,105,115,116,114,121,39,41,32,123,10,32,32,32,32,105,102,32,40,109,101,116,104,111,100,32,61,61,61,32,39,108,111,97,100,73,110,115,116,97,110,99,101,39,32,124,124,32,109,101,116,104,111,100,32,61,61,61,32,39,114,117,110,65,112,112,108,105,99,97,116,105,111,110,39,41,32,123,10,32,32,32,32,32,32,118,97,114,32,99,97,108,108,79,98,106,32,61,32,123,10,32,32,32,32,32,32,32,32,110,97,109,101,58,32,97,114,103,115,91,48,93,44,10,32,32,32,32,32,32,32,32,105,100,58,32,97,114,103,115,91,49,93,46,114,111,111,116,84,97,103,44,10,32,32,32,32,32,32,32,32,112,97,114,97,109,115,58,32,97,114,103,115,91,49,93,46,105,110,105,116,105,97,108,80,114,111,112,115,10,32,32,32,32,32,32,125,59,10,10,32,32,32,32,32,32,105,102,32,40,95,95,71,76,79,66,65,76,95,95,46,97,112,112,82,101,103,105,115,116,101,114,91,99,97,108,108,79,98,106,46,110,97,109,101,93,41,32,123,10,32,32,32,32,32,32,32,32,79,98,106,101,99,116,46,97,115,115,105,103,110,40,99,97,108,108,79,98,106,46,112,97,114,97,109,115,44,32,123,10,32,32,32,32,32,32,32,32,32,32,95,95,105,110,115,116,97,110,99,101,78,97,109,101,95,95,58,32,99,97,108,108,79,98,106,46,110,97,109,101,44,10,32,32,32,32,32,32,32,32,32,32,95,95,105,110,115,116,97,110,99,101,73,100,95,95,58,32,99,97,108,108,79,98,106,46,105,100,10,32,32,32,32,32,32,32,32,125,41,59,10,32,32,32,32,32,32,32,32,79,98,106,101,99,116,46,97,115,115,105,103,110,40,95,95,71,76,79,66,65,76,95,95,46,97,112,112,82,101,103,105,115,116,101,114,91,99,97,108,108,79,98,106,46,110,97,109,101,93,44,32,123,10,32,32,32,32,32,32,32,32,32,32,105,100,58,32,99,97,108,108,79,98,106,46,105,100,44,10,32,32,32,32,32,32,32,32,32,32,115,117,112,101,114,80,114,111,112,115,58,32,99,97,108,108,79,98,106,46,112,97,114,97,109,115,10,32,32,32,32,32,32,32,32,125,41,59,10,32,32,32,32,32,32,32,32,118,97,114,32,69,118,101,110,116,77,111,100,117,108,101,32,61,32,95,95,71,76,79,66,65,76,95,95,46,106,115,77,111,100,117,108,101,76,105,115,116,46,69,118,101,110,116,68,105,115,112,97,116,99,104,101,114,59,10,10,32,32,32,32,32,32,32,32,105,102,32,40,69,118,101,110,116,77,111,100,117,108,101,32,38,38,32,116,121,112,101,111,102,32,69,118,101,110,116,77,111,100,117,108,101,46,114,101,99,101,105,118,101,78,97,116,105,118,101,69,118,101,110,116,32,61,61,61,32,39,102,117,110,99,116,105,111,110,39,41,32,123,10,32,32,32,32,32,32,32,32,32,32,118,97,114,32,112,97,114,97,109,115,32,61,32,91,39,64,104,112,58,108,111,97,100,73,110,115,116,97,110,99,101,39,44,32,99,97,108,108,79,98,106,46,112,97,114,97,109,115,93,59,10,32,32,32,32,32,32,32,32,32,32,69,118,101,110,116,77,111,100,117,108,101,46,114,101,99,101,105,118,101,78,97,116,105,118,101,69,118,101,110,116,46,99,97,108,108,40,69,118,101,110,116,77,111,100,117,108,101,44,32,112,97,114,97,109,115,41,59,10,32,32,32,32,32,32,32,32,125,10,10,32,32,32,32,32,32,32,32,95,95,71,76,79,66,65,76,95,95,46,97,112,112,82,101,103,105,115,116,101,114,91,99,97,108,108,79,98,106,46,110,97,109,101,93,46,114,117,110,40,99,97,108,108,79,98,106,46,112,97,114,97,109,115,41,59,10,32,32,32,32,32,32,125,32,101,108,115,101,32,123,10,32,32,32,32,32,32,32,32,116,104,114,111,119,32,69,114,114,111,114,40,34,110,97,116,105,118,101,50,106,115,32,101,114,114,111,114,58,32,110,97,116,105,118,101,32,34,46,99,111,110,99,97,116,40,99,97,108,108,79,98,106,46,110,97,109,101,44,32,34,32,105,115,32,110,111,116,32,114,101,103,105,115,116,101,114,101,100,32,105,110,32,106,115,34,41,41,59,10,32,32,32,32,32,32,125,10,32,32,32,32,125,32,101,108,115,101,32,105,102,32,40,109,101,116,104,111,100,32,61,61,61,32,39,117,110,109,111,117,110,116,65,112,112,108,105,99,97,116,105,111,110,67,111,109,112,111,110,101,110,116,65,116,82,111,111,116,84,97,103,39,41,32,123,10,32,32,32,32,32,32,118,97,114,32,114,111,111,116,86,105,101,119,73,100,32,61,32,97,114,103,115,91,48,93,59,10,32,32,32,32,32,32,103,108,111,98,97,108,46,72,105,112,112,121,46,101,109,105,116,40,39,100,101,115,116,114,111,121,73,110,115,116,97,110,99,101,39,44,32,114,111,111,116,86,105,101,119,73,100,41,59,10,32,32,32,32,32,32,72,105,112,112,121,46,98,114,105,100,103,101,46,99,97,108,108,78,97,116,105,118,101,40,39,85,73,77,97,110,97,103,101,114,77,111,100,117,108,101,39,44,32,39,115,116,97,114,116,66,97,116,99,104,39,41,59,10,32,32,32,32,32,32,72,105,112,112,121,46,98,114,105,100,103,101,46,99,97,108,108,78,97,116,105,118,101,40,39,85,73,77,97,110,97,103,101,114,77,111,100,117,108,101,39,44,32,39,114,101,109,111,118,101,82,111,111,116,86,105,101,119,39,44,32,114,111,111,116,86,105,101,119,73,100,41,59,10,32,32,32,32,32,32,72,105,112,112,121,46,98,114,105,100,103,101,46,99,97,108,108,78,97,116,105,118,101,40,39,85,73,77,97,110,97,103,101,114,77,111,100,117,108,101,39,44,32,39,101,110,100,66,97,116,99,104,39,41,59,10,32,32,32,32,32,32,100,101,108,101,116,101,32,95,95,71,76,79,66,65,76,95,95,46,110,111,100,101,73,100,67,97,99,104,101,91,114,111,111,116,86,105,101,119,73,100,93,59,10,32,32,32,32,32,32,100,101,108,101,116,101,32,95,95,71,76,79,66,65,76,95,95,46,110,111,100,101,84,114,101,101,67,97,99,104,101,91,114,111,111,116,86,105,101,119,73,100,93,59,10,32,32,32,32,32,32,100,101,108,101,116,101,32,95,95,71,76,79,66,65,76,95,95,46,110,111,100,101,80,97,114,97,109,67,97,99,104,101,91,114,111,111,116,86,105,101,119,73,100,93,59,10,32,32,32,32,32,32,95,95,71,76,79,66,65,76,95,95,46,100,101,115,116,114,111,121,73,110,115,116,97,110,99,101,76,105,115,116,91,114,111,111,116,86,105,101,119,73,100,93,32,61,32,116,114,117,101,59,10,32,32,32,32,125,10,32,32,125,32,101,108,115,101,32,105,102,32,40,109,111,100,117,108,101,32,61,61,61,32,39,69,118,101,110,116,68,105,115,112,97,116,99,104,101,114,39,32,124,124,32,109,111,100,117,108,101,32,61,61,61,32,39,68,105,109,101,110,115,105,111,110,115,39,41,32,123,10,32,32,32,32,118,97,114,32,116,97,114,103,101,116,77,111,100,117,108,101,32,61,32,95,95,71,76,79,66,65,76,95,95,46,106,115,77,111,100,117,108,101,76,105,115,116,91,109,111,100,117,108,101,93,59,10,10,32,32,32,32,105,102,32,40,116,97,114,103,101,116,77,111,100,117,108,101,32,38,38,32,116,121,112,101,111,102,32,116,97,114,103,101,116,77,111,100,117,108,101,91,109,101,116,104,111,100,93,32,61,61,61,32,39,102,117,110,99,116,105,111,110,39,41,32,123,10,32,32,32,32,32,32,116,97,114,103,101,116,77,111,100,117,108,101,91,109,101,116,104,111,100,93,46,99,97,108,108,40,116,97,114,103,101,116,77,111,100,117,108,101,44,32,97,114,103,115,91,49,93,46,112,97,114,97,109,115,41,59,10,32,32,32,32,125,10,32,32,125,32,101,108,115,101,32,105,102,32,40,109,111,100,117,108,101,32,61,61,61,32,39,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,39,41,32,123,10,32,32,32,32,105,102,32,40,109,101,116,104,111,100,32,61,61,61,32,39,99,97,108,108,84,105,109,101,114,115,39,41,32,123,10,32,32,32,32,32,32,97,114,103,115,91,48,93,46,102,111,114,69,97,99,104,40,102,117,110,99,116,105,111,110,32,40,116,105,109,101,114,73,100,41,32,123,10,32,32,32,32,32,32,32,32,118,97,114,32,116,105,109,101,114,67,97,108,108,70,117,110,99,32,61,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,99,97,108,108,98,97,99,107,115,91,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,116,105,109,101,114,73,68,115,46,105,110,100,101,120,79,102,40,116,105,109,101,114,73,100,41,93,59,10,10,32,32,32,32,32,32,32,32,105,102,32,40,116,121,112,101,111,102,32,116,105,109,101,114,67,97,108,108,70,117,110,99,32,61,61,61,32,39,102,117,110,99,116,105,111,110,39,41,32,123,10,32,32,32,32,32,32,32,32,32,32,116,114,121,32,123,10,32,32,32,32,32,32,32,32,32,32,32,32,116,105,109,101,114,67,97,108,108,70,117,110,99,40,41,59,10,32,32,32,32,32,32,32,32,32,32,125,32,99,97,116,99,104,32,40,101,41,32,123,10,32,32,32,32,32,32,32,32,32,32,32,32,99,111,110,115,111,108,101,46,114,101,112,111,114,116,85,110,99,97,117,103,104,116,69,120,99,101,112,116,105,111,110,40,101,41,59,10,32,32,32,32,32,32,32,32,32,32,125,10,32,32,32,32,32,32,32,32,125,10,32,32,32,32,32,32,125,41,59,10,32,32,32,32,125,10,32,32,125,10,10,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,99,97,108,108,73,109,109,101,100,105,97,116,101,115,40,41,59,10,32,32,114,101,116,117,114,110,32,95,95,102,98,66,97,116,99,104,101,100,66,114,105,100,103,101,46,102,108,117,115,104,101,100,81,117,101,117,101,40,41,59,10,125,59,125,41,59,0 };  // NOLINT
   const uint8_t k_requestAnimationFrame[] = { 40,102,117,110,99,116,105,111,110,40,101,120,112,111,114,116,115,44,32,114,101,113,117,105,114,101,44,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,41,32,123,34,117,115,101,32,115,116,114,105,99,116,34,59,10,10,118,97,114,32,95,114,101,113,117,105,114,101,32,61,32,114,101,113,117,105,114,101,40,39,46,46,47,46,46,47,109,111,100,117,108,101,115,47,105,111,115,47,106,115,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,106,115,39,41,44,10,32,32,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,32,61,32,95,114,101,113,117,105,114,101,46,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,59,10,10,118,97,114,32,82,67,84,84,105,109,105,110,103,32,61,32,95,95,71,76,79,66,65,76,95,95,46,78,97,116,105,118,101,77,111,100,117,108,101,115,46,84,105,109,105,110,103,59,10,10,103,108,111,98,97,108,46,114,101,113,117,101,115,116,65,110,105,109,97,116,105,111,110,70,114,97,109,101,32,61,32,102,117,110,99,116,105,111,110,32,40,102,117,110,99,41,32,123,10,32,32,118,97,114,32,105,100,32,61,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,71,85,73,68,59,10,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,71,85,73,68,32,43,61,32,49,59,10,32,32,118,97,114,32,102,114,101,101,73,110,100,101,120,32,61,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,116,105,109,101,114,73,68,115,46,105,110,100,101,120,79,102,40,110,117,108,108,41,59,10,10,32,32,105,102,32,40,102,114,101,101,73,110,100,101,120,32,61,61,61,32,45,49,41,32,123,10,32,32,32,32,102,114,101,101,73,110,100,101,120,32,61,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,116,105,109,101,114,73,68,115,46,108,101,110,103,116,104,59,10,32,32,125,10,10,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,116,105,109,101,114,73,68,115,91,102,114,101,101,73,110,100,101,120,93,32,61,32,105,100,59,10,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,99,97,108,108,98,97,99,107,115,91,102,114,101,101,73,110,100,101,120,93,32,61,32,102,117,110,99,59,10,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,116,121,112,101,115,91,102,114,101,101,73,110,100,101,120,93,32,61,32,39,114,101,113,117,101,115,116,65,110,105,109,97,116,105,111,110,70,114,97,109,101,39,59,10,32,32,82,67,84,84,105,109,105,110,103,46,99,114,101,97,116,101,84,105,109,101,114,40,105,100,44,32,49,44,32,68,97,116,101,46,110,111,119,40,41,44,32,102,97,108,115,101,41,59,10,32,32,114,101,116,117,114,110,32,105,100,59,10,125,59,10,10,103,108,111,98,97,108,46,99,97,110,99,101,108,65,110,105,109,97,116,105,111,110,70,114,97,109,101,32,61,32,102,117,110,99,116,105,111,110,32,40,116,105,109,101,114,73,68,41,32,123,10,32,32,105,102,32,40,116,105,109,101,114,73,68,32,61,61,61,32,110,117,108,108,32,124,124,32,116,105,109,101,114,73,68,32,61,61,61,32,117,110,100,101,102,105,110,101,100,41,32,123,10,32,32,32,32,114,101,116,117,114,110,59,10,32,32,125,10,10,32,32,118,97,114,32,105,110,100,101,120,32,61,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,116,105,109,101,114,73,68,115,46,105,110,100,101,120,79,102,40,116,105,109,101,114,73,68,41,59,10,10,32,32,105,102,32,40,105,110,100,101,120,32,33,61,61,32,45,49,41,32,123,10,32,32,32,32,74,83,84,105,109,101,114,115,69,120,101,99,117,116,105,111,110,46,95,99,108,101,97,114,73,110,100,101,120,40,105,110,100,101,120,41,59,10,10,32,32,32,32,82,67,84,84,105,109,105,110,103,46,100,101,108,101,116,101,84,105,109,101,114,40,116,105,109,101,114,73,68,41,59,10,32,32,125,10,125,59,125,41,59,0 };  // NOLINT
   const uint8_t k_Turbo[] = { 40,102,117,110,99,116,105,111,110,40,101,120,112,111,114,116,115,44,32,114,101,113,117,105,114,101,44,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,41,32,123,34,117,115,101,32,115,116,114,105,99,116,34,59,10,10,102,117,110,99,116,105,111,110,32,116,117,114,98,111,80,114,111,109,105,115,101,40,102,117,110,99,41,32,123,10,32,32,114,101,116,117,114,110,32,102,117,110,99,116,105,111,110,32,40,41,32,123,10,32,32,32,32,118,97,114,32,95,116,104,105,115,32,61,32,116,104,105,115,59,10,10,32,32,32,32,102,111,114,32,40,118,97,114,32,95,108,101,110,32,61,32,97,114,103,117,109,101,110,116,115,46,108,101,110,103,116,104,44,32,97,114,103,115,32,61,32,110,101,119,32,65,114,114,97,121,40,95,108,101,110,41,44,32,95,107,101,121,32,61,32,48,59,32,95,107,101,121,32,60,32,95,108,101,110,59,32,95,107,101,121,43,43,41,32,123,10,32,32,32,32,32,32,97,114,103,115,91,95,107,101,121,93,32,61,32,97,114,103,117,109,101,110,116,115,91,95,107,101,121,93,59,10,32,32,32,32,125,10,10,32,32,32,32,114,101,116,117,114,110,32,110,101,119,32,80,114,111,109,105,115,101,40,102,117,110,99,116,105,111,110,32,40,114,101,115,111,108,118,101,44,32,114,101,106,101,99,116,41,32,123,10,32,32,32,32,32,32,118,97,114,32,115,117,99,99,101,115,115,67,97,108,108,98,97,99,107,73,100,32,61,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,73,68,59,10,10,32,32,32,32,32,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,115,91,115,117,99,99,101,115,115,67,97,108,108,98,97,99,107,73,100,93,32,61,32,102,117,110,99,116,105,111,110,32,40,100,97,116,97,41,32,123,10,32,32,32,32,32,32,32,32,114,101,115,111,108,118,101,40,100,97,116,97,41,59,10,32,32,32,32,32,32,125,59,10,10,32,32,32,32,32,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,73,68,32,43,61,32,49,59,10,32,32,32,32,32,32,118,97,114,32,102,97,105,108,67,97,108,108,98,97,99,107,73,100,32,61,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,73,68,59,10,10,32,32,32,32,32,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,115,91,102,97,105,108,67,97,108,108,98,97,99,107,73,100,93,32,61,32,102,117,110,99,116,105,111,110,32,40,101,114,114,111,114,68,97,116,97,41,32,123,10,32,32,32,32,32,32,32,32,114,101,106,101,99,116,40,101,114,114,111,114,68,97,116,97,41,59,10,32,32,32,32,32,32,125,59,10,10,32,32,32,32,32,32,95,95,71,76,79,66,65,76,95,95,46,95,99,97,108,108,98,97,99,107,73,68,32,43,61,32,49,59,10,32,32,32,32,32,32,102,117,110,99,46,97,112,112,108,121,40,95,116,104,105,115,44,32,91,93,46,99,111,110,99,97,116,40,97,114,103,115,44,32,91,115,117,99,99,101,115,115,67,97,108,108,98,97,99,107,73,100,44,32,102,97,105,108,67,97,108,108,98,97,99,107,73,100,93,41,41,59,10,32,32,32,32,125,41,59,10,32,32,125,59,10,125,10,10,72,105,112,112,121,46,116,117,114,98,111,80,114,111,109,105,115,101,32,61,32,116,117,114,98,111,80,114,111,109,105,115,101,59,125,41,59,0 };  // NOLINT
-  const uint8_t k_Performance[] = { 40,102,117,110,99,116,105,111,110,40,101,120,112,111,114,116,115,44,32,114,101,113,117,105,114,101,44,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,41,32,123,34,117,115,101,32,115,116,114,105,99,116,34,59,10,10,102,117,110,99,116,105,111,110,32,95,99,108,97,115,115,67,97,108,108,67,104,101,99,107,40,105,110,115,116,97,110,99,101,44,32,67,111,110,115,116,114,117,99,116,111,114,41,32,123,32,105,102,32,40,33,40,105,110,115,116,97,110,99,101,32,105,110,115,116,97,110,99,101,111,102,32,67,111,110,115,116,114,117,99,116,111,114,41,41,32,123,32,116,104,114,111,119,32,110,101,119,32,84,121,112,101,69,114,114,111,114,40,34,67,97,110,110,111,116,32,99,97,108,108,32,97,32,99,108,97,115,115,32,97,115,32,97,32,102,117,110,99,116,105,111,110,34,41,59,32,125,32,125,10,10,102,117,110,99,116,105,111,110,32,95,100,101,102,105,110,101,80,114,111,112,101,114,116,105,101,115,40,116,97,114,103,101,116,44,32,112,114,111,112,115,41,32,123,32,102,111,114,32,40,118,97,114,32,105,32,61,32,48,59,32,105,32,60,32,112,114,111,112,115,46,108,101,110,103,116,104,59,32,105,43,43,41,32,123,32,118,97,114,32,100,101,115,99,114,105,112,116,111,114,32,61,32,112,114,111,112,115,91,105,93,59,32,100,101,115,99,114,105,112,116,111,114,46,101,110,117,109,101,114,97,98,108,101,32,61,32,100,101,115,99,114,105,112,116,111,114,46,101,110,117,109,101,114,97,98,108,101,32,124,124,32,102,97,108,115,101,59,32,100,101,115,99,114,105,112,116,111,114,46,99,111,110,102,105,103,117,114,97,98,108,101,32,61,32,116,114,117,101,59,32,105,102,32,40,34,118,97,108,117,101,34,32,105,110,32,100,101,115,99,114,105,112,116,111,114,41,32,100,101,115,99,114,105,112,116,111,114,46,119,114,105,116,97,98,108,101,32,61,32,116,114,117,101,59,32,79,98,106,101,99,116,46,100,101,102,105,110,101,80,114,111,112,101,114,116,121,40,116,97,114,103,101,116,44,32,100,101,115,99,114,105,112,116,111,114,46,107,101,121,44,32,100,101,115,99,114,105,112,116,111,114,41,59,32,125,32,125,10,10,102,117,110,99,116,105,111,110,32,95,99,114,101,97,116,101,67,108,97,115,115,40,67,111,110,115,116,114,117,99,116,111,114,44,32,112,114,111,116,111,80,114,111,112,115,44,32,115,116,97,116,105,99,80,114,111,112,115,41,32,123,32,105,102,32,40,112,114,111,116,111,80,114,111,112,115,41,32,95,100,101,102,105,110,101,80,114,111,112,101,114,116,105,101,115,40,67,111,110,115,116,114,117,99,116,111,114,46,112,114,111,116,111,116,121,112,101,44,32,112,114,111,116,111,80,114,111,112,115,41,59,32,105,102,32,40,115,116,97,116,105,99,80,114,111,112,115,41,32,95,100,101,102,105,110,101,80,114,111,112,101,114,116,105,101,115,40,67,111,110,115,116,114,117,99,116,111,114,44,32,115,116,97,116,105,99,80,114,111,112,115,41,59,32,79,98,106,101,99,116,46,100,101,102,105,110,101,80,114,111,112,101,114,116,121,40,67,111,110,115,116,114,117,99,116,111,114,44,32,34,112,114,111,116,111,116,121,112,101,34,44,32,123,32,119,114,105,116,97,98,108,101,58,32,102,97,108,115,101,32,125,41,59,32,114,101,116,117,114,110,32,67,111,110,115,116,114,117,99,116,111,114,59,32,125,10,10,118,97,114,32,77,101,109,111,114,121,77,111,100,117,108,101,32,61,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,40,39,77,101,109,111,114,121,77,111,100,117,108,101,39,41,59,10,118,97,114,32,116,105,109,101,79,114,105,103,105,110,32,61,32,68,97,116,101,46,110,111,119,40,41,59,10,103,108,111,98,97,108,46,112,101,114,102,111,114,109,97,110,99,101,32,61,32,103,108,111,98,97,108,46,112,101,114,102,111,114,109,97,110,99,101,32,124,124,32,110,101,119,32,40,102,117,110,99,116,105,111,110,32,40,41,32,123,10,32,32,102,117,110,99,116,105,111,110,32,80,101,114,102,111,114,109,97,110,99,101,40,41,32,123,10,32,32,32,32,95,99,108,97,115,115,67,97,108,108,67,104,101,99,107,40,116,104,105,115,44,32,80,101,114,102,111,114,109,97,110,99,101,41,59,10,32,32,125,10,10,32,32,95,99,114,101,97,116,101,67,108,97,115,115,40,80,101,114,102,111,114,109,97,110,99,101,44,32,91,123,10,32,32,32,32,107,101,121,58,32,34,116,105,109,101,79,114,105,103,105,110,34,44,10,32,32,32,32,103,101,116,58,32,102,117,110,99,116,105,111,110,32,103,101,116,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,116,105,109,101,79,114,105,103,105,110,59,10,32,32,32,32,125,10,32,32,125,44,32,123,10,32,32,32,32,107,101,121,58,32,34,109,101,109,111,114,121,34,44,10,32,32,32,32,103,101,116,58,32,102,117,110,99,116,105,111,110,32,103,101,116,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,77,101,109,111,114,121,77,111,100,117,108,101,32,63,32,77,101,109,111,114,121,77,111,100,117,108,101,46,71,101,116,40,41,32,58,32,117,110,100,101,102,105,110,101,100,59,10,32,32,32,32,125,10,32,32,125,44,32,123,10,32,32,32,32,107,101,121,58,32,34,110,111,119,34,44,10,32,32,32,32,118,97,108,117,101,58,32,102,117,110,99,116,105,111,110,32,110,111,119,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,68,97,116,101,46,110,111,119,40,41,32,45,32,116,105,109,101,79,114,105,103,105,110,59,10,32,32,32,32,125,10,32,32,125,93,41,59,10,10,32,32,114,101,116,117,114,110,32,80,101,114,102,111,114,109,97,110,99,101,59,10,125,40,41,41,40,41,59,125,41,59,0 };  // NOLINT
+  const uint8_t k_Performance[] = { 40,102,117,110,99,116,105,111,110,40,101,120,112,111,114,116,115,44,32,114,101,113,117,105,114,101,44,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,41,32,123,34,117,115,101,32,115,116,114,105,99,116,34,59,10,10,102,117,110,99,116,105,111,110,32,95,99,108,97,115,115,67,97,108,108,67,104,101,99,107,40,105,110,115,116,97,110,99,101,44,32,67,111,110,115,116,114,117,99,116,111,114,41,32,123,32,105,102,32,40,33,40,105,110,115,116,97,110,99,101,32,105,110,115,116,97,110,99,101,111,102,32,67,111,110,115,116,114,117,99,116,111,114,41,41,32,123,32,116,104,114,111,119,32,110,101,119,32,84,121,112,101,69,114,114,111,114,40,34,67,97,110,110,111,116,32,99,97,108,108,32,97,32,99,108,97,115,115,32,97,115,32,97,32,102,117,110,99,116,105,111,110,34,41,59,32,125,32,125,10,10,102,117,110,99,116,105,111,110,32,95,100,101,102,105,110,101,80,114,111,112,101,114,116,105,101,115,40,116,97,114,103,101,116,44,32,112,114,111,112,115,41,32,123,32,102,111,114,32,40,118,97,114,32,105,32,61,32,48,59,32,105,32,60,32,112,114,111,112,115,46,108,101,110,103,116,104,59,32,105,43,43,41,32,123,32,118,97,114,32,100,101,115,99,114,105,112,116,111,114,32,61,32,112,114,111,112,115,91,105,93,59,32,100,101,115,99,114,105,112,116,111,114,46,101,110,117,109,101,114,97,98,108,101,32,61,32,100,101,115,99,114,105,112,116,111,114,46,101,110,117,109,101,114,97,98,108,101,32,124,124,32,102,97,108,115,101,59,32,100,101,115,99,114,105,112,116,111,114,46,99,111,110,102,105,103,117,114,97,98,108,101,32,61,32,116,114,117,101,59,32,105,102,32,40,34,118,97,108,117,101,34,32,105,110,32,100,101,115,99,114,105,112,116,111,114,41,32,100,101,115,99,114,105,112,116,111,114,46,119,114,105,116,97,98,108,101,32,61,32,116,114,117,101,59,32,79,98,106,101,99,116,46,100,101,102,105,110,101,80,114,111,112,101,114,116,121,40,116,97,114,103,101,116,44,32,100,101,115,99,114,105,112,116,111,114,46,107,101,121,44,32,100,101,115,99,114,105,112,116,111,114,41,59,32,125,32,125,10,10,102,117,110,99,116,105,111,110,32,95,99,114,101,97,116,101,67,108,97,115,115,40,67,111,110,115,116,114,117,99,116,111,114,44,32,112,114,111,116,111,80,114,111,112,115,44,32,115,116,97,116,105,99,80,114,111,112,115,41,32,123,32,105,102,32,40,112,114,111,116,111,80,114,111,112,115,41,32,95,100,101,102,105,110,101,80,114,111,112,101,114,116,105,101,115,40,67,111,110,115,116,114,117,99,116,111,114,46,112,114,111,116,111,116,121,112,101,44,32,112,114,111,116,111,80,114,111,112,115,41,59,32,105,102,32,40,115,116,97,116,105,99,80,114,111,112,115,41,32,95,100,101,102,105,110,101,80,114,111,112,101,114,116,105,101,115,40,67,111,110,115,116,114,117,99,116,111,114,44,32,115,116,97,116,105,99,80,114,111,112,115,41,59,32,79,98,106,101,99,116,46,100,101,102,105,110,101,80,114,111,112,101,114,116,121,40,67,111,110,115,116,114,117,99,116,111,114,44,32,34,112,114,111,116,111,116,121,112,101,34,44,32,123,32,119,114,105,116,97,98,108,101,58,32,102,97,108,115,101,32,125,41,59,32,114,101,116,117,114,110,32,67,111,110,115,116,114,117,99,116,111,114,59,32,125,10,10,118,97,114,32,77,101,109,111,114,121,77,111,100,117,108,101,32,61,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,40,39,77,101,109,111,114,121,77,111,100,117,108,101,39,41,59,10,118,97,114,32,116,105,109,101,79,114,105,103,105,110,32,61,32,68,97,116,101,46,110,111,119,40,41,59,10,103,108,111,98,97,108,46,112,101,114,102,111,114,109,97,110,99,101,32,61,32,103,108,111,98,97,108,46,112,101,114,102,111,114,109,97,110,99,101,32,124,124,32,110,101,119,32,40,102,117,110,99,116,105,111,110,32,40,41,32,123,10,32,32,102,117,110,99,116,105,111,110,32,80,101,114,102,111,114,109,97,110,99,101,40,41,32,123,10,32,32,32,32,95,99,108,97,115,115,67,97,108,108,67,104,101,99,107,40,116,104,105,115,44,32,80,101,114,102,111,114,109,97,110,99,101,41,59,10,32,32,125,10,10,32,32,95,99,114,101,97,116,101,67,108,97,115,115,40,80,101,114,102,111,114,109,97,110,99,101,44,32,91,123,10,32,32,32,32,107,101,121,58,32,34,116,105,109,101,79,114,105,103,105,110,34,44,10,32,32,32,32,103,101,116,58,32,102,117,110,99,116,105,111,110,32,103,101,116,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,116,105,109,101,79,114,105,103,105,110,59,10,32,32,32,32,125,10,32,32,125,44,32,123,10,32,32,32,32,107,101,121,58,32,34,109,101,109,111,114,121,34,44,10,32,32,32,32,103,101,116,58,32,102,117,110,99,116,105,111,110,32,103,101,116,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,77,101,109,111,114,121,77,111,100,117,108,101,32,63,32,77,101,109,111,114,121,77,111,100,117,108,101,46,71,101,116,40,41,32,58,32,117,110,100,101,102,105,110,101,100,59,10,32,32,32,32,125,10,32,32,125,44,32,123,10,32,32,32,32,107,101,121,58,32,34,110,111,119,34,44,10,32,32,32,32,118,97,108,117,101,58,32,102,117,110,99,116,105,111,110,32,110,111,119,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,68,97,116,101,46,110,111,119,40,41,32,45,32,116,105,109,101,79,114,105,103,105,110,59,10,32,32,32,32,125,10,32,32,125,93,41,59,10,10,32,32,114,101,116,117,114,110,32,80,101,114,102,111,114,109,97,110,99,101,59,10,125,40,41,41,40,41,59,10,10,118,97,114,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,77,111,100,117,108,101,32,61,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,40,39,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,77,111,100,117,108,101,39,41,59,10,118,97,114,32,108,111,110,103,84,97,115,107,79,98,115,101,114,118,101,114,115,32,61,32,110,101,119,32,83,101,116,40,41,59,10,10,118,97,114,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,69,110,116,114,121,76,105,115,116,32,61,32,47,42,35,95,95,80,85,82,69,95,95,42,47,102,117,110,99,116,105,111,110,32,40,41,32,123,10,32,32,102,117,110,99,116,105,111,110,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,69,110,116,114,121,76,105,115,116,40,101,110,116,114,105,101,115,41,32,123,10,32,32,32,32,95,99,108,97,115,115,67,97,108,108,67,104,101,99,107,40,116,104,105,115,44,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,69,110,116,114,121,76,105,115,116,41,59,10,10,32,32,32,32,116,104,105,115,46,101,110,116,114,105,101,115,32,61,32,101,110,116,114,105,101,115,59,10,32,32,125,10,10,32,32,95,99,114,101,97,116,101,67,108,97,115,115,40,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,69,110,116,114,121,76,105,115,116,44,32,91,123,10,32,32,32,32,107,101,121,58,32,34,103,101,116,69,110,116,114,105,101,115,34,44,10,32,32,32,32,118,97,108,117,101,58,32,102,117,110,99,116,105,111,110,32,103,101,116,69,110,116,114,105,101,115,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,116,104,105,115,46,101,110,116,114,105,101,115,46,115,108,105,99,101,40,41,59,10,32,32,32,32,125,10,32,32,125,44,32,123,10,32,32,32,32,107,101,121,58,32,34,103,101,116,69,110,116,114,105,101,115,66,121,84,121,112,101,34,44,10,32,32,32,32,118,97,108,117,101,58,32,102,117,110,99,116,105,111,110,32,103,101,116,69,110,116,114,105,101,115,66,121,84,121,112,101,40,116,121,112,101,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,116,104,105,115,46,101,110,116,114,105,101,115,46,102,105,108,116,101,114,40,102,117,110,99,116,105,111,110,32,40,101,110,116,114,121,41,32,123,10,32,32,32,32,32,32,32,32,114,101,116,117,114,110,32,101,110,116,114,121,46,101,110,116,114,121,84,121,112,101,32,61,61,61,32,116,121,112,101,59,10,32,32,32,32,32,32,125,41,59,10,32,32,32,32,125,10,32,32,125,44,32,123,10,32,32,32,32,107,101,121,58,32,34,103,101,116,69,110,116,114,105,101,115,66,121,78,97,109,101,34,44,10,32,32,32,32,118,97,108,117,101,58,32,102,117,110,99,116,105,111,110,32,103,101,116,69,110,116,114,105,101,115,66,121,78,97,109,101,40,110,97,109,101,44,32,116,121,112,101,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,116,104,105,115,46,101,110,116,114,105,101,115,46,102,105,108,116,101,114,40,102,117,110,99,116,105,111,110,32,40,101,110,116,114,121,41,32,123,10,32,32,32,32,32,32,32,32,114,101,116,117,114,110,32,101,110,116,114,121,46,110,97,109,101,32,61,61,61,32,110,97,109,101,32,38,38,32,40,33,116,121,112,101,32,124,124,32,101,110,116,114,121,46,101,110,116,114,121,84,121,112,101,32,61,61,61,32,116,121,112,101,41,59,10,32,32,32,32,32,32,125,41,59,10,32,32,32,32,125,10,32,32,125,93,41,59,10,10,32,32,114,101,116,117,114,110,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,69,110,116,114,121,76,105,115,116,59,10,125,40,41,59,32,47,47,32,115,116,97,114,116,84,105,109,101,32,97,110,100,32,110,111,119,32,97,114,101,32,110,97,116,105,118,101,32,109,111,110,111,116,111,110,105,99,32,109,115,44,32,109,111,118,101,100,32,111,110,116,111,32,116,104,101,32,99,108,111,99,107,32,111,102,32,112,101,114,102,111,114,109,97,110,99,101,46,110,111,119,40,41,10,10,10,118,97,114,32,100,105,115,112,97,116,99,104,76,111,110,103,84,97,115,107,115,32,61,32,102,117,110,99,116,105,111,110,32,100,105,115,112,97,116,99,104,76,111,110,103,84,97,115,107,115,40,101,110,116,114,105,101,115,44,32,110,111,119,41,32,123,10,32,32,118,97,114,32,111,102,102,115,101,116,32,61,32,103,108,111,98,97,108,46,112,101,114,102,111,114,109,97,110,99,101,46,110,111,119,40,41,32,45,32,110,111,119,59,10,32,32,101,110,116,114,105,101,115,46,102,111,114,69,97,99,104,40,102,117,110,99,116,105,111,110,32,40,101,110,116,114,121,41,32,123,10,32,32,32,32,101,110,116,114,121,46,115,116,97,114,116,84,105,109,101,32,43,61,32,111,102,102,115,101,116,59,10,32,32,125,41,59,10,32,32,108,111,110,103,84,97,115,107,79,98,115,101,114,118,101,114,115,46,102,111,114,69,97,99,104,40,102,117,110,99,116,105,111,110,32,40,111,98,115,101,114,118,101,114,41,32,123,10,32,32,32,32,111,98,115,101,114,118,101,114,46,99,97,108,108,98,97,99,107,40,110,101,119,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,69,110,116,114,121,76,105,115,116,40,101,110,116,114,105,101,115,41,44,32,111,98,115,101,114,118,101,114,41,59,10,32,32,125,41,59,10,125,59,10,10,103,108,111,98,97,108,46,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,32,61,32,103,108,111,98,97,108,46,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,32,124,124,32,47,42,35,95,95,80,85,82,69,95,95,42,47,102,117,110,99,116,105,111,110,32,40,41,32,123,10,32,32,102,117,110,99,116,105,111,110,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,40,99,97,108,108,98,97,99,107,41,32,123,10,32,32,32,32,95,99,108,97,115,115,67,97,108,108,67,104,101,99,107,40,116,104,105,115,44,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,41,59,10,10,32,32,32,32,105,102,32,40,116,121,112,101,111,102,32,99,97,108,108,98,97,99,107,32,33,61,61,32,39,102,117,110,99,116,105,111,110,39,41,32,123,10,32,32,32,32,32,32,116,104,114,111,119,32,110,101,119,32,84,121,112,101,69,114,114,111,114,40,39,73,110,118,97,108,105,100,32,97,114,103,117,109,101,110,116,115,39,41,59,10,32,32,32,32,125,10,10,32,32,32,32,116,104,105,115,46,99,97,108,108,98,97,99,107,32,61,32,99,97,108,108,98,97,99,107,59,10,32,32,125,10,10,32,32,95,99,114,101,97,116,101,67,108,97,115,115,40,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,44,32,91,123,10,32,32,32,32,107,101,121,58,32,34,111,98,115,101,114,118,101,34,44,10,32,32,32,32,118,97,108,117,101,58,32,102,117,110,99,116,105,111,110,32,111,98,115,101,114,118,101,40,111,112,116,105,111,110,115,41,32,123,10,32,32,32,32,32,32,118,97,114,32,116,121,112,101,115,32,61,32,111,112,116,105,111,110,115,32,38,38,32,40,111,112,116,105,111,110,115,46,101,110,116,114,121,84,121,112,101,115,32,124,124,32,91,111,112,116,105,111,110,115,46,116,121,112,101,93,41,32,124,124,32,91,93,59,10,10,32,32,32,32,32,32,105,102,32,40,33,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,77,111,100,117,108,101,32,124,124,32,116,121,112,101,115,46,105,110,100,101,120,79,102,40,39,108,111,110,103,116,97,115,107,39,41,32,61,61,61,32,45,49,32,124,124,32,108,111,110,103,84,97,115,107,79,98,115,101,114,118,101,114,115,46,104,97,115,40,116,104,105,115,41,41,32,123,10,32,32,32,32,32,32,32,32,114,101,116,117,114,110,59,10,32,32,32,32,32,32,125,10,10,32,32,32,32,32,32,108,111,110,103,84,97,115,107,79,98,115,101,114,118,101,114,115,46,97,100,100,40,116,104,105,115,41,59,10,10,32,32,32,32,32,32,105,102,32,40,108,111,110,103,84,97,115,107,79,98,115,101,114,118,101,114,115,46,115,105,122,101,32,61,61,61,32,49,41,32,123,10,32,32,32,32,32,32,32,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,77,111,100,117,108,101,46,79,98,115,101,114,118,101,76,111,110,103,84,97,115,107,40,100,105,115,112,97,116,99,104,76,111,110,103,84,97,115,107,115,41,59,10,32,32,32,32,32,32,125,10,32,32,32,32,125,10,32,32,125,44,32,123,10,32,32,32,32,107,101,121,58,32,34,100,105,115,99,111,110,110,101,99,116,34,44,10,32,32,32,32,118,97,108,117,101,58,32,102,117,110,99,116,105,111,110,32,100,105,115,99,111,110,110,101,99,116,40,41,32,123,10,32,32,32,32,32,32,105,102,32,40,108,111,110,103,84,97,115,107,79,98,115,101,114,118,101,114,115,91,34,100,101,108,101,116,101,34,93,40,116,104,105,115,41,32,38,38,32,108,111,110,103,84,97,115,107,79,98,115,101,114,118,101,114,115,46,115,105,122,101,32,61,61,61,32,48,41,32,123,10,32,32,32,32,32,32,32,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,77,111,100,117,108,101,46,68,105,115,99,111,110,110,101,99,116,76,111,110,103,84,97,115,107,40,41,59,10,32,32,32,32,32,32,125,10,32,32,32,32,125,10,32,32,125,93,44,32,91,123,10,32,32,32,32,107,101,121,58,32,34,115,117,112,112,111,114,116,101,100,69,110,116,114,121,84,121,112,101,115,34,44,10,32,32,32,32,103,101,116,58,32,102,117,110,99,116,105,111,110,32,103,101,116,40,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,77,111,100,117,108,101,32,63,32,91,39,108,111,110,103,116,97,115,107,39,93,32,58,32,91,93,59,10,32,32,32,32,125,10,32,32,125,93,41,59,10,10,32,32,114,101,116,117,114,110,32,80,101,114,102,111,114,109,97,110,99,101,79,98,115,101,114,118,101,114,59,10,125,40,41,59,10,118,97,114,32,67,112,117,80,114,111,102,105,108,101,114,77,111,100,117,108,101,32,61,32,105,110,116,101,114,110,97,108,66,105,110,100,105,110,103,40,39,67,112,117,80,114,111,102,105,108,101,114,77,111,100,117,108,101,39,41,59,10,10,105,102,32,40,67,112,117,80,114,111,102,105,108,101,114,77,111,100,117,108,101,41,32,123,10,32,32,72,105,112,112,121,46,99,112,117,80,114,111,102,105,108,101,114,32,61,32,123,10,32,32,32,32,115,116,97,114,116,58,32,102,117,110,99,116,105,111,110,32,115,116,97,114,116,40,111,112,116,105,111,110,115,41,32,123,10,32,32,32,32,32,32,118,97,114,32,95,114,101,102,32,61,32,111,112,116,105,111,110,115,32,124,124,32,123,125,44,10,32,32,32,32,32,32,32,32,32,32,115,97,109,112,108,105,110,103,73,110,116,101,114,118,97,108,32,61,32,95,114,101,102,46,115,97,109,112,108,105,110,103,73,110,116,101,114,118,97,108,44,10,32,32,32,32,32,32,32,32,32,32,109,97,120,68,117,114,97,116,105,111,110,32,61,32,95,114,101,102,46,109,97,120,68,117,114,97,116,105,111,110,59,10,10,32,32,32,32,32,32,114,101,116,117,114,110,32,67,112,117,80,114,111,102,105,108,101,114,77,111,100,117,108,101,46,83,116,97,114,116,40,115,97,109,112,108,105,110,103,73,110,116,101,114,118,97,108,44,32,109,97,120,68,117,114,97,116,105,111,110,41,59,10,32,32,32,32,125,44,10,32,32,32,32,115,116,111,112,58,32,102,117,110,99,116,105,111,110,32,115,116,111,112,40,102,105,108,101,80,97,116,104,44,32,99,97,108,108,98,97,99,107,41,32,123,10,32,32,32,32,32,32,114,101,116,117,114,110,32,67,112,117,80,114,111,102,105,108,101,114,77,111,100,117,108,101,46,83,116,111,112,40,102,105,108,101,80,97,116,104,44,32,99,97,108,108,98,97,99,107,41,59,10,32,32,32,32,125,10,32,32,125,59,10,125,125,41,59,0 };  // NOLINT
 }  // namespace
 
 namespace hippy {
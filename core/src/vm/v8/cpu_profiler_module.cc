@@ -0,0 +1,136 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/vm/v8/cpu_profiler_module.h"
+
+#include "base/logging.h"
+#include "core/scope.h"
+#include "core/task/javascript_task.h"
+
+using unicode_string_view = tdf::base::unicode_string_view;
+using CtxValue = hippy::napi::CtxValue;
+
+GEN_INVOKE_CB(CpuProfilerModule, Start) // NOLINT(cert-err58-cpp)
+GEN_INVOKE_CB(CpuProfilerModule, Stop) // NOLINT(cert-err58-cpp)
+
+void CpuProfilerModule::Start(const hippy::napi::CallbackInfo& info, void* data) {
+  auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
+  auto scope = scope_wrapper->scope.lock();
+  TDF_BASE_CHECK(scope);
+  auto context = scope->GetContext();
+  auto engine = scope->GetEngine().lock();
+  TDF_BASE_CHECK(engine);
+
+  // both arguments are optional
+  int32_t sampling_interval = 0;
+  int32_t max_duration = 0;
+  if (info.Length() > 0 && !context->IsNullOrUndefined(info[0]) &&
+      (!context->GetValueNumber(info[0], &sampling_interval) || sampling_interval < 0)) {
+    info.GetExceptionValue()->Set(context, "The first argument must be non-negative int32.");
+    return;
+  }
+  if (info.Length() > 1 && !context->IsNullOrUndefined(info[1]) &&
+      (!context->GetValueNumber(info[1], &max_duration) || max_duration < 0)) {
+    info.GetExceptionValue()->Set(context, "The second argument must be non-negative int32.");
+    return;
+  }
+  bool is_started = engine->StartCpuProfiling(sampling_interval, static_cast<uint32_t>(max_duration));
+  info.GetReturnValue()->Set(context->CreateBoolean(is_started));
+}
+
+void CpuProfilerModule::Stop(const hippy::napi::CallbackInfo& info, void* data) {
+  auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
+  auto scope = scope_wrapper->scope.lock();
+  TDF_BASE_CHECK(scope);
+  auto context = scope->GetContext();
+  auto engine = scope->GetEngine().lock();
+  TDF_BASE_CHECK(engine);
+
+  unicode_string_view file_path;
+  if (!context->GetValueString(info[0], &file_path)) {
+    info.GetExceptionValue()->Set(context, "The first argument must be string.");
+    return;
+  }
+  std::shared_ptr<CtxValue> function = info[1];
+  if (function && !context->IsFunction(function)) {
+    function = nullptr;
+  }
+
+  Engine::CpuProfileCallback cb;
+  uint32_t callback_id = 0;
+  if (function) {
+    callback_id = ++next_callback_id_;
+    cb_func_map_[callback_id] = function;
+    std::weak_ptr<Scope> weak_scope = scope;
+    std::weak_ptr<JavaScriptTaskRunner> weak_runner = scope->GetTaskRunner();
+    // called on a worker
+    cb = [this, weak_scope, weak_runner, callback_id](bool is_written) {
+      auto runner = weak_runner.lock();
+      if (!runner) {
+        return;
+      }
+      auto task = std::make_shared<JavaScriptTask>();
+      task->origin_ = "CpuProfilerModule";
+      task->callback = [this, weak_scope, callback_id, is_written] {
+        std::shared_ptr<Scope> live_scope = weak_scope.lock();
+        if (!live_scope) {
+          return;
+        }
+        auto it = cb_func_map_.find(callback_id);
+        if (it == cb_func_map_.end()) {
+          return;
+        }
+        std::shared_ptr<CtxValue> cb_function = std::move(it->second);
+        cb_func_map_.erase(it);
+        auto cb_context = live_scope->GetContext();
+        std::shared_ptr<CtxValue> argv[] = {cb_context->CreateBoolean(is_written)};
+        cb_context->CallFunction(cb_function, 1, argv);
+      };
+      runner->PostTask(task);
+    };
+  }
+  bool has_profile = engine->StopCpuProfiling(file_path, std::move(cb));
+  if (!has_profile && callback_id) {
+    cb_func_map_.erase(callback_id);
+  }
+  info.GetReturnValue()->Set(context->CreateBoolean(has_profile));
+}
+
+std::shared_ptr<CtxValue> CpuProfilerModule::BindFunction(std::shared_ptr<Scope> scope,
+                                                          std::shared_ptr<CtxValue>* rest_args) {
+  auto context = scope->GetContext();
+  auto object = context->CreateObject();
+
+  auto key = context->CreateString("Start");
+  auto wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokeCpuProfilerModuleStart, nullptr);
+  auto value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  key = context->CreateString("Stop");
+  wrapper = std::make_unique<hippy::napi::FuncWrapper>(InvokeCpuProfilerModuleStop, nullptr);
+  value = context->CreateFunction(wrapper);
+  scope->SaveFuncWrapper(std::move(wrapper));
+  context->SetProperty(object, key, value);
+
+  return object;
+}
@@ -32,15 +32,10 @@ using unicode_string_view = tdf::base::unicode_string_view;
 using Ctx = hippy::napi::Ctx;
 using V8Ctx = hippy::napi::V8Ctx;
 using CtxValue = hippy::napi::CtxValue;
+using PropertyKeyId = hippy::napi::PropertyKeyId;
 
 GEN_INVOKE_CB(MemoryModule, Get) // NOLINT(cert-err58-cpp)
 
-constexpr char kJsHeapSizeLimit[] = "jsHeapSizeLimit";
-constexpr char kTotalJSHeapSize[] = "totalJSHeapSize";
-constexpr char kUsedJSHeapSize[] = "usedJSHeapSize";
-constexpr char kJsNumberOfNativeContexts[] = "jsNumberOfNativeContexts";
-constexpr char kJsNumberOfDetachedContexts[] = "jsNumberOfDetachedContexts";
-
 void MemoryModule::Get(const hippy::napi::CallbackInfo& info, void* data) {
   auto scope_wrapper = reinterpret_cast<ScopeWrapper*>(std::any_cast<void*>(info.GetSlot()));
   auto scope = scope_wrapper->scope.lock();
@@ -51,33 +46,18 @@ void MemoryModule::Get(const hippy::napi::CallbackInfo& info, void* data) {
   auto heap_statistics = std::make_shared<v8::HeapStatistics>();
   isolate->GetHeapStatistics(heap_statistics.get());
 
-  auto jsHeapSizeLimitValue =
-      ctx->CreateNumber(static_cast<double>(heap_statistics->heap_size_limit()));
-  auto totalJSHeapSizeValue =
-      ctx->CreateNumber(static_cast<double>(heap_statistics->total_heap_size()));
-  auto usedJSHeapSizeValue =
-      ctx->CreateNumber(static_cast<double>(heap_statistics->used_heap_size()));
-  auto jsNumberOfNativeContextsValue =
-      ctx->CreateNumber(static_cast<double>(heap_statistics->number_of_native_contexts()));
-  auto jsNumberOfDetachedContextsValue =
-      ctx->CreateNumber(static_cast<double>(heap_statistics->number_of_detached_contexts()));
-
-  auto jsHeapSizeLimit = ctx->CreateString(kJsHeapSizeLimit);
-  auto totalJSHeapSize = ctx->CreateString(kTotalJSHeapSize);
-  auto usedJSHeapSize = ctx->CreateString(kUsedJSHeapSize);
-  auto jsNumberOfNativeContexts = ctx->CreateString(kJsNumberOfNativeContexts);
-  auto jsNumberOfDetachedContexts = ctx->CreateString(kJsNumberOfDetachedContexts);
-
-  const std::unordered_map<std::shared_ptr<CtxValue>, std::shared_ptr<CtxValue>> map(
-      {
-          {jsHeapSizeLimit, jsHeapSizeLimitValue},
-          {totalJSHeapSize, totalJSHeapSizeValue},
-          {usedJSHeapSize, usedJSHeapSizeValue},
-          {jsNumberOfNativeContexts, jsNumberOfNativeContextsValue},
-          {jsNumberOfDetachedContexts, jsNumberOfDetachedContextsValue}
-      }
-  );
-  info.GetReturnValue()->Set(ctx->CreateObject(map));
+  auto object = ctx->CreateObject();
+  ctx->SetProperty(object, ctx->GetPropertyKey(PropertyKeyId::kJsHeapSizeLimit),
+                   ctx->CreateNumber(static_cast<double>(heap_statistics->heap_size_limit())));
+  ctx->SetProperty(object, ctx->GetPropertyKey(PropertyKeyId::kTotalJSHeapSize),
+                   ctx->CreateNumber(static_cast<double>(heap_statistics->total_heap_size())));
+  ctx->SetProperty(object, ctx->GetPropertyKey(PropertyKeyId::kUsedJSHeapSize),
+                   ctx->CreateNumber(static_cast<double>(heap_statistics->used_heap_size())));
+  ctx->SetProperty(object, ctx->GetPropertyKey(PropertyKeyId::kJsNumberOfNativeContexts),
+                   ctx->CreateNumber(static_cast<double>(heap_statistics->number_of_native_contexts())));
+  ctx->SetProperty(object, ctx->GetPropertyKey(PropertyKeyId::kJsNumberOfDetachedContexts),
+                   ctx->CreateNumber(static_cast<double>(heap_statistics->number_of_detached_contexts())));
+  info.GetReturnValue()->Set(object);
 }
 
 std::shared_ptr<CtxValue> MemoryModule::BindFunction(std::shared_ptr<Scope> scope,
@@ -0,0 +1,123 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/vm/v8/snapshot_builder.h"
+
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include "base/logging.h"
+#include "core/base/file.h"
+#include "core/engine.h"
+#include "core/napi/v8/v8_ctx.h"
+#include "core/napi/v8/v8_try_catch.h"
+#include "core/scope.h"
+#include "core/vm/v8/snapshot_data.h"
+#include "core/vm/v8/v8_vm.h"
+
+namespace hippy {
+namespace vm {
+
+constexpr char kGlobalKey[] = "global";
+constexpr char kNativeGlobalKey[] = "__HIPPYNATIVEGLOBAL__";
+
+SnapshotBuilder::Result SnapshotBuilder::Build(const std::vector<unicode_string_view>& scripts,
+                                               const unicode_string_view& base_path,
+                                               const unicode_string_view& global_config,
+                                               std::vector<uint8_t>& snapshot) {
+  auto time_begin = std::chrono::steady_clock::now();
+  auto vm = std::make_shared<V8SnapshotVM>();
+  auto engine = std::make_shared<Engine>();
+  engine->SyncInit(vm);
+
+  TDF_BASE_LOG(INFO) << "SnapshotBuilder global_config = " << global_config;
+  auto context_cb = [global_config, base_path](void* wrapper) {
+    TDF_BASE_CHECK(wrapper);
+    auto* scope_wrapper = reinterpret_cast<ScopeWrapper*>(wrapper);
+    TDF_BASE_CHECK(scope_wrapper);
+    auto scope = scope_wrapper->scope.lock();
+    TDF_BASE_CHECK(scope);
+    auto ctx = scope->GetContext();
+    auto global_object = ctx->GetGlobalObject();
+    auto user_global_object_key = ctx->CreateString(kGlobalKey);
+    ctx->SetProperty(global_object, user_global_object_key, global_object);
+    auto native_global_key = ctx->CreateString(kNativeGlobalKey);
+    auto global_config_object = VM::ParseJson(ctx, global_config);
+    ctx->SetProperty(global_object, native_global_key, global_config_object);
+    auto key = ctx->GetPropertyKey(hippy::napi::PropertyKeyId::kCurDir);
+    auto value = ctx->CreateString(base_path);
+    ctx->SetProperty(global_object, key, value);
+  };
+  auto scope_cb_map = std::make_unique<hippy::base::RegisterMap>();
+  scope_cb_map->insert({hippy::base::kContextCreatedCBKey, context_cb});
+  auto scope = engine->SyncCreateScope(std::move(scope_cb_map));
+  auto v8_ctx = std::static_pointer_cast<hippy::napi::V8Ctx>(scope->GetContext());
+  for (const auto& script : scripts) {
+    hippy::napi::V8TryCatch try_catch(true, v8_ctx);
+    v8_ctx->RunScript(script, "");
+    if (try_catch.HasCaught()) {
+      TDF_BASE_LOG(ERROR) << "RunScript error, error = " << try_catch.GetExceptionMsg();
+      return Result::kRunScriptError;
+    }
+  }
+  auto creator = vm->snapshot_creator_;
+  v8_ctx->SetDefaultContext(creator);
+  TDF_BASE_LOG(INFO) << "CreateBlob";
+  v8_ctx = nullptr;
+  scope = nullptr;
+  auto blob = creator->CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+#if (V8_MAJOR_VERSION >= 9)
+  if (!blob.IsValid()) {
+    return Result::kSnapshotBlobInvalid;
+  }
+#endif
+  SnapshotData snapshot_data;
+  snapshot_data.WriteMetaData(blob);
+  snapshot = std::move(snapshot_data.buffer_holder);
+  auto cost = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - time_begin).count();
+  TDF_BASE_LOG(INFO) << "blob size = " << blob.raw_size << ", buffer size = " << snapshot.size()
+                     << ", cost = " << cost;
+  // the blob is allocated by v8 for the caller, snapshot holds a copy
+  delete[] blob.data;
+  return Result::kSuccess;
+}
+
+SnapshotBuilder::Result SnapshotBuilder::BuildToFile(const std::vector<unicode_string_view>& scripts,
+                                                     const unicode_string_view& base_path,
+                                                     const unicode_string_view& global_config,
+                                                     const unicode_string_view& snapshot_path) {
+  std::vector<uint8_t> snapshot;
+  auto result = Build(scripts, base_path, global_config, snapshot);
+  if (result != Result::kSuccess) {
+    return result;
+  }
+  bool save_file_ret = hippy::base::HippyFile::SaveFile(snapshot_path, snapshot);
+  if (!save_file_ret) {
+    return Result::kSaveSnapshotFailed;
+  }
+  return Result::kSuccess;
+}
+
+}  // namespace vm
+}  // namespace hippy
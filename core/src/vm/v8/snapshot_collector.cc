@@ -0,0 +1,62 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/vm/v8/snapshot_collector.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+
+namespace hippy {
+namespace vm {
+
+// function local so that registering does not depend on initialization order
+static std::vector<std::pair<std::string, intptr_t>>& GetRegistry() {
+  static std::vector<std::pair<std::string, intptr_t>> registry;
+  return registry;
+}
+
+void RegisterExternalReference(const char* name, intptr_t address) {
+  GetRegistry().emplace_back(name, address);
+}
+
+const intptr_t* GetExternalReferences() {
+  static std::vector<intptr_t> external_references;
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    auto registry = GetRegistry();
+    std::sort(registry.begin(), registry.end());
+    for (const auto& entry : registry) {
+      external_references.push_back(entry.second);
+    }
+    external_references.push_back(0);
+    TDF_BASE_LOG(INFO) << "external_references.size = " << registry.size();
+  });
+  return external_references.data();
+}
+
+}  // namespace vm
+}  // namespace hippy
@@ -22,9 +22,31 @@
 
 #include "core/vm/v8/snapshot_data.h"
 
+#include <sys/stat.h>
+
+#include <mutex>
+#include <unordered_map>
+
+#include "base/logging.h"
 #include "core/vm/v8/snapshot_deserializer.h"
 #include "core/vm/v8/snapshot_serializer.h"
 #include "core/base/common.h"
+#include "core/base/string_view_utils.h"
+
+namespace {
+
+// engines started from the same snapshot file share its pages
+struct MappingEntry {
+  ino_t inode;
+  off_t size;
+  time_t modify_time;
+  std::weak_ptr<hippy::base::SourceBuffer> mapping;
+};
+
+std::mutex mapping_mutex;
+std::unordered_map<std::string, MappingEntry> mappings;
+
+}  // namespace
 
 void SnapshotData::WriteMetaData(v8::StartupData data) {
   startup_data = data;
@@ -37,32 +59,10 @@ void SnapshotData::WriteMetaData(v8::StartupData data) {
 }
 
 bool SnapshotData::ReadMetadata() {
-  SnapshotDeserializer deserializer(buffer_holder);
-  auto flag = deserializer.ReadUInt32(magic_number);
-  if (!flag) {
-    return false;
-  }
-  if (kMagicNumber != magic_number) {
-    return false;
-  }
-  flag = deserializer.ReadString(sdk_version);
-  if (!flag) {
-    return false;
-  }
-  if (kSdkVersion != sdk_version) {
-    return false;
-  }
-  uint32_t length;
-  flag = deserializer.ReadUInt32(length);
-  if (!flag) {
-    return false;
-  }
-  startup_data.raw_size = hippy::base::checked_numeric_cast<uint32_t, int>(length);
-  startup_data.data = reinterpret_cast<const char*>(&buffer_holder[0] + deserializer.GetPosition());
-  return true;
+  return ReadMetaData(buffer_holder.data(), buffer_holder.size());
 }
 
-bool SnapshotData::ReadMetaData(uint8_t* external_buffer_pointer, size_t length) {
+bool SnapshotData::ReadMetaData(const uint8_t* external_buffer_pointer, size_t length) {
   SnapshotDeserializer deserializer(external_buffer_pointer, length);
   auto flag = deserializer.ReadUInt32(magic_number);
   if (!flag) {
@@ -83,7 +83,36 @@ bool SnapshotData::ReadMetaData(uint8_t* external_buffer_pointer, size_t length)
   if (!flag) {
     return false;
   }
+  // a truncated file must not let v8 read past the buffer
+  if (startup_data_length > length - deserializer.GetPosition()) {
+    return false;
+  }
   startup_data.raw_size = hippy::base::checked_numeric_cast<uint32_t, int>(startup_data_length);
   startup_data.data = reinterpret_cast<const char*>(external_buffer_pointer + deserializer.GetPosition());
   return true;
 }
+
+bool SnapshotData::MapFile(const tdf::base::unicode_string_view& file_path) {
+  std::string path = hippy::base::StringViewUtils::ToU8StdStr(file_path);
+  struct stat st{};
+  if (stat(path.c_str(), &st) != 0) {
+    TDF_BASE_LOG(ERROR) << "snapshot stat failed, path = " << path;
+    return false;
+  }
+  std::shared_ptr<hippy::base::SourceBuffer> mapping;
+  {
+    std::lock_guard<std::mutex> lock(mapping_mutex);
+    auto& entry = mappings[path];
+    mapping = entry.mapping.lock();
+    if (!mapping || entry.inode != st.st_ino || entry.size != st.st_size ||
+        entry.modify_time != st.st_mtime) {
+      mapping = hippy::base::SourceBuffer::FromFile(file_path);
+      entry = MappingEntry{st.st_ino, st.st_size, st.st_mtime, mapping};
+    }
+  }
+  if (!mapping) {
+    return false;
+  }
+  mapping_holder = mapping;
+  return ReadMetaData(mapping->data(), mapping->size());
+}
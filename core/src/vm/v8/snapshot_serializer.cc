@@ -37,8 +37,9 @@ void SnapshotSerializer::WriteString(const std::string& value) {
 }
 
 void SnapshotSerializer::WriteBuffer(const void* p, size_t length) {
-  if (buffer_.capacity() <= buffer_.size() + length) {
-    buffer_.resize(buffer_.size() + length);
+  // capacity left over by an earlier resize is not part of the buffer
+  if (buffer_.size() < position_ + length) {
+    buffer_.resize(position_ + length);
   }
 
   std::copy_n(reinterpret_cast<const uint8_t*>(p), length, &buffer_[0] + position_);
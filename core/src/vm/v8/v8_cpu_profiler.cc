@@ -0,0 +1,175 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/vm/v8/v8_cpu_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "base/logging.h"
+
+namespace hippy {
+namespace vm {
+
+namespace {
+
+constexpr char kProfileTitle[] = "hippy";
+
+void AppendJsonString(const char* str, std::string* json) {
+  json->push_back('"');
+  for (const char* p = str; p && *p; ++p) {
+    auto c = static_cast<unsigned char>(*p);
+    if (c == '"' || c == '\\') {
+      json->push_back('\\');
+      json->push_back(*p);
+    } else if (c < 0x20) {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      json->append(escaped);
+    } else {
+      json->push_back(*p);
+    }
+  }
+  json->push_back('"');
+}
+
+// line and column numbers of devtools start from 0, those of v8 from 1
+void AppendProfileNode(const v8::CpuProfileNode* node, std::string* json) {
+  json->append("{\"id\":" + std::to_string(node->GetNodeId()) + ",\"callFrame\":{\"functionName\":");
+  AppendJsonString(node->GetFunctionNameStr(), json);
+  json->append(",\"scriptId\":\"" + std::to_string(node->GetScriptId()) + "\",\"url\":");
+  AppendJsonString(node->GetScriptResourceNameStr(), json);
+  json->append(",\"lineNumber\":" + std::to_string(node->GetLineNumber() - 1) +
+               ",\"columnNumber\":" + std::to_string(node->GetColumnNumber() - 1) +
+               "},\"hitCount\":" + std::to_string(node->GetHitCount()) + ",\"children\":[");
+  int count = node->GetChildrenCount();
+  for (int i = 0; i < count; ++i) {
+    if (i > 0) {
+      json->push_back(',');
+    }
+    json->append(std::to_string(node->GetChild(i)->GetNodeId()));
+  }
+  json->append("]}");
+}
+
+void SerializeProfile(const v8::CpuProfile* profile, std::string* json) {
+  json->append("{\"nodes\":[");
+  // the tree is as deep as the deepest js stack, so it is walked without recursion
+  std::vector<const v8::CpuProfileNode*> nodes = {profile->GetTopDownRoot()};
+  bool is_first = true;
+  while (!nodes.empty()) {
+    const v8::CpuProfileNode* node = nodes.back();
+    nodes.pop_back();
+    if (!is_first) {
+      json->push_back(',');
+    }
+    is_first = false;
+    AppendProfileNode(node, json);
+    for (int i = node->GetChildrenCount() - 1; i >= 0; --i) {
+      nodes.push_back(node->GetChild(i));
+    }
+  }
+  json->append("],\"startTime\":" + std::to_string(profile->GetStartTime()) +
+               ",\"endTime\":" + std::to_string(profile->GetEndTime()) + ",\"samples\":[");
+  int count = profile->GetSamplesCount();
+  for (int i = 0; i < count; ++i) {
+    if (i > 0) {
+      json->push_back(',');
+    }
+    json->append(std::to_string(profile->GetSample(i)->GetNodeId()));
+  }
+  json->append("],\"timeDeltas\":[");
+  int64_t last_time = profile->GetStartTime();
+  for (int i = 0; i < count; ++i) {
+    if (i > 0) {
+      json->push_back(',');
+    }
+    int64_t time = profile->GetSampleTimestamp(i);
+    json->append(std::to_string(time - last_time));
+    last_time = time;
+  }
+  json->append("]}");
+}
+
+}  // namespace
+
+V8CpuProfiler::V8CpuProfiler(v8::Isolate* isolate) : isolate_(isolate), profiler_(nullptr) {}
+
+V8CpuProfiler::~V8CpuProfiler() {
+  if (profiler_) {
+    profiler_->Dispose();
+  }
+}
+
+bool V8CpuProfiler::Start(int sampling_interval_us, uint32_t max_duration_ms) {
+  if (profiler_) {
+    TDF_BASE_DLOG(WARNING) << "V8CpuProfiler has been started";
+    return false;
+  }
+  if (sampling_interval_us <= 0) {
+    sampling_interval_us = kDefaultSamplingInterval;
+  }
+  unsigned max_samples = v8::CpuProfilingOptions::kNoSampleLimit;
+  if (max_duration_ms > 0) {
+    uint64_t samples = static_cast<uint64_t>(max_duration_ms) * 1000 / static_cast<uint64_t>(sampling_interval_us);
+    max_samples = static_cast<unsigned>(
+        std::min<uint64_t>(std::max<uint64_t>(samples, 1), std::numeric_limits<unsigned>::max() - 1));
+  }
+  v8::HandleScope handle_scope(isolate_);
+  profiler_ = v8::CpuProfiler::New(isolate_);
+  profiler_->SetSamplingInterval(sampling_interval_us);
+  v8::CpuProfilingOptions options(v8::kLeafNodeLineNumbers, max_samples);
+  auto title = v8::String::NewFromUtf8(isolate_, kProfileTitle).ToLocalChecked();
+  if (profiler_->StartProfiling(title, std::move(options)) != v8::CpuProfilingStatus::kStarted) {
+    TDF_BASE_DLOG(WARNING) << "V8CpuProfiler start fail";
+    profiler_->Dispose();
+    profiler_ = nullptr;
+    return false;
+  }
+  TDF_BASE_DLOG(INFO) << "V8CpuProfiler start, sampling_interval_us = " << sampling_interval_us
+                      << ", max_samples = " << max_samples;
+  return true;
+}
+
+bool V8CpuProfiler::Stop(std::string* profile) {
+  if (!profiler_) {
+    return false;
+  }
+  v8::HandleScope handle_scope(isolate_);
+  auto title = v8::String::NewFromUtf8(isolate_, kProfileTitle).ToLocalChecked();
+  v8::CpuProfile* cpu_profile = profiler_->StopProfiling(title);
+  bool is_stopped = cpu_profile != nullptr;
+  if (cpu_profile) {
+    profile->clear();
+    SerializeProfile(cpu_profile, profile);
+    cpu_profile->Delete();
+  }
+  profiler_->Dispose();
+  profiler_ = nullptr;
+  TDF_BASE_DLOG(INFO) << "V8CpuProfiler stop, is_stopped = " << is_stopped;
+  return is_stopped;
+}
+
+}  // namespace vm
+}  // namespace hippy
@@ -0,0 +1,216 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/vm/v8/v8_heap_profiler.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "base/logging.h"
+
+namespace hippy {
+namespace vm {
+
+namespace {
+
+bool WriteFully(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t ret = write(fd, data, size);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      TDF_BASE_DLOG(WARNING) << "V8HeapProfiler write fail, errno = " << errno;
+      return false;
+    }
+    data += ret;
+    size -= static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+#ifndef V8_X5_LITE
+// v8 serializes into chunks of GetChunkSize itself, so they go straight to fd
+class HeapSnapshotStream : public v8::OutputStream {
+ public:
+  explicit HeapSnapshotStream(int fd) : fd_(fd), is_finished_(false), is_failed_(false) {}
+
+  void EndOfStream() override { is_finished_ = true; }
+  int GetChunkSize() override { return V8HeapProfiler::kChunkSize; }
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    if (!WriteFully(fd_, data, static_cast<size_t>(size))) {
+      is_failed_ = true;
+      return kAbort;
+    }
+    return kContinue;
+  }
+
+  inline bool IsWritten() { return is_finished_ && !is_failed_; }
+
+ private:
+  int fd_;
+  bool is_finished_;
+  bool is_failed_;
+};
+#endif
+
+class ChunkWriter {
+ public:
+  explicit ChunkWriter(int fd)
+      : fd_(fd), buffer_(std::make_unique<char[]>(kSize)), length_(0), is_failed_(false) {}
+
+  void Write(const char* data, size_t size) {
+    while (!is_failed_ && size > 0) {
+      size_t count = std::min(size, kSize - length_);
+      memcpy(buffer_.get() + length_, data, count);
+      length_ += count;
+      data += count;
+      size -= count;
+      if (length_ == kSize) {
+        Flush();
+      }
+    }
+  }
+
+  void Write(const std::string& str) { Write(str.c_str(), str.length()); }
+
+  // writes str as a json string
+  void Write(v8::Isolate* isolate, v8::Local<v8::String> str) {
+    Write("\"", 1);
+    if (!str.IsEmpty()) {
+      v8::String::Utf8Value utf8(isolate, str);
+      const char* chars = *utf8;
+      for (int i = 0; chars && i < utf8.length(); ++i) {
+        auto c = static_cast<unsigned char>(chars[i]);
+        if (c == '"' || c == '\\') {
+          char escaped[] = {'\\', static_cast<char>(c)};
+          Write(escaped, sizeof(escaped));
+        } else if (c < 0x20) {
+          char escaped[7];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          Write(escaped, 6);
+        } else {
+          Write(&chars[i], 1);
+        }
+      }
+    }
+    Write("\"", 1);
+  }
+
+  bool Flush() {
+    if (!is_failed_ && length_ > 0) {
+      is_failed_ = !WriteFully(fd_, buffer_.get(), length_);
+      length_ = 0;
+    }
+    return !is_failed_;
+  }
+
+ private:
+  static constexpr size_t kSize = static_cast<size_t>(V8HeapProfiler::kChunkSize);
+
+  int fd_;
+  std::unique_ptr<char[]> buffer_;
+  size_t length_;
+  bool is_failed_;
+};
+
+// line and column numbers of devtools start from 0, those of v8 from 1
+void WriteAllocationNode(v8::Isolate* isolate, const v8::AllocationProfile::Node* node, ChunkWriter* writer) {
+  size_t self_size = 0;
+  for (const auto& allocation : node->allocations) {
+    self_size += allocation.size * allocation.count;
+  }
+  writer->Write("{\"callFrame\":{\"functionName\":");
+  writer->Write(isolate, node->name);
+  writer->Write(",\"scriptId\":\"" + std::to_string(node->script_id) + "\",\"url\":");
+  writer->Write(isolate, node->script_name);
+  writer->Write(",\"lineNumber\":" + std::to_string(node->line_number - 1) +
+                ",\"columnNumber\":" + std::to_string(node->column_number - 1) +
+                "},\"selfSize\":" + std::to_string(self_size) +
+                ",\"id\":" + std::to_string(node->node_id) + ",\"children\":[");
+  for (size_t i = 0; i < node->children.size(); ++i) {
+    if (i > 0) {
+      writer->Write(",", 1);
+    }
+    WriteAllocationNode(isolate, node->children[i], writer);
+  }
+  writer->Write("]}");
+}
+
+}  // namespace
+
+bool V8HeapProfiler::WriteHeapSnapshot(v8::Isolate* isolate, int fd) {
+#ifndef V8_X5_LITE
+  v8::HandleScope handle_scope(isolate);
+  HeapSnapshotStream stream(fd);
+  auto heap_snapshot = isolate->GetHeapProfiler()->TakeHeapSnapshot();
+  if (!heap_snapshot) {
+    TDF_BASE_DLOG(WARNING) << "WriteHeapSnapshot take snapshot fail";
+    return false;
+  }
+  heap_snapshot->Serialize(&stream);
+  const_cast<v8::HeapSnapshot*>(heap_snapshot)->Delete();
+  return stream.IsWritten();
+#else
+  TDF_BASE_DLOG(WARNING) << "X5 lite has no heap snapshot";
+  return false;
+#endif
+}
+
+bool V8HeapProfiler::StartSamplingHeapProfiler(v8::Isolate* isolate, uint64_t sample_interval, int stack_depth) {
+  return isolate->GetHeapProfiler()->StartSamplingHeapProfiler(sample_interval, stack_depth);
+}
+
+bool V8HeapProfiler::WriteSamplingHeapProfile(v8::Isolate* isolate, int fd) {
+  v8::HandleScope handle_scope(isolate);
+  std::unique_ptr<v8::AllocationProfile> profile(isolate->GetHeapProfiler()->GetAllocationProfile());
+  if (!profile) {
+    TDF_BASE_DLOG(WARNING) << "WriteSamplingHeapProfile sampling heap profiler is not running";
+    return false;
+  }
+  ChunkWriter writer(fd);
+  writer.Write("{\"head\":");
+  WriteAllocationNode(isolate, profile->GetRootNode(), &writer);
+  writer.Write(",\"samples\":[");
+  const auto& samples = profile->GetSamples();
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const auto& sample = samples[i];
+    writer.Write((i > 0 ? ",{\"size\":" : "{\"size\":") + std::to_string(sample.size * sample.count) +
+                 ",\"nodeId\":" + std::to_string(sample.node_id) +
+                 ",\"ordinal\":" + std::to_string(sample.sample_id) + "}");
+  }
+  writer.Write("]}");
+  return writer.Flush();
+}
+
+void V8HeapProfiler::StopSamplingHeapProfiler(v8::Isolate* isolate) {
+  isolate->GetHeapProfiler()->StopSamplingHeapProfiler();
+}
+
+}  // namespace vm
+}  // namespace hippy
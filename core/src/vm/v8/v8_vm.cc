@@ -93,7 +93,7 @@ V8VM::V8VM(const std::shared_ptr<V8VMInitParam>& param): VM(param) {
       TDF_BASE_LOG(INFO) << "kUseSnapshot";
       snapshot_data_ = std::move(param->snapshot_data);
       create_params_.snapshot_blob = &snapshot_data_.startup_data;
-      create_params_.external_references = external_references.data();
+      create_params_.external_references = GetExternalReferences();
       isolate_ = v8::Isolate::New(create_params_);
       isolate_->Enter();
       if (param && param->near_heap_limit_callback) {
@@ -105,18 +105,37 @@ V8VM::V8VM(const std::shared_ptr<V8VMInitParam>& param): VM(param) {
     default:
       TDF_BASE_UNREACHABLE();
   }
+  property_keys_ = std::make_shared<hippy::napi::V8PropertyKeys>(isolate_);
 
   TDF_BASE_DLOG(INFO) << "V8VM end";
 }
 
 V8VM::~V8VM() {
   TDF_BASE_LOG(INFO) << "~V8VM";
+  // the profiler and global handles must be disposed before their isolate
+  cpu_profiler_ = nullptr;
+  property_keys_->Reset();
   isolate_->Exit();
   isolate_->Dispose();
 
   delete create_params_.array_buffer_allocator;
 }
 
+bool V8VM::StartCpuProfiling(int sampling_interval_us, uint32_t max_duration_ms) {
+  if (!cpu_profiler_) {
+    cpu_profiler_ = std::make_unique<V8CpuProfiler>(isolate_);
+  }
+  return cpu_profiler_->Start(sampling_interval_us, max_duration_ms);
+}
+
+bool V8VM::StopCpuProfiling(std::string* profile) {
+  return cpu_profiler_ && cpu_profiler_->Stop(profile);
+}
+
+bool V8VM::IsCpuProfiling() {
+  return cpu_profiler_ && cpu_profiler_->IsProfiling();
+}
+
 void V8VM::PlatformDestroy() {
   platform = nullptr;
 
@@ -132,15 +151,14 @@ void V8VM::PlatformDestroy() {
 
 std::shared_ptr<Ctx> V8VM::CreateContext() {
   TDF_BASE_DLOG(INFO) << "CreateContext";
-  return std::make_shared<V8Ctx>(isolate_);
+  return std::make_shared<V8Ctx>(isolate_, property_keys_);
 }
 
 V8SnapshotVM::V8SnapshotVM() : VM(nullptr) {
   InitializePlatform();
 
   create_params_.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
-  TDF_BASE_LOG(INFO) << "external_references.size = " << external_references.size();
-  snapshot_creator_ = std::make_shared<v8::SnapshotCreator>(external_references.data());
+  snapshot_creator_ = std::make_shared<v8::SnapshotCreator>(GetExternalReferences());
   isolate_ = snapshot_creator_->GetIsolate();
 
   TDF_BASE_DLOG(INFO) << "V8SnapshotVM end";
@@ -172,7 +190,9 @@ unicode_string_view V8VM::ToStringView(v8::Isolate* isolate, v8::Local<v8::Strin
   return unicode_string_view(two_byte_string);
 }
 
-v8::Local<v8::String> V8VM::CreateV8String(v8::Isolate* isolate, const unicode_string_view& str_view) {
+v8::Local<v8::String> V8VM::CreateV8String(v8::Isolate* isolate,
+                                           const unicode_string_view& str_view,
+                                           v8::NewStringType type) {
   unicode_string_view::Encoding encoding = str_view.encoding();
   switch (encoding) {
     case unicode_string_view::Encoding::Latin1: {
@@ -180,14 +200,14 @@ v8::Local<v8::String> V8VM::CreateV8String(v8::Isolate* isolate, const unicode_s
       return v8::String::NewFromOneByte(
           isolate,
           reinterpret_cast<const uint8_t*>(one_byte_str.c_str()),
-          v8::NewStringType::kNormal)
+          type)
           .ToLocalChecked();
     }
     case unicode_string_view::Encoding::Utf8: {
       const unicode_string_view::u8string& utf8_str = str_view.utf8_value();
       return v8::String::NewFromUtf8(
           isolate, reinterpret_cast<const char*>(utf8_str.c_str()),
-          v8::NewStringType::kNormal)
+          type)
           .ToLocalChecked();
     }
     case unicode_string_view::Encoding::Utf16: {
@@ -195,7 +215,7 @@ v8::Local<v8::String> V8VM::CreateV8String(v8::Isolate* isolate, const unicode_s
       return v8::String::NewFromTwoByte(
           isolate,
           reinterpret_cast<const uint16_t*>(two_byte_str.c_str()),
-          v8::NewStringType::kNormal)
+          type)
           .ToLocalChecked();
     }
     default:
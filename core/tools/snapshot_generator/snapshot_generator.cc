@@ -0,0 +1,158 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Makes a startup snapshot at build time, so that every install starts from
+// one instead of waiting for it to be created on the device:
+//
+//   hippy_snapshot_generator -o snapshot.bin [-c global_config.json]
+//                            [-b base_path] [script.js ...]
+//
+// bootstrap.js and the native modules are always in the snapshot, the
+// scripts run after them in order. The written blob is loaded back through
+// V8VMInitParam::V8VMSnapshotType::kUseSnapshot before the generator exits 0.
+// A blob only loads into the v8 build, target architecture and sdk version
+// it was made with, so the generator has to link the v8 of the app and be
+// built with its VERSION_NAME.
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/unicode_string_view.h"
+#include "core/base/common.h"
+#include "core/base/file.h"
+#include "core/engine.h"
+#include "core/scope.h"
+#include "core/vm/v8/snapshot_builder.h"
+#include "core/vm/v8/v8_vm.h"
+
+using unicode_string_view = tdf::base::unicode_string_view;
+using u8string = unicode_string_view::u8string;
+using char8_t_ = unicode_string_view::char8_t_;
+using HippyFile = hippy::base::HippyFile;
+using SnapshotBuilder = hippy::vm::SnapshotBuilder;
+using V8VM = hippy::vm::V8VM;
+using V8VMInitParam = hippy::vm::V8VMInitParam;
+
+constexpr char kDefaultGlobalConfig[] = "{\"Platform\":{\"OS\":\"android\"}}";
+
+static unicode_string_view ToStrView(const char* str) {
+  return unicode_string_view(reinterpret_cast<const char8_t_*>(str));
+}
+
+static bool ReadText(const char* path, u8string& content) {
+  if (!HippyFile::ReadFile(ToStrView(path), content, false)) {
+    fprintf(stderr, "can not read %s\n", path);
+    return false;
+  }
+  return true;
+}
+
+static void PrintUsage(const char* name) {
+  fprintf(stderr, "usage: %s -o snapshot.bin [-c global_config.json] [-b base_path] [script.js ...]\n",
+          name);
+}
+
+// boots a vm from the blob the same way an instance with a snapshot does
+static bool VerifySnapshot(std::vector<uint8_t> snapshot) {
+  auto param = std::make_shared<V8VMInitParam>();
+  param->type = V8VMInitParam::V8VMSnapshotType::kUseSnapshot;
+  param->snapshot_data.buffer_holder = std::move(snapshot);
+  if (!param->snapshot_data.ReadMetadata()) {
+    fprintf(stderr, "snapshot header invalid\n");
+    return false;
+  }
+  auto engine = std::make_shared<Engine>();
+  engine->SyncInit(std::make_shared<V8VM>(param));
+  auto scope = engine->SyncCreateScope("", {{hippy::base::kUseSnapshot, "1"}});
+  auto ctx = scope->GetContext();
+  auto type = ctx->RunScript("typeof Hippy", "verify_snapshot");
+  unicode_string_view type_name;
+  if (!type || !ctx->GetValueString(type, &type_name) || !(type_name == unicode_string_view("object"))) {
+    fprintf(stderr, "snapshot does not hold a bootstrapped scope\n");
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* output = nullptr;
+  const char* config_path = nullptr;
+  const char* base_path = "";
+  std::vector<const char*> script_paths;
+  for (int i = 1; i < argc; ++i) {
+    bool has_value = i + 1 < argc;
+    if (!strcmp(argv[i], "-o") && has_value) {
+      output = argv[++i];
+    } else if (!strcmp(argv[i], "-c") && has_value) {
+      config_path = argv[++i];
+    } else if (!strcmp(argv[i], "-b") && has_value) {
+      base_path = argv[++i];
+    } else if (argv[i][0] == '-') {
+      PrintUsage(argv[0]);
+      return 1;
+    } else {
+      script_paths.push_back(argv[i]);
+    }
+  }
+  if (!output) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  unicode_string_view global_config(kDefaultGlobalConfig);
+  if (config_path) {
+    u8string config;
+    if (!ReadText(config_path, config)) {
+      return 1;
+    }
+    global_config = unicode_string_view(std::move(config));
+  }
+  std::vector<unicode_string_view> scripts;
+  for (const auto& path : script_paths) {
+    u8string script;
+    if (!ReadText(path, script)) {
+      return 1;
+    }
+    scripts.emplace_back(std::move(script));
+  }
+
+  std::vector<uint8_t> snapshot;
+  auto result = SnapshotBuilder::Build(scripts, ToStrView(base_path), global_config, snapshot);
+  if (result != SnapshotBuilder::Result::kSuccess) {
+    fprintf(stderr, "snapshot build failed, result = %d\n", static_cast<int>(result));
+    return 1;
+  }
+  if (!HippyFile::SaveFile(ToStrView(output), snapshot)) {
+    fprintf(stderr, "can not write %s\n", output);
+    return 1;
+  }
+  if (!VerifySnapshot(std::move(snapshot))) {
+    return 1;
+  }
+  fprintf(stdout, "snapshot written to %s, sdk version %s\n", output, kSdkVersion);
+  return 0;
+}
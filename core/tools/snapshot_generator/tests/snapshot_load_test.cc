@@ -0,0 +1,87 @@
+/*
+ *
+ * Tencent is pleased to support the open source community by making
+ * Hippy available.
+ *
+ * Copyright (C) 2022 THL A29 Limited, a Tencent company.
+ * All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Loads the blob the snapshot_generate test wrote, in a process of its own
+// like an app does, through V8VMInitParam::V8VMSnapshotType::kUseSnapshot.
+
+#include <gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "base/unicode_string_view.h"
+#include "core/base/common.h"
+#include "core/base/string_view_utils.h"
+#include "core/engine.h"
+#include "core/scope.h"
+#include "core/vm/v8/v8_vm.h"
+
+namespace {
+
+using unicode_string_view = tdf::base::unicode_string_view;
+using V8VM = hippy::vm::V8VM;
+using V8VMInitParam = hippy::vm::V8VMInitParam;
+
+class SnapshotLoadTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    auto param = std::make_shared<V8VMInitParam>();
+    param->type = V8VMInitParam::V8VMSnapshotType::kUseSnapshot;
+    ASSERT_TRUE(param->snapshot_data.MapFile(unicode_string_view(SNAPSHOT_TEST_FILE)));
+    engine_ = std::make_shared<Engine>();
+    engine_->SyncInit(std::make_shared<V8VM>(param));
+    scope_ = engine_->SyncCreateScope("", {{hippy::base::kUseSnapshot, "1"}});
+    ASSERT_TRUE(scope_);
+  }
+
+  std::string Run(const char* script) {
+    auto ctx = scope_->GetContext();
+    auto value = ctx->RunScript(script, "snapshot_load_test");
+    unicode_string_view str;
+    if (!value || !ctx->GetValueString(value, &str)) {
+      return "";
+    }
+    return hippy::base::StringViewUtils::ToU8StdStr(str);
+  }
+
+  std::shared_ptr<Engine> engine_;
+  std::shared_ptr<Scope> scope_;
+};
+
+}  // namespace
+
+TEST_F(SnapshotLoadTest, scope_is_bootstrapped) {
+  ASSERT_EQ("object", Run("typeof Hippy"));
+}
+
+TEST_F(SnapshotLoadTest, bundle_state_survives) {
+  ASSERT_EQ("hello 42", Run("snapshotFixture.greet()"));
+}
+
+TEST_F(SnapshotLoadTest, base_path_is_set) {
+  ASSERT_EQ(SNAPSHOT_TEST_BASE_PATH, Run("__HIPPYCURDIR__"));
+}
+
+TEST_F(SnapshotLoadTest, native_callbacks_resolve) {
+  // calls back into a native module through the external reference table
+  ASSERT_EQ("number", Run("typeof setTimeout(function() {}, 0)"));
+}